@@ -3,91 +3,148 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <limits.h>  // UINT_MAX
 #include "a89alloc.h"
 
-#define MAX_ALLOCATIONS 1000  // Configurável conforme necessidades
+// Contadores disponíveis nos dois modos (ver a89alloc.h)
+A89Stats a89_stats = { 0, 0, 0 };
 
-typedef struct {
-    void* ptr;          // Ponteiro para a memória alocada
-    size_t size;        // Tamanho do bloco alocado em bytes
-    char file[256];     // Nome do arquivo onde ocorreu a alocação
-    int line;           // Número da linha da alocação
-} allocation_info;
+A89Stats a89stats(void)
+{
+    return a89_stats;
+}
+
+void a89alloc_failed(size_t size, const char* file, int line)
+{
+    // Falha na alocação. Encerra programa.
+    fprintf(stderr,
+            "a89alloc:ERRO: Falha na alocação de %zu bytes em %s:%d\n",
+            size, file, line);
+    fprintf(stderr,
+            "Possíveis causas: memória insuficiente ou fragmentação.\n");
+
+    exit(EXIT_FAILURE);
+}
+
+#ifndef A89ALLOC_RELEASE
+
+/********************************************************************
+RASTREAMENTO INTRUSIVO
+
+Cada bloco é alocado com um cabeçalho logo antes do ponteiro entregue
+ao usuário. Os cabeçalhos formam uma lista duplamente encadeada
+circular (com sentinela), em ordem de alocação:
+
+    [ allocation_header | memória do usuário ]
+                          ^ ponteiro retornado
+
+* a89alloc: insere no fim da lista          -> O(1)
+* a89free:  volta ao cabeçalho e desencadeia -> O(1)
+* sem limite de alocações ativas
+
+Como free(), a89free só aceita um ponteiro vindo de A89ALLOC e ainda
+não liberado: o cabeçalho de um bloco liberado volta ao malloc, e o de
+um ponteiro estranho nem existe, então nenhum dos dois é consultado
+(double-free e ponteiros de malloc ficam para o ASan/Valgrind).
+
+O nome do arquivo não é copiado: guardamos o ponteiro de __FILE__,
+que é um literal e vive durante todo o programa.
+********************************************************************/
+
+typedef struct allocation_info allocation_info;
+
+struct allocation_info {
+    allocation_info* prev;  // Lista encadeada de blocos ativos
+    allocation_info* next;
+    size_t size;            // Tamanho do bloco alocado em bytes
+    const char* file;       // Arquivo onde ocorreu a alocação (__FILE__)
+    int line;               // Número da linha da alocação
+};
+
+// Cabeçalho com tamanho múltiplo do maior alinhamento da plataforma,
+// para que a memória do usuário fique alinhada como a do malloc
+typedef union {
+    allocation_info info;
+    max_align_t align;
+} allocation_header;
 
-// Array principal de controle
-static allocation_info allocations[MAX_ALLOCATIONS];
+// Sentinela da lista de blocos ativos
+static allocation_info allocations = { &allocations, &allocations, 0, NULL, 0 };
 
 // Contador de alocações ativas
 static int total_allocations = 0;
 
 
+static allocation_info* header_of(void* ptr)
+{
+    return &((allocation_header*)ptr - 1)->info;
+}
+
+static void* user_pointer(allocation_info* info)
+{
+    return (allocation_header*)info + 1;
+}
+
+
 void* a89alloc(size_t size, const char* file, int line)
 {
-    // Validação 1: Verificar limite de alocações
-    if (total_allocations >= MAX_ALLOCATIONS)
-    {
-        fprintf(stderr,
-                "ERRO: Limite máximo de alocações atingido (%d)!\n", 
-                MAX_ALLOCATIONS);
-        fprintf(stderr,
-                "Considere aumentar MAX_ALLOCATIONS ou revisar o código.\n");
-        return NULL;
-    }
-    
-    // Validação 2: Verificar tamanho válido
+    // Validação 1: Verificar tamanho válido
     if (size == 0)
     {
         fprintf(stderr,
-                "AVISO: Tentativa de alocar 0 bytes em %s:%d\n", 
+                "AVISO: Tentativa de alocar 0 bytes em %s:%d\n",
                 file, line);
         fprintf(stderr,
                 "Esta operação pode indicar um erro lógico.\n");
         return NULL;
     }
-    
-    // Validação 3: Verificar parâmetros de entrada
+
+    // Validação 2: Verificar parâmetros de entrada
     if (file == NULL)
     {
         fprintf(stderr,
                 "ERRO: Parâmetro 'file' é NULL em a89alloc()\n");
         return NULL;
     }
-    
-    // Alocação usando malloc padrão
-    void* ptr = malloc(size);
-    
-    if (ptr != NULL)
+
+    // Alocação usando malloc padrão (cabeçalho + bloco do usuário)
+    allocation_info* info = NULL;
+    if (size <= SIZE_MAX - sizeof(allocation_header))
+    {
+        info = malloc(sizeof(allocation_header) + size);
+    }
+
+    if (info != NULL)
     {
-        // Registro bem-sucedido no sistema de controle
-        allocations[total_allocations].ptr = ptr;
-        allocations[total_allocations].size = size;
-        
-        // Cópia segura do nome do arquivo
-        strncpy(allocations[total_allocations].file, file, 255);
-        // Encerra a string corretamente
-        allocations[total_allocations].file[255] = '\0';
-        
-        allocations[total_allocations].line = line;
+        // Registro no sistema de controle: insere no fim da lista
+        info->size = size;
+        info->file = file;
+        info->line = line;
+
+        info->prev = allocations.prev;
+        info->next = &allocations;
+        allocations.prev->next = info;
+        allocations.prev = info;
         total_allocations++;
-        
+
+        a89_stats.allocation_count++;
+        a89_stats.live_bytes += size;
+        if (a89_stats.live_bytes > a89_stats.peak_bytes)
+        {
+            a89_stats.peak_bytes = a89_stats.live_bytes;
+        }
+
         // Log informativo (pode ser desabilitado em produção)
-        //printf("ALOCACAO: %zu bytes em %s:%d (ptr: %p)\n", 
-        //       size, file, line, ptr);
+        //printf("ALOCACAO: %zu bytes em %s:%d (ptr: %p)\n",
+        //       size, file, line, user_pointer(info));
     }
     else
     {
-        // Falha na alocação. Encerra programa.
-        fprintf(stderr,
-                "a89alloc:ERRO: Falha na alocação de %zu bytes em %s:%d\n", 
-                size, file, line);
-        fprintf(stderr,
-                "Possíveis causas: memória insuficiente ou fragmentação.\n");
-
-        exit(EXIT_FAILURE);
+        a89alloc_failed(size, file, line);
     }
-    
-    return ptr;
+
+    return user_pointer(info);
 }
 
 
@@ -96,92 +153,77 @@ void a89free(void* ptr) {
     if (ptr == NULL) {
         return;
     }
-    
-    // Busca linear no array de alocações
-    for (int i = 0; i < total_allocations; i++) {
-        if (allocations[i].ptr == ptr) {
-            // Alocação encontrada - proceder com liberação da memória
-            free(ptr);
-            
-            // Otimização: substituir por último elemento (O(1) vs O(n))
-            allocations[i] = allocations[total_allocations - 1];
-            total_allocations--;
-            
-            return;
-        }
-    }
-    
-    // Ponteiro não encontrado - possível erro
-    fprintf(stderr, "AVISO: Tentativa de liberar ponteiro não rastreado: %p\n", ptr);
-    fprintf(stderr, "         Possíveis causas:\n");
-    fprintf(stderr, "         - Ponteiro alocado com malloc() padrão\n");
-    fprintf(stderr, "         - Double-free (liberação dupla)\n");
-    fprintf(stderr, "         - Ponteiro corrompido\n");
-    
-    // Decisão: liberar mesmo assim para evitar vazamentos
-    free(ptr);
+
+    // Bloco ativo (contrato acima): remove da lista e libera
+    allocation_info* info = header_of(ptr);
+    info->prev->next = info->next;
+    info->next->prev = info->prev;
+    total_allocations--;
+    a89_stats.live_bytes -= info->size;
+
+    free(info);
 }
 
 
 void a89check_leaks(void) {
     if (total_allocations == 0) {
         //printf("SUCESSO: Nenhum vazamento de memoria detectado!\n");
-        //printf("   Todas as alocacoes foram devidamente liberadas.\n");        
+        //printf("   Todas as alocacoes foram devidamente liberadas.\n");
         return;
     }
-    
+
     // Cabeçalho do relatório de vazamentos
-    printf("VAZAMENTOS DETECTADOS: %d alocacao(oes) nao liberada(s)\n", 
+    printf("VAZAMENTOS DETECTADOS: %d alocacao(oes) nao liberada(s)\n",
            total_allocations);
-    
+
     // Imprimir linha de separação
     for (int i = 0; i < 60; i++) {
         printf("=");
     }
     printf("\n");
-    
+
     size_t total_leaked = 0;
     size_t max_leak = 0;
-    int max_leak_index = 0;
-    
+    allocation_info* max_leak_info = NULL;
+
     // Análise detalhada de cada vazamento
-    for (int i = 0; i < total_allocations; i++) {
-        printf("VAZAMENTO #%d:\n", i + 1);
-        printf("  Localizacao: %s:%d\n", allocations[i].file, allocations[i].line);
-        printf("  Tamanho: %zu bytes\n", allocations[i].size);
-        printf("  Endereco: %p\n", allocations[i].ptr);
-        
+    int i = 0;
+    for (allocation_info* info = allocations.next; info != &allocations; info = info->next) {
+        printf("VAZAMENTO #%d:\n", ++i);
+        printf("  Localizacao: %s:%d\n", info->file, info->line);
+        printf("  Tamanho: %zu bytes\n", info->size);
+        printf("  Endereco: %p\n", user_pointer(info));
+
         // Análise de impacto
-        if (allocations[i].size > 1024) {
+        if (info->size > 1024) {
             printf("  IMPACTO ALTO: Vazamento > 1KB\n");
-        } else if (allocations[i].size > 100) {
+        } else if (info->size > 100) {
             printf("  IMPACTO MEDIO: Vazamento > 100 bytes\n");
         }
-        
+
         // Imprimir linha de separação
         for (int j = 0; j < 40; j++) {
             printf("-");
         }
         printf("\n");
-        
+
         // Estatísticas
-        total_leaked += allocations[i].size;
-        if (allocations[i].size > max_leak) {
-            max_leak = allocations[i].size;
-            max_leak_index = i;
+        total_leaked += info->size;
+        if (max_leak_info == NULL || info->size > max_leak) {
+            max_leak = info->size;
+            max_leak_info = info;
         }
     }
-    
+
     // Resumo estatístico
     printf("\nRESUMO ESTATISTICO:\n");
-    printf("  Total vazado: %zu bytes (%.2f KB)\n", 
+    printf("  Total vazado: %zu bytes (%.2f KB)\n",
            total_leaked, (double)total_leaked / 1024.0);
-    printf("  Media por vazamento: %.2f bytes\n", 
+    printf("  Media por vazamento: %.2f bytes\n",
            (double)total_leaked / total_allocations);
     printf("  Maior vazamento: %zu bytes em %s:%d\n",
-           max_leak, allocations[max_leak_index].file, 
-           allocations[max_leak_index].line);
-    
+           max_leak, max_leak_info->file, max_leak_info->line);
+
     // Recomendações
     printf("\nRECOMENDACOES:\n");
     printf("  1. Revisar cada localizacao listada acima\n");
@@ -193,19 +235,19 @@ void a89check_leaks(void) {
 
 void a89report_alloc(void) {
     printf("RELATORIO DE ALOCACOES ATIVAS\n");
-    
+
     // Imprimir linha de separação
     for (int i = 0; i < 50; i++) {
         printf("=");
     }
     printf("\n");
-    
+
     printf("Total de alocacoes ativas: %d\n", total_allocations);
-    
+
     if (total_allocations == 0) {
         printf("Nenhuma alocacao ativa no momento.\n");
         printf("   Sistema de memoria limpo.\n");
-        
+
         // Imprimir linha de separação
         for (int i = 0; i < 50; i++) {
             printf("=");
@@ -213,34 +255,35 @@ void a89report_alloc(void) {
         printf("\n");
         return;
     }
-    
+
     size_t total_memory = 0;
     size_t min_alloc = UINT_MAX;
     size_t max_alloc = 0;
-    
+
     // Processamento de cada alocação
-    for (int i = 0; i < total_allocations; i++) {
-        printf("\nALOCACAO #%d:\n", i + 1);
-        printf("  Tamanho: %zu bytes\n", allocations[i].size);
-        printf("  Endereco: %p\n", allocations[i].ptr);
-        printf("  Arquivo: %s\n", allocations[i].file);
-        printf("  Linha: %d\n", allocations[i].line);
-        
+    int i = 0;
+    for (allocation_info* info = allocations.next; info != &allocations; info = info->next) {
+        printf("\nALOCACAO #%d:\n", ++i);
+        printf("  Tamanho: %zu bytes\n", info->size);
+        printf("  Endereco: %p\n", user_pointer(info));
+        printf("  Arquivo: %s\n", info->file);
+        printf("  Linha: %d\n", info->line);
+
         // Estatísticas globais
-        total_memory += allocations[i].size;
-        if (allocations[i].size < min_alloc) min_alloc = allocations[i].size;
-        if (allocations[i].size > max_alloc) max_alloc = allocations[i].size;
+        total_memory += info->size;
+        if (info->size < min_alloc) min_alloc = info->size;
+        if (info->size > max_alloc) max_alloc = info->size;
     }
-    
+
     // Resumo estatístico
     printf("\nESTATISTICAS GERAIS:\n");
-    printf("  Total de memoria alocada: %zu bytes (%.2f KB)\n", 
+    printf("  Total de memoria alocada: %zu bytes (%.2f KB)\n",
            total_memory, (double)total_memory / 1024.0);
-    printf("  Media por alocacao: %.2f bytes\n", 
+    printf("  Media por alocacao: %.2f bytes\n",
            (double)total_memory / total_allocations);
     printf("  Menor alocacao: %zu bytes\n", min_alloc);
     printf("  Maior alocacao: %zu bytes\n", max_alloc);
-    
+
     // Imprimir linha de separação
     for (int i = 0; i < 50; i++) {
         printf("=");
@@ -248,4 +291,6 @@ void a89report_alloc(void) {
     printf("\n");
 }
 
+#endif // A89ALLOC_RELEASE
+
 // fim de a89alloc.c
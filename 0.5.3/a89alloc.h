@@ -5,6 +5,86 @@
 
 #include <stddef.h>
 
+/********************************************************************
+MODOS DE COMPILAÇÃO
+
+* padrão: cada bloco é rastreado (arquivo/linha), com detecção de
+  vazamentos (a89check_leaks) e relatório (a89report_alloc).
+
+* -DA89ALLOC_RELEASE: A89ALLOC e a89free viram chamadas diretas a
+  malloc/free (inline, sem lista nem arquivo/linha) e a89check_leaks
+  e a89report_alloc não fazem nada. O código que usa a biblioteca
+  (ex: main.c) não muda.
+
+Nos dois modos os contadores abaixo ficam disponíveis para métricas.
+********************************************************************/
+
+typedef struct {
+    size_t live_bytes;        // Bytes alocados e ainda não liberados
+    size_t peak_bytes;        // Maior valor já atingido por live_bytes
+    size_t allocation_count;  // Total de alocações feitas
+} A89Stats;
+
+// Contadores globais (atualizados por A89ALLOC/a89free)
+extern A89Stats a89_stats;
+
+/********************************************************************
+Retorna uma cópia dos contadores de memória
+********************************************************************/
+A89Stats a89stats(void);
+
+/********************************************************************
+Encerra o programa após falha do malloc (não retorna)
+********************************************************************/
+void a89alloc_failed(size_t size, const char* file, int line);
+
+
+#ifdef A89ALLOC_RELEASE
+
+#include <stdlib.h>
+
+// Prefixo com o tamanho do bloco, só para manter live_bytes
+typedef union {
+    size_t size;
+    max_align_t align;
+} a89_release_header;
+
+static inline void* a89alloc_release(size_t size)
+{
+    if (size == 0) return NULL;
+    
+    a89_release_header* block = malloc(sizeof(a89_release_header) + size);
+    if (block == NULL)
+    {
+        a89alloc_failed(size, "?", 0);
+    }
+    block->size = size;
+    
+    a89_stats.allocation_count++;
+    a89_stats.live_bytes += size;
+    if (a89_stats.live_bytes > a89_stats.peak_bytes)
+    {
+        a89_stats.peak_bytes = a89_stats.live_bytes;
+    }
+    return block + 1;
+}
+
+#define A89ALLOC(size) a89alloc_release(size)
+
+static inline void a89free(void* ptr)
+{
+    if (ptr == NULL) return;
+    
+    a89_release_header* block = (a89_release_header*)ptr - 1;
+    a89_stats.live_bytes -= block->size;
+    free(block);
+}
+
+static inline void a89check_leaks(void) {}
+static inline void a89report_alloc(void) {}
+
+#else // rastreamento completo
+
 /********************************************************************
 Função principal de alocação com rastreamento
 Parâmetros:
@@ -28,7 +108,8 @@ Captura automaticamente __FILE__ e __LINE__
 /********************************************************************
 Função para liberação de memória com rastreamento
 Parâmetro:
-	ptr - ponteiro a ser liberado
+	ptr - ponteiro de A89ALLOC ainda não liberado (ou NULL), como
+	      no free()
 ********************************************************************/
 void a89free(void* ptr);
 
@@ -44,4 +125,6 @@ Função para gerar relatório de alocações ativas
 ********************************************************************/
 void a89report_alloc(void);
 
+#endif // A89ALLOC_RELEASE
+
 #endif // A89ALLOC_H
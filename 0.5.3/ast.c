@@ -28,106 +28,310 @@ static LogicOp logic_operators [] =
     {">=", OP_GREATER_EQUAL}
 };
 
+//===================================================================
+// AST ARENA
+//===================================================================
+/********************************************************************
+Todos os nós, arrays de filhos e strings de um programa saem de
+blocos grandes alocados em sequência (bump pointer). Nada é liberado
+individualmente: ast_arena_destroy() devolve a árvore inteira
+percorrendo só a lista de blocos.
+
+Os literais string são a exceção: são String com contagem de
+referências (zzstring.h), porque uma variável pode continuar com o
+valor depois que a árvore some (REPL). A arena guarda uma referência
+de cada um e a solta no destroy. Literais inteiros fora da faixa
+inline (value.h) seguem a mesma regra: a caixa fica na lista values.
+
+Literais e nomes de variáveis são internados numa tabela hash da
+própria arena: um script que repete o mesmo prompt ou rótulo milhares
+de vezes tem uma única cópia do texto, e dois literais iguais são o
+mesmo ponteiro.
+********************************************************************/
+#define AST_ARENA_CHUNK_SIZE  (16 * 1024)
+#define AST_ARENA_ALIGN       16
+#define AST_ARENA_STRINGS_MIN 64
+
+struct ASTArenaChunk
+{
+    ASTArenaChunk* next;     // Bloco anterior (lista em ordem inversa)
+    size_t capacity;         // Bytes disponíveis em data[]
+    size_t used;             // Bytes já entregues
+    unsigned char data[];
+};
+
+struct ASTArenaValue
+{
+    ASTArenaValue* next;
+    Value value;             // Referência da arena
+};
+
+static ASTArenaChunk* arena_new_chunk(ASTArena* arena, size_t min_size)
+{
+    size_t capacity = AST_ARENA_CHUNK_SIZE;
+    if (min_size > capacity)
+    {
+        capacity = min_size;  // Alocação grande: bloco sob medida
+    }
+    
+    ASTArenaChunk* chunk = A89ALLOC(sizeof(ASTArenaChunk) + capacity);
+    chunk->next = arena->chunks;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    
+    arena->chunks = chunk;
+    arena->chunk_count++;
+    arena->total_bytes += capacity;
+    return chunk;
+}
+
+ASTArena* ast_arena_create(void)
+{
+    ASTArena* arena = A89ALLOC(sizeof(ASTArena));
+    arena->chunks = NULL;
+    arena->chunk_count = 0;
+    arena->total_bytes = 0;
+    arena->strings = NULL;
+    arena->string_capacity = 0;
+    arena->string_count = 0;
+    arena->values = NULL;
+    return arena;
+}
+
+void ast_arena_destroy(ASTArena* arena)
+{
+    if (!arena) return;
+    
+    for (int i = 0; i < arena->string_capacity; i++)
+    {
+        if (arena->strings[i]) string_release(arena->strings[i]);
+    }
+    a89free(arena->strings);
+    
+    for (ASTArenaValue* item = arena->values; item; item = item->next)
+    {
+        value_release(item->value);
+    }
+    
+    ASTArenaChunk* chunk = arena->chunks;
+    while (chunk)
+    {
+        ASTArenaChunk* next = chunk->next;
+        a89free(chunk);
+        chunk = next;
+    }
+    a89free(arena);
+}
+
+// Memória zerada e alinhada; válida até ast_arena_destroy()
+void* ast_arena_alloc(ASTArena* arena, size_t size)
+{
+    size = (size + AST_ARENA_ALIGN - 1) & ~(size_t)(AST_ARENA_ALIGN - 1);
+    
+    ASTArenaChunk* chunk = arena->chunks;
+    if (!chunk || chunk->capacity - chunk->used < size)
+    {
+        chunk = arena_new_chunk(arena, size);
+    }
+    
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+char* ast_arena_strdup(ASTArena* arena, const char* text)
+{
+    if (!text) text = "";
+    return ast_arena_strndup(arena, text, strlen(text));
+}
+
+char* ast_arena_strndup(ASTArena* arena, const char* text, size_t length)
+{
+    char* copy = ast_arena_alloc(arena, length + 1);  // Zerada: já termina em '\0'
+    memcpy(copy, text, length);
+    return copy;
+}
+
+// Dobra a tabela de internação, reposicionando as entradas
+static void arena_grow_strings(ASTArena* arena)
+{
+    int old_capacity = arena->string_capacity;
+    String** old_strings = arena->strings;
+    
+    int capacity = old_capacity ? old_capacity * 2 : AST_ARENA_STRINGS_MIN;
+    arena->strings = A89ALLOC(capacity * sizeof(String*));
+    memset(arena->strings, 0, capacity * sizeof(String*));
+    arena->string_capacity = capacity;
+    
+    for (int i = 0; i < old_capacity; i++)
+    {
+        String* string = old_strings[i];
+        if (!string) continue;
+        
+        int index = string_hash(string) & (capacity - 1);
+        while (arena->strings[index]) index = (index + 1) & (capacity - 1);
+        arena->strings[index] = string;
+    }
+    a89free(old_strings);
+}
+
+String* ast_arena_string(ASTArena* arena, const char* chars, size_t length)
+{
+    // Carga máxima de 3/4
+    if ((arena->string_count + 1) * 4 > arena->string_capacity * 3)
+    {
+        arena_grow_strings(arena);
+    }
+    
+    uint32_t hash = string_hash_bytes(chars, length);
+    int mask = arena->string_capacity - 1;
+    int index = hash & mask;
+    
+    while (arena->strings[index])
+    {
+        String* string = arena->strings[index];
+        if (string_hash(string) == hash && string->length == length &&
+            memcmp(string->chars, chars, length) == 0)
+        {
+            return string;
+        }
+        index = (index + 1) & mask;
+    }
+    
+    String* string = string_new(chars, length);
+    string->hash = hash;
+    arena->strings[index] = string;
+    arena->string_count++;
+    return string;
+}
+
+const char* ast_arena_name(ASTArena* arena, const char* name)
+{
+    if (!name) name = "";
+    return ast_arena_string(arena, name, strlen(name))->chars;
+}
+
+
 //===================================================================
 // NODE CREATION FUNCTIONS
 //===================================================================
 
-// CREATES NODE AND SAFELY INITIALIZES ITS FIELDS WITH memset
-static ASTNode* create_node(NodeType type, int line, int column)
+// CREATES NODE IN THE ARENA (MEMORY ALREADY ZEROED)
+static ASTNode* create_node(ASTArena* arena, NodeType type, int line, int column)
 {
-    ASTNode* node = A89ALLOC(sizeof(ASTNode));
+    ASTNode* node = ast_arena_alloc(arena, sizeof(ASTNode));
     node->type = type;
     node->line = line;
     node->column = column;
-    memset(&node->data, 0, sizeof(node->data));
     return node;
 }
 
-ASTNode* create_bool_node(int value, int line, int column)
+// Altura de um nó com esses filhos (right pode ser NULL)
+static unsigned char parent_height(ASTNode* left, ASTNode* right)
+{
+    unsigned char height = left->height;
+    if (right && right->height > height) height = right->height;
+    return height < AST_HEIGHT_MAX ? (unsigned char)(height + 1) : AST_HEIGHT_MAX;
+}
+
+ASTNode* create_bool_node(ASTArena* arena, int value, int line, int column)
 {
-    ASTNode* node = create_node(NODE_BOOL, line, column);
+    ASTNode* node = create_node(arena, NODE_BOOL, line, column);
     node->data.boolean.value = value;
     return node;
 }
 
-ASTNode* create_number_node(double value, int line, int column)
+ASTNode* create_number_node(ASTArena* arena, double value, int line, int column)
 {
-    ASTNode* node = create_node(NODE_NUMBER, line, column);
-    node->data.number.value = value;
+    ASTNode* node = create_node(arena, NODE_NUMBER, line, column);
+    node->data.number.value = value_from_double(value);
     return node;
 }
 
-
-ASTNode* create_string_node(const char* value, int line, int column)
+ASTNode* create_integer_node(ASTArena* arena, int64_t value, int line, int column)
 {
-    ASTNode* node = create_node(NODE_STRING, line, column);
-    
-    if (value)
-    {
-        strncpy(node->data.string.value, value, STRING_SIZE - 1);
-        node->data.string.value[STRING_SIZE - 1] = '\0';
-    }
-    else
+    ASTNode* node = create_node(arena, NODE_NUMBER, line, column);
+    if (value >= VALUE_INT_MIN && value <= VALUE_INT_MAX)
     {
-        node->data.string.value[0] = '\0';
+        node->data.number.value = value_int(value);
+        return node;
     }
     
+    ASTArenaValue* item = ast_arena_alloc(arena, sizeof(ASTArenaValue));
+    item->value = value_box_int(value);
+    item->next = arena->values;
+    arena->values = item;
+    node->data.number.value = item->value;
+    return node;
+}
+
+
+ASTNode* create_string_node(ASTArena* arena, const char* value, size_t length,
+                            int line, int column)
+{
+    ASTNode* node = create_node(arena, NODE_STRING, line, column);
+    
+    node->data.string.value = ast_arena_string(arena, value, length);
+    
     return node;
 }
 
 // CREATES VARIABLE NODE. VAR_NAME MUST ALREADY BE VALID (VALIDATED BY PARSER)
-ASTNode* create_variable_node(const char* var_name, int line, int column)
+ASTNode* create_variable_node(ASTArena* arena, const char* var_name, int line, int column)
 {
-    ASTNode* node = create_node(NODE_VARIABLE, line, column);
-    strncpy(node->data.variable.var_name, var_name, VARNAME_SIZE - 1);
-    node->data.variable.var_name[VARNAME_SIZE - 1] = '\0';
+    ASTNode* node = create_node(arena, NODE_VARIABLE, line, column);
+    node->data.variable.var_name = ast_arena_name(arena, var_name);
+    node->data.variable.slot = -1;
     return node;
 }
 
 // CREATES BINARY OPERATION. LEFT AND RIGHT CANNOT BE NULL
-ASTNode* create_binary_op_node(char operator, ASTNode* left, ASTNode* right, 
+ASTNode* create_binary_op_node(ASTArena* arena, char operator, ASTNode* left, ASTNode* right, 
                                int line, int column)
 {
-    ASTNode* node = create_node(NODE_BINARY_OP, line, column);
+    ASTNode* node = create_node(arena, NODE_BINARY_OP, line, column);
     node->data.binaryop.operator = operator;
     node->data.binaryop.left = left;
     node->data.binaryop.right = right;
+    node->height = parent_height(left, right);
     return node;
 }
 
 // CREATES UNARY OPERATION. OPERAND CANNOT BE NULL
-ASTNode* create_unary_op_node(char operator, ASTNode* operand, 
+ASTNode* create_unary_op_node(ASTArena* arena, char operator, ASTNode* operand, 
                               int line, int column)
 {
-    ASTNode* node = create_node(NODE_UNARY_OP, line, column);
+    ASTNode* node = create_node(arena, NODE_UNARY_OP, line, column);
     node->data.unaryop.operator = operator;
     node->data.unaryop.operand = operand;
+    node->height = parent_height(operand, NULL);
     return node;
 }
 
 // CREATES ASSIGNMENT. VAR_NAME ALREADY VALIDATED, VALUE CANNOT BE NULL
-ASTNode* create_assignment_node(const char* var_name, ASTNode* value, 
+ASTNode* create_assignment_node(ASTArena* arena, const char* var_name, ASTNode* value, 
                                 int line, int column)
 {
-    ASTNode* node = create_node(NODE_ASSIGNMENT, line, column);
-    strncpy(node->data.assignment.var_name, var_name, VARNAME_SIZE - 1);
-    node->data.assignment.var_name[VARNAME_SIZE - 1] = '\0';
+    ASTNode* node = create_node(arena, NODE_ASSIGNMENT, line, column);
+    node->data.assignment.var_name = ast_arena_name(arena, var_name);
+    node->data.assignment.slot = -1;
     node->data.assignment.value = value;
     return node;
 }
 
 // Cria um nó de lista de statements
-ASTNode* create_statement_list_node(int line, int column) {
-    ASTNode* node = create_node(NODE_STATEMENT_LIST, line, column);
+ASTNode* create_statement_list_node(ASTArena* arena, int line, int column) {
+    ASTNode* node = create_node(arena, NODE_STATEMENT_LIST, line, column);
     node->data.statementlist.capacity = 4;
-    node->data.statementlist.statements = A89ALLOC(
+    node->data.statementlist.statements = ast_arena_alloc(arena,
         sizeof(ASTNode*) * node->data.statementlist.capacity
     );
     return node;
 }
 
 // Adiciona um statement à lista (redimensiona se necessário)
-void statement_list_add(ASTNode* list_node, ASTNode* stmt)
+void statement_list_add(ASTArena* arena, ASTNode* list_node, ASTNode* stmt)
 {
     if (list_node->type != NODE_STATEMENT_LIST)
     {
@@ -142,14 +346,13 @@ void statement_list_add(ASTNode* list_node, ASTNode* stmt)
     {
         int new_cap = list->capacity * 2;
         
-        ASTNode** new_exprs = A89ALLOC(new_cap * sizeof(ASTNode*));
+        ASTNode** new_exprs = ast_arena_alloc(arena, new_cap * sizeof(ASTNode*));
         
+        // O array antigo fica na arena até ast_arena_destroy()
         for (int i = 0; i < list->capacity; i++) {
             new_exprs[i] = list->statements[i];
         }
         
-        a89free(list->statements);
-        
         list->statements = new_exprs;
         list->capacity = new_cap;
     }
@@ -158,26 +361,36 @@ void statement_list_add(ASTNode* list_node, ASTNode* stmt)
     list->count++;
 }
 
-ASTNode* create_input_node(const char* prompt, char* var_name, int line, int column)
+ASTNode* create_input_node(ASTArena* arena, const char* prompt, size_t prompt_length,
+                           char* var_name, int line, int column)
 {
-    ASTNode* node = create_node(NODE_INPUT, line, column);
-    if(prompt)
-    {
-        strncpy(node->data.inputstatement.prompt, prompt, STRING_SIZE - 1);
-        node->data.inputstatement.prompt[STRING_SIZE - 1] = '\0';
-    }
-    strncpy(node->data.inputstatement.var_name, var_name, VARNAME_SIZE - 1);
-    node->data.inputstatement.var_name[VARNAME_SIZE - 1] = '\0';
+    ASTNode* node = create_node(arena, NODE_INPUT, line, column);
+    node->data.inputstatement.prompt = ast_arena_string(arena, prompt ? prompt : "",
+                                                        prompt ? prompt_length : 0)->chars;
+    node->data.inputstatement.var_name = ast_arena_name(arena, var_name);
+    node->data.inputstatement.slot = -1;
     return node;
 }
 
-ASTNode* create_print_node(int line, int column)
+int ast_is_self_append(const ASTNode* assignment)
+{
+    if (assignment->type != NODE_ASSIGNMENT) return 0;
+    
+    const ASTNode* value = assignment->data.assignment.value;
+    if (value->type != NODE_BINARY_OP || value->data.binaryop.operator != '+') return 0;
+    
+    const ASTNode* left = value->data.binaryop.left;
+    return left->type == NODE_VARIABLE && left->data.variable.slot >= 0 &&
+           left->data.variable.slot == assignment->data.assignment.slot;
+}
+
+ASTNode* create_print_node(ASTArena* arena, int line, int column)
 {
-    ASTNode* node = create_node(NODE_PRINT, line, column);
+    ASTNode* node = create_node(arena, NODE_PRINT, line, column);
     
     // Inicializa a estrutura printstatement
     node->data.printstatement.capacity = 4;  // Começa com capacidade para 4 itens
-    node->data.printstatement.items = A89ALLOC(
+    node->data.printstatement.items = ast_arena_alloc(arena,
         sizeof(ASTNode*) * node->data.printstatement.capacity
     );
     node->data.printstatement.count = 0;
@@ -186,45 +399,32 @@ ASTNode* create_print_node(int line, int column)
     return node;
 }
 
-ASTNode* create_color_node(TokenType color_token, int line, int column)
+ASTNode* create_color_node(ASTArena* arena, TokenType color_token, int line, int column)
 {
-    ASTNode* node = create_node(NODE_COLOR, line, column);
+    ASTNode* node = create_node(arena, NODE_COLOR, line, column);
     
-    // 1. Converte TokenType para ColorCode
-    ColorCode color_code = token_to_color_code(color_token);
-    node->data.color.color_token_id = color_code;
-    
-    // 2. Obtém string ANSI
-    const char* ansi = token_to_ansi(color_token);
-    
-    // 3. Copia para o node
-    if (ansi != NULL) {
-        strncpy(node->data.color.ansi_color, ansi, 
-                sizeof(node->data.color.ansi_color) - 1);
-        node->data.color.ansi_color[sizeof(node->data.color.ansi_color) - 1] = '\0';
-    } else {
-        strcpy(node->data.color.ansi_color, "\033[0m");
-    }
+    // Só o código; a sequência ANSI é buscada na tabela ao imprimir
+    node->data.color.code = (unsigned char)token_to_color_code(color_token);
     
     return node;
 }
 
-ASTNode* create_alignment_node(TokenType token_type, int line, int column)
+ASTNode* create_alignment_node(ASTArena* arena, TokenType token_type, int line, int column)
 {
-    ASTNode* node = create_node(NODE_ALIGNMENT, line, column);
+    ASTNode* node = create_node(arena, NODE_ALIGNMENT, line, column);
     node->data.alignment.alignment_type = token_type;
     return node;
 }
 
-ASTNode* create_width_node(int width_value, int line, int column)
+ASTNode* create_width_node(ASTArena* arena, int width_value, int line, int column)
 {
-    ASTNode* node = create_node(NODE_WIDTH, line, column);
+    ASTNode* node = create_node(arena, NODE_WIDTH, line, column);
     node->data.width.value = width_value;
     return node;
 }
 
 // Adiciona um item (expressão) ao comando print
-void print_node_add_item(ASTNode* print_node, ASTNode* item)
+void print_node_add_item(ASTArena* arena, ASTNode* print_node, ASTNode* item)
 {
     if (print_node->type != NODE_PRINT)
     {
@@ -238,16 +438,13 @@ void print_node_add_item(ASTNode* print_node, ASTNode* item)
     if (print_data->count >= print_data->capacity)
     {
         int new_cap = print_data->capacity * 2;
-        ASTNode** new_items = A89ALLOC(new_cap * sizeof(ASTNode*));
+        ASTNode** new_items = ast_arena_alloc(arena, new_cap * sizeof(ASTNode*));
         
-        // Copia os itens antigos
+        // Copia os itens antigos (o array antigo fica na arena)
         for (int i = 0; i < print_data->capacity; i++) {
             new_items[i] = print_data->items[i];
         }
         
-        // Libera o array antigo
-        a89free(print_data->items);
-        
         // Atualiza para o novo array
         print_data->items = new_items;
         print_data->capacity = new_cap;
@@ -264,49 +461,52 @@ void print_set_newline(ASTNode* print_node, int has_newline) {
 }
 
 // Criar nó de operação de comparação(==, !=, <, <=, >, >=)
-ASTNode* create_comparison_op_node(LogicalOperator operator,
+ASTNode* create_comparison_op_node(ASTArena* arena, LogicalOperator operator,
                                    ASTNode* left, ASTNode* right, 
                                    int line, int column) {
-    ASTNode* node = create_node(NODE_COMPARISON_OP, line, column);
+    ASTNode* node = create_node(arena, NODE_COMPARISON_OP, line, column);
     node->line = line;
     node->column = column;
     
     node->data.logicalop.operator = operator;
     node->data.logicalop.left = left;
     node->data.logicalop.right = right;
+    node->height = parent_height(left, right);
     
     return node;
 }
 
 // Criar nó de operação lógica (AND, OR)
-ASTNode* create_logical_op_node(LogicalOperator operator,
+ASTNode* create_logical_op_node(ASTArena* arena, LogicalOperator operator,
                                 ASTNode* left, ASTNode* right, 
                                 int line, int column) {
-    ASTNode* node = create_node(NODE_LOGICAL_OP, line, column);
+    ASTNode* node = create_node(arena, NODE_LOGICAL_OP, line, column);
     node->line = line;
     node->column = column;
     
     node->data.logicalop.operator = operator;
     node->data.logicalop.left = left;
     node->data.logicalop.right = right;
+    node->height = parent_height(left, right);
     
     return node;
 }
 
 // Criar nó de operação lógica unária (NOT)
-ASTNode* create_logical_not_node(ASTNode* operand, int line, int column)
+ASTNode* create_logical_not_node(ASTArena* arena, ASTNode* operand, int line, int column)
 {
-    ASTNode* node = create_node(NODE_NOT_LOGICAL_OP, line, column);
+    ASTNode* node = create_node(arena, NODE_NOT_LOGICAL_OP, line, column);
     node->line = line;
     node->column = column;
     
     node->data.notop.operator = OP_NOT;
     node->data.notop.operand = operand;
+    node->height = parent_height(operand, NULL);
     
     return node;
 }
 
-ASTNode* create_if_node(ASTNode* condition,
+ASTNode* create_if_node(ASTArena* arena, ASTNode* condition,
                         ASTNode* then_body, ASTNode* else_body,
                         int line, int column)
 {
@@ -315,7 +515,7 @@ ASTNode* create_if_node(ASTNode* condition,
         return NULL;
     }
     
-    ASTNode* node = create_node(NODE_IF, line, column);
+    ASTNode* node = create_node(arena, NODE_IF, line, column);
     node->line = line;
     node->column = column;
 
@@ -326,9 +526,9 @@ ASTNode* create_if_node(ASTNode* condition,
     return node;
 }
 
-ASTNode* create_while_node(ASTNode* condition, ASTNode* body, int line, int column)
+ASTNode* create_while_node(ASTArena* arena, ASTNode* condition, ASTNode* body, int line, int column)
 {
-    ASTNode* node = create_node(NODE_WHILE, line, column);
+    ASTNode* node = create_node(arena, NODE_WHILE, line, column);
     node->line = line;
     node->column = column;
 
@@ -338,18 +538,18 @@ ASTNode* create_while_node(ASTNode* condition, ASTNode* body, int line, int colu
     return node;
 }
 
-ASTNode* create_break_node(int line, int column)
+ASTNode* create_break_node(ASTArena* arena, int line, int column)
 {
-    ASTNode* node = create_node(NODE_BREAK, line, column);
+    ASTNode* node = create_node(arena, NODE_BREAK, line, column);
     node->line = line;
     node->column = column;
     
     return node;
 }
 
-ASTNode* create_continue_node(int line, int column)
+ASTNode* create_continue_node(ASTArena* arena, int line, int column)
 {
-    ASTNode* node = create_node(NODE_CONTINUE, line, column);
+    ASTNode* node = create_node(arena, NODE_CONTINUE, line, column);
     node->line = line;
     node->column = column;
     
@@ -357,106 +557,42 @@ ASTNode* create_continue_node(int line, int column)
 }
 
 
-//===================================================================
-// MEMORY DEALLOCATION
-//===================================================================
-void free_ast(ASTNode* node)
+ASTNode* create_call_node(ASTArena* arena, const char* name, int builtin,
+                          ASTNode** args, int argc, int line, int column)
 {
-    if (!node) return;
-    
-    switch (node->type) {
-        case NODE_BINARY_OP:
-            free_ast(node->data.binaryop.left);
-            free_ast(node->data.binaryop.right);
-            break;
-            
-        case NODE_UNARY_OP:
-            free_ast(node->data.unaryop.operand);
-            break;
-            
-        case NODE_ASSIGNMENT:
-            free_ast(node->data.assignment.value);
-            break;
-            
-        case NODE_STATEMENT_LIST:
-        {
-            // Libera cada statement individual
-            for (int i = 0; i < node->data.statementlist.count; i++) {
-                free_ast(node->data.statementlist.statements[i]);
-            }
-            
-            // Libera o array de ponteiros
-            if (node->data.statementlist.statements != NULL) {
-                a89free(node->data.statementlist.statements);
-            }
-            
-            break;
-        }
-
-        case NODE_COMPARISON_OP:
-            free_ast(node->data.logicalop.left);
-            free_ast(node->data.logicalop.right);
-            break;
-
-        case NODE_LOGICAL_OP:
-            free_ast(node->data.logicalop.left);
-            free_ast(node->data.logicalop.right);
-            break;
-
-        case NODE_NOT_LOGICAL_OP:
-            free_ast(node->data.notop.operand);
-            break;            
-
-        case NODE_PRINT:
-        {
-            // Libera cada item (expressão) individualmente
-            for (int i = 0; i < node->data.printstatement.count; i++)
-            {
-                free_ast(node->data.printstatement.items[i]);
-            }
-            
-            // Libera o array de ponteiros
-            if (node->data.printstatement.items != NULL)
-            {
-                a89free(node->data.printstatement.items);
-            }
-            break;
-        }
+    ASTNode* node = create_node(arena, NODE_CALL, line, column);
+    node->data.call.name = ast_arena_name(arena, name);
+    node->data.call.builtin = (unsigned char)builtin;
+    node->data.call.argc = (unsigned char)argc;
+
+    // Altura: um acima do argumento mais alto
+    ASTNode* highest = args[0];
+    for (int i = 0; i < argc; i++)
+    {
+        node->data.call.args[i] = args[i];
+        if (args[i]->height > highest->height) highest = args[i];
+    }
+    node->height = parent_height(highest, NULL);
+    return node;
+}
 
-        case NODE_IF:
-            free_ast(node->data.ifstatement.condition);
-            free_ast(node->data.ifstatement.then_body);
-            if (node->data.ifstatement.else_body) {
-                free_ast(node->data.ifstatement.else_body);
-            }
-            break;
+ASTNode* create_array_node(ASTArena* arena, NodeType kind, const char* var_name,
+                           ASTNode* index, ASTNode* value, int line, int column)
+{
+    ASTNode* node = create_node(arena, kind, line, column);
+    node->data.array.var_name = ast_arena_name(arena, var_name);
+    node->data.array.slot = -1;
+    node->data.array.index = index;
+    node->data.array.value = value;
+    node->data.array.checked = 1;
+    node->height = parent_height(index, value);
+    return node;
+}
 
-        case NODE_WHILE:
-            if (node->data.whilestatement.condition)
-            {
-                free_ast(node->data.whilestatement.condition);
-            } 
-            if (node->data.whilestatement.body)
-            {
-                free_ast(node->data.whilestatement.body);
-            } 
-            break;
 
-        case NODE_BOOL:
-        case NODE_NUMBER:
-        case NODE_STRING:
-        case NODE_VARIABLE:
-        case NODE_INPUT:
-        case NODE_COLOR:
-        case NODE_BREAK:
-        case NODE_CONTINUE:
-        case NODE_NULL:
-            // No children to free
-            break;
-
-    }
-    
-    a89free(node); 
+const char* logical_operator_name(LogicalOperator op)
+{
+    return logic_operators[op].logic_operator_name;
 }
 
 void print_ast(ASTNode* node, int indent)
@@ -474,8 +610,12 @@ void print_ast(ASTNode* node, int indent)
             break;
 
         case NODE_NUMBER:
-            printf("NUMBER: %g\n", node->data.number.value);
+        {
+            char number[NUMBER_FORMAT_SIZE];
+            value_format_number(node->data.number.value, number);
+            printf("NUMBER: %s\n", number);
             break;
+        }
             
         case NODE_BINARY_OP:
             printf("BINARY_OP: '%c'\n", node->data.binaryop.operator);
@@ -506,7 +646,7 @@ void print_ast(ASTNode* node, int indent)
             break;
             
         case NODE_STRING:
-            printf("STRING: \"%s\"\n", node->data.string.value);
+            printf("STRING: \"%s\"\n", node->data.string.value->chars);
             break;
             
         case NODE_NULL:
@@ -532,8 +672,7 @@ void print_ast(ASTNode* node, int indent)
             break;
 
         case NODE_COLOR:
-            printf("COLOR: token_id=%d\n", 
-                   node->data.color.color_token_id);
+            printf("COLOR: code=%d\n", node->data.color.code);
             break;
 
         case NODE_ALIGNMENT:
@@ -601,6 +740,27 @@ void print_ast(ASTNode* node, int indent)
             printf("NODE CONTINUE\n");
             break;
 
+        case NODE_CALL:
+            printf("CALL: %s (%d args)\n", node->data.call.name, node->data.call.argc);
+            for (int i = 0; i < node->data.call.argc; i++)
+            {
+                print_ast(node->data.call.args[i], indent + 1);
+            }
+            break;
+
+        case NODE_DIM:
+            printf("DIM: %s\n", node->data.array.var_name);
+            print_ast(node->data.array.index, indent + 1);
+            break;
+
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGNMENT:
+            printf("%s: %s%s\n", node->type == NODE_INDEX ? "INDEX" : "INDEX_ASSIGNMENT",
+                   node->data.array.var_name, node->data.array.checked ? "" : " [unchecked]");
+            print_ast(node->data.array.index, indent + 1);
+            print_ast(node->data.array.value, indent + 1);
+            break;
+
     }
 }
 
@@ -614,186 +774,177 @@ int main(void)
     setup_utf8();
     printf("ZzBasic AST Test v0.5.3 - loop while, break, continue\n\n");
     
+    ASTArena* arena = ast_arena_create();
+    
     // ========================================================
     // TESTE 1: WHILE simples com condição
     // ========================================================
     printf("=== TESTE 1: WHILE simples ===\n");
-    ASTNode* condition1 = create_number_node(10, 1, 1);
-    ASTNode* body1 = create_statement_list_node(1, 1);
-    ASTNode* while_node1 = create_while_node(condition1, body1, 1, 1);
+    ASTNode* condition1 = create_number_node(arena, 10, 1, 1);
+    ASTNode* body1 = create_statement_list_node(arena, 1, 1);
+    ASTNode* while_node1 = create_while_node(arena, condition1, body1, 1, 1);
     printf("while_node1:\n");
     print_ast(while_node1, 0);
     printf("\n");
-    free_ast(while_node1);
     wait();
     
     // ========================================================
     // TESTE 2: WHILE com condição de comparação
     // ========================================================
     printf("=== TESTE 2: WHILE com comparação (x < 10) ===\n");
-    ASTNode* var_x = create_identifier_node("x", 1, 1);
-    ASTNode* num_10 = create_number_node(10, 1, 5);
-    ASTNode* condition2 = create_comparison_op_node(OP_LESS, var_x, num_10, 1, 3);
-    ASTNode* body2 = create_statement_list_node(2, 1);
-    ASTNode* while_node2 = create_while_node(condition2, body2, 1, 1);
+    ASTNode* var_x = create_identifier_node(arena, "x", 1, 1);
+    ASTNode* num_10 = create_number_node(arena, 10, 1, 5);
+    ASTNode* condition2 = create_comparison_op_node(arena, OP_LESS, var_x, num_10, 1, 3);
+    ASTNode* body2 = create_statement_list_node(arena, 2, 1);
+    ASTNode* while_node2 = create_while_node(arena, condition2, body2, 1, 1);
     printf("while_node2:\n");
     print_ast(while_node2, 0);
     printf("\n");
-    free_ast(while_node2);
     wait();
     
     // ========================================================
     // TESTE 3: WHILE com condição booleana
     // ========================================================
     printf("=== TESTE 3: WHILE com booleano (true) ===\n");
-    ASTNode* condition3 = create_boolean_node(true, 1, 1);
-    ASTNode* body3 = create_statement_list_node(3, 1);
-    ASTNode* while_node3 = create_while_node(condition3, body3, 1, 1);
+    ASTNode* condition3 = create_boolean_node(arena, true, 1, 1);
+    ASTNode* body3 = create_statement_list_node(arena, 3, 1);
+    ASTNode* while_node3 = create_while_node(arena, condition3, body3, 1, 1);
     printf("while_node3:\n");
     print_ast(while_node3, 0);
     printf("\n");
-    free_ast(while_node3);
     wait();
     
     // ========================================================
     // TESTE 4: BREAK simples
     // ========================================================
     printf("=== TESTE 4: BREAK simples ===\n");
-    ASTNode* break_node1 = create_break_node(5, 1);
+    ASTNode* break_node1 = create_break_node(arena, 5, 1);
     printf("break_node1:\n");
     print_ast(break_node1, 0);
     printf("\n");
-    free_ast(break_node1);
     wait();
     
     // ========================================================
     // TESTE 5: CONTINUE simples
     // ========================================================
     printf("=== TESTE 5: CONTINUE simples ===\n");
-    ASTNode* continue_node1 = create_continue_node(6, 1);
+    ASTNode* continue_node1 = create_continue_node(arena, 6, 1);
     printf("continue_node1:\n");
     print_ast(continue_node1, 0);
     printf("\n");
-    free_ast(continue_node1);
     wait();
     
     // ========================================================
     // TESTE 6: WHILE com múltiplos statements no body
     // ========================================================
     printf("=== TESTE 6: WHILE com múltiplos statements ===\n");
-    ASTNode* var_i = create_identifier_node("i", 1, 1);
-    ASTNode* num_5 = create_number_node(5, 1, 5);
-    ASTNode* condition6 = create_comparison_op_node(OP_LESS, var_i, num_5, 1, 3);
+    ASTNode* var_i = create_identifier_node(arena, "i", 1, 1);
+    ASTNode* num_5 = create_number_node(arena, 5, 1, 5);
+    ASTNode* condition6 = create_comparison_op_node(arena, OP_LESS, var_i, num_5, 1, 3);
     
-    ASTNode* body6 = create_statement_list_node(7, 1);
-    ASTNode* while_node6 = create_while_node(condition6, body6, 1, 1);
+    ASTNode* body6 = create_statement_list_node(arena, 7, 1);
+    ASTNode* while_node6 = create_while_node(arena, condition6, body6, 1, 1);
     printf("while_node6:\n");
     print_ast(while_node6, 0);
     printf("\n");
-    free_ast(while_node6);
     wait();
     
     // ========================================================
     // TESTE 7: WHILE com condição lógica (AND)
     // ========================================================
     printf("=== TESTE 7: WHILE com AND (x < 10 AND y > 0) ===\n");
-    ASTNode* var_x7 = create_identifier_node("x", 1, 1);
-    ASTNode* num_10_7 = create_number_node(10, 1, 5);
-    ASTNode* comp_x = create_comparison_op_node(OP_LESS, var_x7, num_10_7, 1, 3);
+    ASTNode* var_x7 = create_identifier_node(arena, "x", 1, 1);
+    ASTNode* num_10_7 = create_number_node(arena, 10, 1, 5);
+    ASTNode* comp_x = create_comparison_op_node(arena, OP_LESS, var_x7, num_10_7, 1, 3);
     
-    ASTNode* var_y7 = create_identifier_node("y", 1, 10);
-    ASTNode* num_0_7 = create_number_node(0, 1, 15);
-    ASTNode* comp_y = create_comparison_op_node(OP_GREATER, var_y7, num_0_7, 1, 12);
+    ASTNode* var_y7 = create_identifier_node(arena, "y", 1, 10);
+    ASTNode* num_0_7 = create_number_node(arena, 0, 1, 15);
+    ASTNode* comp_y = create_comparison_op_node(arena, OP_GREATER, var_y7, num_0_7, 1, 12);
     
-    ASTNode* condition7 = create_logical_op_node(OP_AND, comp_x, comp_y, 1, 5);
-    ASTNode* body7 = create_statement_list_node(8, 1);
-    ASTNode* while_node7 = create_while_node(condition7, body7, 1, 1);
+    ASTNode* condition7 = create_logical_op_node(arena, OP_AND, comp_x, comp_y, 1, 5);
+    ASTNode* body7 = create_statement_list_node(arena, 8, 1);
+    ASTNode* while_node7 = create_while_node(arena, condition7, body7, 1, 1);
     printf("while_node7:\n");
     print_ast(while_node7, 0);
     printf("\n");
-    free_ast(while_node7);
     wait();
     
     // ========================================================
     // TESTE 8: WHILE com condição lógica (OR)
     // ========================================================
     printf("=== TESTE 8: WHILE com OR (x == 0 OR y == 0) ===\n");
-    ASTNode* var_x8 = create_identifier_node("x", 1, 1);
-    ASTNode* num_0_8a = create_number_node(0, 1, 5);
-    ASTNode* comp_x8 = create_comparison_op_node(OP_EQUAL, var_x8, num_0_8a, 1, 3);
+    ASTNode* var_x8 = create_identifier_node(arena, "x", 1, 1);
+    ASTNode* num_0_8a = create_number_node(arena, 0, 1, 5);
+    ASTNode* comp_x8 = create_comparison_op_node(arena, OP_EQUAL, var_x8, num_0_8a, 1, 3);
     
-    ASTNode* var_y8 = create_identifier_node("y", 1, 10);
-    ASTNode* num_0_8b = create_number_node(0, 1, 15);
-    ASTNode* comp_y8 = create_comparison_op_node(OP_EQUAL, var_y8, num_0_8b, 1, 12);
+    ASTNode* var_y8 = create_identifier_node(arena, "y", 1, 10);
+    ASTNode* num_0_8b = create_number_node(arena, 0, 1, 15);
+    ASTNode* comp_y8 = create_comparison_op_node(arena, OP_EQUAL, var_y8, num_0_8b, 1, 12);
     
-    ASTNode* condition8 = create_logical_op_node(OP_OR, comp_x8, comp_y8, 1, 5);
-    ASTNode* body8 = create_statement_list_node(9, 1);
-    ASTNode* while_node8 = create_while_node(condition8, body8, 1, 1);
+    ASTNode* condition8 = create_logical_op_node(arena, OP_OR, comp_x8, comp_y8, 1, 5);
+    ASTNode* body8 = create_statement_list_node(arena, 9, 1);
+    ASTNode* while_node8 = create_while_node(arena, condition8, body8, 1, 1);
     printf("while_node8:\n");
     print_ast(while_node8, 0);
     printf("\n");
-    free_ast(while_node8);
     wait();
     
     // ========================================================
     // TESTE 9: WHILE com condição NOT
     // ========================================================
     printf("=== TESTE 9: WHILE com NOT (!done) ===\n");
-    ASTNode* var_done = create_identifier_node("done", 1, 1);
-    ASTNode* condition9 = create_logical_not_node(var_done, 1, 2);
-    ASTNode* body9 = create_statement_list_node(10, 1);
-    ASTNode* while_node9 = create_while_node(condition9, body9, 1, 1);
+    ASTNode* var_done = create_identifier_node(arena, "done", 1, 1);
+    ASTNode* condition9 = create_logical_not_node(arena, var_done, 1, 2);
+    ASTNode* body9 = create_statement_list_node(arena, 10, 1);
+    ASTNode* while_node9 = create_while_node(arena, condition9, body9, 1, 1);
     printf("while_node9:\n");
     print_ast(while_node9, 0);
     printf("\n");
-    free_ast(while_node9);
     wait();
     
     // ========================================================
     // TESTE 10: BREAK em diferentes linhas
     // ========================================================
     printf("=== TESTE 10: BREAK em linha 15 ===\n");
-    ASTNode* break_node10 = create_break_node(15, 5);
+    ASTNode* break_node10 = create_break_node(arena, 15, 5);
     printf("break_node10:\n");
     print_ast(break_node10, 0);
     printf("\n");
-    free_ast(break_node10);
     wait();
     
     // ========================================================
     // TESTE 11: CONTINUE em diferentes linhas
     // ========================================================
     printf("=== TESTE 11: CONTINUE em linha 20 ===\n");
-    ASTNode* continue_node11 = create_continue_node(20, 8);
+    ASTNode* continue_node11 = create_continue_node(arena, 20, 8);
     printf("continue_node11:\n");
     print_ast(continue_node11, 0);
     printf("\n");
-    free_ast(continue_node11);
     wait();
     
     // ========================================================
     // TESTE 12: WHILE aninhado
     // ========================================================
     printf("=== TESTE 12: WHILE aninhado ===\n");
-    ASTNode* var_x12 = create_identifier_node("x", 1, 1);
-    ASTNode* num_5_12 = create_number_node(5, 1, 5);
-    ASTNode* condition_outer = create_comparison_op_node(OP_LESS, var_x12, num_5_12, 1, 3);
+    ASTNode* var_x12 = create_identifier_node(arena, "x", 1, 1);
+    ASTNode* num_5_12 = create_number_node(arena, 5, 1, 5);
+    ASTNode* condition_outer = create_comparison_op_node(arena, OP_LESS, var_x12, num_5_12, 1, 3);
     
-    ASTNode* var_y12 = create_identifier_node("y", 2, 1);
-    ASTNode* num_3_12 = create_number_node(3, 2, 5);
-    ASTNode* condition_inner = create_comparison_op_node(OP_LESS, var_y12, num_3_12, 2, 3);
+    ASTNode* var_y12 = create_identifier_node(arena, "y", 2, 1);
+    ASTNode* num_3_12 = create_number_node(arena, 3, 2, 5);
+    ASTNode* condition_inner = create_comparison_op_node(arena, OP_LESS, var_y12, num_3_12, 2, 3);
     
-    ASTNode* body_inner = create_statement_list_node(12, 1);
-    ASTNode* while_inner = create_while_node(condition_inner, body_inner, 2, 1);
+    ASTNode* body_inner = create_statement_list_node(arena, 12, 1);
+    ASTNode* while_inner = create_while_node(arena, condition_inner, body_inner, 2, 1);
     
-    ASTNode* body_outer = create_statement_list_node(11, 1);
-    ASTNode* while_outer = create_while_node(condition_outer, body_outer, 1, 1);
+    ASTNode* body_outer = create_statement_list_node(arena, 11, 1);
+    ASTNode* while_outer = create_while_node(arena, condition_outer, body_outer, 1, 1);
     printf("while_outer (aninhado):\n");
     print_ast(while_outer, 0);
     printf("\n");
-    free_ast(while_outer);
     wait();
     
+    ast_arena_destroy(arena);
     printf("Memória liberada. Teste concluído.\n");
     a89check_leaks();
 }
@@ -3,11 +3,33 @@
 #ifndef AST_H
 #define AST_H
 
+#include <stddef.h>
+
 #include "zzdefs.h"
 #include "color_mapping.h"
+#include "symbol_table.h"
 
 typedef struct ASTNode ASTNode;
 
+//===================================================================
+// ARENA - dona de todos os nós, arrays e strings de um programa
+//===================================================================
+typedef struct ASTArenaChunk ASTArenaChunk;
+typedef struct ASTArenaValue ASTArenaValue;
+
+typedef struct
+{
+    ASTArenaChunk* chunks;   // Bloco atual (topo da lista)
+    int chunk_count;
+    size_t total_bytes;
+    
+    String** strings;        // Literais e nomes internados (hash aberto)
+    int string_capacity;     // Potência de 2 (0 = tabela ainda não criada)
+    int string_count;
+    
+    ASTArenaValue* values;   // Inteiros em caixa dos literais (lista)
+} ASTArena;
+
 //===================================================================
 // ENUMS
 //===================================================================
@@ -33,7 +55,11 @@ typedef enum
     NODE_IF,
     NODE_WHILE,
     NODE_BREAK,
-    NODE_CONTINUE
+    NODE_CONTINUE,
+    NODE_CALL,              // Função de string: len(s), mid(s, i, n)... (builtins.h)
+    NODE_DIM,               // dim a(n)
+    NODE_INDEX,             // a(i) numa expressão
+    NODE_INDEX_ASSIGNMENT   // let a(i) = valor
 } NodeType;
 
 typedef enum
@@ -42,12 +68,34 @@ typedef enum
     TYPE_NUMBER,
     TYPE_STRING,
     TYPE_BOOL,
+    TYPE_ARRAY,             // Só variáveis (dim); a(i) é TYPE_NUMBER
     // Tipos futuros...
-    // TYPE_ARRAY,
     // TYPE_FUNCTION,
 } VariableType;
 
 
+// Especialização feita pelo evaluator na primeira execução do nó
+// (quickening): o tipo observado vira uma guarda barata
+typedef enum
+{
+    QUICK_NONE,         // Ainda não executado (ou desespecializado)
+    QUICK_NUMBER,       // Variável número; operandos número-número
+    QUICK_BOOL,         // Variável booleana; comparação entre booleanos
+    QUICK_STRING,       // Variável string
+    QUICK_GENERIC       // Guarda falhou QUICK_MAX_DEOPTS vezes: fica genérico
+} QuickKind;
+
+#define QUICK_MAX_DEOPTS 4
+
+// Altura de uma expressão (folha = 0), calculada na criação dos nós e
+// saturada em AST_HEIGHT_MAX. O evaluator recursa só em subárvores
+// até AST_SHALLOW_HEIGHT; acima disso usa uma pilha de trabalho
+#define AST_SHALLOW_HEIGHT 64
+#define AST_HEIGHT_MAX     255
+
+// Máximo de argumentos de uma função (builtins.h)
+#define CALL_MAX_ARGS 3
+
 typedef enum
 {
     OP_NONE,
@@ -75,17 +123,19 @@ typedef struct{
 
 typedef struct
 {
-    double value;
+    Value value;     // Inteiro ou double (value.h)
 } NumberData;
 
 typedef struct
 {
-    char value[STRING_SIZE];
+    String* value;   // Internada na arena: literais iguais, mesmo ponteiro
 } StringData;
 
 typedef struct
 {
-    char var_name[VARNAME_SIZE];
+    const char* var_name;        // Internado (ast_arena_name)
+    int slot;                    // Índice na SymbolTable (resolver.c), -1 = não resolvido
+    SymbolValue* cache;          // Endereço do slot guardado pelo quickening
 } VariableData;
 
 typedef struct
@@ -116,7 +166,8 @@ typedef struct
 
 typedef struct
 {
-    char var_name[VARNAME_SIZE];
+    const char* var_name;  // Internado (ast_arena_name)
+    int slot;        // Índice na SymbolTable (resolver.c), -1 = não resolvido
     ASTNode* value;  // ASTNode que contém a expressão a ser atribuída
 } AssignmentData;
 
@@ -137,8 +188,7 @@ typedef struct
 
 typedef struct
 {
-    int color_token_id;
-    char ansi_color[15];  // Ex: "\033[31m" para vermelho
+    unsigned char code;         // ColorCode (sequência ANSI via color_code_to_ansi)
 } ColorNodeData;
 
 typedef struct {
@@ -151,8 +201,9 @@ typedef struct
 } WidthNodeData;
 
 typedef struct {
-    char prompt[STRING_SIZE];// Prompt opcional (ex: "Digite: ")
-    char var_name[VARNAME_SIZE];// Nome da variável 
+    const char* prompt;         // Prompt opcional (ex: "Digite: "), internado
+    const char* var_name;       // Nome da variável, internado
+    int slot;                   // Índice na SymbolTable (resolver.c)
 } InputStatementNode;
 
 typedef struct {
@@ -174,9 +225,29 @@ typedef struct {
     int dummy;  // continue não precisa de dados
 } ContinueStatementData;
 
+typedef struct {
+    const char* name;               // Internado (ast_arena_name)
+    unsigned char builtin;          // BuiltinId (builtins.h)
+    unsigned char argc;
+    ASTNode* args[CALL_MAX_ARGS];
+} CallData;
+
+// dim a(n), a(i) e let a(i) = valor
+typedef struct {
+    const char* var_name;           // Internado (ast_arena_name)
+    int slot;                       // Índice na SymbolTable (resolver.c), -1 = não resolvido
+    ASTNode* index;                 // Índice; em NODE_DIM, o tamanho
+    ASTNode* value;                 // NODE_INDEX_ASSIGNMENT; NULL nos demais
+    int checked;                    // 0 = optimizer provou 1 <= índice <= tamanho
+} ArrayData;
+
 typedef struct ASTNode
 {
     NodeType type;
+    VariableType value_type;    // Tipo provado por infer_program (TYPE_NULL = não provado)
+    unsigned char quick;        // QuickKind observado em execução (evaluator.c)
+    unsigned char deopts;       // Quantas vezes a guarda do quick falhou
+    unsigned char height;       // Altura da subárvore (AST_HEIGHT_MAX = ou mais)
     int line;
     int column;
     
@@ -201,6 +272,8 @@ typedef struct ASTNode
         WhileStatementData      whilestatement;
         BreakStatementData      breakstatement;
         ContinueStatementData   continuestatement;
+        CallData                call;
+        ArrayData               array;
 
     } data;
 
@@ -210,50 +283,88 @@ typedef struct ASTNode
 //===================================================================
 // FUNCTIONS
 //===================================================================
-ASTNode* create_bool_node(int value, int line, int column);
-ASTNode* create_number_node(double value, int line, int column);
-ASTNode* create_string_node(const char* value, int line, int column);
+// Arena: cada parse (arquivo, linha do REPL, --ast) usa a sua e libera
+// a árvore inteira de uma vez com ast_arena_destroy()
+ASTArena* ast_arena_create(void);
+void ast_arena_destroy(ASTArena* arena);
+void* ast_arena_alloc(ASTArena* arena, size_t size);
+char* ast_arena_strdup(ASTArena* arena, const char* text);
+char* ast_arena_strndup(ASTArena* arena, const char* text, size_t length);
+// String internada: o mesmo texto devolve sempre a mesma String, retida
+// pela arena até ast_arena_destroy()
+String* ast_arena_string(ASTArena* arena, const char* chars, size_t length);
+// Nome internado (identificadores): texto da String de ast_arena_string
+const char* ast_arena_name(ASTArena* arena, const char* name);
+
+ASTNode* create_bool_node(ASTArena* arena, int value, int line, int column);
+// CRIA LITERAL NUMBER. VALOR INTEIRO (DENTRO DA FAIXA) VIRA INTEIRO
+ASTNode* create_number_node(ASTArena* arena, double value, int line, int column);
+// CRIA LITERAL INTEIRO EXATO (FORA DA FAIXA INLINE, EM CAIXA RETIDA PELA ARENA)
+ASTNode* create_integer_node(ASTArena* arena, int64_t value, int line, int column);
+// CRIA LITERAL STRING COM OS 'LENGTH' BYTES DE VALUE (SEM LIMITE DE TAMANHO)
+ASTNode* create_string_node(ASTArena* arena, const char* value, size_t length,
+                            int line, int column);
 // CRIA NÓ DE VARIÁVEL. VAR_NAME JÁ DEVE SER VÁLIDO (VALIDADO PELO PARSER)
-ASTNode* create_variable_node(const char* var_name, int line, int column);
+ASTNode* create_variable_node(ASTArena* arena, const char* var_name, int line, int column);
 // CRIA OPERAÇÃO BINÁRIA. LEFT E RIGHT NÃO PODEM SER NULL
-ASTNode* create_binary_op_node(char operator, ASTNode* left, ASTNode* right, 
+ASTNode* create_binary_op_node(ASTArena* arena, char operator, ASTNode* left, ASTNode* right, 
                                int line, int column);
 // CRIA OPERAÇÃO UNÁRIA. OPERAND NÃO PODE SER NULL
-ASTNode* create_unary_op_node(char operator, ASTNode* operand, 
+ASTNode* create_unary_op_node(ASTArena* arena, char operator, ASTNode* operand, 
                               int line, int column);
 // CRIA ATRIBUIÇÃO. VAR_NAME JÁ VALIDADO, VALUE NÃO PODE SER NULL
-ASTNode* create_assignment_node(const char* var_name, ASTNode* value, 
+ASTNode* create_assignment_node(ASTArena* arena, const char* var_name, ASTNode* value, 
                                 int line, int column);
-ASTNode* create_statement_list_node(int line, int column);
-void statement_list_add(ASTNode* list_node, ASTNode* stmt);
+ASTNode* create_statement_list_node(ASTArena* arena, int line, int column);
+void statement_list_add(ASTArena* arena, ASTNode* list_node, ASTNode* stmt);
 
-ASTNode* create_input_node(const char* prompt, char* var_name, int line, int column);
+ASTNode* create_input_node(ASTArena* arena, const char* prompt, size_t prompt_length,
+                           char* var_name, int line, int column);
 
 // Funções para criar nó print
-ASTNode* create_print_node(int line, int column);
-ASTNode* create_color_node(TokenType color_token, int line, int column);
-ASTNode* create_alignment_node(TokenType alignment_token, int line, int column);
-ASTNode* create_width_node(int width_value, int line, int column);
+ASTNode* create_print_node(ASTArena* arena, int line, int column);
+ASTNode* create_color_node(ASTArena* arena, TokenType color_token, int line, int column);
+ASTNode* create_alignment_node(ASTArena* arena, TokenType alignment_token, int line, int column);
+ASTNode* create_width_node(ASTArena* arena, int width_value, int line, int column);
 
 // Operações de comparação e lógicas
-ASTNode* create_comparison_op_node(LogicalOperator operator,
+ASTNode* create_comparison_op_node(ASTArena* arena, LogicalOperator operator,
                                    ASTNode* left, ASTNode* right, 
                                    int line, int column);
-ASTNode* create_logical_op_node(LogicalOperator operator,
+ASTNode* create_logical_op_node(ASTArena* arena, LogicalOperator operator,
                                 ASTNode* left, ASTNode* right, 
                                 int line, int column);
-ASTNode* create_logical_not_node(ASTNode* operand, int line, int column);
+ASTNode* create_logical_not_node(ASTArena* arena, ASTNode* operand, int line, int column);
 
 // if
-ASTNode* create_if_node(ASTNode* condition,
+ASTNode* create_if_node(ASTArena* arena, ASTNode* condition,
                         ASTNode* then_body, ASTNode* else_body,
                         int line, int column);
 
+// while, break, continue
+ASTNode* create_while_node(ASTArena* arena, ASTNode* condition, ASTNode* body, int line, int column);
+ASTNode* create_break_node(ASTArena* arena, int line, int column);
+ASTNode* create_continue_node(ASTArena* arena, int line, int column);
+
+// Chamada de função. ARGS (ARGC <= CALL_MAX_ARGS) JÁ CONFERIDOS PELO PARSER
+ASTNode* create_call_node(ASTArena* arena, const char* name, int builtin,
+                          ASTNode** args, int argc, int line, int column);
+
+
+// Arrays. KIND: NODE_DIM (INDEX = TAMANHO), NODE_INDEX OU
+// NODE_INDEX_ASSIGNMENT (VALUE NÃO NULL). NASCEM COM checked = 1
+ASTNode* create_array_node(ASTArena* arena, NodeType kind, const char* var_name,
+                           ASTNode* index, ASTNode* value, int line, int column);
+
+
+// let x = x + <expr> (mesma variável à esquerda do '+'): evaluator e
+// compilador acrescentam strings no próprio bloco da variável
+int ast_is_self_append(const ASTNode* assignment);
 
-void print_node_add_item(ASTNode* print_node, ASTNode* expr_node);
+void print_node_add_item(ASTArena* arena, ASTNode* print_node, ASTNode* expr_node);
 void print_set_newline(ASTNode* print_node, int has_newline);
-void free_ast(ASTNode* node);
 void print_ast(ASTNode* node, int indent);
+const char* logical_operator_name(LogicalOperator op);  // "AND", "==", ...
 
 #endif // AST_H
 // Fim de st.h
\ No newline at end of file
@@ -0,0 +1,328 @@
+// builtins.c
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "builtins.h"
+
+static const BuiltinInfo builtins[BUILTIN_COUNT] =
+{
+    [BUILTIN_LEN]   = { "len",   1, 1, { TYPE_STRING },                          TYPE_NUMBER },
+    [BUILTIN_MID]   = { "mid",   2, 3, { TYPE_STRING, TYPE_NUMBER, TYPE_NUMBER }, TYPE_STRING },
+    [BUILTIN_INSTR] = { "instr", 2, 3, { TYPE_STRING, TYPE_STRING, TYPE_NUMBER }, TYPE_NUMBER },
+    [BUILTIN_FIELD] = { "field", 3, 3, { TYPE_STRING, TYPE_STRING, TYPE_NUMBER }, TYPE_STRING },
+};
+
+int builtin_lookup(const char* name)
+{
+    for (int i = 0; i < BUILTIN_COUNT; i++)
+    {
+        if (strcmp(builtins[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+const BuiltinInfo* builtin_info(BuiltinId id)
+{
+    return &builtins[id];
+}
+
+// ============================================
+// HELPERS
+// ============================================
+static Value builtin_error(ExecutionContext* ctx, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vsnprintf(ctx->error.message, sizeof(ctx->error.message), format, args);
+    va_end(args);
+
+    ctx->error.has_error = 1;
+    ctx->error.line = 0;
+    ctx->error.column = 0;
+    return VALUE_ERROR;
+}
+
+static const char* builtin_type_name(VariableType type)
+{
+    return type == TYPE_STRING ? "string" : "number";
+}
+
+static int matches_type(Value value, VariableType type)
+{
+    return type == TYPE_STRING ? value_is_string(value) : value_is_number(value);
+}
+
+// Argumento número inteiro >= minimum. Grande demais vira SIZE_MAX
+// (os índices são limitados pelo tamanho da string logo depois)
+static int index_argument(Value value, size_t minimum, size_t* out)
+{
+    if (value_is_int(value))
+    {
+        int64_t integer = value_as_int(value);
+        if (integer < (int64_t)minimum) return 0;
+        *out = (size_t)integer;
+        return 1;
+    }
+
+    double number = value_as_number(value);
+    if (number != floor(number) || number < (double)minimum) return 0;
+    *out = number >= 9e18 ? SIZE_MAX : (size_t)number;
+    return 1;
+}
+
+// Resultado string: o contexto retém até o fim do statement
+static Value temp_string(ExecutionContext* ctx, String* string)
+{
+    if (string->refcount != STRING_IMMORTAL)
+    {
+        *WORK_STACK_PUSH(&ctx->temps, Value) = value_string(string);
+    }
+    return value_string(string);
+}
+
+// Primeira ocorrência de needle em text a partir de 'from'; SIZE_MAX = não há
+static size_t find_bytes(const String* text, const String* needle, size_t from)
+{
+    size_t length = needle->length;
+    if (from > text->length || length > text->length - from) return SIZE_MAX;
+    if (length == 0) return from;
+
+    const char* chars = text->chars;
+    const char* last = chars + text->length - length;  // Último início possível
+    const char* p = chars + from;
+    while (p <= last)
+    {
+        p = memchr(p, needle->chars[0], (size_t)(last - p) + 1);
+        if (!p) break;
+        if (memcmp(p, needle->chars, length) == 0) return (size_t)(p - chars);
+        p++;
+    }
+    return SIZE_MAX;
+}
+
+// ============================================
+// FUNÇÕES
+// ============================================
+static Value call_mid(ExecutionContext* ctx, const Value* args, int argc)
+{
+    String* string = value_as_string_object(args[0]);
+    size_t start;
+    size_t count = SIZE_MAX;
+
+    if (!index_argument(args[1], 1, &start))
+    {
+        return builtin_error(ctx, "Evaluator error: mid() start must be an integer >= 1");
+    }
+    if (argc > 2 && !index_argument(args[2], 0, &count))
+    {
+        return builtin_error(ctx, "Evaluator error: mid() length must be an integer >= 0");
+    }
+
+    size_t offset = start - 1;
+    if (offset >= string->length) return value_string(string_empty());
+
+    size_t available = string->length - offset;
+    if (count > available) count = available;
+    return temp_string(ctx, string_view(string, offset, count));
+}
+
+static Value call_instr(ExecutionContext* ctx, const Value* args, int argc)
+{
+    size_t start = 1;
+    if (argc > 2 && !index_argument(args[2], 1, &start))
+    {
+        return builtin_error(ctx, "Evaluator error: instr() start must be an integer >= 1");
+    }
+
+    size_t position = find_bytes(value_as_string_object(args[0]),
+                                 value_as_string_object(args[1]), start - 1);
+    return value_integer(position == SIZE_MAX ? 0 : (int64_t)position + 1);
+}
+
+static Value call_field(ExecutionContext* ctx, const Value* args)
+{
+    String* string = value_as_string_object(args[0]);
+    String* separator = value_as_string_object(args[1]);
+    size_t index;
+
+    if (separator->length == 0)
+    {
+        return builtin_error(ctx, "Evaluator error: field() separator cannot be empty");
+    }
+    if (!index_argument(args[2], 1, &index))
+    {
+        return builtin_error(ctx, "Evaluator error: field() index must be an integer >= 1");
+    }
+
+    // Pula index - 1 separadores
+    size_t start = 0;
+    for (size_t i = 1; i < index; i++)
+    {
+        size_t found = find_bytes(string, separator, start);
+        if (found == SIZE_MAX) return value_string(string_empty());
+        start = found + separator->length;
+    }
+
+    size_t end = find_bytes(string, separator, start);
+    if (end == SIZE_MAX) end = string->length;
+    return temp_string(ctx, string_view(string, start, end - start));
+}
+
+Value builtin_call(ExecutionContext* ctx, BuiltinId id, const Value* args, int argc)
+{
+    const BuiltinInfo* info = &builtins[id];
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (!matches_type(args[i], info->args[i]))
+        {
+            return builtin_error(ctx, BUILTIN_ARGUMENT_ERROR, info->name, i + 1,
+                                 builtin_type_name(info->args[i]),
+                                 value_type_name(args[i]));
+        }
+    }
+
+    switch (id)
+    {
+        case BUILTIN_LEN:
+            return value_integer((int64_t)value_string_length(args[0]));
+        case BUILTIN_MID:
+            return call_mid(ctx, args, argc);
+        case BUILTIN_INSTR:
+            return call_instr(ctx, args, argc);
+        case BUILTIN_FIELD:
+            return call_field(ctx, args);
+        default:
+            return builtin_error(ctx, "Evaluator error: unknown function");
+    }
+}
+
+
+// ============================================
+// TESTE
+// gcc -DTESTBUILTINS builtins.c evaluator.c lexer.c parser.c ast.c resolver.c symbol_table.c color_mapping.c output.c number_format.c a89alloc.c utils.c work_stack.c zzstring.c -lm -o test_builtins
+// ============================================
+#ifdef TESTBUILTINS
+#include "color.h"
+#include "utils.h"
+#include "a89alloc.h"
+
+static int falhas = 0;
+
+static void check(int ok, const char* name)
+{
+    printf("%s%-4s%s %s\n", ok ? COLOR_SUCCESS : COLOR_ERROR,
+           ok ? "OK" : "ERRO", COLOR_RESET, name);
+    if (!ok) falhas++;
+}
+
+static int string_is(Value value, const char* text)
+{
+    return value_is_string(value) && value_string_length(value) == strlen(text) &&
+           memcmp(value_string_chars(value), text, strlen(text)) == 0;
+}
+
+int main()
+{
+    setup_utf8();
+    printf("%s=== TESTE BUILTINS ===%s\n\n", COLOR_HEADER, COLOR_RESET);
+
+    ExecutionContext* ctx = execution_context_create();
+
+    // Linha com campos longos (maiores que STRING_VIEW_MIN)
+    char text[256];
+    snprintf(text, sizeof(text), "%s;%s;%s",
+             "primeiro campo, bem mais longo que o minimo",
+             "segundo campo, tambem longo o bastante aqui",
+             "x");
+    String* line = string_from_text(text);
+    String* semicolon = string_from_text(";");
+    Value args[3];
+
+    args[0] = value_string(line);
+    args[1] = value_string(semicolon);
+    args[2] = value_number(2);
+    Value second = builtin_call(ctx, BUILTIN_FIELD, args, 3);
+    check(string_is(second, "segundo campo, tambem longo o bastante aqui"), "field(s, \";\", 2)");
+    check(string_is_view(value_as_string_object(second)) &&
+          value_as_string_object(second)->parent == line && line->refcount == 2,
+          "field devolve view que retém a linha");
+
+    // View de view aponta para a raiz
+    args[0] = second;
+    args[1] = value_number(9);
+    Value tail = builtin_call(ctx, BUILTIN_MID, args, 2);
+    check(string_is(tail, "campo, tambem longo o bastante aqui") &&
+          value_as_string_object(tail)->parent == line && line->refcount == 3,
+          "mid de view: view da raiz");
+
+    // Trecho curto: cópia, não prende a linha
+    args[0] = value_string(line);
+    args[1] = value_number(1);
+    args[2] = value_number(8);
+    Value short_part = builtin_call(ctx, BUILTIN_MID, args, 3);
+    check(string_is(short_part, "primeiro") && !string_is_view(value_as_string_object(short_part)),
+          "mid curto é copiado");
+
+    // A string inteira: a própria, sem view
+    args[2] = value_number(1000);
+    Value whole = builtin_call(ctx, BUILTIN_MID, args, 3);
+    check(value_as_string_object(whole) == line, "mid da string inteira");
+
+    args[1] = value_string(string_from_text(";x"));
+    Value position = builtin_call(ctx, BUILTIN_INSTR, args, 2);
+    check(value_as_number(position) == strlen(text) - 1, "instr");
+    string_release(value_as_string_object(args[1]));
+
+    args[1] = value_string(semicolon);
+    args[2] = value_number(9);
+    check(string_is(builtin_call(ctx, BUILTIN_FIELD, args, 3), ""), "field inexistente");
+
+    args[0] = second;
+    check(value_as_number(builtin_call(ctx, BUILTIN_LEN, args, 1)) == 43, "len de view");
+
+    args[1] = value_number(0);
+    check(value_is_error(builtin_call(ctx, BUILTIN_MID, args, 2)) &&
+          strstr(ctx->error.message, "start") != NULL, "mid(s, 0): erro");
+    ctx->error.has_error = 0;
+
+    args[0] = value_number(1);
+    check(value_is_error(builtin_call(ctx, BUILTIN_LEN, args, 1)) &&
+          strcmp(ctx->error.message,
+                 "Evaluator error: len() argument 1 must be string, got number") == 0,
+          "len(1): erro de tipo");
+    ctx->error.has_error = 0;
+
+    // C precisa de '\0': a view vira string própria e solta a linha
+    String* view = value_as_string_object(second);
+    string_retain(view);
+    evaluator_release_temps(ctx);
+    check(line->refcount == 2, "fim do statement solta as temporárias");
+    const char* cstr = string_cstr(view);
+    check(!string_is_view(view) && strcmp(cstr, "segundo campo, tambem longo o bastante aqui") == 0 &&
+          line->refcount == 1, "string_cstr materializa a view");
+
+    // Acrescentar numa view copia antes
+    String* other = string_view(line, 0, 40);
+    other = string_append(other, "!", 1);
+    check(!string_is_view(other) && other->length == 41 && other->chars[40] == '!' &&
+          line->refcount == 1, "string_append em view");
+
+    string_release(other);
+    string_release(view);
+    string_release(semicolon);
+    string_release(line);
+    execution_context_destroy(ctx);
+
+    printf("\n%s%s%s\n", falhas ? COLOR_ERROR : COLOR_SUCCESS,
+           falhas ? "ERRO" : "OK", COLOR_RESET);
+
+    a89check_leaks();
+    return falhas != 0;
+}
+#endif
+// Fim de builtins.c
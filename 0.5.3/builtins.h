@@ -0,0 +1,64 @@
+// builtins.h
+
+#ifndef BUILTINS_H
+#define BUILTINS_H
+
+#include "evaluator.h"
+
+/********************************************************************
+FUNÇÕES DE STRING
+
+    len(s)              Tamanho em bytes
+    mid(s, i)           De i (1 = primeiro byte) até o fim
+    mid(s, i, n)        Até n bytes a partir de i
+    instr(s, t)         Posição da primeira ocorrência de t (0 = não há)
+    instr(s, t, i)      Idem, procurando a partir de i
+    field(s, sep, n)    n-ésimo campo de s separado por sep ("" = não há)
+
+left e right são palavras-chave do print: mid(s, 1, n) e
+mid(s, len(s) - n + 1) fazem o papel delas.
+
+mid e field devolvem views (zzstring.h): o trecho não é copiado e a
+string original fica viva enquanto ele estiver em uso. Um laço que
+corta a linha com instr e mid ("let linha = mid(linha, p + 1)") custa
+O(tamanho da linha), não O(campos x tamanho). Como na concatenação,
+o resultado é retido pelo ExecutionContext até o fim do statement.
+
+Os nomes só são funções quando seguidos de '(': uma variável chamada
+len continua valendo. Os argumentos são avaliados em CTX_ANY e
+conferidos aqui, então evaluator e VM dão as mesmas mensagens.
+********************************************************************/
+
+typedef enum
+{
+    BUILTIN_LEN,
+    BUILTIN_MID,
+    BUILTIN_INSTR,
+    BUILTIN_FIELD,
+    BUILTIN_COUNT
+} BuiltinId;
+
+typedef struct
+{
+    const char* name;
+    unsigned char min_args;
+    unsigned char max_args;
+    VariableType args[CALL_MAX_ARGS];   // Tipo exigido de cada argumento
+    VariableType result;
+} BuiltinInfo;
+
+// Mensagem de argumento com tipo errado (também usada pela inferência):
+// nome da função, número do argumento, tipo exigido, tipo recebido
+#define BUILTIN_ARGUMENT_ERROR "Evaluator error: %s() argument %d must be %s, got %s"
+
+// Função com esse nome; -1 = não é função
+int builtin_lookup(const char* name);
+const BuiltinInfo* builtin_info(BuiltinId id);
+
+// Executa com os 'argc' argumentos já avaliados (quantidade conferida
+// pelo parser). Erro: VALUE_ERROR com a mensagem em ctx->error; a
+// posição fica para quem chama
+Value builtin_call(ExecutionContext* ctx, BuiltinId id, const Value* args, int argc);
+
+#endif // BUILTINS_H
+// Fim de builtins.h
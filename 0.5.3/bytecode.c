@@ -0,0 +1,316 @@
+// bytecode.c
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bytecode.h"
+#include "a89alloc.h"
+#include "builtins.h"
+
+#define OPCODE_NAME(name, operand_bytes) #name,
+#define OPCODE_SIZE(name, operand_bytes) operand_bytes,
+
+static const char* OPCODE_NAMES[] = { OPCODE_LIST(OPCODE_NAME) };
+static const int OPCODE_OPERAND_BYTES[] = { OPCODE_LIST(OPCODE_SIZE) };
+
+//===================================================================
+// CRESCIMENTO DOS VETORES
+// a89alloc não tem realloc: aloca o novo bloco, copia e libera o antigo
+//===================================================================
+static void* grow_array(void* old, size_t old_bytes, size_t new_bytes)
+{
+    void* data = A89ALLOC(new_bytes);
+    if (old)
+    {
+        memcpy(data, old, old_bytes);
+        a89free(old);
+    }
+    return data;
+}
+
+#define ENSURE_CAPACITY(ptr, count, capacity, extra, initial)            \
+    do {                                                                 \
+        if ((count) + (extra) > (capacity)) {                            \
+            size_t new_cap = (capacity) ? (capacity) * 2 : (initial);    \
+            while (new_cap < (count) + (extra)) new_cap *= 2;            \
+            (ptr) = grow_array((ptr), (count) * sizeof(*(ptr)),          \
+                               new_cap * sizeof(*(ptr)));                \
+            (capacity) = new_cap;                                        \
+        }                                                                \
+    } while (0)
+
+
+void chunk_init(Chunk* chunk)
+{
+    memset(chunk, 0, sizeof(Chunk));
+}
+
+void chunk_free(Chunk* chunk)
+{
+    a89free(chunk->code);
+    for (size_t i = 0; i < chunk->number_count; i++)
+    {
+        value_release(chunk->numbers[i]);
+    }
+    a89free(chunk->numbers);
+    for (size_t i = 0; i < chunk->string_constant_count; i++)
+    {
+        string_release(chunk->string_constants[i]);
+    }
+    a89free(chunk->string_constants);
+    a89free(chunk->strings);
+    a89free(chunk->lines);
+    a89free(chunk->ranges);
+    chunk_init(chunk);
+}
+
+void chunk_write_byte(Chunk* chunk, uint8_t byte)
+{
+    ENSURE_CAPACITY(chunk->code, chunk->count, chunk->capacity, 1, 64);
+    chunk->code[chunk->count++] = byte;
+}
+
+void chunk_write_u32(Chunk* chunk, uint32_t value)
+{
+    ENSURE_CAPACITY(chunk->code, chunk->count, chunk->capacity, 4, 64);
+    chunk_patch_u32(chunk, chunk->count, value);
+    chunk->count += 4;
+}
+
+void chunk_patch_u32(Chunk* chunk, size_t offset, uint32_t value)
+{
+    chunk->code[offset]     = (uint8_t)(value & 0xFF);
+    chunk->code[offset + 1] = (uint8_t)((value >> 8) & 0xFF);
+    chunk->code[offset + 2] = (uint8_t)((value >> 16) & 0xFF);
+    chunk->code[offset + 3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+// Retém o inteiro em caixa, como as strings constantes
+uint32_t chunk_add_number(Chunk* chunk, Value value)
+{
+    ENSURE_CAPACITY(chunk->numbers, chunk->number_count,
+                    chunk->number_capacity, 1, 16);
+    value_retain(value);
+    chunk->numbers[chunk->number_count] = value;
+    return (uint32_t)chunk->number_count++;
+}
+
+// Retém a string (sem cópia) e devolve seu índice
+uint32_t chunk_add_string_constant(Chunk* chunk, String* string)
+{
+    ENSURE_CAPACITY(chunk->string_constants, chunk->string_constant_count,
+                    chunk->string_constant_capacity, 1, 16);
+    chunk->string_constants[chunk->string_constant_count] = string_retain(string);
+    return (uint32_t)chunk->string_constant_count++;
+}
+
+// Copia o texto para o pool e devolve seu offset
+uint32_t chunk_add_string(Chunk* chunk, const char* str)
+{
+    size_t len = strlen(str) + 1;
+    ENSURE_CAPACITY(chunk->strings, chunk->strings_size,
+                    chunk->strings_capacity, len, 256);
+    uint32_t offset = (uint32_t)chunk->strings_size;
+    memcpy(chunk->strings + offset, str, len);
+    chunk->strings_size += len;
+    return offset;
+}
+
+// Registra a posição da próxima instrução (só se mudou)
+void chunk_add_line(Chunk* chunk, int line, int column)
+{
+    if (chunk->line_count > 0)
+    {
+        LineInfo* last = &chunk->lines[chunk->line_count - 1];
+        if (last->line == line && last->column == column) return;
+        if (last->pc == chunk->count)
+        {
+            last->line = line;
+            last->column = column;
+            return;
+        }
+    }
+
+    ENSURE_CAPACITY(chunk->lines, chunk->line_count,
+                    chunk->line_capacity, 1, 32);
+    LineInfo* info = &chunk->lines[chunk->line_count++];
+    info->pc = (uint32_t)chunk->count;
+    info->line = line;
+    info->column = column;
+}
+
+void chunk_add_range(Chunk* chunk, uint32_t start, uint32_t end)
+{
+    ENSURE_CAPACITY(chunk->ranges, chunk->range_count,
+                    chunk->range_capacity, 1, 32);
+    chunk->ranges[chunk->range_count].start = start;
+    chunk->ranges[chunk->range_count].end = end;
+    chunk->range_count++;
+}
+
+// Busca binária: última entrada com pc <= alvo
+const LineInfo* chunk_find_line(const Chunk* chunk, uint32_t pc)
+{
+    if (chunk->line_count == 0) return NULL;
+
+    size_t low = 0;
+    size_t high = chunk->line_count;
+    while (high - low > 1)
+    {
+        size_t mid = (low + high) / 2;
+        if (chunk->lines[mid].pc <= pc) low = mid;
+        else high = mid;
+    }
+    return &chunk->lines[low];
+}
+
+// Região mais interna que contém pc (regiões são aninhadas ou disjuntas)
+const RecoveryRange* chunk_find_range(const Chunk* chunk, uint32_t pc)
+{
+    const RecoveryRange* best = NULL;
+    for (size_t i = 0; i < chunk->range_count; i++)
+    {
+        const RecoveryRange* r = &chunk->ranges[i];
+        if (pc >= r->start && pc < r->end)
+        {
+            if (!best || (r->end - r->start) < (best->end - best->start))
+            {
+                best = r;
+            }
+        }
+    }
+    return best;
+}
+
+// Só instruções que podem reportar erro ou aviso precisam de posição:
+// a tabela de linhas é consultada apenas por vm_print_message. As
+// demais herdam a entrada anterior, o que corta a maior parte da
+// tabela em código linear (um print gera várias dessas instruções).
+int opcode_reports_position(OpCode op)
+{
+    switch (op)
+    {
+        case BC_HALT:
+        case BC_NUMBER:
+        case BC_STRING:
+        case BC_TRUE:
+        case BC_FALSE:
+        case BC_POP:
+        case BC_ADD_NUM:
+        case BC_SUB_NUM:
+        case BC_MUL_NUM:
+        case BC_NEGATE_NUM:
+        case BC_EQUAL_NUM:
+        case BC_NOT_EQUAL_NUM:
+        case BC_LESS_NUM:
+        case BC_GREATER_NUM:
+        case BC_LESS_EQUAL_NUM:
+        case BC_GREATER_EQUAL_NUM:
+        case BC_JUMP:
+        case BC_PRINT_BEGIN:
+        case BC_PRINT_ITEM:
+        case BC_PRINT_COLOR:
+        case BC_PRINT_WIDTH:
+        case BC_PRINT_ALIGN:
+        case BC_PRINT_EMPTY:
+        case BC_NEWLINE:
+        case BC_NOCOLOR:
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+const char* opcode_name(OpCode op)
+{
+    if (op >= 0 && op < BC_COUNT) return OPCODE_NAMES[op];
+    return "BC_UNKNOWN";
+}
+
+//===================================================================
+// DISASSEMBLER (comando 'bytecode' do REPL)
+//===================================================================
+void chunk_disassemble(const Chunk* chunk, SymbolTable* symbols)
+{
+    size_t pc = 0;
+    while (pc < chunk->count)
+    {
+        OpCode op = (OpCode)chunk->code[pc];
+        const LineInfo* info = chunk_find_line(chunk, (uint32_t)pc);
+
+        char position[32] = "";
+        if (info && opcode_reports_position(op))
+        {
+            snprintf(position, sizeof(position), "[%d:%d]", info->line, info->column);
+        }
+        printf("%04zu %-10s ", pc, position);
+        printf("%-18s", opcode_name(op));
+
+        const uint8_t* operands = chunk->code + pc + 1;
+        switch (op)
+        {
+            case BC_NUMBER:
+            {
+                char number[NUMBER_FORMAT_SIZE];
+                value_format_number(chunk->numbers[bytecode_read_u32(operands)], number);
+                printf(" %s", number);
+                break;
+            }
+            case BC_STRING:
+                printf(" \"%s\"", chunk->string_constants[bytecode_read_u32(operands)]->chars);
+                break;
+            case BC_ERROR:
+            case BC_WARNING:
+                printf(" \"%s\"", chunk->strings + bytecode_read_u32(operands));
+                break;
+            case BC_GET_VAR:
+            case BC_GET_VAR_NUM:
+            case BC_SET_VAR:
+            case BC_APPEND_VAR:
+            case BC_DIM:
+            case BC_GET_INDEX:
+            case BC_GET_INDEX_FAST:
+            case BC_SET_INDEX:
+            case BC_SET_INDEX_FAST:
+            {
+                int slot = (int)bytecode_read_u32(operands);
+                printf(" #%d %s", slot, symbol_table_slot_name(symbols, slot));
+                break;
+            }
+            case BC_INPUT:
+            {
+                int slot = (int)bytecode_read_u32(operands);
+                printf(" #%d %s \"%s\"", slot, symbol_table_slot_name(symbols, slot),
+                       chunk->strings + bytecode_read_u32(operands + 4));
+                break;
+            }
+            case BC_AND:
+            case BC_OR:
+            case BC_JUMP:
+            case BC_JUMP_IF_FALSE:
+                printf(" -> %04u", bytecode_read_u32(operands));
+                break;
+            case BC_PRINT_WIDTH:
+                printf(" %u", bytecode_read_u32(operands));
+                break;
+            case BC_CALL:
+                printf(" %s %u", operands[0] < BUILTIN_COUNT
+                                 ? builtin_info((BuiltinId)operands[0])->name : "?",
+                       operands[1]);
+                break;
+            case BC_ECHO:
+            case BC_PRINT_ITEM:
+            case BC_PRINT_COLOR:
+            case BC_PRINT_ALIGN:
+                printf(" %u", operands[0]);
+                break;
+            default:
+                break;
+        }
+        printf("\n");
+
+        pc += 1 + (op < BC_COUNT ? OPCODE_OPERAND_BYTES[op] : 0);
+    }
+    printf("(%zu bytes, max stack %d)\n", chunk->count, chunk->max_stack);
+}
+// Fim de bytecode.c
@@ -0,0 +1,177 @@
+// bytecode.h
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "symbol_table.h"
+
+/********************************************************************
+BYTECODE DA VM
+
+O compilador (compiler.c) transforma a AST gerada por parse() em um
+vetor linear de bytes. Cada instrução é um opcode de 1 byte seguido
+de zero ou mais operandos de 1 ou 4 bytes:
+
+    u8  - índice de cor, alinhamento, flags
+    u32 - índices de constantes, offsets no pool de strings, destinos
+          de salto (posição absoluta no código)
+
+Informações que só importam quando algo dá errado (linha/coluna e
+pontos de recuperação) ficam em tabelas à parte, consultadas apenas
+no caminho de erro. O laço da VM não paga nada por elas.
+********************************************************************/
+
+// X-macro: nome do opcode e quantidade de bytes de operandos.
+// Mantém enum, nomes e tabela de despacho sempre sincronizados.
+#define OPCODE_LIST(X)                                                  \
+    X(BC_HALT,          0)  /* fim do programa                       */ \
+    X(BC_NUMBER,        4)  /* u32 índice em numbers[]                */ \
+    X(BC_STRING,        4)  /* u32 índice em string_constants[]       */ \
+    X(BC_TRUE,          0)                                              \
+    X(BC_FALSE,         0)                                              \
+    X(BC_POP,           0)                                              \
+    X(BC_GET_VAR,       4)  /* u32 slot; qualquer tipo                */ \
+    X(BC_GET_VAR_NUM,   4)  /* u32 slot; exige número (CTX_NUMBER)    */ \
+    X(BC_SET_VAR,       4)  /* u32 slot; desempilha e armazena        */ \
+    X(BC_APPEND_VAR,    4)  /* u32 slot; let s = s + x: BC_ADD e      */ \
+                            /* BC_SET_VAR, string cresce no lugar     */ \
+    X(BC_ADD,           0)  /* soma números ou concatena strings      */ \
+    X(BC_SUB,           0)                                              \
+    X(BC_MUL,           0)                                              \
+    X(BC_DIV,           0)                                              \
+    X(BC_QUOTIENT,      0)  /* a \ b: divisão inteira                 */ \
+    X(BC_REMAINDER,     0)  /* a % b                                  */ \
+    X(BC_NEGATE,        0)                                              \
+    X(BC_ADD_NUM,       0)  /* operandos provados número (inference)  */ \
+    X(BC_SUB_NUM,       0)                                              \
+    X(BC_MUL_NUM,       0)                                              \
+    X(BC_DIV_NUM,       0)  /* ainda verifica divisão por zero        */ \
+    X(BC_QUOTIENT_NUM,  0)                                              \
+    X(BC_REMAINDER_NUM, 0)                                              \
+    X(BC_NEGATE_NUM,    0)                                              \
+    X(BC_EQUAL,         0)                                              \
+    X(BC_NOT_EQUAL,     0)                                              \
+    X(BC_LESS,          0)                                              \
+    X(BC_GREATER,       0)                                              \
+    X(BC_LESS_EQUAL,    0)                                              \
+    X(BC_GREATER_EQUAL, 0)                                              \
+    X(BC_EQUAL_NUM,     0)  /* comparações entre números provados     */ \
+    X(BC_NOT_EQUAL_NUM, 0)                                              \
+    X(BC_LESS_NUM,      0)                                              \
+    X(BC_GREATER_NUM,   0)                                              \
+    X(BC_LESS_EQUAL_NUM, 0)                                             \
+    X(BC_GREATER_EQUAL_NUM, 0)                                          \
+    X(BC_NOT,           0)                                              \
+    X(BC_CALL,          2)  /* u8 BuiltinId, u8 argumentos            */ \
+    X(BC_DIM,           4)  /* u32 slot; desempilha o tamanho         */ \
+    X(BC_GET_INDEX,     4)  /* u32 slot; troca o índice pelo elemento */ \
+    X(BC_GET_INDEX_FAST, 4) /* índice provado nos limites (optimizer) */ \
+    X(BC_SET_INDEX,     4)  /* u32 slot; desempilha valor e índice    */ \
+    X(BC_SET_INDEX_FAST, 4)                                             \
+    X(BC_AND,           4)  /* u32 destino: curto-circuito se false   */ \
+    X(BC_OR,            4)  /* u32 destino: curto-circuito se true    */ \
+    X(BC_CHECK_BOOL,    0)  /* operando direito de and/or             */ \
+    X(BC_JUMP,          4)  /* u32 destino                            */ \
+    X(BC_JUMP_IF_FALSE, 4)  /* u32 destino; desempilha a condição     */ \
+    X(BC_ECHO,          1)  /* u8 1 = literal string ("= ...")        */ \
+    X(BC_PRINT_BEGIN,   0)  /* zera cor e formato do print            */ \
+    X(BC_PRINT_ITEM,    1)  /* u8 1 = imprime espaço depois           */ \
+    X(BC_PRINT_COLOR,   1)  /* u8 ColorCode                           */ \
+    X(BC_PRINT_WIDTH,   4)  /* u32 largura                            */ \
+    X(BC_PRINT_ALIGN,   1)  /* u8 TokenType (left/right/center)       */ \
+    X(BC_PRINT_EMPTY,   0)  /* print sem itens: linha em branco       */ \
+    X(BC_NEWLINE,       0)                                              \
+    X(BC_NOCOLOR,       0)  /* 'nocolor' como statement               */ \
+    X(BC_INPUT,         8)  /* u32 slot, u32 prompt                   */ \
+    X(BC_ERROR,         4)  /* u32 mensagem (erro de tipo estático)   */ \
+    X(BC_WARNING,       4)  /* u32 mensagem                           */
+
+#define OPCODE_ENUM(name, operand_bytes) name,
+
+typedef enum
+{
+    OPCODE_LIST(OPCODE_ENUM)
+    BC_COUNT
+} OpCode;
+
+// Linha/coluna da instrução que começa em 'pc' (vale até a próxima).
+// Só instruções com opcode_reports_position() ganham entrada.
+typedef struct
+{
+    uint32_t pc;
+    int line;
+    int column;
+} LineInfo;
+
+// Região de recuperação: um erro dentro de [start, end) descarta o
+// restante do statement e a execução continua em 'end'.
+typedef struct
+{
+    uint32_t start;
+    uint32_t end;
+} RecoveryRange;
+
+typedef struct
+{
+    uint8_t* code;
+    size_t count;
+    size_t capacity;
+
+    Value* numbers;             // Constantes numéricas (inteiro ou double)
+    size_t number_count;
+    size_t number_capacity;
+
+    String** string_constants;  // Literais string (referência retida)
+    size_t string_constant_count;
+    size_t string_constant_capacity;
+
+    char* strings;              // Pool de textos (prompts e mensagens)
+    size_t strings_size;
+    size_t strings_capacity;
+
+    LineInfo* lines;
+    size_t line_count;
+    size_t line_capacity;
+
+    RecoveryRange* ranges;
+    size_t range_count;
+    size_t range_capacity;
+
+    int max_stack;              // Profundidade máxima da pilha de valores
+} Chunk;
+
+void chunk_init(Chunk* chunk);
+void chunk_free(Chunk* chunk);
+
+void chunk_write_byte(Chunk* chunk, uint8_t byte);
+void chunk_write_u32(Chunk* chunk, uint32_t value);
+void chunk_patch_u32(Chunk* chunk, size_t offset, uint32_t value);
+
+uint32_t chunk_add_number(Chunk* chunk, Value value);
+uint32_t chunk_add_string_constant(Chunk* chunk, String* string);
+uint32_t chunk_add_string(Chunk* chunk, const char* str);
+
+void chunk_add_line(Chunk* chunk, int line, int column);
+void chunk_add_range(Chunk* chunk, uint32_t start, uint32_t end);
+
+// Consultas usadas apenas no caminho de erro
+const LineInfo* chunk_find_line(const Chunk* chunk, uint32_t pc);
+const RecoveryRange* chunk_find_range(const Chunk* chunk, uint32_t pc);
+
+static inline uint32_t bytecode_read_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] |
+           ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+const char* opcode_name(OpCode op);
+int opcode_reports_position(OpCode op);     // Precisa de entrada em lines[]
+void chunk_disassemble(const Chunk* chunk, SymbolTable* symbols);  // symbols: nomes dos slots (pode ser NULL)
+
+#endif // BYTECODE_H
+// Fim de bytecode.h
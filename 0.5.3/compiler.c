@@ -0,0 +1,681 @@
+// compiler.c
+/********************************************************************
+COMPILADOR AST -> BYTECODE
+
+Espelha a semântica de evaluator.c:
+
+* O EvalContext de cada expressão é conhecido em tempo de compilação
+  (depende só da posição na árvore). Por isso a verificação de tipo
+  que o evaluator faz a cada avaliação vira a escolha do opcode:
+  BC_GET_VAR_NUM para variáveis em contexto numérico, BC_ERROR para
+  uma string literal usada como número, etc.
+
+* Onde infer_program() provou os tipos (value_type dos nós), os
+  opcodes *_NUM e BC_GET_VAR dispensam até essa verificação.
+
+* Um erro em tempo de execução aborta apenas o statement mais interno
+  (como execute_statement_list, que continua no próximo). Cada
+  statement registra sua região de recuperação no chunk.
+********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "evaluator.h"
+#include "builtins.h"
+#include "output.h"
+#include "work_stack.h"
+
+// while sendo compilado. Os saltos de break ainda sem destino formam
+// uma lista encadeada pelos próprios operandos: cada um guarda o
+// offset+1 do operando do break anterior (0 = fim da lista).
+typedef struct LoopScope
+{
+    struct LoopScope* enclosing;
+    uint32_t start;             // Início da condição (destino do continue)
+    size_t breaks;              // Último break pendente (offset+1) ou 0
+} LoopScope;
+
+typedef struct
+{
+    Chunk* chunk;
+    int depth;          // Profundidade atual da pilha de valores
+    LoopScope* loop;    // while mais interno (NULL fora de laço)
+} Compiler;
+
+static void compile_statement(Compiler* c, ASTNode* node);
+static void compile_expression(Compiler* c, ASTNode* node, EvalContext ctx);
+
+//===================================================================
+// EMISSÃO
+//===================================================================
+static void adjust_depth(Compiler* c, int effect)
+{
+    c->depth += effect;
+    if (c->depth > c->chunk->max_stack)
+    {
+        c->chunk->max_stack = c->depth;
+    }
+}
+
+static void emit_op(Compiler* c, ASTNode* node, OpCode op, int stack_effect)
+{
+    if (opcode_reports_position(op))
+    {
+        chunk_add_line(c->chunk, node->line, node->column);
+    }
+    chunk_write_byte(c->chunk, (uint8_t)op);
+    adjust_depth(c, stack_effect);
+}
+
+static void emit_op_u8(Compiler* c, ASTNode* node, OpCode op, uint8_t operand,
+                       int stack_effect)
+{
+    emit_op(c, node, op, stack_effect);
+    chunk_write_byte(c->chunk, operand);
+}
+
+static void emit_op_u32(Compiler* c, ASTNode* node, OpCode op, uint32_t operand,
+                        int stack_effect)
+{
+    emit_op(c, node, op, stack_effect);
+    chunk_write_u32(c->chunk, operand);
+}
+
+// Emite salto com destino ainda desconhecido; devolve onde corrigir
+static size_t emit_jump(Compiler* c, ASTNode* node, OpCode op, int stack_effect)
+{
+    emit_op_u32(c, node, op, 0, stack_effect);
+    return c->chunk->count - 4;
+}
+
+static void patch_jump(Compiler* c, size_t operand_offset)
+{
+    chunk_patch_u32(c->chunk, operand_offset, (uint32_t)c->chunk->count);
+}
+
+// Erro detectado na compilação mas que só deve aparecer quando a
+// execução chegar neste ponto (mesma ordem de saída do evaluator)
+static void emit_error(Compiler* c, ASTNode* node, const char* message)
+{
+    emit_op_u32(c, node, BC_ERROR, chunk_add_string(c->chunk, message), 1);
+}
+
+//===================================================================
+// EXPRESSÕES
+//===================================================================
+static int both_numbers(ASTNode* left, ASTNode* right)
+{
+    return left->value_type == TYPE_NUMBER && right->value_type == TYPE_NUMBER;
+}
+
+// Operador aritmético com os dois operandos já na pilha
+static void emit_binary_op(Compiler* c, ASTNode* node)
+{
+    int proven = both_numbers(node->data.binaryop.left, node->data.binaryop.right);
+    switch (node->data.binaryop.operator)
+    {
+        case '+': emit_op(c, node, proven ? BC_ADD_NUM : BC_ADD, -1); break;
+        case '-': emit_op(c, node, proven ? BC_SUB_NUM : BC_SUB, -1); break;
+        case '*': emit_op(c, node, proven ? BC_MUL_NUM : BC_MUL, -1); break;
+        case '/': emit_op(c, node, proven ? BC_DIV_NUM : BC_DIV, -1); break;
+        case '\\': emit_op(c, node, proven ? BC_QUOTIENT_NUM : BC_QUOTIENT, -1); break;
+        case '%': emit_op(c, node, proven ? BC_REMAINDER_NUM : BC_REMAINDER, -1); break;
+        default:
+        {
+            char message[BUFFER_SIZE];
+            snprintf(message, sizeof(message),
+                     "Evaluator error: invalid operator '%c'",
+                     node->data.binaryop.operator);
+            emit_op(c, node, BC_POP, -1);
+            emit_op(c, node, BC_POP, -1);
+            emit_error(c, node, message);
+            break;
+        }
+    }
+}
+
+// -x e +x. 'after' = 0 antes do operando, 1 depois dele:
+//     -x:  <x>  BC_NEGATE
+//     +x:  <x>                   (x provado número)
+//     +x:  0  <x>  BC_ADD        (mantém a verificação de tipo de '+')
+// Devolve 0 se o operando não deve ser compilado
+static int emit_unary_op(Compiler* c, ASTNode* node, int after)
+{
+    int proven = node->data.unaryop.operand->value_type == TYPE_NUMBER;
+    switch (node->data.unaryop.operator)
+    {
+        case '-':
+            if (after) emit_op(c, node, proven ? BC_NEGATE_NUM : BC_NEGATE, 0);
+            return 1;
+        case '+':
+            if (proven) return 1;
+            if (after)
+                emit_op(c, node, BC_ADD, -1);
+            else
+                emit_op_u32(c, node, BC_NUMBER, chunk_add_number(c->chunk, value_int(0)), 1);
+            return 1;
+        default:
+        {
+            char message[BUFFER_SIZE];
+            snprintf(message, sizeof(message),
+                     "Evaluator error: invalid unary operator '%c'",
+                     node->data.unaryop.operator);
+            emit_error(c, node, message);
+            return 0;
+        }
+    }
+}
+
+// Comparação com os dois operandos já na pilha
+static void emit_comparison_op(Compiler* c, ASTNode* node)
+{
+    if (both_numbers(node->data.logicalop.left, node->data.logicalop.right))
+    {
+        switch (node->data.logicalop.operator)
+        {
+            case OP_EQUAL:         emit_op(c, node, BC_EQUAL_NUM, -1); return;
+            case OP_NOT_EQUAL:     emit_op(c, node, BC_NOT_EQUAL_NUM, -1); return;
+            case OP_LESS:          emit_op(c, node, BC_LESS_NUM, -1); return;
+            case OP_GREATER:       emit_op(c, node, BC_GREATER_NUM, -1); return;
+            case OP_LESS_EQUAL:    emit_op(c, node, BC_LESS_EQUAL_NUM, -1); return;
+            case OP_GREATER_EQUAL: emit_op(c, node, BC_GREATER_EQUAL_NUM, -1); return;
+            default:               break;  // Erro abaixo
+        }
+    }
+
+    switch (node->data.logicalop.operator)
+    {
+        case OP_EQUAL:         emit_op(c, node, BC_EQUAL, -1); break;
+        case OP_NOT_EQUAL:     emit_op(c, node, BC_NOT_EQUAL, -1); break;
+        case OP_LESS:          emit_op(c, node, BC_LESS, -1); break;
+        case OP_GREATER:       emit_op(c, node, BC_GREATER, -1); break;
+        case OP_LESS_EQUAL:    emit_op(c, node, BC_LESS_EQUAL, -1); break;
+        case OP_GREATER_EQUAL: emit_op(c, node, BC_GREATER_EQUAL, -1); break;
+        default:
+            emit_op(c, node, BC_POP, -1);
+            emit_op(c, node, BC_POP, -1);
+            emit_error(c, node, "Evaluator error: invalid comparison operator");
+            break;
+    }
+}
+
+// Folhas: literais e variáveis (e nós que não são expressão)
+static void compile_leaf(Compiler* c, ASTNode* node, EvalContext ctx)
+{
+    switch (node->type)
+    {
+        case NODE_BOOL:
+            emit_op(c, node, node->data.boolean.value ? BC_TRUE : BC_FALSE, 1);
+            break;
+
+        case NODE_NUMBER:
+            emit_op_u32(c, node, BC_NUMBER,
+                        chunk_add_number(c->chunk, node->data.number.value), 1);
+            break;
+
+        case NODE_STRING:
+            if (ctx == CTX_NUMBER)
+            {
+                emit_error(c, node, "Evaluator error: string cannot be used as number");
+                break;
+            }
+            emit_op_u32(c, node, BC_STRING,
+                        chunk_add_string_constant(c->chunk, node->data.string.value), 1);
+            break;
+
+        case NODE_VARIABLE:
+            // Tipo provado: a verificação de contexto é desnecessária
+            emit_op_u32(c, node,
+                        ctx == CTX_NUMBER && node->value_type != TYPE_NUMBER
+                            ? BC_GET_VAR_NUM : BC_GET_VAR,
+                        (uint32_t)node->data.variable.slot, 1);
+            break;
+
+        case NODE_STATEMENT_LIST:
+            emit_error(c, node,
+                "Evaluator error: statement list cannot be used as expression");
+            break;
+
+        default:
+        {
+            char message[BUFFER_SIZE];
+            snprintf(message, sizeof(message),
+                     "Evaluator error: unsupported node type: %d", node->type);
+            emit_error(c, node, message);
+            break;
+        }
+    }
+}
+
+//===================================================================
+// PERCURSO DAS EXPRESSÕES
+// Pós-ordem com pilha de trabalho (a profundidade da expressão não
+// consome pilha do C). Cada quadro lembra até onde o nó foi emitido.
+//===================================================================
+typedef struct
+{
+    ASTNode* node;
+    EvalContext ctx;
+    int state;          // Filhos já compilados
+    size_t jump;        // and/or: salto de curto-circuito a corrigir
+} CompileFrame;
+
+static void push_compile(WorkStack* frames, ASTNode* node, EvalContext ctx)
+{
+    CompileFrame* frame = WORK_STACK_PUSH(frames, CompileFrame);
+    frame->node = node;
+    frame->ctx = ctx;
+    frame->state = 0;
+}
+
+static void compile_expression(Compiler* c, ASTNode* node, EvalContext ctx)
+{
+    // Literal ou variável (a maioria dos itens de print): sem percurso
+    if (node->type == NODE_NUMBER || node->type == NODE_STRING ||
+        node->type == NODE_VARIABLE || node->type == NODE_BOOL)
+    {
+        compile_leaf(c, node, ctx);
+        return;
+    }
+
+    WorkStack frames;
+    work_stack_init(&frames, sizeof(CompileFrame));
+    push_compile(&frames, node, ctx);
+
+    while (!work_stack_empty(&frames))
+    {
+        CompileFrame* frame = WORK_STACK_TOP(&frames, CompileFrame);
+        ASTNode* current = frame->node;
+        int state = frame->state++;
+
+        switch (current->type)
+        {
+            case NODE_BINARY_OP:
+            {
+                // <left> <right> op. Os operandos de '+' podem ser strings
+                EvalContext operand_ctx = current->data.binaryop.operator == '+'
+                                        ? CTX_ANY : CTX_NUMBER;
+                if (state == 0)
+                {
+                    push_compile(&frames, current->data.binaryop.left, operand_ctx);
+                    continue;
+                }
+                if (state == 1)
+                {
+                    push_compile(&frames, current->data.binaryop.right, operand_ctx);
+                    continue;
+                }
+                emit_binary_op(c, current);
+                break;
+            }
+
+            case NODE_COMPARISON_OP:
+                if (state == 0)
+                {
+                    push_compile(&frames, current->data.logicalop.left, CTX_ANY);
+                    continue;
+                }
+                if (state == 1)
+                {
+                    push_compile(&frames, current->data.logicalop.right, CTX_ANY);
+                    continue;
+                }
+                emit_comparison_op(c, current);
+                break;
+
+            case NODE_UNARY_OP:
+                if (state == 0)
+                {
+                    if (!emit_unary_op(c, current, 0)) break;
+                    push_compile(&frames, current->data.unaryop.operand, CTX_NUMBER);
+                    continue;
+                }
+                emit_unary_op(c, current, 1);
+                break;
+
+            case NODE_LOGICAL_OP:
+            {
+                // a and b / a or b com curto-circuito:
+                //     <a>  BC_AND fim  <b>  BC_CHECK_BOOL  fim:
+                LogicalOperator op = current->data.logicalop.operator;
+                if (state == 0)
+                {
+                    if (op != OP_AND && op != OP_OR)
+                    {
+                        emit_error(c, current, "Evaluator error: invalid logical operator");
+                        break;
+                    }
+                    push_compile(&frames, current->data.logicalop.left, CTX_BOOL);
+                    continue;
+                }
+                if (state == 1)
+                {
+                    frame->jump = emit_jump(c, current, op == OP_AND ? BC_AND : BC_OR, -1);
+                    push_compile(&frames, current->data.logicalop.right, CTX_BOOL);
+                    continue;
+                }
+                if (current->data.logicalop.right->value_type != TYPE_BOOL)
+                {
+                    emit_op(c, current, BC_CHECK_BOOL, 0);
+                }
+                patch_jump(c, frame->jump);
+                break;
+            }
+
+            case NODE_NOT_LOGICAL_OP:
+                if (state == 0)
+                {
+                    push_compile(&frames, current->data.notop.operand, CTX_BOOL);
+                    continue;
+                }
+                emit_op(c, current, BC_NOT, 0);
+                break;
+
+            case NODE_CALL:
+            {
+                // <args...> BC_CALL id argc: os tipos são conferidos na execução
+                CallData* call = &current->data.call;
+                if (state < call->argc)
+                {
+                    push_compile(&frames, call->args[state], CTX_ANY);
+                    continue;
+                }
+                emit_op_u8(c, current, BC_CALL, call->builtin, 1 - call->argc);
+                chunk_write_byte(c->chunk, call->argc);
+                break;
+            }
+
+            case NODE_INDEX:
+                // <índice> BC_GET_INDEX slot (sem comparar com o tamanho
+                // se o optimizer provou o índice)
+                if (state == 0)
+                {
+                    push_compile(&frames, current->data.array.index, CTX_NUMBER);
+                    continue;
+                }
+                emit_op_u32(c, current,
+                            current->data.array.checked ? BC_GET_INDEX : BC_GET_INDEX_FAST,
+                            (uint32_t)current->data.array.slot, 0);
+                break;
+
+            default:
+                compile_leaf(c, current, frame->ctx);
+                break;
+        }
+
+        work_stack_pop(&frames);
+    }
+
+    work_stack_free(&frames);
+}
+
+//===================================================================
+// STATEMENTS
+//===================================================================
+static void compile_print(Compiler* c, ASTNode* node)
+{
+    PrintStatementData* print_data = &node->data.printstatement;
+
+    emit_op(c, node, BC_PRINT_BEGIN, 0);
+
+    // Se não tem itens (print vazio) -> linha em branco
+    if (print_data->count == 0)
+    {
+        emit_op(c, node, BC_PRINT_EMPTY, 0);
+        return;
+    }
+
+    for (int i = 0; i < print_data->count; i++)
+    {
+        ASTNode* item = print_data->items[i];
+
+        switch (item->type)
+        {
+            case NODE_COLOR:
+                emit_op_u8(c, item, BC_PRINT_COLOR,
+                           item->data.color.code, 0);
+                break;
+
+            case NODE_WIDTH:
+                emit_op_u32(c, item, BC_PRINT_WIDTH,
+                            (uint32_t)item->data.width.value, 0);
+                break;
+
+            case NODE_ALIGNMENT:
+                emit_op_u8(c, item, BC_PRINT_ALIGN,
+                           (uint8_t)item->data.alignment.alignment_type, 0);
+                break;
+
+            default:
+                compile_expression(c, item, CTX_ANY);
+                // Espaço entre itens (exceto após o último)
+                emit_op_u8(c, item, BC_PRINT_ITEM,
+                           (uint8_t)(i < print_data->count - 1), -1);
+                break;
+        }
+    }
+
+    if (print_data->newline)
+    {
+        emit_op(c, node, BC_NEWLINE, 0);
+    }
+}
+
+static void compile_if(Compiler* c, ASTNode* node)
+{
+    IfStatementData* data = &node->data.ifstatement;
+
+    compile_expression(c, data->condition, CTX_BOOL);
+    size_t else_jump = emit_jump(c, node, BC_JUMP_IF_FALSE, -1);
+
+    compile_statement(c, data->then_body);
+
+    if (data->else_body)
+    {
+        size_t end_jump = emit_jump(c, node, BC_JUMP, 0);
+        patch_jump(c, else_jump);
+        compile_statement(c, data->else_body);
+        patch_jump(c, end_jump);
+    }
+    else
+    {
+        patch_jump(c, else_jump);
+    }
+}
+
+// while (cond) do body end while:
+//     inicio: <cond> BC_JUMP_IF_FALSE fim  <body>  BC_JUMP inicio  fim:
+// continue -> BC_JUMP inicio; break -> BC_JUMP fim
+static void compile_while(Compiler* c, ASTNode* node)
+{
+    WhileStatementData* data = &node->data.whilestatement;
+
+    LoopScope loop;
+    loop.enclosing = c->loop;
+    loop.start = (uint32_t)c->chunk->count;
+    loop.breaks = 0;
+    c->loop = &loop;
+
+    compile_expression(c, data->condition, CTX_BOOL);
+    size_t exit_jump = emit_jump(c, node, BC_JUMP_IF_FALSE, -1);
+
+    compile_statement(c, data->body);
+    emit_op_u32(c, node, BC_JUMP, loop.start, 0);
+
+    patch_jump(c, exit_jump);
+    while (loop.breaks)
+    {
+        size_t operand = loop.breaks - 1;
+        loop.breaks = bytecode_read_u32(c->chunk->code + operand);
+        patch_jump(c, operand);
+    }
+
+    c->loop = loop.enclosing;
+}
+
+static void compile_loop_control(Compiler* c, ASTNode* node)
+{
+    if (!c->loop)
+    {
+        // O parser não deixa chegar aqui
+        emit_error(c, node, "Evaluator error: break/continue outside of a while loop");
+        emit_op(c, node, BC_POP, -1);
+        return;
+    }
+
+    if (node->type == NODE_CONTINUE)
+    {
+        emit_op_u32(c, node, BC_JUMP, c->loop->start, 0);
+        return;
+    }
+
+    size_t operand = emit_jump(c, node, BC_JUMP, 0);
+    chunk_patch_u32(c->chunk, operand, (uint32_t)c->loop->breaks);
+    c->loop->breaks = operand + 1;
+}
+
+static void compile_statement(Compiler* c, ASTNode* node)
+{
+    if (!node) return;
+
+    uint32_t start = (uint32_t)c->chunk->count;
+
+    switch (node->type)
+    {
+        case NODE_STATEMENT_LIST:
+        {
+            StatementListData* list = &node->data.statementlist;
+            for (int i = 0; i < list->count; i++)
+            {
+                compile_statement(c, list->statements[i]);
+            }
+            return;  // Cada statement da lista tem sua própria região
+        }
+
+        case NODE_ASSIGNMENT:
+        {
+            ASTNode* value = node->data.assignment.value;
+            uint32_t slot = (uint32_t)node->data.assignment.slot;
+
+            // let s = s + x (fora número provado):
+            //     BC_GET_VAR s  <x>  BC_APPEND_VAR s
+            if (ast_is_self_append(node) && value->value_type != TYPE_NUMBER)
+            {
+                compile_leaf(c, value->data.binaryop.left, CTX_ANY);
+                compile_expression(c, value->data.binaryop.right, CTX_ANY);
+                emit_op_u32(c, value, BC_APPEND_VAR, slot, -2);
+                break;
+            }
+            compile_expression(c, value, CTX_ANY);
+            emit_op_u32(c, node, BC_SET_VAR, slot, -1);
+            break;
+        }
+
+        case NODE_BOOL:
+        case NODE_NUMBER:
+        case NODE_BINARY_OP:
+        case NODE_UNARY_OP:
+        case NODE_VARIABLE:
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+        case NODE_NOT_LOGICAL_OP:
+        case NODE_CALL:
+        case NODE_INDEX:
+            compile_expression(c, node, CTX_ANY);
+            emit_op_u8(c, node, BC_ECHO, 0, -1);
+            break;
+
+        case NODE_STRING:
+            compile_expression(c, node, CTX_ANY);
+            emit_op_u8(c, node, BC_ECHO, 1, -1);
+            break;
+
+        case NODE_PRINT:
+            compile_print(c, node);
+            break;
+
+        case NODE_COLOR:
+            // Comando nocolor sozinho (sem cores na saída não gera nada);
+            // outras cores sozinhas não fazem sentido
+            if (node->data.color.code == CLR_NOCOLOR)
+            {
+                if (output_colors_enabled())
+                {
+                    emit_op(c, node, BC_NOCOLOR, 0);
+                }
+            }
+            else
+            {
+                emit_op_u32(c, node, BC_WARNING, chunk_add_string(c->chunk,
+                    "Evaluator warning: color command without print has no effect"), 0);
+            }
+            break;
+
+        case NODE_INPUT:
+            emit_op_u32(c, node, BC_INPUT,
+                        (uint32_t)node->data.inputstatement.slot, 0);
+            chunk_write_u32(c->chunk,
+                            chunk_add_string(c->chunk, node->data.inputstatement.prompt));
+            break;
+
+        case NODE_DIM:
+            compile_expression(c, node->data.array.index, CTX_NUMBER);
+            emit_op_u32(c, node, BC_DIM, (uint32_t)node->data.array.slot, -1);
+            break;
+
+        case NODE_INDEX_ASSIGNMENT:
+            // <índice> <valor> BC_SET_INDEX slot
+            compile_expression(c, node->data.array.index, CTX_NUMBER);
+            compile_expression(c, node->data.array.value, CTX_NUMBER);
+            emit_op_u32(c, node,
+                        node->data.array.checked ? BC_SET_INDEX : BC_SET_INDEX_FAST,
+                        (uint32_t)node->data.array.slot, -2);
+            break;
+
+        case NODE_IF:
+            compile_if(c, node);
+            break;
+
+        case NODE_WHILE:
+            compile_while(c, node);
+            break;
+
+        case NODE_BREAK:
+        case NODE_CONTINUE:
+            compile_loop_control(c, node);
+            break;
+
+        default:
+        {
+            char message[BUFFER_SIZE];
+            snprintf(message, sizeof(message),
+                     "Evaluator error: unsupported statement type: %d", node->type);
+            emit_error(c, node, message);
+            emit_op(c, node, BC_POP, -1);
+            break;
+        }
+    }
+
+    chunk_add_range(c->chunk, start, (uint32_t)c->chunk->count);
+}
+
+//===================================================================
+// FUNÇÃO PRINCIPAL
+//===================================================================
+int compile_program(ASTNode* ast, Chunk* chunk)
+{
+    if (!ast || !chunk) return 0;
+
+    Compiler compiler;
+    compiler.chunk = chunk;
+    compiler.depth = 0;
+    compiler.loop = NULL;
+
+    compile_statement(&compiler, ast);
+    emit_op(&compiler, ast, BC_HALT, 0);
+
+    return 1;
+}
+// Fim de compiler.c
@@ -0,0 +1,22 @@
+// compiler.h
+
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "ast.h"
+#include "bytecode.h"
+
+/********************************************************************
+Compila a AST produzida por parse() para bytecode (ver bytecode.h).
+
+O chunk deve ter sido inicializado com chunk_init() e a AST já deve
+ter passado por resolve_program(): variáveis viram índices de slot da
+SymbolTable. A AST pode ser liberada logo após a compilação: o chunk
+guarda cópias de todas as strings que usa.
+
+Retorno: 1 = sucesso, 0 = erro
+********************************************************************/
+int compile_program(ASTNode* ast, Chunk* chunk);
+
+#endif // COMPILER_H
+// Fim de compiler.h
@@ -3,60 +3,49 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <errno.h>
 #include <stdarg.h>  
 
 #include "color.h"
 #include "a89alloc.h"
 #include "evaluator.h"
-
-#define EPSILON 1e-12
-
-// Cor atual sendo aplicada (estado global para sessão)
-static const char* current_color_global = "";
-static int colors_enabled_global = 1;
+#include "output.h"
+#include "number_format.h"
+#include "work_stack.h"
+#include "builtins.h"
+#include "numeric.h"
 
 
 //===================================================================
 // FUNÇÕES DESTE ARQUIVO
 //===================================================================
-static EvaluatorResult create_success_result_bool(int value, int line, int column);
-static EvaluatorResult create_success_result_number(double value, int line, int column);
-static EvaluatorResult create_success_result_string(const char* value, int line, int column);
-static EvaluatorResult create_error_result(const char* message, int line, int column);
-static EvaluatorResult create_error_result_fmt(int line, int column, 
-                                              const char* format, ...);
-
-static void reset_current_color(void);
-static void apply_color(const char* ansi_color);
-static void detect_color_support(void);
+static Value raise_error(ExecutionContext* exec, int line, int column,
+                         const char* format, ...);
 
 static int count_utf8_chars(const char* str);
 static AlignmentType token_to_alignment(TokenType token_type);
 static void reset_format(ExecutionContext* ctx);
 static void update_format_from_node(ASTNode* node, ExecutionContext* ctx);
-static void apply_format(const char* str, OutputFormat* format);
-void evaluator_reset_format(ExecutionContext* ctx);
-
-ExecutionContext* execution_context_create(SymbolTable* symbols);
-void execution_context_destroy(ExecutionContext* ctx);
-
-static int evaluate_print_statement_with_format(ASTNode* node, ExecutionContext* ctx);
-int evaluate_print_with_context(ASTNode* node, ExecutionContext* ctx);
-int evaluate_input_statement(ASTNode* node, SymbolTable* symbols);
+static void apply_format(OutputBuffer* out, const char* str, OutputFormat* format);
+static Value evaluate_number(ASTNode* node, ExecutionContext* exec);
+static Value apply_binary_op(ASTNode* node, ExecutionContext* exec,
+                             Value left_value, Value right_value);
+static Value apply_index(ASTNode* node, ExecutionContext* exec, Value index);
+static int execute_array_statement(ASTNode* node, ExecutionContext* ctx);
 
 
 
 // FUNÇÕES PÚBLICAS
 
-// int evaluate_program(ASTNode* node, SymbolTable* symbols);
-// int evaluate_print_statement(ASTNode* node, SymbolTable* symbols);
-// EvaluatorResult evaluate_expression(ASTNode* node, SymbolTable* symbols, EvalContext ctx);
+// int evaluate_program(ASTNode* node, ExecutionContext* ctx);
+// int evaluate_print_statement(ASTNode* node, ExecutionContext* ctx);
+// Value evaluate_expression(ASTNode* node, ExecutionContext* exec, EvalContext ctx);
 
 // // Old function (for compatibility)
-// EvaluatorResult evaluate(ASTNode* node);
+// Value evaluate(ASTNode* node);
 
-// int execute_statement_list(ASTNode* node, SymbolTable* symbols);
-// int execute_statement(ASTNode* node, SymbolTable* symbols);
+// int execute_statement_list(ASTNode* node, ExecutionContext* ctx);
+// int execute_statement(ASTNode* node, ExecutionContext* ctx);
 //===================================================================
 
 
@@ -64,108 +53,46 @@ int evaluate_input_statement(ASTNode* node, SymbolTable* symbols);
 // HELPER FUNCTIONS (static)
 // ============================================
 
-static EvaluatorResult create_success_result_bool(int value, int line, int column)
-{
-    EvaluatorResult result;
-    memset(&result, 0, sizeof(EvaluatorResult)); 
-    result.type = RESULT_BOOL;
-    result.value.boolean = value;
-    result.line = line;      
-    result.column = column;  
-    return result;    
-}
-
-static EvaluatorResult create_success_result_number(double value, int line, int column)
-{
-    EvaluatorResult result;
-    memset(&result, 0, sizeof(EvaluatorResult)); 
-    result.type = RESULT_NUMBER;
-    result.value.number = value;
-    result.line = line;      
-    result.column = column;  
-    return result;
-}
-
-static EvaluatorResult create_success_result_string(const char* value, int line, int column)
-{
-    EvaluatorResult result;
-    memset(&result, 0, sizeof(EvaluatorResult)); 
-    result.type = RESULT_STRING;
-    strncpy(result.value.string, value, sizeof(result.value.string) - 1);
-    result.value.string[sizeof(result.value.string) - 1] = '\0';
-    result.line = line;
-    result.column = column;
-    return result;
-}
-
-static EvaluatorResult create_error_result(const char* message, int line, int column)
+// Registra o erro no contexto e devolve o marcador VALUE_ERROR.
+// A mensagem só é formatada no caminho de erro.
+static Value raise_error(ExecutionContext* exec, int line, int column,
+                         const char* format, ...)
 {
-    EvaluatorResult result;
-    memset(&result, 0, sizeof(EvaluatorResult)); 
-    result.type = RESULT_ERROR;
-    snprintf(result.error_message, sizeof(result.error_message), 
-             "%s[%d:%d] %s%s", COLOR_ERROR, line, column, message, COLOR_RESET);
-    result.line = line;
-    result.column = column;
-    return result;
-}
-
-// printf-style version for formatted messages
-static EvaluatorResult create_error_result_fmt(int line, int column, 
-                                              const char* format, ...)
-{
-    char message[BUFFER_SIZE];
     va_list args;
     va_start(args, format);
-    vsnprintf(message, sizeof(message), format, args);
+    vsnprintf(exec->error.message, sizeof(exec->error.message), format, args);
     va_end(args);
     
-    return create_error_result(message, line, column);
+    exec->error.has_error = 1;
+    exec->error.line = line;
+    exec->error.column = column;
+    return VALUE_ERROR;
 }
 
-
-// =================================================
-// CORES
-// =================================================
-
-// Reseta a cor atual
-static void reset_current_color(void)
+// Registra e já imprime um erro com posição (erros antes da execução)
+void evaluator_report_error_at(ExecutionContext* exec, int line, int column,
+                               const char* format, ...)
 {
-    current_color_global = "";
-    if (colors_enabled_global) {
-        printf("%s", COLOR_RESET);
-    }
-}
+    va_list args;
+    va_start(args, format);
+    vsnprintf(exec->error.message, sizeof(exec->error.message), format, args);
+    va_end(args);
 
-// Aplica uma cor (se diferente da atual)
-static void apply_color(const char* ansi_color)
-{
-    if (!colors_enabled_global) return;
-    
-    // Se é nocolor (reset)
-    if (ansi_color[0] == '\0' || strcmp(ansi_color, "\033[0m") == 0)
-    {
-        reset_current_color();
-        return;
-    }
-    
-    // Se é a mesma cor já aplicada, não faz nada
-    if (strcmp(current_color_global, ansi_color) == 0)
-    {
-        return;
-    }
-    
-    // Aplica a nova cor
-    printf("%s", ansi_color);
-    current_color_global = ansi_color;
+    exec->error.has_error = 1;
+    exec->error.line = line;
+    exec->error.column = column;
+    evaluator_report_error(exec);
 }
 
-// Verifica se o terminal suporta cores (detecção simples)
-static void detect_color_support(void)
+// Imprime e limpa o erro pendente do contexto
+void evaluator_report_error(ExecutionContext* exec)
 {
-    // Por enquanto assume que sim
-    // Futuro: verificar variáveis de ambiente TERM, NO_COLOR, etc.
-    colors_enabled_global = 1;
+    if (!exec->error.has_error) return;
+    
+    output_flush(&exec->output);
+    printf("%s[%d:%d] %s%s\n", output_ansi(COLOR_ERROR), exec->error.line, 
+           exec->error.column, exec->error.message, output_ansi(COLOR_RESET));
+    exec->error.has_error = 0;
 }
 
 
@@ -237,11 +164,13 @@ static void update_format_from_node(ASTNode* node, ExecutionContext* ctx)
 }
 
 // Aplica formatação (width e alinhamento) a uma string
-static void apply_format(const char* str, OutputFormat* format)
+static void apply_format(OutputBuffer* out, const char* str, OutputFormat* format)
 {
+    size_t length = strlen(str);
+
     if (!format || !format->has_format || format->width <= 0)
     {
-        printf("%s", str);
+        output_write(out, str, length);
         return;
     }
     
@@ -251,7 +180,7 @@ static void apply_format(const char* str, OutputFormat* format)
     if (str_len >= width)
     {
         // Se a string for maior ou igual à largura, imprime sem formatação
-        printf("%s", str);
+        output_write(out, str, length);
         return;
     }
     
@@ -260,54 +189,122 @@ static void apply_format(const char* str, OutputFormat* format)
     switch (format->align)
     {
         case ALIGN_LEFT:
-            printf("%s", str);
-            for (int i = 0; i < padding; i++) putchar(' ');
+            output_write(out, str, length);
+            output_spaces(out, padding);
             break;
             
         case ALIGN_RIGHT:
-            for (int i = 0; i < padding; i++) putchar(' ');
-            printf("%s", str);
+            output_spaces(out, padding);
+            output_write(out, str, length);
             break;
             
         case ALIGN_CENTER:
         {
             int left_pad = padding / 2;
             int right_pad = padding - left_pad;
-            for (int i = 0; i < left_pad; i++) putchar(' ');
-            printf("%s", str);
-            for (int i = 0; i < right_pad; i++) putchar(' ');
+            output_spaces(out, left_pad);
+            output_write(out, str, length);
+            output_spaces(out, right_pad);
             break;
         }
     }
 }
 
-// Cria contexto de execução
-ExecutionContext* execution_context_create(SymbolTable* symbols)
+// Cria o interpretador de uma sessão (run_file, run_repl)
+ExecutionContext* execution_context_create(void)
 {
     ExecutionContext* ctx = A89ALLOC(sizeof(ExecutionContext));
-    ctx->symbols = symbols;
-    ctx->current_color = "";
-    ctx->color_enabled = 1;
-    reset_format(ctx);    
+    ctx->symbols = symbol_table_create();
+    output_init(&ctx->output, stdout);
+    ctx->current_color = CLR_NOCOLOR;
+    ctx->color_enabled = output_colors_enabled();
+    ctx->error.has_error = 0;
+    ctx->error.line = 0;
+    ctx->error.column = 0;
+    ctx->error.message[0] = '\0';
+    ctx->quick.specializations = 0;
+    ctx->quick.deopts = 0;
+    work_stack_init(&ctx->temps, sizeof(Value));
+    reset_format(ctx);
     return ctx;
 }
 
-// Destrói contexto de execução
+// Destrói o interpretador: o que ficou no buffer sai antes
 void execution_context_destroy(ExecutionContext* ctx)
 {
     if (ctx)
     {
+        output_flush(&ctx->output);
+        evaluator_release_temps(ctx);
+        work_stack_free(&ctx->temps);
+        symbol_table_destroy(ctx->symbols);
         a89free(ctx);
     }
 }
 
+// Recomeça a sessão sem variáveis (a saída pendente é mantida)
+void execution_context_reset(ExecutionContext* ctx)
+{
+    evaluator_release_temps(ctx);
+    symbol_table_destroy(ctx->symbols);
+    ctx->symbols = symbol_table_create();
+    ctx->current_color = CLR_NOCOLOR;
+    ctx->error.has_error = 0;
+    reset_format(ctx);
+}
+
 // Reseta formatação (pública)
 void evaluator_reset_format(ExecutionContext* ctx)
 {
     reset_format(ctx);
 }
 
-// evaluator.c - ADICIONAR estas funções:
+// =================================================
+// VALORES TEMPORÁRIOS (concatenação, inteiros em caixa)
+// =================================================
+Value evaluator_concat(ExecutionContext* ctx, Value left, Value right)
+{
+    String* a = value_as_string_object(left);
+    String* b = value_as_string_object(right);
+    
+    // O temporário mais recente só com a referência do contexto é de
+    // uso exclusivo desta expressão: "a + b + c" cresce no lugar
+    Value* newest = work_stack_empty(&ctx->temps) ? NULL
+                  : WORK_STACK_TOP(&ctx->temps, Value);
+    if (newest && *newest == left && a->refcount == 1)
+    {
+        *newest = value_string(string_append(a, b->chars, b->length));
+        return *newest;
+    }
+    
+    Value result = value_string(string_concat(a, b));
+    *WORK_STACK_PUSH(&ctx->temps, Value) = result;
+    return result;
+}
+
+int evaluator_append_in_place(ExecutionContext* ctx, int slot, Value right)
+{
+    SymbolValue* symbol = symbol_table_slot(ctx->symbols, slot);
+    if (!value_is_string(right) || !value_is_string(symbol->value)) return 0;
+    
+    String* target = value_as_string_object(symbol->value);
+    if (target->refcount != 1) return 0;  // Outro dono enxergaria a mudança
+    
+    // A referência continua sendo da variável: troca só o endereço
+    String* tail = value_as_string_object(right);
+    symbol->value = value_string(string_append(target, tail->chars, tail->length));
+    return 1;
+}
+
+void evaluator_free_temps(ExecutionContext* ctx)
+{
+    while (!work_stack_empty(&ctx->temps))
+    {
+        value_release(*WORK_STACK_TOP(&ctx->temps, Value));
+        work_stack_pop(&ctx->temps);
+    }
+}
+
 
 // =================================================
 // FUNÇÕES PARA INPUT
@@ -325,80 +322,254 @@ static int is_numeric_string(const char* str)
     return (*endptr == '\0');
 }
 
-// Lê entrada do usuário com prompt
-static char* read_user_input(const char* prompt)
+// Número digitado: inteiro exato (em caixa fora da faixa inline, com
+// uma referência para quem chama) ou double com fração, expoente ou
+// fora de int64
+static Value input_number(const char* str)
+{
+    char* endptr;
+    errno = 0;
+    long long integer = strtoll(str, &endptr, 10);
+    if (errno != ERANGE && *endptr == '\0')
+    {
+        if (integer >= VALUE_INT_MIN && integer <= VALUE_INT_MAX) return value_int(integer);
+        return value_box_int((int64_t)integer);
+    }
+    return value_from_double(atof(str));
+}
+
+// Lê uma linha inteira do usuário (sem limite de tamanho), sem o
+// newline. NULL = erro ou EOF antes de qualquer caractere
+static String* read_user_input(ExecutionContext* ctx, const char* prompt)
 {
+    // Garante que a saída pendente e o prompt apareçam antes de ler
     if (prompt && prompt[0] != '\0') {
-        printf("%s", prompt);
-        fflush(stdout);  // Garante que o prompt seja exibido antes de ler
+        output_text(&ctx->output, prompt);
     }
+    output_flush(&ctx->output);
     
-    static char buffer[BUFFER_SIZE];
-    
+    char buffer[BUFFER_SIZE];
     if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
         return NULL;  // Erro ou EOF
     }
     
-    // Remove newline no final
-    buffer[strcspn(buffer, "\n")] = '\0';
+    // Caso comum: a linha coube no buffer
+    size_t length = strcspn(buffer, "\n");
+    if (buffer[length] == '\n' || length < sizeof(buffer) - 1) {
+        return string_new(buffer, length);
+    }
+    
+    // Linha longa: junta os pedaços num bloco que dobra de tamanho
+    size_t capacity = sizeof(buffer) * 2;
+    char* line = A89ALLOC(capacity);
+    memcpy(line, buffer, length);
+    
+    while (fgets(buffer, sizeof(buffer), stdin) != NULL) {
+        size_t piece = strcspn(buffer, "\n");
+        if (length + piece > capacity) {
+            char* bigger = A89ALLOC(capacity * 2);
+            memcpy(bigger, line, length);
+            a89free(line);
+            line = bigger;
+            capacity *= 2;
+        }
+        memcpy(line + length, buffer, piece);
+        length += piece;
+        if (buffer[piece] == '\n') break;
+    }
     
-    return buffer;
+    String* input = string_new(line, length);
+    a89free(line);
+    return input;
 }
 
 // Avalia statement input
-int evaluate_input_statement(ASTNode* node, SymbolTable* symbols)
+int evaluate_input_statement(ASTNode* node, ExecutionContext* ctx)
 {
-    if (!node || node->type != NODE_INPUT || !symbols)
+    if (!node || node->type != NODE_INPUT || !ctx)
     {
         printf("Evaluator error: expected input statement node\n");
         return 0;
     }
     
-    const char* prompt = node->data.inputstatement.prompt;
-    const char* var_name = node->data.inputstatement.var_name;
-    
+    return evaluator_assign_input(ctx,
+                                  node->data.inputstatement.slot,
+                                  node->data.inputstatement.prompt);
+}
+
+// Lê a entrada e armazena no slot (bool, número ou string).
+// Compartilhada pelo evaluator e pela VM.
+int evaluator_assign_input(ExecutionContext* ctx, int slot, const char* prompt)
+{
+    SymbolTable* symbols = ctx->symbols;
+    const char* var_name = symbol_table_slot_name(symbols, slot);
+
     // Lê entrada do usuário
-    char* input = read_user_input(prompt);
-    if (!input)
+    String* line = read_user_input(ctx, prompt);
+    if (!line)
     {
         printf("Evaluator error: reading input\n");
         return 0;
     }
 
-    if(!strcmp(input, "true") || !strcmp(input, "false") )
+    const char* input = line->chars;
+    Value value;
+    if (!strcmp(input, "true") || !strcmp(input, "false"))
     {
-        if(strcmp(input, "true") == 0) {
-            if (!symbol_table_set_bool(symbols, var_name, 1)) {
-                printf("Evaluator error: assigning boolean to '%s'\n", var_name);
-                return 0;
-            }
-        }
-        else if(strcmp(input, "false") == 0) {
-            if (!symbol_table_set_bool(symbols, var_name, 0)) {
-                printf("Evaluator error: assigning boolean to '%s'\n", var_name);
-                return 0;
-            }
-        }
-    }    
+        value = value_bool(strcmp(input, "true") == 0);
+    }
     else if (is_numeric_string(input))
     {
-        double value = atof(input);
-        if (!symbol_table_set_number(symbols, var_name, value))
-        {
-            printf("Evaluator error: assigning number to '%s'\n", var_name);
-            return 0;
-        }
+        value = input_number(input);
     }
     else
     {
-        if (!symbol_table_set_string(symbols, var_name, input))
+        value = value_string(line);  // A tabela retém; a linha não é copiada
+    }
+    
+    int success = symbol_table_slot_set(symbols, slot, value);
+    string_release(line);
+    if (value_is_boxed_int(value)) value_release(value);  // A tabela retém a caixa
+    if (!success)
+    {
+        output_flush(&ctx->output);
+        printf("Evaluator error: assigning %s to '%s'\n", value_type_name(value), var_name);
+        return 0;
+    }
+    
+    return 1;
+}
+
+// ===================================================
+// ARRAYS (compartilhadas com a VM)
+// O erro fica em ctx->error com linha/coluna 0; quem chama completa
+// a posição, como nas builtins
+// ===================================================
+
+// Array do slot; NULL = sem dim ou variável de outro tipo (erro)
+static Array* slot_array(ExecutionContext* ctx, int slot)
+{
+    SymbolValue* symbol = symbol_table_slot(ctx->symbols, slot);
+    const char* name = symbol_table_slot_name(ctx->symbols, slot);
+    
+    if (symbol && value_is_array(symbol->value)) return value_as_array(symbol->value);
+    
+    if (!symbol || value_is_undefined(symbol->value))
+    {
+        raise_error(ctx, 0, 0, "Evaluator error: array '%s' not dimensioned. Use 'dim %s(size)'",
+                    name, name);
+        return NULL;
+    }
+    raise_error(ctx, 0, 0, "Evaluator error: variable '%s' is a %s, not an array",
+                name, value_type_name(symbol->value));
+    return NULL;
+}
+
+// Posição de a(i) em items (índice 1 = posição 0); -1 = erro
+static int64_t array_position(ExecutionContext* ctx, int slot, const Array* array, Value index)
+{
+    if (!value_is_number(index))
+    {
+        raise_error(ctx, 0, 0, "Evaluator error: array index must be a number, got %s",
+                    value_type_name(index));
+        return -1;
+    }
+    
+    char number[NUMBER_FORMAT_SIZE];
+    if (!value_is_int(index))
+    {
+        // Double com valor inteiro (2^63 ou mais) ainda é um índice
+        double position = value_as_number(index);
+        if (position != floor(position))
         {
-            printf("Evaluator error: assigning string to '%s'\n", var_name);
-            return 0;
+            value_format_number(index, number);
+            raise_error(ctx, 0, 0, "Evaluator error: array index must be an integer, got %s",
+                        number);
+            return -1;
         }
-        //printf("OK: %s = \"%s\" (from input)\n", var_name, input);
+        if (position >= 1 && position <= (double)array->length) return (int64_t)position - 1;
+    }
+    else
+    {
+        int64_t position = value_as_int(index);
+        if (position >= 1 && (uint64_t)position <= array->length) return position - 1;
+    }
+    
+    value_format_number(index, number);
+    raise_error(ctx, 0, 0, "Evaluator error: index %s out of range for '%s' (1 to %zu)",
+                number, symbol_table_slot_name(ctx->symbols, slot), array->length);
+    return -1;
+}
+
+// dim a(n): n elementos zerados (n truncado). Um dim que falha deixa
+// a variável sem array: nada fica com o tamanho antigo
+int evaluator_dim(ExecutionContext* ctx, int slot, Value size)
+{
+    SymbolValue* symbol = symbol_table_slot(ctx->symbols, slot);
+    const char* name = symbol_table_slot_name(ctx->symbols, slot);
+    
+    if (symbol && !value_is_undefined(symbol->value) && !value_is_array(symbol->value))
+    {
+        raise_error(ctx, 0, 0, "Evaluator error: variable '%s' is a %s, not an array",
+                    name, value_type_name(symbol->value));
+        return 0;
+    }
+    
+    if (!value_is_number(size))
+    {
+        symbol_table_slot_dim(ctx->symbols, slot, NULL);
+        raise_error(ctx, 0, 0, "Evaluator error: array size must be a number, got %s",
+                    value_type_name(size));
+        return 0;
+    }
+    
+    double length = floor(value_as_number(size));
+    if (!(length >= 0 && length <= ARRAY_MAX_LENGTH))  // NaN também
+    {
+        char number[NUMBER_FORMAT_SIZE];
+        value_format_number(size, number);
+        symbol_table_slot_dim(ctx->symbols, slot, NULL);
+        raise_error(ctx, 0, 0, "Evaluator error: invalid size %s for array '%s' (0 to %d)",
+                    number, name, ARRAY_MAX_LENGTH);
+        return 0;
+    }
+    
+    Array* array = array_create((size_t)length);
+    if (!symbol_table_slot_dim(ctx->symbols, slot, array))
+    {
+        array_free(array);
+        raise_error(ctx, 0, 0, "Evaluator error: cannot dim '%s'", name);
+        return 0;
     }
+    return 1;
+}
+
+Value evaluator_array_get(ExecutionContext* ctx, int slot, Value index)
+{
+    Array* array = slot_array(ctx, slot);
+    if (!array) return VALUE_ERROR;
+    
+    int64_t position = array_position(ctx, slot, array, index);
+    if (position < 0) return VALUE_ERROR;
+    return array->items[position];
+}
+
+// Elementos só guardam numbers; 0 = erro
+int evaluator_array_set(ExecutionContext* ctx, int slot, Value index, Value value)
+{
+    Array* array = slot_array(ctx, slot);
+    if (!array) return 0;
+    
+    int64_t position = array_position(ctx, slot, array, index);
+    if (position < 0) return 0;
     
+    if (!value_is_number(value))
+    {
+        raise_error(ctx, 0, 0, "Evaluator error: array element must be a number, got %s",
+                    value_type_name(value));
+        return 0;
+    }
+    array_store(&array->items[position], value);
     return 1;
 }
 
@@ -406,15 +577,15 @@ int evaluate_input_statement(ASTNode* node, SymbolTable* symbols)
 // EVALUATE PROGRAM 
 // Função principal para avaliar um programa completo
 // ===================================================
-int evaluate_program(ASTNode* node, SymbolTable* symbols) {
-    if (!node) return 0;
+int evaluate_program(ASTNode* node, ExecutionContext* ctx) {
+    if (!node || !ctx) return 0;
     
     if (node->type == NODE_STATEMENT_LIST) {
-        return execute_statement_list(node, symbols);
+        return execute_statement_list(node, ctx);
     }
     else {
         // Programa com apenas um statement (backward compatibility)
-        return execute_statement(node, symbols);
+        return execute_statement(node, ctx);
     }
 }
 
@@ -422,26 +593,33 @@ int evaluate_program(ASTNode* node, SymbolTable* symbols) {
 // ==================================================================
 // Executa uma lista de statements
 // ==================================================================
-int execute_statement_list(ASTNode* node, SymbolTable* symbols)
+int execute_statement_list(ASTNode* node, ExecutionContext* ctx)
 {
     if (!node || node->type != NODE_STATEMENT_LIST)
     {
+        output_flush(&ctx->output);
         printf("Evaluator error: expected statement list node\n");
         return 0;
     }
     
     StatementListData* list = &node->data.statementlist;
-    int all_success = 1;
+    int all_success = STMT_OK;
     
     // Executa cada statement em sequência
     for (int i = 0; i < list->count; i++)
     {
         ASTNode* stmt = list->statements[i];
-        int success = execute_statement(stmt, symbols);
+        int status = execute_statement(stmt, ctx);
+        
+        // break/continue interrompem a lista e sobem até o while
+        if (status == STMT_BREAK || status == STMT_CONTINUE)
+        {
+            return status;
+        }
         
-        if (!success)
+        if (status == STMT_ERROR)
         {
-            all_success = 0;
+            all_success = STMT_ERROR;
             // Não para no primeiro erro? Decisão de design.
             // Por enquanto, continua executando os outros.
         }
@@ -453,7 +631,7 @@ int execute_statement_list(ASTNode* node, SymbolTable* symbols)
 // ============================================
 // EXECUTE STATEMENT (uses CTX_ANY by default)
 // ============================================
-int execute_statement(ASTNode* node, SymbolTable* symbols)
+int execute_statement(ASTNode* node, ExecutionContext* ctx)
 {
     if (!node) return 0;
     
@@ -461,42 +639,47 @@ int execute_statement(ASTNode* node, SymbolTable* symbols)
     {
         case NODE_ASSIGNMENT: {
             const char* var_name = node->data.assignment.var_name;
+            int slot = node->data.assignment.slot;
             ASTNode* value_node = node->data.assignment.value;
+            Value value;
             
-            // Evaluate value (any type)
-            EvaluatorResult value_result = evaluate_expression(
-                value_node, symbols, CTX_ANY);
-            
-            if (value_result.type == RESULT_ERROR)
-            {
-                printf("%s\n", value_result.error_message);
-                return 0;
-            }
-            
-            // Store based on type
-            if (value_result.type == RESULT_STRING)
+            SymbolValue* symbol = NULL;
+            if (ast_is_self_append(node)) symbol = symbol_table_slot(ctx->symbols, slot);
+            if (symbol && value_is_string(symbol->value))
             {
-                if (!symbol_table_set_string(symbols, var_name, value_result.value.string))
+                // let s = s + x com s string: mesmos passos do caminho
+                // geral, mas x vai direto para o bloco de s se der
+                Value left = evaluate_expression(value_node->data.binaryop.left, ctx, CTX_ANY);
+                Value right = evaluate_expression(value_node->data.binaryop.right, ctx, CTX_ANY);
+                if (!value_is_error(right) && evaluator_append_in_place(ctx, slot, right))
                 {
-                    printf("Evaluator error: assigning string to '%s'\n", var_name);
-                    return 0;
+                    evaluator_release_temps(ctx);
+                    return 1;
                 }
+                value = value_is_error(right) ? right
+                      : apply_binary_op(value_node, ctx, left, right);
+            }
+            else
+            {
+                // Evaluate value (any type)
+                value = evaluate_expression(value_node, ctx, CTX_ANY);
             }
-            else if (value_result.type == RESULT_NUMBER)
+            
+            if (value_is_error(value))
             {
-                if (!symbol_table_set_number(symbols, var_name, value_result.value.number))
-                {
-                    printf("Evaluator error: assigning number to '%s'\n", var_name);
-                    return 0;
-                }
+                evaluator_release_temps(ctx);
+                evaluator_report_error(ctx);
+                return 0;
             }
-            else if (value_result.type == RESULT_BOOL)
-             {  
-                if (!symbol_table_set_bool(symbols, var_name, value_result.value.boolean))
-                {
-                    printf("Evaluator error: assigning boolean to '%s'\n", var_name);
-                    return 0;
-                }
+            
+            // Store (the symbol table checks the type)
+            int stored = symbol_table_slot_set(ctx->symbols, slot, value);
+            evaluator_release_temps(ctx);
+            if (!stored)
+            {
+                output_flush(&ctx->output);
+                printf("Evaluator error: assigning %s to '%s'\n", value_type_name(value), var_name);
+                return 0;
             }
             return 1;
         }
@@ -506,139 +689,138 @@ int execute_statement(ASTNode* node, SymbolTable* symbols)
         case NODE_BINARY_OP:
         case NODE_UNARY_OP:
         case NODE_VARIABLE:
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+        case NODE_NOT_LOGICAL_OP:
+        case NODE_CALL:
+        case NODE_INDEX:
         {
             // Evaluate for display (any type)
-            EvaluatorResult result = evaluate_expression(node, symbols, CTX_ANY);
-            if(result.type == RESULT_ERROR)
+            Value value = evaluate_expression(node, ctx, CTX_ANY);
+            if (value_is_error(value))
             {
-                printf("%s\n", result.error_message);
+                evaluator_release_temps(ctx);
+                evaluator_report_error(ctx);
                 return 0;
             }
-            else
-            {
-                switch(result.type)
-                {
-                    case RESULT_STRING:
-                        printf("\"%s\"\n", result.value.string);
-                        break;
-                    case RESULT_NUMBER:
-                        printf("%g\n", result.value.number);
-                        break;
-                    case RESULT_BOOL:
-                    {
-                        if(result.value.boolean == 1){
-                            printf("true\n");
-                        }
-                        else{
-                            printf("false\n");
-                        }
-                        break;
-                    }
-                }
-                return 1;
-            }
+            evaluator_echo_value(ctx, value, 0);
+            evaluator_release_temps(ctx);
+            return 1;
         }
             
         case NODE_STRING:
         {
             // Standalone string
-            printf("= \"%s\"\n", node->data.string.value);
+            output_flush(&ctx->output);
+            printf("= \"%s\"\n", node->data.string.value->chars);
             return 1;
         }
 
         case NODE_PRINT:
-            return evaluate_print_statement(node, symbols);
+            return evaluate_print_statement(node, ctx);
 
         case NODE_COLOR:
             // Comando nocolor sozinho (ex: "nocolor" como statement)
             // Apenas reseta a cor
-            if (node->data.color.color_token_id == 0) {  // CLR_NOCOLOR
-                reset_current_color();
+            if (node->data.color.code == CLR_NOCOLOR) {
+                evaluator_color_reset(ctx);
                 return 1;
             }
             // Outras cores sozinhas não fazem sentido como statements
+            output_flush(&ctx->output);
             printf("%s[%d:%d] Evaluator warning: color command without print has no effect%s\n",
-                   COLOR_WARNING, node->line, node->column, COLOR_RESET);
+                   output_ansi(COLOR_WARNING), node->line, node->column, output_ansi(COLOR_RESET));
             return 1;
 
 
         case NODE_STATEMENT_LIST:  
-            return execute_statement_list(node, symbols);
+            return execute_statement_list(node, ctx);
 
         case NODE_INPUT:
-            return evaluate_input_statement(node, symbols);
+            return evaluate_input_statement(node, ctx);
 
-        case NODE_COMPARISON_OP:
-        case NODE_LOGICAL_OP:
-        case NODE_NOT_LOGICAL_OP:
-        {
-            // Evaluate logical/comparison expression
-            EvaluatorResult result = evaluate_expression(node, symbols, CTX_ANY);
-            
-            if (result.type == RESULT_ERROR)
-            {
-                printf("%s\n", result.error_message);
-                return 0;
-            }
-            else
-            {
-                // Print the result
-                switch(result.type)
-                {
-                    case RESULT_BOOL:
-                    {
-                        if(result.value.boolean == 1){
-                            printf("true\n");
-                        }
-                        else{
-                            printf("false\n");
-                        }
-                        break;
-                    }
-                    case RESULT_NUMBER:
-                        printf("%g\n", result.value.number);
-                        break;
-                    case RESULT_STRING:
-                        printf("\"%s\"\n", result.value.string);
-                        break;
-                    default:
-                        break;
-                }
-                return 1;
-            }
-        }
+        case NODE_DIM:
+        case NODE_INDEX_ASSIGNMENT:
+            return execute_array_statement(node, ctx);
 
         case NODE_IF:
-            return execute_if_statement(node, symbols);
+            return execute_if_statement(node, ctx);
+
+        case NODE_WHILE:
+            return execute_while_statement(node, ctx);
+
+        case NODE_BREAK:
+            return STMT_BREAK;
+
+        case NODE_CONTINUE:
+            return STMT_CONTINUE;
             
         default:
+            output_flush(&ctx->output);
             printf("Evaluator error: unsupported statement type: %d\n", node->type);
             return 0;
     }
 }
 
 // ============================================
-// EXECUTE PRINT STATEMENT
+// DIM E ATRIBUIÇÃO A ELEMENTO
 // ============================================
-
-// Função pública para avaliar print com contexto
-int evaluate_print_with_context(ASTNode* node, ExecutionContext* ctx)
-{
-    return evaluate_print_statement_with_format(node, ctx);
-}
-
-int evaluate_print_statement(ASTNode* node, SymbolTable* symbols)
+static int execute_array_statement(ASTNode* node, ExecutionContext* ctx)
 {
-    ExecutionContext* ctx = execution_context_create(symbols);
-    if (!ctx) return 0;
+    ArrayData* data = &node->data.array;
+    int success = 0;
     
-    int result = evaluate_print_statement_with_format(node, ctx);
+    // Índice (ou tamanho) e valor em CTX_NUMBER: a mensagem de um tipo
+    // errado é a mesma de uma conta
+    Value index = evaluate_expression(data->index, ctx, CTX_NUMBER);
+    if (value_is_error(index))
+    {
+        evaluator_release_temps(ctx);
+        evaluator_report_error(ctx);
+        return 0;
+    }
     
-    execution_context_destroy(ctx);
-    return result;
+    if (node->type == NODE_DIM)
+    {
+        success = evaluator_dim(ctx, data->slot, index);
+    }
+    else
+    {
+        Value value = evaluate_expression(data->value, ctx, CTX_NUMBER);
+        if (value_is_error(value))
+        {
+            evaluator_release_temps(ctx);
+            evaluator_report_error(ctx);
+            return 0;
+        }
+        
+        Value* item = data->checked ? NULL
+                    : evaluator_array_item(symbol_table_slot(ctx->symbols, data->slot), index);
+        if (item && value_is_number(value))
+        {
+            array_store(item, value);
+            success = 1;
+        }
+        else
+        {
+            success = evaluator_array_set(ctx, data->slot, index, value);
+        }
+    }
+    
+    evaluator_release_temps(ctx);
+    if (!success)
+    {
+        ctx->error.line = node->line;
+        ctx->error.column = node->column;
+        evaluator_report_error(ctx);
+    }
+    return success;
 }
 
-static int evaluate_print_statement_with_format(ASTNode* node, ExecutionContext* ctx)
+// ============================================
+// EXECUTE PRINT STATEMENT
+// ============================================
+int evaluate_print_statement(ASTNode* node, ExecutionContext* ctx)
 {
     if (!node || node->type != NODE_PRINT || !ctx)
     {
@@ -652,12 +834,11 @@ static int evaluate_print_statement_with_format(ASTNode* node, ExecutionContext*
     // Se não tem itens (print vazio) → linha em branco
     if (print_data->count == 0)
     {
-        printf("\n");
+        output_newline(&ctx->output);
         return 1;
     }
     
-    // Salva o formato original
-    OutputFormat original_format = ctx->format;
+    evaluator_print_begin(ctx);
     
     // Avalia e imprime cada item
     for (int i = 0; i < print_data->count; i++)
@@ -671,7 +852,7 @@ static int evaluate_print_statement_with_format(ASTNode* node, ExecutionContext*
         // 1. NODE_COLOR (aplica cor)
         if (item_node->type == NODE_COLOR)
         {
-            evaluator_color_set(ctx, item_node->data.color.ansi_color);
+            evaluator_color_set(ctx, (ColorCode)item_node->data.color.code);
             continue;
         }
         
@@ -685,89 +866,722 @@ static int evaluate_print_statement_with_format(ASTNode* node, ExecutionContext*
         // ======================================================
         // CASO NORMAL: Expressão (número, string, variável, etc)
         // ======================================================
-        EvaluatorResult result = evaluate_expression(item_node, ctx->symbols, CTX_ANY);
-        if (result.type == RESULT_ERROR) {
-            printf("%s\n", result.error_message);
+        Value value = evaluate_expression(item_node, ctx, CTX_ANY);
+        if (value_is_error(value)) {
+            evaluator_release_temps(ctx);
+            evaluator_report_error(ctx);
             return 0;
         }
         
-        // Converte para string
-        char buffer[BUFFER_SIZE];
-        if (result.type == RESULT_BOOL)
-        {
-            // Trata booleano
-            snprintf(buffer, sizeof(buffer), "%s", 
-                     result.value.boolean ? "true" : "false");
-        }
-        else if (result.type == RESULT_STRING)
+        evaluator_print_value(ctx, value);
+        evaluator_release_temps(ctx);  // O texto já está no buffer
+        
+        // Adiciona espaço entre itens (exceto após o último)
+        if (i < print_data->count - 1) {
+            output_char(&ctx->output, ' ');
+        }
+        
+        printed_something = 1;
+    }
+    
+    // Quebra linha se tem newline=1
+    if (print_data->newline) {
+        output_newline(&ctx->output);
+    }
+    
+    return printed_something ? 1 : 0;
+}
+
+// Formata número: inteiro exato ou menor forma que lê de volta igual
+void evaluator_format_number(double num, char* buffer, size_t size)
+{
+    char text[NUMBER_FORMAT_SIZE];
+    size_t length = number_format(num, text);
+
+    if (length >= size) length = size - 1;
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+}
+
+// Cada print começa com cor e formato padrão (o contexto é da sessão)
+void evaluator_print_begin(ExecutionContext* ctx)
+{
+    ctx->current_color = CLR_NOCOLOR;
+    reset_format(ctx);
+}
+
+// Imprime um item do print aplicando width/alinhamento pendentes
+void evaluator_print_text(ExecutionContext* ctx, const char* text)
+{
+    // Aplica formatação se estiver ativa
+    if (ctx->format.has_format && ctx->format.width > 0) {
+        apply_format(&ctx->output, text, &ctx->format);
+        
+        // Reseta formato após aplicar (formato é "consumível")
+        reset_format(ctx);
+    } else {
+        output_text(&ctx->output, text);
+    }
+}
+
+// Converte o valor para texto e imprime como item do print
+void evaluator_print_value(ExecutionContext* ctx, Value value)
+{
+    if (value_is_bool(value))
+    {
+        evaluator_print_text(ctx, value_as_bool(value) ? "true" : "false");
+    }
+    else if (value_is_string(value))
+    {
+        if (ctx->format.has_format && ctx->format.width > 0)
         {
-            snprintf(buffer, sizeof(buffer), "%s", result.value.string);
+            evaluator_print_text(ctx, value_as_string(value));
         }
         else
         {
-            // Formata número sem zeros desnecessários
-            double num = result.value.number;
-            
-            if (fabs(num - (int)num) < EPSILON) {
-                snprintf(buffer, sizeof(buffer), "%d", (int)num);
-            } else {
-                // Remove zeros à direita
-                char temp[NUMBER_SIZE];
-                snprintf(temp, sizeof(temp), "%.10g", num);
-                
-                // Remove .00000 no final
-                char* dot = strchr(temp, '.');
-                if (dot) {
-                    char* end = temp + strlen(temp) - 1;
-                    while (end > dot && *end == '0') {
-                        *end = '\0';
-                        end--;
-                    }
-                    if (*(end) == '.') {
-                        *end = '\0';
+            // Tamanho já conhecido: sem strlen (e sem copiar views)
+            output_write(&ctx->output, value_string_chars(value), value_string_length(value));
+        }
+    }
+    else if (ctx->format.has_format && ctx->format.width > 0)
+    {
+        // Alinhamento precisa do texto pronto para medir
+        char buffer[NUMBER_FORMAT_SIZE];
+        value_format_number(value, buffer);
+        evaluator_print_text(ctx, buffer);
+    }
+    else if (value_is_int(value))
+    {
+        output_integer(&ctx->output, value_as_int(value));
+    }
+    else
+    {
+        output_number(&ctx->output, value_as_number(value));
+    }
+}
+
+// Exibe o resultado de uma expressão solta (modo calculadora)
+void evaluator_echo_value(ExecutionContext* ctx, Value value, int string_literal)
+{
+    output_flush(&ctx->output);
+
+    if (value_is_string(value))
+    {
+        printf(string_literal ? "= \"%.*s\"\n" : "\"%.*s\"\n",
+               (int)value_string_length(value), value_string_chars(value));
+    }
+    else if (value_is_number(value))
+    {
+        char buffer[NUMBER_FORMAT_SIZE];
+        value_format_number(value, buffer);
+        printf("%s\n", buffer);
+    }
+    else if (value_is_bool(value))
+    {
+        printf("%s\n", value_as_bool(value) ? "true" : "false");
+    }
+}
+
+// Atualiza width/alinhamento a partir dos valores já decodificados
+void evaluator_set_width(ExecutionContext* ctx, int width)
+{
+    ctx->format.width = width;
+    ctx->format.has_format = 1;
+}
+
+void evaluator_set_alignment(ExecutionContext* ctx, TokenType alignment_token)
+{
+    ctx->format.align = token_to_alignment(alignment_token);
+    ctx->format.has_format = 1;
+}
+
+// ============================================
+// CAMINHO ESPECIALIZADO: TIPO NÚMERO PROVADO
+// Só para nós com value_type == TYPE_NUMBER (infer_program). Erros
+// possíveis aqui são os que não dependem de tipo: variável sem valor
+// e divisão por zero, que devolvem VALUE_ERROR (raise_error).
+// ============================================
+static Value evaluate_number(ASTNode* node, ExecutionContext* exec)
+{
+    switch (node->type)
+    {
+        case NODE_NUMBER:
+            return node->data.number.value;
+
+        case NODE_VARIABLE:
+        {
+            SymbolValue* symbol = symbol_table_slot(exec->symbols, node->data.variable.slot);
+            if (!symbol || value_is_undefined(symbol->value))
+            {
+                const char* var_name = node->data.variable.var_name;
+                return raise_error(exec, node->line, node->column,
+                     "Evaluator error: variable '%s' not declared. Use 'let %s = value'", 
+                     var_name, var_name);
+            }
+            return symbol->value;
+        }
+
+        case NODE_INDEX:
+        {
+            ASTNode* index_node = node->data.array.index;
+            if (index_node->value_type != TYPE_NUMBER) break;
+
+            Value index = evaluate_number(index_node, exec);
+            if (value_is_error(index)) return index;
+            return apply_index(node, exec, index);
+        }
+
+        case NODE_BINARY_OP:
+        {
+            ASTNode* left_node = node->data.binaryop.left;
+            ASTNode* right_node = node->data.binaryop.right;
+            if (left_node->value_type != TYPE_NUMBER || right_node->value_type != TYPE_NUMBER)
+            {
+                break;  // Operandos sem prova: caminho geral
+            }
+
+            Value left = evaluate_number(left_node, exec);
+            if (value_is_error(left)) return left;
+            Value right = evaluate_number(right_node, exec);
+            if (value_is_error(right)) return right;
+
+            switch (node->data.binaryop.operator)
+            {
+                case '+': return numeric_add(&exec->temps, left, right);
+                case '-': return numeric_subtract(&exec->temps, left, right);
+                case '*': return numeric_multiply(&exec->temps, left, right);
+                case '/':
+                case '\\':
+                case '%':
+                {
+                    Value result = numeric_operation(&exec->temps, node->data.binaryop.operator,
+                                                     left, right);
+                    if (value_is_error(result))
+                    {
+                        return raise_error(exec, node->line, node->column,
+                             "Evaluator error: division by zero");
                     }
+                    return result;
                 }
-                snprintf(buffer, sizeof(buffer), "%s", temp);
             }
+            break;
         }
-        
-        // Aplica formatação se estiver ativa
-        if (ctx->format.has_format && ctx->format.width > 0) {
-            apply_format(buffer, &ctx->format);
-            
-            // Reseta formato após aplicar (formato é "consumível")
-            reset_format(ctx);
-        } else {
-            printf("%s", buffer);
+
+        case NODE_UNARY_OP:
+        {
+            ASTNode* operand = node->data.unaryop.operand;
+            if (operand->value_type != TYPE_NUMBER) break;
+
+            Value value = evaluate_number(operand, exec);
+            if (value_is_error(value)) return value;
+            if (node->data.unaryop.operator == '-') return numeric_negate(&exec->temps, value);
+            if (node->data.unaryop.operator == '+') return value;
+            break;
         }
-        
-        // Adiciona espaço entre itens (exceto após o último)
-        if (i < print_data->count - 1) {
-            printf(" ");
+
+        default:
+            break;
+    }
+
+    return evaluate_expression(node, exec, CTX_NUMBER);
+}
+
+// ============================================
+// QUICKENING
+// O nó sem tipo provado guarda o tipo visto na primeira execução
+// que deu certo. O EvalContext de um nó depende só da posição dele
+// na árvore, então a guarda só precisa conferir o tipo do valor.
+// ============================================
+static QuickKind quick_kind_of(Value value)
+{
+    if (value_is_number(value)) return QUICK_NUMBER;
+    if (value_is_bool(value))   return QUICK_BOOL;
+    if (value_is_string(value)) return QUICK_STRING;
+    return QUICK_GENERIC;
+}
+
+// Operador já validado por uma execução anterior do nó
+static inline int compare_numbers(LogicalOperator op, Value left, Value right)
+{
+    switch (op)
+    {
+        case OP_EQUAL:         return numeric_equal(left, right);
+        case OP_NOT_EQUAL:     return !numeric_equal(left, right);
+        case OP_LESS:          return numeric_less(left, right);
+        case OP_GREATER:       return numeric_less(right, left);
+        case OP_LESS_EQUAL:    return numeric_less_equal(left, right);
+        default:               return numeric_less_equal(right, left);
+    }
+}
+
+// Ordem e igualdade de strings (igualdade com os atalhos de string_equal)
+static inline int compare_strings(LogicalOperator op, const String* left, const String* right)
+{
+    switch (op)
+    {
+        case OP_EQUAL:         return string_equal(left, right);
+        case OP_NOT_EQUAL:     return !string_equal(left, right);
+        case OP_LESS:          return string_compare(left, right) < 0;
+        case OP_GREATER:       return string_compare(left, right) > 0;
+        case OP_LESS_EQUAL:    return string_compare(left, right) <= 0;
+        default:               return string_compare(left, right) >= 0;
+    }
+}
+
+static void quicken(ASTNode* node, ExecutionContext* exec, QuickKind kind)
+{
+    if (node->quick != QUICK_NONE) return;  // Já especializado ou genérico
+    node->quick = (unsigned char)kind;
+    exec->quick.specializations++;
+}
+
+// Operando de um nó QUICK_NUMBER lido sem recursão: literal ou
+// variável especializada como número. 0 = avaliar pelo caminho geral
+static inline int quick_number(ASTNode* node, Value* out)
+{
+    if (node->type == NODE_NUMBER)
+    {
+        *out = node->data.number.value;
+        return 1;
+    }
+    if (node->type == NODE_VARIABLE && node->quick == QUICK_NUMBER)
+    {
+        Value value = node->data.variable.cache->value;
+        if (value_is_number(value))
+        {
+            *out = value;
+            return 1;
         }
-        
-        printed_something = 1;
+    }
+    return 0;
+}
+
+// Guarda falhou: volta ao caminho geral (e desiste depois de várias)
+static void deoptimize(ASTNode* node, ExecutionContext* exec)
+{
+    exec->quick.deopts++;
+    node->deopts++;
+    node->quick = node->deopts >= QUICK_MAX_DEOPTS ? QUICK_GENERIC : QUICK_NONE;
+}
+
+// ============================================
+// OPERADORES COM OS OPERANDOS JÁ AVALIADOS
+// Compartilhados pelo caminho recursivo e por evaluate_deep()
+// ============================================
+static Value apply_binary_op(ASTNode* node, ExecutionContext* exec,
+                             Value left_value, Value right_value)
+{
+    // string + string: concatenação
+    if (node->data.binaryop.operator == '+' &&
+        value_is_string(left_value) && value_is_string(right_value))
+    {
+        return evaluator_concat(exec, left_value, right_value);
+    }
+
+    // Both must be numbers
+    if (value_is_string(left_value) || value_is_string(right_value))
+    {
+        return raise_error(exec, node->line, node->column,
+             "Evaluator error: mathematical operation with string");
+    }
+
+    // Both must be numbers
+    if (value_is_bool(left_value) || value_is_bool(right_value))
+    {
+        return raise_error(exec, node->line, node->column,
+             "Evaluator error: mathematical operation with boolean");
     }
     
-    // Restaura formato original (se necessário)
-    // ctx->format = original_format;
+    Value result;
+    switch (node->data.binaryop.operator)
+    {
+        case '+': 
+            result = numeric_add(&exec->temps, left_value, right_value); 
+            break;
+        case '-': 
+            result = numeric_subtract(&exec->temps, left_value, right_value); 
+            break;
+        case '*': 
+            result = numeric_multiply(&exec->temps, left_value, right_value); 
+            break;
+        case '/': 
+        case '\\':
+        case '%':
+            result = numeric_operation(&exec->temps, node->data.binaryop.operator,
+                                       left_value, right_value);
+            if (value_is_error(result))
+            {
+                return raise_error(exec, node->line, node->column,
+                     "Evaluator error: division by zero");
+            }
+            break;
+        default: 
+            return raise_error(exec, node->line, node->column,
+                 "Evaluator error: invalid operator '%c'", node->data.binaryop.operator);
+    }
     
-    // Quebra linha se tem newline=1
-    if (print_data->newline) {
-        printf("\n");
+    quicken(node, exec, QUICK_NUMBER);
+    return result;
+}
+
+static Value apply_unary_op(ASTNode* node, ExecutionContext* exec, Value operand)
+{
+    if (value_is_string(operand))
+    {
+        return raise_error(exec, node->line, node->column,
+             "Evaluator error: unary operator '-' applied to string");
+    }
+
+    if (value_is_bool(operand))
+    {
+        return raise_error(exec, node->line, node->column,
+             "Evaluator error: mathematical operation with boolean");
     }
     
-    return printed_something ? 1 : 0;
+    switch (node->data.unaryop.operator)
+    {
+        case '+':
+            return operand;  // +x = x
+        case '-':
+            return numeric_negate(&exec->temps, operand); // -x
+        default:
+            return raise_error(exec, node->line, node->column,
+                 "Evaluator error: invalid unary operator '%c'", node->data.unaryop.operator);
+    }
+}
+
+static Value apply_comparison_op(ASTNode* node, ExecutionContext* exec,
+                                 Value left_value, Value right_value)
+{
+    // Ambos devem ser do mesmo tipo
+    if (symbol_type_of(left_value) != symbol_type_of(right_value))
+    {
+        return raise_error(exec, node->line, node->column,
+             "Evaluator error: type mismatch in comparison: cannot compare %s with %s",
+             value_type_name(left_value),
+             value_type_name(right_value));
+    }
+    
+    int comparison_result = 0;
+    
+    // Comparação de strings
+    if (value_is_string(left_value))
+    {
+        switch (node->data.logicalop.operator)
+        {
+            case OP_EQUAL:
+            case OP_NOT_EQUAL:
+            case OP_LESS:
+            case OP_GREATER:
+            case OP_LESS_EQUAL:
+            case OP_GREATER_EQUAL:
+                comparison_result = compare_strings(node->data.logicalop.operator,
+                                                    value_as_string_object(left_value),
+                                                    value_as_string_object(right_value));
+                break;
+            default:
+                return raise_error(exec, node->line, node->column,
+                     "Evaluator error: invalid comparison operator");
+        }
+    }
+    // Comparação de números
+    else if (value_is_number(left_value))
+    {
+        switch (node->data.logicalop.operator)
+        {
+            case OP_EQUAL:
+            case OP_NOT_EQUAL:
+            case OP_LESS:
+            case OP_GREATER:
+            case OP_LESS_EQUAL:
+            case OP_GREATER_EQUAL:
+                comparison_result = compare_numbers(node->data.logicalop.operator,
+                                                    left_value, right_value);
+                break;
+            default:
+                return raise_error(exec, node->line, node->column,
+                     "Evaluator error: invalid comparison operator");
+        }
+    }
+    // Comparação de booleanos
+    else
+    {
+        switch (node->data.logicalop.operator)
+        {
+            case OP_EQUAL:
+                comparison_result = (left_value == right_value) ? 1 : 0;
+                break;
+            case OP_NOT_EQUAL:
+                comparison_result = (left_value != right_value) ? 1 : 0;
+                break;
+            // Outros operadores não fazem sentido para booleanos
+            default:
+                return raise_error(exec, node->line, node->column,
+                     "Evaluator error: operator not supported for boolean values");
+        }
+    }
+    
+    quicken(node, exec, quick_kind_of(left_value));
+    return value_bool(comparison_result);
+}
+
+// Operando de and/or/not: o próprio valor ou o erro
+static Value expect_bool(ASTNode* node, ExecutionContext* exec, Value value,
+                         const char* operator_name)
+{
+    if (value_is_bool(value)) return value;
+    return raise_error(exec, node->line, node->column,
+         "Evaluator error: %s expects boolean, got %s",
+         operator_name, value_type_name(value));
+}
+
+// Função com os argumentos já avaliados: o erro ganha a posição da chamada
+static Value apply_call(ASTNode* node, ExecutionContext* exec, const Value* args)
+{
+    Value result = builtin_call(exec, (BuiltinId)node->data.call.builtin,
+                                args, node->data.call.argc);
+    if (value_is_error(result))
+    {
+        exec->error.line = node->line;
+        exec->error.column = node->column;
+    }
+    return result;
+}
+
+// a(i) com o índice já avaliado. Índice provado (checked == 0) lê
+// direto, sem comparar com o tamanho
+static Value apply_index(ASTNode* node, ExecutionContext* exec, Value index)
+{
+    if (!node->data.array.checked)
+    {
+        Value* item = evaluator_array_item(symbol_table_slot(exec->symbols,
+                                           node->data.array.slot), index);
+        if (item) return *item;
+    }
+    
+    Value element = evaluator_array_get(exec, node->data.array.slot, index);
+    if (value_is_error(element))
+    {
+        exec->error.line = node->line;
+        exec->error.column = node->column;
+    }
+    return element;
+}
+
+// and/or sem curto-circuito: o resultado é o lado direito
+static Value logical_result(ASTNode* node, ExecutionContext* exec, Value right_value)
+{
+    right_value = expect_bool(node, exec, right_value, "logical operator");
+    if (value_is_error(right_value)) return right_value;
+
+    LogicalOperator op = node->data.logicalop.operator;
+    if (op != OP_AND && op != OP_OR)
+    {
+        return raise_error(exec, node->line, node->column,
+             "Evaluator error: invalid logical operator");
+    }
+    return right_value;
+}
+
+// ============================================
+// EXPRESSÕES PROFUNDAS
+// Subárvores mais altas que AST_SHALLOW_HEIGHT são avaliadas aqui,
+// com pilhas de trabalho para os nós pendentes e para os valores:
+// a profundidade fica limitada pela memória, não pela pilha do C.
+// Filhos rasos voltam para evaluate_expression() (recursão limitada),
+// que continua sendo o caminho rápido das expressões comuns.
+// ============================================
+typedef struct
+{
+    ASTNode* node;
+    EvalContext ctx;
+    int state;      // Operandos já avaliados
+} EvalFrame;
+
+static void push_eval(WorkStack* frames, ASTNode* node, EvalContext ctx)
+{
+    EvalFrame* frame = WORK_STACK_PUSH(frames, EvalFrame);
+    frame->node = node;
+    frame->ctx = ctx;
+    frame->state = 0;
+}
+
+static Value pop_value(WorkStack* values)
+{
+    Value value = *WORK_STACK_TOP(values, Value);
+    work_stack_pop(values);
+    return value;
+}
+
+static Value evaluate_deep(ASTNode* node, ExecutionContext* exec, EvalContext ctx)
+{
+    WorkStack frames;
+    WorkStack values;
+    work_stack_init(&frames, sizeof(EvalFrame));
+    work_stack_init(&values, sizeof(Value));
+    push_eval(&frames, node, ctx);
+
+    Value result = VALUE_ERROR;
+    while (!work_stack_empty(&frames))
+    {
+        EvalFrame* frame = WORK_STACK_TOP(&frames, EvalFrame);
+        ASTNode* current = frame->node;
+        int state = frame->state++;
+
+        if (current->height <= AST_SHALLOW_HEIGHT)
+        {
+            result = evaluate_expression(current, exec, frame->ctx);
+        }
+        else switch (current->type)
+        {
+            case NODE_BINARY_OP:
+            {
+                ASTNode* left = current->data.binaryop.left;
+                ASTNode* right = current->data.binaryop.right;
+                EvalContext operand_ctx = current->data.binaryop.operator == '+'
+                                        ? CTX_ANY : CTX_NUMBER;
+                if (state == 0)
+                {
+                    // Operandos com tipo provado dispensam o contexto
+                    if (frame->ctx == CTX_STRING && operand_ctx == CTX_NUMBER &&
+                        (left->value_type != TYPE_NUMBER || right->value_type != TYPE_NUMBER))
+                    {
+                        result = raise_error(exec, current->line, current->column,
+                             "Evaluator error: mathematical operation cannot be used as string");
+                        break;
+                    }
+                    push_eval(&frames, left, operand_ctx);
+                    continue;
+                }
+                if (state == 1)
+                {
+                    push_eval(&frames, right, operand_ctx);
+                    continue;
+                }
+                Value right_value = pop_value(&values);
+                result = apply_binary_op(current, exec, pop_value(&values), right_value);
+                break;
+            }
+
+            case NODE_UNARY_OP:
+                if (state == 0)
+                {
+                    if (frame->ctx == CTX_STRING)
+                    {
+                        result = raise_error(exec, current->line, current->column,
+                             "Evaluator error: unary operator cannot be applied to string");
+                        break;
+                    }
+                    push_eval(&frames, current->data.unaryop.operand, CTX_NUMBER);
+                    continue;
+                }
+                result = apply_unary_op(current, exec, pop_value(&values));
+                break;
+
+            case NODE_COMPARISON_OP:
+                if (state < 2)
+                {
+                    push_eval(&frames, state == 0 ? current->data.logicalop.left
+                                                  : current->data.logicalop.right, CTX_ANY);
+                    continue;
+                }
+                {
+                    Value right_value = pop_value(&values);
+                    result = apply_comparison_op(current, exec, pop_value(&values), right_value);
+                }
+                break;
+
+            case NODE_LOGICAL_OP:
+                if (state == 0)
+                {
+                    push_eval(&frames, current->data.logicalop.left, CTX_BOOL);
+                    continue;
+                }
+                if (state == 1)
+                {
+                    result = expect_bool(current, exec, pop_value(&values), "logical operator");
+                    if (value_is_error(result)) break;
+
+                    // Curto-circuito
+                    LogicalOperator op = current->data.logicalop.operator;
+                    if ((op == OP_AND && !value_as_bool(result)) ||
+                        (op == OP_OR && value_as_bool(result)))
+                    {
+                        break;
+                    }
+                    push_eval(&frames, current->data.logicalop.right, CTX_BOOL);
+                    continue;
+                }
+                result = logical_result(current, exec, pop_value(&values));
+                break;
+
+            case NODE_NOT_LOGICAL_OP:
+                if (state == 0)
+                {
+                    push_eval(&frames, current->data.notop.operand, CTX_BOOL);
+                    continue;
+                }
+                result = expect_bool(current, exec, pop_value(&values), "NOT operator");
+                if (!value_is_error(result)) result = value_bool(!value_as_bool(result));
+                break;
+
+            case NODE_CALL:
+                if (state < current->data.call.argc)
+                {
+                    push_eval(&frames, current->data.call.args[state], CTX_ANY);
+                    continue;
+                }
+                {
+                    Value args[CALL_MAX_ARGS];
+                    for (int i = current->data.call.argc - 1; i >= 0; i--)
+                    {
+                        args[i] = pop_value(&values);
+                    }
+                    result = apply_call(current, exec, args);
+                }
+                break;
+
+            case NODE_INDEX:
+                if (state == 0)
+                {
+                    push_eval(&frames, current->data.array.index, CTX_NUMBER);
+                    continue;
+                }
+                result = apply_index(current, exec, pop_value(&values));
+                break;
+
+            default:
+                // Folhas têm altura 0; nunca chegam aqui
+                result = raise_error(exec, current->line, current->column,
+                     "Evaluator error: unsupported node type: %d", current->type);
+                break;
+        }
+
+        // Nó concluído: o erro (já no slot) interrompe a expressão inteira
+        work_stack_pop(&frames);
+        if (value_is_error(result)) break;
+        *WORK_STACK_PUSH(&values, Value) = result;
+    }
+
+    work_stack_free(&frames);
+    work_stack_free(&values);
+    return result;
 }
 
 // ============================================
 // EVALUATE EXPRESSIONS (with context)
 // ============================================
-EvaluatorResult evaluate_expression(ASTNode* node, SymbolTable* symbols, EvalContext ctx)
+Value evaluate_expression(ASTNode* node, ExecutionContext* exec, EvalContext ctx)
 {
     if (node == NULL)
     {
-        return create_error_result("Evaluator error: AST node is null", 0, 0);
+        return raise_error(exec, 0, 0, "Evaluator error: AST node is null");
+    }
+    
+    // Expressão mais funda que o limite de recursão
+    if (node->height > AST_SHALLOW_HEIGHT)
+    {
+        return evaluate_deep(node, exec, ctx);
     }
     
     switch (node->type)
@@ -777,144 +1591,174 @@ EvaluatorResult evaluate_expression(ASTNode* node, SymbolTable* symbols, EvalCon
         {
             if (ctx == CTX_STRING)
             {
-                return create_error_result_fmt(node->line, node->column,
+                return raise_error(exec, node->line, node->column,
                      "Evaluator error: boolean cannot be used as string");
             }
-            return create_success_result_bool(node->data.boolean.value, 
-                                               node->line, node->column);
+            return value_bool(node->data.boolean.value);
         }
 
         case NODE_NUMBER:
         {
             if (ctx == CTX_STRING)
             {
-                return create_error_result_fmt(node->line, node->column,
+                return raise_error(exec, node->line, node->column,
                      "Evaluator error: number cannot be used as string");
             }
-            return create_success_result_number(node->data.number.value, 
-                                               node->line, node->column);
+            return node->data.number.value;
         }
             
         case NODE_VARIABLE:
         {
+            // Especializado: leitura pelo endereço guardado. Uma variável
+            // com valor nunca volta a ficar sem valor nem muda de tipo
+            if (node->quick != QUICK_NONE && node->quick != QUICK_GENERIC)
+            {
+                Value value = node->data.variable.cache->value;
+                if (quick_kind_of(value) == node->quick) return value;
+                deoptimize(node, exec);
+            }
+            
             const char* var_name = node->data.variable.var_name;
             
+            // Acesso direto pelo slot (resolve_program)
+            SymbolValue* symbol = symbol_table_slot(exec->symbols, node->data.variable.slot);
+            
             // Check if exists
-            if (!symbol_table_exists(symbols, var_name))
+            if (!symbol || value_is_undefined(symbol->value))
             {
-                return create_error_result_fmt(node->line, node->column,
+                return raise_error(exec, node->line, node->column,
                      "Evaluator error: variable '%s' not declared. Use 'let %s = value'", 
                      var_name, var_name);
             }
             
-            // Try as number
-            double num_value;
-            if (symbol_table_get_number(symbols, var_name, &num_value))
+            Value value = symbol->value;
+            
+            if (value_is_number(value))
             {
                 if (ctx == CTX_STRING)
                 {
-                    return create_error_result_fmt(node->line, node->column,
+                    return raise_error(exec, node->line, node->column,
                          "Evaluator error: variable '%s' is a number, cannot be used as string", 
                          var_name);
                 }
-                return create_success_result_number(num_value, node->line, node->column);
+                node->data.variable.cache = symbol;
+                quicken(node, exec, QUICK_NUMBER);
+                return value;
             }
-            
-            // Try as string
-            char str_value[STRING_SIZE];
-            if (symbol_table_get_string(symbols, var_name, str_value, sizeof(str_value)))
+                    
+            if (value_is_string(value))
             {
                 if (ctx == CTX_NUMBER)
                 {
-                    return create_error_result_fmt(node->line, node->column,
+                    return raise_error(exec, node->line, node->column,
                          "Evaluator error: variable '%s' is a string, cannot be used in mathematical operation", 
                          var_name);
                 }
-                return create_success_result_string(str_value, node->line, node->column);
+                node->data.variable.cache = symbol;
+                quicken(node, exec, QUICK_STRING);
+                return value;
             }
-
-            // Try as boolean
-            int bool_value;
-            if (symbol_table_get_bool(symbols, var_name, &bool_value))
+                    
+            if (value_is_bool(value))
             {
                 if (ctx == CTX_NUMBER)
                 {
-                    return create_error_result_fmt(node->line, node->column,
+                    return raise_error(exec, node->line, node->column,
                          "Evaluator error: variable '%s' is a boolean, cannot be used in mathematical operation", 
                          var_name);
                 }
                 if (ctx == CTX_STRING)
                 {
-                    return create_error_result_fmt(node->line, node->column,
+                    return raise_error(exec, node->line, node->column,
                          "Evaluator error: variable '%s' is a boolean, cannot be used as string", 
                          var_name);
                 }
-                return create_success_result_bool(bool_value, node->line, node->column);
-            }      
+                node->data.variable.cache = symbol;
+                quicken(node, exec, QUICK_BOOL);
+                return value;
+            }
+            
+            if (value_is_array(value))
+            {
+                return raise_error(exec, node->line, node->column,
+                     "Evaluator error: variable '%s' is an array, use %s(index)",
+                     var_name, var_name);
+            }
             
             // Should not reach here
-            return create_error_result_fmt(node->line, node->column,
+            return raise_error(exec, node->line, node->column,
                  "Evaluator error: internal error: unknown variable type '%s'", var_name);
         }
             
         case NODE_BINARY_OP:
         {
-            // Binary operations always expect numbers (for now)
-            if (ctx == CTX_STRING)
+            // Operandos com tipo provado: sem Value e sem checagens
+            if (node->data.binaryop.left->value_type == TYPE_NUMBER &&
+                node->data.binaryop.right->value_type == TYPE_NUMBER)
             {
-                return create_error_result_fmt(node->line, node->column,
-                     "Evaluator error: mathematical operation cannot be used as string");
+                return evaluate_number(node, exec);
             }
             
-            // Evaluate operands in number context
-            EvaluatorResult left_result = evaluate_expression(
-                node->data.binaryop.left, symbols, CTX_NUMBER);
-            if (left_result.type == RESULT_ERROR) return left_result;
-            
-            EvaluatorResult right_result = evaluate_expression(
-                node->data.binaryop.right, symbols, CTX_NUMBER);
-            if (right_result.type == RESULT_ERROR) return right_result;
-            
-            // Both must be numbers
-            if (left_result.type == RESULT_STRING || right_result.type == RESULT_STRING )
+            // Só '+' (concatenação) produz string
+            char op = node->data.binaryop.operator;
+            if (ctx == CTX_STRING && op != '+')
             {
-                return create_error_result("Evaluator error: mathematical operation with string", 
-                                         node->line, node->column);
+                return raise_error(exec, node->line, node->column,
+                     "Evaluator error: mathematical operation cannot be used as string");
             }
-
-            // Both must be numbers
-            if (left_result.type == RESULT_BOOL || right_result.type == RESULT_BOOL )
+            
+            // Especializado número-número com folhas: sem avaliar os filhos
+            if (node->quick == QUICK_NUMBER)
             {
-                return create_error_result("Evaluator error: mathematical operation with boolean", 
-                                         node->line, node->column);
+                Value left, right;
+                if (quick_number(node->data.binaryop.left, &left) &&
+                    quick_number(node->data.binaryop.right, &right))
+                {
+                    switch (node->data.binaryop.operator)
+                    {
+                        case '+': return numeric_add(&exec->temps, left, right);
+                        case '-': return numeric_subtract(&exec->temps, left, right);
+                        case '*': return numeric_multiply(&exec->temps, left, right);
+                        default:
+                        {
+                            Value result = numeric_operation(&exec->temps, op, left, right);
+                            if (!value_is_error(result)) return result;
+                            break;  // Divisão por zero: erro pelo caminho geral
+                        }
+                    }
+                }
             }
             
-            double result;
-            switch (node->data.binaryop.operator)
+            // Operandos em contexto numérico; os de '+' podem ser strings
+            EvalContext operand_ctx = op == '+' ? CTX_ANY : CTX_NUMBER;
+            Value left_value = evaluate_expression(
+                node->data.binaryop.left, exec, operand_ctx);
+            if (value_is_error(left_value)) return left_value;
+            
+            Value right_value = evaluate_expression(
+                node->data.binaryop.right, exec, operand_ctx);
+            if (value_is_error(right_value)) return right_value;
+            
+            // Especializado com operandos compostos: uma guarda para os dois
+            if (node->quick == QUICK_NUMBER)
             {
-                case '+': 
-                    result = left_result.value.number + right_result.value.number; 
-                    break;
-                case '-': 
-                    result = left_result.value.number - right_result.value.number; 
-                    break;
-                case '*': 
-                    result = left_result.value.number * right_result.value.number; 
-                    break;
-                case '/': 
-                    if (fabs(right_result.value.number) < EPSILON)
+                if (value_is_number(left_value) && value_is_number(right_value))
+                {
+                    switch (node->data.binaryop.operator)
                     {
-                        return create_error_result_fmt(node->line, node->column,
-                             "Evaluator error: division by zero");
+                        case '+': return numeric_add(&exec->temps, left_value, right_value);
+                        case '-': return numeric_subtract(&exec->temps, left_value, right_value);
+                        case '*': return numeric_multiply(&exec->temps, left_value, right_value);
+                        default:  break;  // '/', '\', '%': divisão por zero abaixo
                     }
-                    result = left_result.value.number / right_result.value.number; 
-                    break;
-                default: 
-                    return create_error_result_fmt(node->line, node->column,
-                         "Evaluator error: invalid operator '%c'", node->data.binaryop.operator);
+                }
+                else
+                {
+                    deoptimize(node, exec);
+                }
             }
             
-            return create_success_result_number(result, node->line, node->column);
+            return apply_binary_op(node, exec, left_value, right_value);
         }
             
         case NODE_UNARY_OP:
@@ -922,50 +1766,30 @@ EvaluatorResult evaluate_expression(ASTNode* node, SymbolTable* symbols, EvalCon
             // Unary operations always expect numbers
             if (ctx == CTX_STRING)
             {
-                return create_error_result_fmt(node->line, node->column,
+                return raise_error(exec, node->line, node->column,
                      "Evaluator error: unary operator cannot be applied to string");
             }
             
-            EvaluatorResult operand_result = evaluate_expression(
-                node->data.unaryop.operand, symbols, CTX_NUMBER);
-            if (operand_result.type == RESULT_ERROR)  return operand_result;
+            Value operand = evaluate_expression(
+                node->data.unaryop.operand, exec, CTX_NUMBER);
+            if (value_is_error(operand))  return operand;
             
-            if (operand_result.type == RESULT_STRING )
-            {
-                return create_error_result("Evaluator error: unary operator '-' applied to string", 
-                                         node->line, node->column);
-            }
-            
-            double result;
-            switch (node->data.unaryop.operator)
-            {
-                case '+':
-                    result = operand_result.value.number;  // +x = x
-                    break;
-                case '-':
-                    result = -operand_result.value.number; // -x
-                    break;
-                default:
-                    return create_error_result_fmt(node->line, node->column,
-                         "Evaluator error: invalid unary operator '%c'", node->data.unaryop.operator);
-            }
-            
-            return create_success_result_number(result, node->line, node->column);
+            return apply_unary_op(node, exec, operand);
         }
             
         case NODE_STRING:
         {
             if (ctx == CTX_NUMBER)
             {
-                return create_error_result_fmt(node->line, node->column,
+                return raise_error(exec, node->line, node->column,
                      "Evaluator error: string cannot be used as number");
             }
-            return create_success_result_string(node->data.string.value, 
-                                               node->line, node->column);
+            // Referência ao texto guardado na AST (sem cópia)
+            return value_string(node->data.string.value);
         }
 
         case NODE_STATEMENT_LIST:
-            return create_error_result_fmt(node->line, node->column,
+            return raise_error(exec, node->line, node->column,
                  "Evaluator error: statement list cannot be used as expression");
 
         case NODE_COMPARISON_OP:
@@ -973,88 +1797,84 @@ EvaluatorResult evaluate_expression(ASTNode* node, SymbolTable* symbols, EvalCon
             // Operações de comparação: ==, !=, <, >, <=, >=
             // Resultado é sempre booleano
             
-            // Avalia lado esquerdo (pode ser número ou booleano)
-            EvaluatorResult left_result = evaluate_expression(
-                node->data.logicalop.left, symbols, CTX_ANY);
-            if (left_result.type == RESULT_ERROR) return left_result;
-            
-            // Avalia lado direito (pode ser número ou booleano)
-            EvaluatorResult right_result = evaluate_expression(
-                node->data.logicalop.right, symbols, CTX_ANY);
-            if (right_result.type == RESULT_ERROR) return right_result;
-            
-            // Ambos devem ser do mesmo tipo (número ou booleano)
-            if (left_result.type != right_result.type)
-            {
-                return create_error_result_fmt(node->line, node->column,
-                     "Evaluator error: type mismatch in comparison: cannot compare %s with %s",
-                     (left_result.type == RESULT_NUMBER ? "number" : "boolean"),
-                     (right_result.type == RESULT_NUMBER ? "number" : "boolean"));
-            }
-            
-            // Strings não podem ser comparadas (por enquanto)
-            if (left_result.type == RESULT_STRING)
-            {
-                return create_error_result_fmt(node->line, node->column,
-                     "Evaluator error: string comparison not supported");
-            }
-            
-            int comparison_result = 0;
-            
-            // Comparação de números
-            if (left_result.type == RESULT_NUMBER)
+            // Dois números provados: compara direto
+            if (node->data.logicalop.left->value_type == TYPE_NUMBER &&
+                node->data.logicalop.right->value_type == TYPE_NUMBER)
             {
-                double left = left_result.value.number;
-                double right = right_result.value.number;
+                Value left = evaluate_number(node->data.logicalop.left, exec);
+                if (value_is_error(left)) return left;
+                Value right = evaluate_number(node->data.logicalop.right, exec);
+                if (value_is_error(right)) return right;
                 
                 switch (node->data.logicalop.operator)
                 {
                     case OP_EQUAL:
-                        comparison_result = (fabs(left - right) < EPSILON) ? 1 : 0;
-                        break;
                     case OP_NOT_EQUAL:
-                        comparison_result = (fabs(left - right) >= EPSILON) ? 1 : 0;
-                        break;
                     case OP_LESS:
-                        comparison_result = (left < right) ? 1 : 0;
-                        break;
                     case OP_GREATER:
-                        comparison_result = (left > right) ? 1 : 0;
-                        break;
                     case OP_LESS_EQUAL:
-                        comparison_result = (left <= right) ? 1 : 0;
-                        break;
                     case OP_GREATER_EQUAL:
-                        comparison_result = (left >= right) ? 1 : 0;
-                        break;
+                        return value_bool(compare_numbers(node->data.logicalop.operator,
+                                                          left, right));
                     default:
-                        return create_error_result_fmt(node->line, node->column,
+                        return raise_error(exec, node->line, node->column,
                              "Evaluator error: invalid comparison operator");
                 }
             }
-            // Comparação de booleanos
-            else if (left_result.type == RESULT_BOOL)
+            
+            // Especializado número-número com folhas: sem avaliar os filhos
+            if (node->quick == QUICK_NUMBER)
             {
-                int left = left_result.value.boolean;
-                int right = right_result.value.boolean;
-                
-                switch (node->data.logicalop.operator)
+                Value left, right;
+                if (quick_number(node->data.logicalop.left, &left) &&
+                    quick_number(node->data.logicalop.right, &right))
                 {
-                    case OP_EQUAL:
-                        comparison_result = (left == right) ? 1 : 0;
-                        break;
-                    case OP_NOT_EQUAL:
-                        comparison_result = (left != right) ? 1 : 0;
-                        break;
-                    // Outros operadores não fazem sentido para booleanos
-                    default:
-                        return create_error_result_fmt(node->line, node->column,
-                             "Evaluator error: operator not supported for boolean values");
+                    return value_bool(compare_numbers(node->data.logicalop.operator,
+                                                      left, right));
                 }
             }
             
-            return create_success_result_bool(comparison_result, 
-                                             node->line, node->column);
+            // Avalia lado esquerdo (pode ser número ou booleano)
+            Value left_value = evaluate_expression(
+                node->data.logicalop.left, exec, CTX_ANY);
+            if (value_is_error(left_value)) return left_value;
+            
+            // Avalia lado direito (pode ser número ou booleano)
+            Value right_value = evaluate_expression(
+                node->data.logicalop.right, exec, CTX_ANY);
+            if (value_is_error(right_value)) return right_value;
+            
+            // Especializado pelo tipo visto: só == e != chegam a QUICK_BOOL
+            if (node->quick == QUICK_NUMBER)
+            {
+                if (value_is_number(left_value) && value_is_number(right_value))
+                {
+                    return value_bool(compare_numbers(node->data.logicalop.operator,
+                                                      left_value, right_value));
+                }
+                deoptimize(node, exec);
+            }
+            else if (node->quick == QUICK_BOOL)
+            {
+                if (value_is_bool(left_value) && value_is_bool(right_value))
+                {
+                    int equal = (left_value == right_value);
+                    return value_bool(node->data.logicalop.operator == OP_EQUAL ? equal : !equal);
+                }
+                deoptimize(node, exec);
+            }
+            else if (node->quick == QUICK_STRING)
+            {
+                if (value_is_string(left_value) && value_is_string(right_value))
+                {
+                    return value_bool(compare_strings(node->data.logicalop.operator,
+                                                      value_as_string_object(left_value),
+                                                      value_as_string_object(right_value)));
+                }
+                deoptimize(node, exec);
+            }
+            
+            return apply_comparison_op(node, exec, left_value, right_value);
         }
 
         case NODE_LOGICAL_OP:
@@ -1065,318 +1885,639 @@ EvaluatorResult evaluate_expression(ASTNode* node, SymbolTable* symbols, EvalCon
             LogicalOperator op = node->data.logicalop.operator;
             
             // Avalia lado esquerdo (deve ser booleano)
-            EvaluatorResult left_result = evaluate_expression(
-                node->data.logicalop.left, symbols, CTX_BOOL);
-            if (left_result.type == RESULT_ERROR) return left_result;
+            Value left_value = evaluate_expression(
+                node->data.logicalop.left, exec, CTX_BOOL);
+            if (value_is_error(left_value)) return left_value;
             
             // Verifica se é booleano
-            if (left_result.type != RESULT_BOOL)
-            {
-                return create_error_result_fmt(node->line, node->column,
-                     "Evaluator error: logical operator expects boolean, got %s",
-                     (left_result.type == RESULT_NUMBER ? "number" : "string"));
-            }
+            left_value = expect_bool(node, exec, left_value, "logical operator");
+            if (value_is_error(left_value)) return left_value;
             
-            int left = left_result.value.boolean;
+            int left = value_as_bool(left_value);
             
             // OTIMIZAÇÃO: Short-circuit evaluation
             // Se é AND e left é false, não precisa avaliar right
             if (op == OP_AND && !left)
             {
-                return create_success_result_bool(0, node->line, node->column);
+                return VALUE_FALSE;
             }
             
             // Se é OR e left é true, não precisa avaliar right
             if (op == OP_OR && left)
             {
-                return create_success_result_bool(1, node->line, node->column);
+                return VALUE_TRUE;
             }
             
             // Avalia lado direito (deve ser booleano)
-            EvaluatorResult right_result = evaluate_expression(
-                node->data.logicalop.right, symbols, CTX_BOOL);
-            if (right_result.type == RESULT_ERROR) return right_result;
+            Value right_value = evaluate_expression(
+                node->data.logicalop.right, exec, CTX_BOOL);
+            if (value_is_error(right_value)) return right_value;
+            
+            // Com o curto-circuito acima, o resultado é o lado direito
+            return logical_result(node, exec, right_value);
+        }
+
+        case NODE_NOT_LOGICAL_OP:
+        {
+            // Operação lógica unária: NOT (!)
+            // Resultado é sempre booleano
+            
+            // Avalia operando (deve ser booleano)
+            Value operand = evaluate_expression(
+                node->data.notop.operand, exec, CTX_BOOL);
+            if (value_is_error(operand)) return operand;
             
             // Verifica se é booleano
-            if (right_result.type != RESULT_BOOL)
+            operand = expect_bool(node, exec, operand, "NOT operator");
+            if (value_is_error(operand)) return operand;
+            
+            return value_bool(!value_as_bool(operand));  // Inverte o valor
+        }
+
+        case NODE_CALL:
+        {
+            // Argumentos em CTX_ANY: os tipos são conferidos por builtin_call
+            Value args[CALL_MAX_ARGS];
+            for (int i = 0; i < node->data.call.argc; i++)
             {
-                return create_error_result_fmt(node->line, node->column,
-                     "Evaluator error: logical operator expects boolean, got %s",
-                     (right_result.type == RESULT_NUMBER ? "number" : "string"));
+                args[i] = evaluate_expression(node->data.call.args[i], exec, CTX_ANY);
+                if (value_is_error(args[i])) return args[i];
             }
+            return apply_call(node, exec, args);
+        }
+
+        case NODE_INDEX:
+        {
+            // Elementos são sempre numbers: o contexto não muda nada
+            Value index = evaluate_expression(node->data.array.index, exec, CTX_NUMBER);
+            if (value_is_error(index)) return index;
+            return apply_index(node, exec, index);
+        }
             
-            int right = right_result.value.boolean;
-            int logical_result = 0;
             
-            switch (op)
+        default:
+            return raise_error(exec, node->line, node->column,
+                 "Evaluator error: unsupported node type: %d", node->type);
+    }
+}
+
+
+// ============================================
+// DEBUG DO QUICKENING
+// ============================================
+static const char* quick_kind_name(QuickKind kind)
+{
+    switch (kind)
+    {
+        case QUICK_NUMBER:  return "number";
+        case QUICK_BOOL:    return "boolean";
+        case QUICK_STRING:  return "string";
+        case QUICK_GENERIC: return "generic";
+        default:            return "-";
+    }
+}
+
+static void dump_quick_node(ASTNode* node)
+{
+    if (node->quick == QUICK_NONE && node->deopts == 0) return;
+
+    printf("[%d:%d] ", node->line, node->column);
+    if (node->type == NODE_VARIABLE)
+        printf("VARIABLE %s", node->data.variable.var_name);
+    else if (node->type == NODE_BINARY_OP)
+        printf("BINARY_OP '%c'", node->data.binaryop.operator);
+    else
+        printf("COMPARISON_OP %s",
+               logical_operator_name(node->data.logicalop.operator));
+    printf(": %s, %d deopt(s)\n",
+           quick_kind_name((QuickKind)node->quick), node->deopts);
+}
+
+// Empilha os filhos em ordem inversa (o primeiro sai primeiro)
+static void push_quick_children(WorkStack* pending, ASTNode* node)
+{
+    ASTNode* children[3] = { NULL, NULL, NULL };
+    ASTNode** list = NULL;
+    int count = 0;
+
+    switch (node->type)
+    {
+        case NODE_BINARY_OP:
+            children[0] = node->data.binaryop.left;
+            children[1] = node->data.binaryop.right;
+            break;
+
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+            children[0] = node->data.logicalop.left;
+            children[1] = node->data.logicalop.right;
+            break;
+
+        case NODE_UNARY_OP:
+            children[0] = node->data.unaryop.operand;
+            break;
+
+        case NODE_NOT_LOGICAL_OP:
+            children[0] = node->data.notop.operand;
+            break;
+
+        case NODE_CALL:
+            for (int i = 0; i < node->data.call.argc; i++)
             {
-                case OP_AND:
-                    logical_result = left && right;
-                    break;
-                case OP_OR:
-                    logical_result = left || right;
-                    break;
-                default:
-                    return create_error_result_fmt(node->line, node->column,
-                         "Evaluator error: invalid logical operator");
+                children[i] = node->data.call.args[i];
             }
-            
-            return create_success_result_bool(logical_result, 
-                                             node->line, node->column);
-        }
+            break;
+
+        case NODE_DIM:
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGNMENT:
+            children[0] = node->data.array.index;
+            children[1] = node->data.array.value;
+            break;
+
+        case NODE_ASSIGNMENT:
+            children[0] = node->data.assignment.value;
+            break;
+
+        case NODE_STATEMENT_LIST:
+            list = node->data.statementlist.statements;
+            count = node->data.statementlist.count;
+            break;
+
+        case NODE_PRINT:
+            list = node->data.printstatement.items;
+            count = node->data.printstatement.count;
+            break;
 
-        case NODE_NOT_LOGICAL_OP:
+        case NODE_IF:
+            children[0] = node->data.ifstatement.condition;
+            children[1] = node->data.ifstatement.then_body;
+            children[2] = node->data.ifstatement.else_body;
+            break;
+
+        case NODE_WHILE:
+            children[0] = node->data.whilestatement.condition;
+            children[1] = node->data.whilestatement.body;
+            break;
+
+        default:
+            break;
+    }
+
+    for (int i = count - 1; i >= 0; i--)
+    {
+        *WORK_STACK_PUSH(pending, ASTNode*) = list[i];
+    }
+    for (int i = 2; i >= 0; i--)
+    {
+        if (children[i]) *WORK_STACK_PUSH(pending, ASTNode*) = children[i];
+    }
+}
+
+// Totais da sessão e, em ordem de fonte, os nós especializados
+void evaluator_dump_quickening(ASTNode* ast, ExecutionContext* ctx)
+{
+    output_flush(&ctx->output);
+    printf("Quickening: %zu specialization(s), %zu deopt(s)\n",
+           ctx->quick.specializations, ctx->quick.deopts);
+    if (!ast) return;
+
+    // Pré-ordem com pilha explícita (expressões podem ser muito fundas)
+    WorkStack pending;
+    work_stack_init(&pending, sizeof(ASTNode*));
+    *WORK_STACK_PUSH(&pending, ASTNode*) = ast;
+
+    while (!work_stack_empty(&pending))
+    {
+        ASTNode* node = *WORK_STACK_TOP(&pending, ASTNode*);
+        work_stack_pop(&pending);
+
+        if (node->type == NODE_VARIABLE || node->type == NODE_BINARY_OP ||
+            node->type == NODE_COMPARISON_OP)
         {
-            // Operação lógica unária: NOT (!)
-            // Resultado é sempre booleano
-            
-            // Avalia operando (deve ser booleano)
-            EvaluatorResult operand_result = evaluate_expression(
-                node->data.notop.operand, symbols, CTX_BOOL);
-            if (operand_result.type == RESULT_ERROR) return operand_result;
-            
-            // Verifica se é booleano
-            if (operand_result.type != RESULT_BOOL)
-            {
-                return create_error_result_fmt(node->line, node->column,
-                     "Evaluator error: NOT operator expects boolean, got %s",
-                     (operand_result.type == RESULT_NUMBER ? "number" : "string"));
-            }
-            
-            int operand = operand_result.value.boolean;
-            int not_result = !operand;  // Inverte o valor
-            
-            return create_success_result_bool(not_result, 
-                                             node->line, node->column);
+            dump_quick_node(node);
         }
-            
-        default:
-            return create_error_result_fmt(node->line, node->column,
-                 "Evaluator error: unsupported node type: %d", node->type);
+        push_quick_children(&pending, node);
     }
+
+    work_stack_free(&pending);
 }
 
 
 // Old function (for compatibility)
-EvaluatorResult evaluate(ASTNode* node)
+Value evaluate(ASTNode* node)
 {
-    SymbolTable* symbols = symbol_table_create();
-    if (!symbols)
+    ExecutionContext* exec = execution_context_create();
+    
+    Value result = evaluate_expression(node, exec, CTX_ANY);
+    if (value_is_error(result))
     {
-        return create_error_result("Evaluator error: could not create symbol table", 0, 0);
+        evaluator_report_error(exec);
     }
     
-    EvaluatorResult result = evaluate_expression(node, symbols, CTX_ANY);
-    symbol_table_destroy(symbols);
+    execution_context_destroy(exec);
     return result;
 }
 
 
-// evaluator.c - ADICIONAR estas implementações
-
-// Funções de gerenciamento de cores com contexto
+// =================================================
+// CORES (estado do contexto, não há cor global)
+// =================================================
 void evaluator_color_reset(ExecutionContext* ctx)
 {
-    if (ctx) {
-        ctx->current_color = "";
-        if (ctx->color_enabled) {
-            printf("%s", COLOR_RESET);
-        }
-    } else {
-        reset_current_color();
+    ctx->current_color = CLR_NOCOLOR;
+    if (ctx->color_enabled) {
+        output_text(&ctx->output, COLOR_RESET);
     }
 }
 
-void evaluator_color_set(ExecutionContext* ctx, const char* ansi_color)
+void evaluator_color_set(ExecutionContext* ctx, ColorCode color)
 {
-    if (!ctx) {
-        apply_color(ansi_color);
-        return;
-    }
-    
     if (!ctx->color_enabled) return;
     
     // Se é nocolor (reset)
-    if (ansi_color[0] == '\0' || strcmp(ansi_color, "\033[0m") == 0) {
+    if (color == CLR_NOCOLOR) {
         evaluator_color_reset(ctx);
         return;
     }
     
     // Se é a mesma cor já aplicada, não faz nada
-    if (strcmp(ctx->current_color, ansi_color) == 0) {
+    if (ctx->current_color == color) {
         return;
     }
     
     // Aplica a nova cor
-    printf("%s", ansi_color);
-    ctx->current_color = ansi_color;
+    output_text(&ctx->output, color_code_to_ansi(color));
+    ctx->current_color = color;
 }
 
 void evaluator_color_apply_current(ExecutionContext* ctx)
 {
-    if (!ctx) return;
+    if (ctx->color_enabled && ctx->current_color != CLR_NOCOLOR) {
+        output_text(&ctx->output, color_code_to_ansi(ctx->current_color));
+    }
+}
+
+int execute_if_statement(ASTNode* node, ExecutionContext* ctx)
+{
+    if (!node || !ctx) return 0;
+    
+    // Evaluate condition
+    Value condition = evaluate_expression(node->data.ifstatement.condition,
+                                          ctx, CTX_BOOL);
+    evaluator_release_temps(ctx);  // Só o tipo e o booleano importam
+    
+    if (value_is_error(condition))
+    {
+        evaluator_report_error(ctx);
+        return 0;
+    }
+
+    if (!value_is_bool(condition))
+    {
+        raise_error(ctx, node->line, node->column,
+             "Evaluator error: condition must be boolean, got %s",
+             value_type_name(condition));
+        evaluator_report_error(ctx);
+        return 0;
+    }
     
-    if (ctx->color_enabled && ctx->current_color && ctx->current_color[0] != '\0') {
-        printf("%s", ctx->current_color);
+    // Execute appropriate branch
+    if (value_as_bool(condition))
+    {
+        // Execute THEN body
+        return execute_statement(node->data.ifstatement.then_body, ctx);
+    }
+    else if (node->data.ifstatement.else_body)
+    {
+        // Execute ELSE body
+        return execute_statement(node->data.ifstatement.else_body, ctx);
     }
+    
+    // No else body, just return success
+    return 1;
 }
 
-// Função de execução com contexto 
-int execute_statement_with_context(ASTNode* node, ExecutionContext* ctx)
+// ============================================
+// WHILE
+// Erro na condição encerra o laço; erro no corpo só descarta o
+// statement (como em execute_statement_list) e o laço continua.
+// ============================================
+int execute_while_statement(ASTNode* node, ExecutionContext* ctx)
 {
     if (!node || !ctx) return 0;
     
-    switch (node->type) {
-        case NODE_ASSIGNMENT: {
-            const char* var_name = node->data.assignment.var_name;
-            ASTNode* value_node = node->data.assignment.value;
-            
-            EvaluatorResult value_result = evaluate_expression(
-                value_node, ctx->symbols, CTX_ANY);
-            
-            if (value_result.type == RESULT_ERROR) {
-                printf("%s\n", value_result.error_message);
-                return 0;
-            }
-            
-            if (value_result.type == RESULT_STRING) {
-                if (!symbol_table_set_string(ctx->symbols, var_name, value_result.value.string)) {
-                    printf("Evaluator error: assigning string to '%s'\n", var_name);
-                    return 0;
-                }
-            } else {
-                if (!symbol_table_set_number(ctx->symbols, var_name, value_result.value.number)) {
-                    printf("Evaluator error: assigning number to '%s'\n", var_name);
-                    return 0;
-                }
-            }
-            return 1;
+    WhileStatementData* data = &node->data.whilestatement;
+    int all_success = STMT_OK;
+    
+    for (;;)
+    {
+        Value condition = evaluate_expression(data->condition, ctx, CTX_BOOL);
+        evaluator_release_temps(ctx);
+        
+        if (value_is_error(condition))
+        {
+            evaluator_report_error(ctx);
+            return STMT_ERROR;
         }
-            
-        case NODE_PRINT:
-            return evaluate_print_with_context(node, ctx);
-            
-        case NODE_COLOR:
-            // Comando nocolor sozinho
-            if (node->data.color.color_token_id == 0) {
-                evaluator_color_reset(ctx);
-                return 1;
-            }
-            printf("%s[%d:%d] Evaluator warning: color command without print has no effect%s\n",
-                   COLOR_WARNING, node->line, node->column, COLOR_RESET);
-            return 1;
-            
-
-        case NODE_BOOL:
-        case NODE_NUMBER:
-        case NODE_BINARY_OP:
-        case NODE_UNARY_OP:
-        case NODE_VARIABLE:
+        
+        if (!value_is_bool(condition))
         {
-            EvaluatorResult result = evaluate_expression(node, ctx->symbols, CTX_ANY);
-            if (result.type == RESULT_ERROR)
-            {
-                printf("%s\n", result.error_message);
-                return 0;
-            }
-            else
-            {
-                switch(result.type)
-                {
-                    case RESULT_STRING:
-                        printf("\"%s\"\n", result.value.string);
-                        break;
-                    case RESULT_NUMBER:
-                        printf("%g\n", result.value.number);
-                        break;
-                    case RESULT_BOOL:
-                    {
-                        if(result.value.boolean == 1){
-                            printf("true\n");
-                        }
-                        else{
-                            printf("false\n");
-                        }
-                        break;
-                    }
-                }
-                return 1;
-            }
+            raise_error(ctx, node->line, node->column,
+                 "Evaluator error: condition must be boolean, got %s",
+                 value_type_name(condition));
+            evaluator_report_error(ctx);
+            return STMT_ERROR;
         }
-            
-        case NODE_STRING:
-            printf("\"%s\"\n", node->data.string.value);
-            return 1;
-            
-        case NODE_STATEMENT_LIST:
-            return execute_statement_list(node, ctx->symbols);
+        
+        if (!value_as_bool(condition))
+        {
+            break;
+        }
+        
+        int status = execute_statement(data->body, ctx);
+        if (status == STMT_BREAK)
+        {
+            break;
+        }
+        if (status == STMT_ERROR)
+        {
+            all_success = STMT_ERROR;
+        }
+        // STMT_OK e STMT_CONTINUE: próxima volta
+    }
+    
+    return all_success;
+}
 
-        case NODE_IF:
-            return execute_if_statement_with_context(node, ctx);
-            
-        default:
-            printf("Evaluator error: unsupported statement type: %d\n", node->type);
-            return 0;
+#ifdef TESTEVALUATOR
+#include "color.h"
+#include "utils.h"
+#include "lexer.h"
+#include "parser.h"
+#include "evaluator.h"
+#include "symbol_table.h"
+#include "resolver.h"
+
+// Literal maior que os antigos 256 bytes, guardado numa variável:
+// continua inteiro (e vivo) depois que a árvore é destruída, como
+// acontece entre duas linhas do REPL
+static void test_string_lifetime(void)
+{
+    printf("%s=== Teste string: literal de 300 bytes sobrevive à AST ===%s\n",
+           COLOR_HEADER, COLOR_RESET);
+    
+    char source[400] = "let s = \"";
+    size_t length = strlen(source);
+    memset(source + length, 'a', 300);
+    strcpy(source + length + 300, "\"\nlet t = s");
+    
+    ExecutionContext* exec = execution_context_create();
+    Lexer lexer;
+    lexer_init(&lexer, source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    int ok = ast && resolve_program(ast, exec->symbols) && evaluate_program(ast, exec);
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    
+    if (ok)
+    {
+        // s e t compartilham a mesma String, agora só da tabela
+        Value s = symbol_table_lookup(exec->symbols, "s").value->value;
+        Value t = symbol_table_lookup(exec->symbols, "t").value->value;
+        ok = value_is_string(s) && s == t &&
+             value_string_length(s) == 300 &&
+             value_as_string(s)[299] == 'a' &&
+             value_as_string_object(s)->refcount == 2;
     }
+    
+    printf("%s%s%s\n\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    execution_context_destroy(exec);
 }
 
-int execute_if_statement(ASTNode* node, SymbolTable* symbols)
+// O mesmo literal repetido vira uma única String; nomes também
+static void test_string_interning(void)
 {
-    if (!node || !symbols) return 0;
+    printf("%s=== Teste string: literais repetidos são internados ===%s\n",
+           COLOR_HEADER, COLOR_RESET);
     
-    ExecutionContext* ctx = execution_context_create(symbols);
-    if (!ctx) return 0;
+    Lexer lexer;
+    lexer_init(&lexer, "let a = \"----\"\nlet b = \"----\"\nlet a = \"-- --\"\n? a");
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
     
-    int result = execute_if_statement_with_context(node, ctx);
+    int ok = ast && ast->data.statementlist.count == 4;
+    if (ok)
+    {
+        ASTNode** stmts = ast->data.statementlist.statements;
+        String* first = stmts[0]->data.assignment.value->data.string.value;
+        String* second = stmts[1]->data.assignment.value->data.string.value;
+        String* third = stmts[2]->data.assignment.value->data.string.value;
+        ok = first == second && first != third && first->length == 4 &&
+             stmts[0]->data.assignment.var_name == stmts[2]->data.assignment.var_name &&
+             arena->string_count == 4;  // "----", "-- --", "a", "b"
+    }
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
     
-    execution_context_destroy(ctx);
-    return result;
+    printf("%s%s%s\n\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
 }
 
-int execute_if_statement_with_context(ASTNode* node, ExecutionContext* ctx)
+// let s = s + x num laço cresce o bloco da variável (capacidade dobra);
+// r = s + "!" é uma String nova e as duas comparam pelo conteúdo
+static void test_string_append(void)
 {
-    if (!node || !ctx) return 0;
+    printf("%s=== Teste string: concatenação e append no próprio bloco ===%s\n",
+           COLOR_HEADER, COLOR_RESET);
     
-    // Evaluate condition
-    EvaluatorResult cond_result = evaluate_expression(
-                                  node->data.ifstatement.condition,
-                                  ctx->symbols, CTX_BOOL);
+    ExecutionContext* exec = execution_context_create();
+    Lexer lexer;
+    lexer_init(&lexer,
+               "let s = \"\"\nlet i = 0\n"
+               "while (i < 1000) do\n    let s = s + \"ab\"\n    let i = i + 1\nend while\n"
+               "let r = s + \"!\"\nlet menor = (s < r)\nlet igual = (s + \"!\" == r)");
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    int ok = ast && resolve_program(ast, exec->symbols) && evaluate_program(ast, exec);
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
     
-    if (cond_result.type == RESULT_ERROR)
+    if (ok)
     {
-        printf("%s\n", cond_result.error_message);
-        return 0;
+        String* s = value_as_string_object(symbol_table_lookup(exec->symbols, "s").value->value);
+        String* r = value_as_string_object(symbol_table_lookup(exec->symbols, "r").value->value);
+        Value menor = symbol_table_lookup(exec->symbols, "menor").value->value;
+        Value igual = symbol_table_lookup(exec->symbols, "igual").value->value;
+        ok = s->length == 2000 && s->capacity >= 2001 && s->capacity < 4096 &&
+             s->refcount == 1 && memcmp(s->chars + 1996, "abab", 5) == 0 &&
+             r != s && r->length == 2001 && r->chars[2000] == '!' && r->refcount == 1 &&
+             value_as_bool(menor) && value_as_bool(igual) &&
+             work_stack_empty(&exec->temps);
     }
     
-    // Execute appropriate branch
-    if (cond_result.value.boolean)
+    printf("%s%s%s\n\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    execution_context_destroy(exec);
+}
+
+// Contas entre inteiros ficam inteiras: fora da faixa inline em caixa,
+// exatas; só saindo de int64 viram double
+static void test_integers(void)
+{
+    printf("%s=== Teste inteiros: / \\ %% e promoção a double ===%s\n",
+           COLOR_HEADER, COLOR_RESET);
+    
+    ExecutionContext* exec = execution_context_create();
+    Lexer lexer;
+    lexer_init(&lexer,
+               "let a = 6 / 3\nlet b = 7 / 2\nlet c = -7 \\ 2\nlet d = -7 % 3\n"
+               "let e = 140737488355327\nlet f = e + 1\nlet g = f - 1\n"
+               "let h = 7.5 % 2\nlet igual = (g == e)\n"
+               "let k = 9223372036854775807\nlet l = k + 1");
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    int ok = ast && resolve_program(ast, exec->symbols) && evaluate_program(ast, exec);
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    
+    if (ok)
     {
-        // Execute THEN body
-        return execute_statement_with_context(node->data.ifstatement.then_body, ctx);
+        #define VAR(name) (symbol_table_lookup(exec->symbols, name).value->value)
+        ok = value_is_int(VAR("a")) && value_as_int(VAR("a")) == 2 &&
+             !value_is_int(VAR("b")) && value_as_number(VAR("b")) == 3.5 &&
+             value_is_int(VAR("c")) && value_as_int(VAR("c")) == -3 &&
+             value_is_int(VAR("d")) && value_as_int(VAR("d")) == -1 &&
+             value_is_int(VAR("e")) && value_as_int(VAR("e")) == VALUE_INT_MAX &&
+             value_is_boxed_int(VAR("f")) && value_as_int(VAR("f")) == VALUE_INT_MAX + 1 &&
+             value_is_int(VAR("g")) && !value_is_boxed_int(VAR("g")) &&
+             value_as_number(VAR("h")) == 1.5 && value_as_bool(VAR("igual")) &&
+             value_is_boxed_int(VAR("k")) && value_as_int(VAR("k")) == INT64_MAX &&
+             !value_is_int(VAR("l")) && work_stack_empty(&exec->temps);
+        #undef VAR
     }
-    else if (node->data.ifstatement.else_body)
+    
+    printf("%s%s%s\n\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    execution_context_destroy(exec);
+}
+
+// Acima de 2^53 o double perde o último dígito: o literal, a soma e o
+// print passam pelo int64 exato (a saída vai para um arquivo temporário)
+static void test_big_integers(void)
+{
+    printf("%s=== Teste inteiros acima de 2^53: literal, + e print ===%s\n",
+           COLOR_HEADER, COLOR_RESET);
+    
+    ExecutionContext* exec = execution_context_create();
+    FILE* stream = tmpfile();
+    output_init(&exec->output, stream);
+    Lexer lexer;
+    lexer_init(&lexer,
+               "let a = 9007199254740993\nlet b = a + 1\ndim c(1)\nlet c(1) = b\n"
+               "print a nl\nprint b nl\nprint c(1) - 2 nl\nprint 9007199254740993 + 1");
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    int ok = stream && ast && resolve_program(ast, exec->symbols) && evaluate_program(ast, exec);
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    
+    char text[128] = "";
+    if (ok)
     {
-        // Execute ELSE body
-        return execute_statement_with_context(node->data.ifstatement.else_body, ctx);
+        output_flush(&exec->output);
+        rewind(stream);
+        text[fread(text, 1, sizeof(text) - 1, stream)] = '\0';
+        
+        // A variável continua com a caixa depois que a árvore sumiu
+        Value a = symbol_table_lookup(exec->symbols, "a").value->value;
+        ok = strcmp(text, "9007199254740993\n9007199254740994\n"
+                          "9007199254740992\n9007199254740994") == 0 &&
+             value_is_boxed_int(a) && value_as_int(a) == 9007199254740993LL;
     }
     
-    // No else body, just return success
-    return 1;
+    printf("%s%s%s\n\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    execution_context_destroy(exec);
+    if (stream) fclose(stream);
 }
 
-// Esta função também está declarada mas não implementada
-// int evaluate_print_statement_with_context(ASTNode* node, ExecutionContext* ctx)
-// {
-//     return evaluate_print_with_context(node, ctx);
-// }
+// dim zera os elementos; um novo dim troca o array e um dim que falha
+// deixa a variável sem array. Elementos fora de 1..n são recusados
+static void test_arrays(void)
+{
+    printf("%s=== Teste arrays: dim, a(i) e let a(i) ===%s\n", COLOR_HEADER, COLOR_RESET);
+    
+    ExecutionContext* exec = execution_context_create();
+    Lexer lexer;
+    lexer_init(&lexer,
+               "dim a(4)\nlet i = 1\n"
+               "while (i <= 4) do\n    let a(i) = i * 1.5\n    let i = i + 1\nend while\n"
+               "let soma = a(1) + a(2) + a(3) + a(4)\nlet zero = a(0)\n"
+               "dim b(2)\nlet b(2) = 7\ndim c(2)\ndim c(-1)");
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    int ok = ast && resolve_program(ast, exec->symbols);
+    if (ok) evaluate_program(ast, exec);  // a(0) e dim c(-1) dão erro
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    
+    if (ok)
+    {
+        #define VAR(name) (symbol_table_lookup(exec->symbols, name).value->value)
+        Array* a = value_is_array(VAR("a")) ? value_as_array(VAR("a")) : NULL;
+        Array* b = value_is_array(VAR("b")) ? value_as_array(VAR("b")) : NULL;
+        ok = a && a->length == 4 && value_as_number(a->items[3]) == 6.0 &&
+             value_as_number(VAR("soma")) == 15.0 &&
+             value_is_undefined(VAR("zero")) &&
+             b && b->length == 2 && value_is_int(b->items[0]) && value_as_int(b->items[0]) == 0 &&
+             value_as_int(b->items[1]) == 7 &&
+             value_is_undefined(VAR("c")) &&
+             symbol_type_of(VAR("a")) == SYM_ARRAY;
+        #undef VAR
+    }
+    
+    printf("%s%s%s\n\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    execution_context_destroy(exec);
+}
 
-#ifdef TESTEVALUATOR
-#include "color.h"
-#include "utils.h"
-#include "lexer.h"
-#include "parser.h"
-#include "evaluator.h"
-#include "symbol_table.h"
+// Especializa na primeira execução; a guarda falha quando o operando
+// deixa de ser número (aqui trocado à mão na AST)
+static void test_quickening(void)
+{
+    printf("%s=== Teste quickening: '5 + 3 < 10' ===%s\n", COLOR_HEADER, COLOR_RESET);
+    
+    ExecutionContext* exec = execution_context_create();
+    Lexer lexer;
+    lexer_init(&lexer, "5 + 3 < 10");
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse_single_statement(&lexer, arena);
+    ASTNode* sum = ast ? ast->data.logicalop.left : NULL;
+    
+    int ok = ast != NULL;
+    for (int i = 0; ok && i < 3; i++)
+    {
+        Value result = evaluate_expression(ast, exec, CTX_ANY);
+        ok = value_is_bool(result) && value_as_bool(result);
+    }
+    ok = ok && ast->quick == QUICK_NUMBER && sum->quick == QUICK_NUMBER &&
+         exec->quick.specializations == 2 && exec->quick.deopts == 0;
+    
+    if (ok)
+    {
+        // 5 vira true: a soma precisa desespecializar e dar o erro de sempre
+        sum->data.binaryop.left->type = NODE_BOOL;
+        sum->data.binaryop.left->data.boolean.value = TRUE;
+        Value result = evaluate_expression(ast, exec, CTX_ANY);
+        ok = value_is_error(result) && sum->quick == QUICK_NONE &&
+             sum->deopts == 1 && exec->quick.deopts == 1;
+        evaluator_report_error(exec);
+        evaluator_dump_quickening(ast, exec);
+    }
+    
+    printf("%s%s%s\n\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(exec);
+}
 
 int main()
 {
@@ -1412,7 +2553,7 @@ int main()
     };
     
     int num_testes = sizeof(testes) / sizeof(testes[0]);
-    SymbolTable* symbols = symbol_table_create();
+    ExecutionContext* exec = execution_context_create();
     
     for (int i = 0; i < num_testes; i++)
     {
@@ -1422,40 +2563,49 @@ int main()
         Lexer lexer;
         lexer_init(&lexer, testes[i]);
         
-        ASTNode* ast = parse_single_statement(&lexer);
+        ASTArena* arena = ast_arena_create();
+        ASTNode* ast = parse_single_statement(&lexer, arena);
         
         if (ast)
         {
-            EvaluatorResult result = evaluate_expression(ast, symbols, CTX_ANY);
+            Value result = evaluate_expression(ast, exec, CTX_ANY);
             
-            if (result.type == RESULT_ERROR)
+            if (value_is_error(result))
             {
-                printf("%s\n", result.error_message);
+                evaluator_report_error(exec);
             }
-            else if (result.type == RESULT_BOOL)
+            else if (value_is_bool(result))
             {
                 printf("Resultado: %s\n", 
-                       result.value.boolean ? "true" : "false");
+                       value_as_bool(result) ? "true" : "false");
                 printf("%sOK%s\n", COLOR_SUCCESS, COLOR_RESET);
             }
-            else if (result.type == RESULT_NUMBER)
+            else if (value_is_number(result))
             {
-                printf("Resultado: %g\n", result.value.number);
+                printf("Resultado: %g\n", value_as_number(result));
                 printf("%sOK%s\n", COLOR_SUCCESS, COLOR_RESET);
             }
-            
-            free_ast(ast);
         }
         else
         {
             printf("%sERRO no parsing%s\n", COLOR_ERROR, COLOR_RESET);
         }
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
         
         printf("\n");
         wait();
     }
     
-    symbol_table_destroy(symbols);
+    execution_context_destroy(exec);
+    
+    test_quickening();
+    test_string_lifetime();
+    test_string_interning();
+    test_string_append();
+    test_integers();
+    test_big_integers();
+    test_arrays();
     
     printf("\n%s=== TODOS OS TESTES COMPLETADOS ===%s\n", 
            COLOR_SUCCESS, COLOR_RESET);
@@ -1464,4 +2614,86 @@ int main()
     return 0;
 }
 #endif
-// Fim de evaluator.c
\ No newline at end of file
+// ============================================
+// BENCHMARK
+// gcc -O2 -DBENCHEVALUATOR evaluator.c builtins.c lexer.c parser.c ast.c resolver.c symbol_table.c color_mapping.c output.c number_format.c a89alloc.c utils.c work_stack.c zzstring.c -lm -o bench_evaluator
+// ============================================
+
+#ifdef BENCHEVALUATOR
+#include <time.h>
+#include "utils.h"
+#include "lexer.h"
+#include "parser.h"
+#include "resolver.h"
+
+static int count_nodes(ASTNode* node)
+{
+    if (!node) return 0;
+    
+    switch (node->type)
+    {
+        case NODE_BINARY_OP:
+            return 1 + count_nodes(node->data.binaryop.left)
+                     + count_nodes(node->data.binaryop.right);
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+            return 1 + count_nodes(node->data.logicalop.left)
+                     + count_nodes(node->data.logicalop.right);
+        case NODE_UNARY_OP:
+            return 1 + count_nodes(node->data.unaryop.operand);
+        case NODE_NOT_LOGICAL_OP:
+            return 1 + count_nodes(node->data.notop.operand);
+        default:
+            return 1;
+    }
+}
+
+int main()
+{
+    setup_utf8();
+    printf("%s=== Benchmark Evaluator ===%s\n\n", COLOR_HEADER, COLOR_RESET);
+    
+    const char* source =
+        "((x + 2) * 3 - y / 5 + 6 * x - 8) * (9 - 10 / 2 + y) > 0 and not (x < 2)";
+    int iterations = 1000000;
+    
+    ExecutionContext* exec = execution_context_create();
+    SymbolTable* symbols = exec->symbols;
+    symbol_table_set_number(symbols, "x", 4);
+    symbol_table_set_number(symbols, "y", 7);
+    
+    Lexer lexer;
+    lexer_init(&lexer, source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse_single_statement(&lexer, arena);
+    if (!ast || !resolve_program(ast, symbols))
+    {
+        printf("%sERRO no parsing%s\n", COLOR_ERROR, COLOR_RESET);
+        return 1;
+    }
+    
+    int nodes = count_nodes(ast);
+    int true_count = 0;
+    
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++)
+    {
+        Value result = evaluate_expression(ast, exec, CTX_ANY);
+        true_count += value_as_bool(result);
+    }
+    double ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+    
+    int ok = (true_count == iterations);
+    printf("%d nodes x %d | %.1f ms | %.2f ns/node | sizeof(Value) %zu | %s%s%s\n",
+           nodes, iterations, ms, ms * 1e6 / ((double)iterations * nodes),
+           sizeof(Value), ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(exec);
+    
+    a89check_leaks();
+    return 0;
+}
+#endif
+// Fim de evaluator.c
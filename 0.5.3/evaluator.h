@@ -7,6 +7,10 @@
 #include "ast.h"
 #include "symbol_table.h"
 #include "color_mapping.h"
+#include "value.h"
+#include "output.h"
+#include "work_stack.h"
+#include "zzarray.h"
 
 
 // =================================================
@@ -36,49 +40,61 @@ typedef enum
     CTX_ANY,      // Qualquer tipo aceitável (para exibição: PRINT x)
     CTX_BOOL,     // Espera um booleano: true(1) ou false(0)
     CTX_NUMBER,   // Espera número (operações matemáticas: x + 5)
-    CTX_STRING    // Espera string (concatenação futura: "Olá " + nome)
+    CTX_STRING    // Espera string
 } EvalContext;
 
-typedef enum
-{
-    RESULT_ERROR,
-    RESULT_BOOL,
-    RESULT_NUMBER,
-    RESULT_STRING
-} ResultType;
+// =================================================
+// Slot de erro - evaluate_expression() devolve VALUE_ERROR
+// e a mensagem fica aqui, fora do valor
+// =================================================
+typedef struct {
+    int has_error;
+    int line;
+    int column;
+    char message[BUFFER_SIZE];
+} EvaluatorError;
 
 // =================================================
-// Contexto de execução - print usa
+// Contadores do quickening (evaluator_dump_quickening)
 // =================================================
 typedef struct {
-    SymbolTable* symbols;        // Tabela de símbolos
-    const char* current_color;   // Cor atual aplicada
+    size_t specializations;     // Nós que passaram a um caminho especializado
+    size_t deopts;              // Guardas que falharam
+} QuickStats;
+
+// =================================================
+// Contexto de execução - o interpretador
+//
+// Um por sessão: run_file e run_repl criam o seu e o passam por
+// ponteiro a todos os execute_* / evaluate_* e à VM. Não há estado
+// global de execução, então vários interpretadores podem conviver
+// no mesmo processo.
+// =================================================
+typedef struct {
+    SymbolTable* symbols;        // Tabela de símbolos (do contexto)
+    OutputBuffer output;         // Saída buferizada do print
+    ColorCode current_color;     // Cor atual aplicada (CLR_NOCOLOR = nenhuma)
     int color_enabled;           // Se cores estão habilitadas
     OutputFormat format;         // Formatação (width e alignment)
+    EvaluatorError error;        // Último erro de avaliação
+    QuickStats quick;            // Quickening da sessão (evaluator.c)
+    WorkStack temps;             // Values (strings, inteiros em caixa) do statement atual
 } ExecutionContext;
 
-typedef struct
-{
-    ResultType type;
-    union {
-        int boolean;
-        double number;
-        char string[STRING_SIZE];
-    } value;
-    char error_message[BUFFER_SIZE];
-    int line;   
-    int column; 
-} EvaluatorResult;
 
+// Cria o interpretador com uma SymbolTable vazia e saída em stdout
+ExecutionContext* execution_context_create(void);
+// Esvazia a saída pendente e libera a SymbolTable e o contexto
+void execution_context_destroy(ExecutionContext* ctx);
+// Apaga todas as variáveis e volta cor/formato ao padrão (REPL "reset")
+void execution_context_reset(ExecutionContext* ctx);
 
 // width e alignment
-ExecutionContext* execution_context_create(SymbolTable* symbols);
-void execution_context_destroy(ExecutionContext* ctx);
 void evaluator_reset_format(ExecutionContext* ctx);// Formatação
 
 // Funções de gerenciamento de cores
 void evaluator_color_reset(ExecutionContext* ctx);
-void evaluator_color_set(ExecutionContext* ctx, const char* ansi_color);
+void evaluator_color_set(ExecutionContext* ctx, ColorCode color);
 void evaluator_color_apply_current(ExecutionContext* ctx);
 
 
@@ -101,29 +117,108 @@ execute_statement():
     NODE_STATEMENT_LIST ==> execute_statement_list()
 
     NODE_INPUT ==> evaluate_input_statement()
-    
 
+    NODE_DIM / NODE_INDEX_ASSIGNMENT ==> evaluator_dim() / evaluator_array_set()
+
+    NODE_IF ==> execute_if_statement()
+
+    NODE_WHILE ==> execute_while_statement()
+    NODE_BREAK / NODE_CONTINUE ==> STMT_BREAK / STMT_CONTINUE
+
+Todos recebem o ExecutionContext da sessão. Os executores devolvem
+um StatementStatus. break e continue sobem
+como status pelas listas e pelos if até o while mais interno (o
+parser garante que existe um). Só a concatenação de strings e as
+contas inteiras fora da faixa inline alocam no heap (ver
+evaluator_concat e numeric.h).
+    
+A AST deve ter passado por resolve_program() (resolver.h): variáveis
+são lidas e escritas pelo slot, sem busca por nome. Se também passou
+por infer_program() (inference.h), operações cujos operandos têm tipo
+número provado seguem por evaluate_number(), sem Value nem checagem
+de tipo a cada avaliação.
+
+Sem tipo provado (depois de input, por exemplo), NODE_VARIABLE,
+NODE_BINARY_OP e NODE_COMPARISON_OP se especializam na primeira
+execução pelo tipo observado (quickening, campo quick do nó): a
+variável guarda o endereço do slot e as operações trocam as
+checagens por uma guarda. Se a guarda falha o nó volta ao caminho
+geral (deopt); depois de QUICK_MAX_DEOPTS falhas fica genérico.
 ********************************************************************/
-int evaluate_program(ASTNode* node, SymbolTable* symbols);
+typedef enum {
+    STMT_ERROR = 0,             // Erro já reportado
+    STMT_OK = 1,
+    STMT_BREAK,                 // Sai do while mais interno
+    STMT_CONTINUE               // Volta para a condição do while
+} StatementStatus;
 
-int execute_statement_list(ASTNode* node, SymbolTable* symbols);
-int execute_statement(ASTNode* node, SymbolTable* symbols);
-int execute_statement_with_context(ASTNode* node, ExecutionContext* ctx);
+int evaluate_program(ASTNode* node, ExecutionContext* ctx);
 
-EvaluatorResult evaluate_expression(ASTNode* node, SymbolTable* symbols, EvalContext ctx);
+int execute_statement_list(ASTNode* node, ExecutionContext* ctx);
+int execute_statement(ASTNode* node, ExecutionContext* ctx);
 
-int evaluate_print_statement(ASTNode* node, SymbolTable* symbols);
-int evaluate_print_with_context(ASTNode* node, ExecutionContext* ctx);
+Value evaluate_expression(ASTNode* node, ExecutionContext* exec, EvalContext ctx);
+void evaluator_report_error(ExecutionContext* exec);
+// Debug: contadores do contexto e nós especializados da AST
+void evaluator_dump_quickening(ASTNode* ast, ExecutionContext* ctx);
+// Erro encontrado antes da execução (optimizer, inferência): mesmo formato
+void evaluator_report_error_at(ExecutionContext* exec, int line, int column,
+                               const char* format, ...);
 
-//int evaluate_print_statement_with_context(ASTNode* node, ExecutionContext* ctx);
+int evaluate_print_statement(ASTNode* node, ExecutionContext* ctx);
+int evaluate_input_statement(ASTNode* node, ExecutionContext* ctx);
 
-int evaluate_input_statement(ASTNode* node, SymbolTable* symbols);
+// =================================================
+// Valores temporários
+//
+// A concatenação cria strings, e uma conta inteira fora da faixa
+// inline cria uma caixa (numeric.h), que nenhuma variável retém ainda.
+// O contexto guarda uma referência de cada uma até quem consome o
+// valor da expressão (atribuição, print, echo, condição) terminar e
+// chamar evaluator_release_temps(). Quem atribui já reteve a sua.
+// =================================================
+// a + b (duas strings); o resultado vale até o fim do statement
+Value evaluator_concat(ExecutionContext* ctx, Value left, Value right);
+// let s = s + x: acrescenta x no bloco da variável (string) quando ela
+// é a única dona. 0 = não se aplica (use a concatenação comum)
+int evaluator_append_in_place(ExecutionContext* ctx, int slot, Value right);
+void evaluator_free_temps(ExecutionContext* ctx);
+
+static inline void evaluator_release_temps(ExecutionContext* ctx)
+{
+    if (!work_stack_empty(&ctx->temps)) evaluator_free_temps(ctx);
+}
+
+// Auxiliares compartilhadas com a VM (vm.c) para manter a mesma saída
+int evaluator_assign_input(ExecutionContext* ctx, int slot, const char* prompt);
+void evaluator_format_number(double num, char* buffer, size_t size);
+void evaluator_print_begin(ExecutionContext* ctx);
+void evaluator_print_text(ExecutionContext* ctx, const char* text);
+void evaluator_set_width(ExecutionContext* ctx, int width);
+void evaluator_set_alignment(ExecutionContext* ctx, TokenType alignment_token);
+void evaluator_print_value(ExecutionContext* ctx, Value value);
+void evaluator_echo_value(ExecutionContext* ctx, Value value, int string_literal);
+
+// Arrays: dim a(n), a(i) e let a(i) = v. O erro fica em ctx->error sem
+// posição (quem chama completa linha e coluna, como nas builtins)
+int evaluator_dim(ExecutionContext* ctx, int slot, Value size);                        // 0 = erro
+Value evaluator_array_get(ExecutionContext* ctx, int slot, Value index);               // VALUE_ERROR = erro
+int evaluator_array_set(ExecutionContext* ctx, int slot, Value index, Value value);   // 0 = erro
+
+// a(i) com o índice provado entre 1 e o tamanho (optimizer): só confere
+// que o slot tem array e o índice é inteiro. NULL = use o caminho
+// verificado, que dá a mensagem de erro
+static inline Value* evaluator_array_item(SymbolValue* symbol, Value index)
+{
+    if (!symbol || !value_is_array(symbol->value) || !value_is_int(index)) return NULL;
+    return &value_as_array(symbol->value)->items[value_as_int(index) - 1];
+}
 
-int execute_if_statement(ASTNode* node, SymbolTable* symbols);
-int execute_if_statement_with_context(ASTNode* node, ExecutionContext* ctx);
+int execute_if_statement(ASTNode* node, ExecutionContext* ctx);
+int execute_while_statement(ASTNode* node, ExecutionContext* ctx);
 
 // Old function (for compatibility)
-EvaluatorResult evaluate(ASTNode* node);
+Value evaluate(ASTNode* node);
 
 #endif
 // Fim de evaluator.h
\ No newline at end of file
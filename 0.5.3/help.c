@@ -32,7 +32,8 @@ void display_help(void)
         "  reset            - Clear all variables\n"
         "  clear            - Clear screen\n"
         "  tokens code      - Show tokens for code\n"
-        "  ast code         - Show AST for code\n"
+        "  ast code         - Show AST (parsed and optimized)\n"
+        "  bytecode code    - Show bytecode for code\n"
         "  symbols          - Show Symbol Table\n"
         "\n"
     );
@@ -47,6 +48,9 @@ void display_help(void)
         "  expr1 ; expr2    - Multiple statements\n"
         "  print expr       - Print values\n"
         "  input msg var    - Read input\n"
+        "  dim a(n)         - Array of n numbers, all 0\n"
+        "  let a(i) = expr  - Set element i (1 to n)\n"
+        "  a(i)             - Element i (no space before '(')\n"
         "\n"
     );
     wait_for_enter();
@@ -63,8 +67,15 @@ void display_help(void)
         "      statements\n"
         "  end if\n"
         "\n"
+        "  while (condition) do\n"
+        "      statements\n"
+        "      break        - leave the loop\n"
+        "      continue     - go to the next iteration\n"
+        "  end while\n"
+        "\n"
         "Note: Use 'nl' to go to next line in REPL:\n"
         "  >> if(n == 3) then nl print \"n é 3\" nl end if\n"
+        "  >> while(n < 3) do nl let n = n + 1 : print n nl end while\n"
         "\n"
     );
     wait_for_enter();
@@ -73,14 +84,20 @@ void display_help(void)
     print_page(
         "\n"
         "Operators:\n"
-        "  Arithmetic:  +, -, *, /\n"
+        "  Arithmetic:  +, -, *, /, \\ (integer division), % (remainder)\n"
         "  Comparison:  ==, !=, <, >, <=, >=\n"
         "  Logical:     and, or, not, !\n"
         "\n"
+        "String functions:\n"
+        "  len(s)            - Length in bytes\n"
+        "  mid(s, i [, n])   - n bytes from position i (1 = first)\n"
+        "  instr(s, t [, i]) - Position of t in s (0 = not found)\n"
+        "  field(s, sep, n)  - n-th field of s split by sep\n"
+        "\n"
         "Precedence (highest to lowest):\n"
         "  1. Parentheses ()\n"
         "  2. Unary: +, -, not, !\n"
-        "  3. Multiplication, Division: *, /\n"
+        "  3. Multiplication, Division: *, /, \\, %\n"
         "  4. Addition, Subtraction: +, -\n"
         "  5. Comparison: ==, !=, <, >, <=, >=\n"
         "  6. AND: and\n"
@@ -119,6 +136,7 @@ void display_help(void)
         "  let x = 5 : x * 2\n"
         "  tokens x + 5 * 2\n"
         "  ast (a + b) * c\n"
+        "  bytecode a > 1 and b < 2\n"
         "  print \"Result:\" 10 + 5 nl\n"
         "  print red width(40) center \"SECURITY ALERT\" nocolor nl\n"
         "  print yellow width(40) center \"Check system permissions\" nocolor nl\n"
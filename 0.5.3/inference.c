@@ -0,0 +1,1004 @@
+// inference.c
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "a89alloc.h"
+#include "inference.h"
+#include "work_stack.h"
+#include "builtins.h"
+
+// Estado de um slot durante a análise: um VariableType (TYPE_NULL =
+// qualquer tipo) ou SLOT_UNASSIGNED (nenhum caminho atribuiu ainda).
+// Um estado são dois blocos de slot_count bytes: os tipos e, logo
+// depois, 1 se o slot com certeza tem valor. A execução continua depois
+// de um erro, então só conta a atribuição que não pode falhar
+#define SLOT_UNASSIGNED ((unsigned char)0xFF)
+
+// while sendo analisado: estados em break/continue se juntam aqui
+typedef struct LoopTypes
+{
+    struct LoopTypes* enclosing;
+    unsigned char* exits;
+} LoopTypes;
+
+typedef struct
+{
+    ExecutionContext* ctx;
+    int slot_count;
+    unsigned char* types;       // Estado atual, um byte por slot
+    unsigned char* assigned;    // types + slot_count: com certeza tem valor
+    LoopTypes* loop;
+    int quiet;                  // Iterando até o ponto fixo: não reporta
+    int definite;               // 0 no lado direito de and/or
+    int statement_error;        // Já reportou um erro neste statement
+    int errors;
+} Inference;
+
+static void infer_statement(Inference* inf, ASTNode* node);
+
+//===================================================================
+// ESTADOS
+//===================================================================
+static unsigned char join_type(unsigned char a, unsigned char b)
+{
+    if (a == b) return a;
+    if (a == SLOT_UNASSIGNED) return b;
+    if (b == SLOT_UNASSIGNED) return a;
+    return TYPE_NULL;
+}
+
+static size_t state_size(Inference* inf)
+{
+    return 2 * (size_t)inf->slot_count;
+}
+
+static unsigned char* state_copy(Inference* inf, const unsigned char* from)
+{
+    unsigned char* state = A89ALLOC(state_size(inf) + 1);
+    memcpy(state, from, state_size(inf));
+    return state;
+}
+
+// Nenhum caminho chegou ainda: neutro para state_join
+static void state_unreached(Inference* inf, unsigned char* state)
+{
+    memset(state, SLOT_UNASSIGNED, inf->slot_count);
+    memset(state + inf->slot_count, 1, inf->slot_count);
+}
+
+// into = into ∪ from (com valor só se nos dois); devolve 1 se into mudou
+static int state_join(Inference* inf, unsigned char* into, const unsigned char* from)
+{
+    int changed = 0;
+    for (int i = 0; i < inf->slot_count; i++)
+    {
+        unsigned char joined = join_type(into[i], from[i]);
+        if (joined != into[i])
+        {
+            into[i] = joined;
+            changed = 1;
+        }
+    }
+    for (int i = inf->slot_count; i < 2 * inf->slot_count; i++)
+    {
+        if (into[i] && !from[i])
+        {
+            into[i] = 0;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+static const char* type_name(VariableType type)
+{
+    switch (type)
+    {
+        case TYPE_NUMBER: return "number";
+        case TYPE_STRING: return "string";
+        case TYPE_BOOL:   return "boolean";
+        case TYPE_ARRAY:  return "array";
+        default:          return "undefined";
+    }
+}
+
+// Erro de tipo: reportado só se for certo (e o primeiro do statement)
+static VariableType type_error(Inference* inf, ASTNode* node, const char* format, ...)
+{
+    if (!inf->quiet && inf->definite && !inf->statement_error)
+    {
+        char message[BUFFER_SIZE];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(message, sizeof(message), format, args);
+        va_end(args);
+
+        evaluator_report_error_at(inf->ctx, node->line, node->column, "%s", message);
+        inf->errors++;
+    }
+    if (inf->definite) inf->statement_error = 1;
+    node->value_type = TYPE_NULL;
+    return TYPE_NULL;
+}
+
+//===================================================================
+// EXPRESSÕES
+// Espelha as verificações de evaluate_expression(); devolve o tipo
+// provado do resultado (TYPE_NULL = não provado ou erro). O percurso
+// usa uma pilha de trabalho: a profundidade da expressão não consome
+// pilha do C
+//===================================================================
+typedef struct
+{
+    ASTNode* node;
+    EvalContext ctx;
+    int state;          // 0 = filhos pendentes; 1 = esquerdo pronto; 2 = todos prontos
+    int definite;       // inf->definite antes do lado direito de and/or
+} InferFrame;
+
+static void push_infer(WorkStack* frames, ASTNode* node, EvalContext ctx)
+{
+    InferFrame* frame = WORK_STACK_PUSH(frames, InferFrame);
+    frame->node = node;
+    frame->ctx = ctx;
+    frame->state = 0;
+}
+
+static VariableType pop_type(WorkStack* types)
+{
+    VariableType type = *WORK_STACK_TOP(types, VariableType);
+    work_stack_pop(types);
+    return type;
+}
+
+// Folhas (e nós desconhecidos): tipo direto, sem filhos
+static VariableType infer_leaf(Inference* inf, ASTNode* node, EvalContext ctx)
+{
+    VariableType result = TYPE_NULL;
+
+    switch (node->type)
+    {
+        case NODE_BOOL:
+            if (ctx == CTX_STRING)
+                return type_error(inf, node, "Evaluator error: boolean cannot be used as string");
+            result = TYPE_BOOL;
+            break;
+
+        case NODE_NUMBER:
+            if (ctx == CTX_STRING)
+                return type_error(inf, node, "Evaluator error: number cannot be used as string");
+            result = TYPE_NUMBER;
+            break;
+
+        case NODE_STRING:
+            if (ctx == CTX_NUMBER)
+                return type_error(inf, node, "Evaluator error: string cannot be used as number");
+            result = TYPE_STRING;
+            break;
+
+        case NODE_VARIABLE:
+        {
+            const char* name = node->data.variable.var_name;
+            unsigned char state = inf->types[node->data.variable.slot];
+
+            if (state == SLOT_UNASSIGNED)
+            {
+                // Não é erro de tipo: a execução reporta a variável sem valor
+                node->value_type = TYPE_NULL;
+                return TYPE_NULL;
+            }
+            if (state == TYPE_ARRAY)
+            {
+                // Em qualquer contexto: o array só é lido elemento a elemento
+                return type_error(inf, node,
+                     "Evaluator error: variable '%s' is an array, use %s(index)", name, name);
+            }
+            if (state == TYPE_NUMBER && ctx == CTX_STRING)
+            {
+                return type_error(inf, node,
+                     "Evaluator error: variable '%s' is a number, cannot be used as string", name);
+            }
+            if (state == TYPE_STRING && ctx == CTX_NUMBER)
+            {
+                return type_error(inf, node,
+                     "Evaluator error: variable '%s' is a string, cannot be used in mathematical operation",
+                     name);
+            }
+            if (state == TYPE_BOOL && ctx == CTX_NUMBER)
+            {
+                return type_error(inf, node,
+                     "Evaluator error: variable '%s' is a boolean, cannot be used in mathematical operation",
+                     name);
+            }
+            if (state == TYPE_BOOL && ctx == CTX_STRING)
+            {
+                return type_error(inf, node,
+                     "Evaluator error: variable '%s' is a boolean, cannot be used as string", name);
+            }
+            result = (VariableType)state;
+            break;
+        }
+
+        default:
+            result = TYPE_NULL;
+            break;
+    }
+
+    node->value_type = result;
+    return result;
+}
+
+// '+' soma números ou concatena strings (operandos em CTX_ANY). Com
+// um lado desconhecido o erro só é certo se a mensagem não depender
+// dele: a execução acusa string antes de booleano
+static VariableType infer_addition(Inference* inf, ASTNode* node,
+                                   VariableType left, VariableType right)
+{
+    int known = left != TYPE_NULL && right != TYPE_NULL;
+
+    if (left == TYPE_STRING || right == TYPE_STRING)
+    {
+        if (known && left != right)
+            return type_error(inf, node, "Evaluator error: mathematical operation with string");
+        return TYPE_STRING;
+    }
+    if (left == TYPE_BOOL || right == TYPE_BOOL)
+    {
+        if (known)
+            return type_error(inf, node, "Evaluator error: mathematical operation with boolean");
+        return TYPE_NULL;
+    }
+    // Número com desconhecido: se não der erro, o resultado é número
+    return left == TYPE_NUMBER || right == TYPE_NUMBER ? TYPE_NUMBER : TYPE_NULL;
+}
+
+// Operadores com os tipos dos filhos já calculados (ordem de fonte)
+static VariableType infer_operator(Inference* inf, ASTNode* node,
+                                   VariableType left, VariableType right)
+{
+    switch (node->type)
+    {
+        case NODE_BINARY_OP:
+            if (node->data.binaryop.operator == '+')
+            {
+                node->value_type = infer_addition(inf, node, left, right);
+                break;
+            }
+            if (left == TYPE_STRING || right == TYPE_STRING)
+                return type_error(inf, node, "Evaluator error: mathematical operation with string");
+            if (left == TYPE_BOOL || right == TYPE_BOOL)
+                return type_error(inf, node, "Evaluator error: mathematical operation with boolean");
+            node->value_type = TYPE_NUMBER;
+            break;
+
+        case NODE_UNARY_OP:
+            if (left == TYPE_STRING)
+                return type_error(inf, node, "Evaluator error: unary operator '-' applied to string");
+            if (left == TYPE_BOOL)
+                return type_error(inf, node, "Evaluator error: mathematical operation with boolean");
+            node->value_type = TYPE_NUMBER;
+            break;
+
+        case NODE_COMPARISON_OP:
+            if (left != TYPE_NULL && right != TYPE_NULL)
+            {
+                LogicalOperator op = node->data.logicalop.operator;
+                if (left != right)
+                {
+                    return type_error(inf, node,
+                         "Evaluator error: type mismatch in comparison: cannot compare %s with %s",
+                         type_name(left), type_name(right));
+                }
+                if (left == TYPE_BOOL && op != OP_EQUAL && op != OP_NOT_EQUAL)
+                {
+                    return type_error(inf, node,
+                         "Evaluator error: operator not supported for boolean values");
+                }
+            }
+            node->value_type = TYPE_BOOL;
+            break;
+
+        case NODE_LOGICAL_OP:
+            // Só o lado direito chega aqui (o esquerdo já foi conferido)
+            if (right != TYPE_NULL && right != TYPE_BOOL)
+            {
+                type_error(inf, node,
+                     "Evaluator error: logical operator expects boolean, got %s", type_name(right));
+            }
+            node->value_type = TYPE_BOOL;
+            break;
+
+        case NODE_NOT_LOGICAL_OP:
+            if (left != TYPE_NULL && left != TYPE_BOOL)
+            {
+                return type_error(inf, node,
+                     "Evaluator error: NOT operator expects boolean, got %s", type_name(left));
+            }
+            node->value_type = TYPE_BOOL;
+            break;
+
+        default:
+            break;
+    }
+    return node->value_type;
+}
+
+// Argumentos de função (ordem de fonte): a execução confere um a um e
+// acusa o primeiro errado, então um desconhecido antes torna o erro incerto
+static VariableType infer_call(Inference* inf, ASTNode* node, const VariableType* args)
+{
+    const BuiltinInfo* info = builtin_info((BuiltinId)node->data.call.builtin);
+
+    for (int i = 0; i < node->data.call.argc; i++)
+    {
+        if (args[i] == TYPE_NULL) break;
+        if (args[i] != info->args[i])
+        {
+            return type_error(inf, node, BUILTIN_ARGUMENT_ERROR, info->name, i + 1,
+                              type_name(info->args[i]), type_name(args[i]));
+        }
+    }
+    node->value_type = info->result;
+    return info->result;
+}
+
+static int is_scalar_type(unsigned char state)
+{
+    return state == TYPE_NUMBER || state == TYPE_STRING || state == TYPE_BOOL;
+}
+
+// dim a(n) com n literal que evaluator_dim aceita
+static int valid_dim_size(ASTNode* size)
+{
+    if (size->type != NODE_NUMBER) return 0;
+    double length = value_as_number(size->data.number.value);
+    return length >= 0 && length <= ARRAY_MAX_LENGTH;
+}
+
+// a(i) e let a(i) = x, com índice e valor já calculados (value =
+// TYPE_NUMBER em a(i)). Mesma ordem da execução: slot, índice, valor.
+// Um slot com tipo escalar pode ainda não ter valor, e aí a execução
+// acusa o dim que falta: o erro é certo, só a mensagem muda
+static VariableType infer_array_access(Inference* inf, ASTNode* node,
+                                       VariableType index, VariableType value)
+{
+    ArrayData* data = &node->data.array;
+    unsigned char state = inf->types[data->slot];
+
+    // Desconhecido: a avaliação do índice ou do valor pode falhar antes
+    if (index != TYPE_NULL && value != TYPE_NULL)
+    {
+        if (is_scalar_type(state))
+        {
+            return type_error(inf, node, "Evaluator error: variable '%s' is a %s, not an array",
+                              data->var_name, type_name((VariableType)state));
+        }
+        if (state == TYPE_ARRAY && index != TYPE_NUMBER)
+        {
+            return type_error(inf, node, "Evaluator error: array index must be a number, got %s",
+                              type_name(index));
+        }
+        if (state == TYPE_ARRAY && value != TYPE_NUMBER)
+        {
+            return type_error(inf, node, "Evaluator error: array element must be a number, got %s",
+                              type_name(value));
+        }
+    }
+    // Elementos só guardam numbers
+    node->value_type = TYPE_NUMBER;
+    return TYPE_NUMBER;
+}
+
+static VariableType infer_expression(Inference* inf, ASTNode* node, EvalContext ctx)
+{
+    if (!node) return TYPE_NULL;
+
+    WorkStack frames;
+    WorkStack types;
+    work_stack_init(&frames, sizeof(InferFrame));
+    work_stack_init(&types, sizeof(VariableType));
+    push_infer(&frames, node, ctx);
+
+    while (!work_stack_empty(&frames))
+    {
+        InferFrame* frame = WORK_STACK_TOP(&frames, InferFrame);
+        ASTNode* current = frame->node;
+        VariableType result;
+
+        if (frame->state == 0)
+        {
+            // Operadores aritméticos (menos '+') recusam contexto string
+            // antes dos filhos
+            if (((current->type == NODE_BINARY_OP && current->data.binaryop.operator != '+') ||
+                 current->type == NODE_UNARY_OP) &&
+                frame->ctx == CTX_STRING)
+            {
+                result = type_error(inf, current, current->type == NODE_BINARY_OP
+                     ? "Evaluator error: mathematical operation cannot be used as string"
+                     : "Evaluator error: unary operator cannot be applied to string");
+                work_stack_pop(&frames);
+                *WORK_STACK_PUSH(&types, VariableType) = result;
+                continue;
+            }
+
+            frame->state = current->type == NODE_LOGICAL_OP ? 1 : 2;
+            switch (current->type)
+            {
+                case NODE_BINARY_OP:
+                {
+                    EvalContext operand_ctx = current->data.binaryop.operator == '+'
+                                            ? CTX_ANY : CTX_NUMBER;
+                    push_infer(&frames, current->data.binaryop.right, operand_ctx);
+                    push_infer(&frames, current->data.binaryop.left, operand_ctx);
+                    continue;
+                }
+
+                case NODE_COMPARISON_OP:
+                    push_infer(&frames, current->data.logicalop.right, CTX_ANY);
+                    push_infer(&frames, current->data.logicalop.left, CTX_ANY);
+                    continue;
+
+                case NODE_LOGICAL_OP:
+                    push_infer(&frames, current->data.logicalop.left, CTX_BOOL);
+                    continue;
+
+                case NODE_UNARY_OP:
+                    push_infer(&frames, current->data.unaryop.operand, CTX_NUMBER);
+                    continue;
+
+                case NODE_NOT_LOGICAL_OP:
+                    push_infer(&frames, current->data.notop.operand, CTX_BOOL);
+                    continue;
+
+                case NODE_CALL:
+                    for (int i = current->data.call.argc - 1; i >= 0; i--)
+                    {
+                        push_infer(&frames, current->data.call.args[i], CTX_ANY);
+                    }
+                    continue;
+
+                case NODE_INDEX:
+                    push_infer(&frames, current->data.array.index, CTX_NUMBER);
+                    continue;
+
+                default:
+                    result = infer_leaf(inf, current, frame->ctx);
+                    break;
+            }
+        }
+        else if (frame->state == 1)
+        {
+            // and/or: esquerdo pronto
+            VariableType left = pop_type(&types);
+            if (left != TYPE_NULL && left != TYPE_BOOL)
+            {
+                result = type_error(inf, current,
+                     "Evaluator error: logical operator expects boolean, got %s", type_name(left));
+            }
+            else
+            {
+                // Curto-circuito: o lado direito pode nunca ser avaliado
+                frame->state = 2;
+                frame->definite = inf->definite;
+                inf->definite = 0;
+                push_infer(&frames, current->data.logicalop.right, CTX_BOOL);
+                continue;
+            }
+        }
+        else if (current->type == NODE_CALL)
+        {
+            VariableType args[CALL_MAX_ARGS];
+            for (int i = current->data.call.argc - 1; i >= 0; i--)
+            {
+                args[i] = pop_type(&types);
+            }
+            result = infer_call(inf, current, args);
+        }
+        else if (current->type == NODE_INDEX)
+        {
+            result = infer_array_access(inf, current, pop_type(&types), TYPE_NUMBER);
+        }
+        else
+        {
+            VariableType right = TYPE_NULL;
+            if (current->type == NODE_BINARY_OP || current->type == NODE_COMPARISON_OP ||
+                current->type == NODE_LOGICAL_OP)
+            {
+                right = pop_type(&types);
+            }
+            VariableType left = current->type == NODE_LOGICAL_OP ? TYPE_BOOL : pop_type(&types);
+
+            result = infer_operator(inf, current, left, right);
+            if (current->type == NODE_LOGICAL_OP) inf->definite = frame->definite;
+        }
+
+        work_stack_pop(&frames);
+        *WORK_STACK_PUSH(&types, VariableType) = result;
+    }
+
+    VariableType result = pop_type(&types);
+    work_stack_free(&frames);
+    work_stack_free(&types);
+    return result;
+}
+
+// Condição de if/while: mesma mensagem da execução
+static void infer_condition(Inference* inf, ASTNode* node, ASTNode* condition)
+{
+    VariableType type = infer_expression(inf, condition, CTX_BOOL);
+    if (type != TYPE_NULL && type != TYPE_BOOL)
+    {
+        type_error(inf, node, "Evaluator error: condition must be boolean, got %s",
+                   type_name(type));
+    }
+}
+
+//===================================================================
+// STATEMENTS
+//===================================================================
+
+// Lado direito que não pode falhar na execução: literal (inclusive o
+// que o optimizer dobrou) ou cópia de variável escalar que tem valor
+static int produces_value(Inference* inf, ASTNode* node)
+{
+    switch (node->type)
+    {
+        case NODE_NUMBER:
+        case NODE_STRING:
+        case NODE_BOOL:
+            return 1;
+        case NODE_VARIABLE:
+            return inf->assigned[node->data.variable.slot] &&
+                   is_scalar_type(inf->types[node->data.variable.slot]);
+        default:
+            return 0;
+    }
+}
+
+// Efeito de atribuir um valor do tipo 'type' ao slot ('certain' = o
+// valor com certeza é produzido). Se o slot com certeza tem valor de
+// outro tipo provado, a tabela recusa: o erro é certo
+static void assign_slot(Inference* inf, ASTNode* node, int slot, const char* name,
+                        VariableType type, int certain)
+{
+    unsigned char current = inf->types[slot];
+    unsigned char assigned;
+
+    if (inf->assigned[slot] && type != TYPE_NULL && current != TYPE_NULL && current != type)
+    {
+        type_error(inf, node, "Evaluator error: assigning %s to '%s'", type_name(type), name);
+        return;  // A tabela recusa: o slot fica como estava
+    }
+
+    if (current == SLOT_UNASSIGNED || current == type)
+    {
+        assigned = type;  // Primeira atribuição define o tipo
+    }
+    else
+    {
+        // Sem valor: aceita o novo tipo; com valor: a tabela recusa
+        assigned = TYPE_NULL;
+    }
+    // A atribuição pode falhar (erro na expressão): o antigo continua possível
+    inf->types[slot] = join_type(current, assigned);
+    // Gravado ou recusado (o valor antigo fica): nos dois casos há valor
+    if (certain) inf->assigned[slot] = 1;
+}
+
+static void infer_while(Inference* inf, ASTNode* node)
+{
+    WhileStatementData* data = &node->data.whilestatement;
+    unsigned char* head = state_copy(inf, inf->types);
+    unsigned char* exits = A89ALLOC(state_size(inf) + 1);
+
+    LoopTypes loop;
+    loop.enclosing = inf->loop;
+    loop.exits = exits;
+    inf->loop = &loop;
+
+    // Ponto fixo sem reportar: o estado só sobe (sem valor -> tipo ->
+    // qualquer), então poucas voltas bastam
+    int quiet = inf->quiet;
+    inf->quiet = 1;
+    for (;;)
+    {
+        state_unreached(inf, exits);
+        memcpy(inf->types, head, state_size(inf));
+        infer_condition(inf, node, data->condition);
+        infer_statement(inf, data->body);
+
+        int changed = state_join(inf, head, inf->types);
+        changed |= state_join(inf, head, exits);
+        if (!changed) break;
+    }
+    inf->quiet = quiet;
+
+    // Passada final sobre o estado estável: anotações e erros valem
+    state_unreached(inf, exits);
+    memcpy(inf->types, head, state_size(inf));
+    infer_condition(inf, node, data->condition);
+    infer_statement(inf, data->body);
+
+    // Saída: condição falsa (cabeça) ou break
+    memcpy(inf->types, head, state_size(inf));
+    state_join(inf, inf->types, exits);
+
+    inf->loop = loop.enclosing;
+    a89free(exits);
+    a89free(head);
+}
+
+static void infer_statement(Inference* inf, ASTNode* node)
+{
+    if (!node) return;
+
+    switch (node->type)
+    {
+        case NODE_STATEMENT_LIST:
+        {
+            StatementListData* list = &node->data.statementlist;
+            for (int i = 0; i < list->count; i++)
+            {
+                inf->statement_error = 0;
+                infer_statement(inf, list->statements[i]);
+            }
+            break;
+        }
+
+        case NODE_ASSIGNMENT:
+        {
+            VariableType type = infer_expression(inf, node->data.assignment.value, CTX_ANY);
+            assign_slot(inf, node, node->data.assignment.slot, node->data.assignment.var_name,
+                        type, produces_value(inf, node->data.assignment.value));
+            break;
+        }
+
+        case NODE_INPUT:
+            // O tipo depende do que for digitado (e o input pode falhar)
+            assign_slot(inf, node, node->data.inputstatement.slot,
+                        node->data.inputstatement.var_name, TYPE_NULL, 0);
+            break;
+
+        case NODE_DIM:
+        {
+            ArrayData* data = &node->data.array;
+            VariableType size = infer_expression(inf, data->index, CTX_NUMBER);
+            unsigned char state = inf->types[data->slot];
+
+            // Variável escalar: erro só se com certeza tiver valor (e
+            // o tamanho não puder falhar antes). Sem valor ou já array,
+            // o tamanho é conferido
+            if (inf->assigned[data->slot] && is_scalar_type(state) && size != TYPE_NULL)
+            {
+                type_error(inf, node, "Evaluator error: variable '%s' is a %s, not an array",
+                           data->var_name, type_name((VariableType)state));
+                break;
+            }
+            if ((state == SLOT_UNASSIGNED || state == TYPE_ARRAY) &&
+                (size == TYPE_STRING || size == TYPE_BOOL))
+            {
+                type_error(inf, node, "Evaluator error: array size must be a number, got %s",
+                           type_name(size));
+            }
+            // Um dim que falha deixa a variável sem valor (ou com o
+            // escalar que já tinha): só um tamanho literal válido garante
+            inf->types[data->slot] = join_type(state, TYPE_ARRAY);
+            inf->assigned[data->slot] = valid_dim_size(data->index);
+            break;
+        }
+
+        case NODE_INDEX_ASSIGNMENT:
+        {
+            VariableType index = infer_expression(inf, node->data.array.index, CTX_NUMBER);
+            VariableType value = infer_expression(inf, node->data.array.value, CTX_NUMBER);
+            infer_array_access(inf, node, index, value);
+            break;
+        }
+
+        case NODE_BOOL:
+        case NODE_NUMBER:
+        case NODE_STRING:
+        case NODE_BINARY_OP:
+        case NODE_UNARY_OP:
+        case NODE_VARIABLE:
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+        case NODE_NOT_LOGICAL_OP:
+        case NODE_CALL:
+        case NODE_INDEX:
+            infer_expression(inf, node, CTX_ANY);
+            break;
+
+        case NODE_PRINT:
+        {
+            PrintStatementData* print = &node->data.printstatement;
+            for (int i = 0; i < print->count; i++)
+            {
+                ASTNode* item = print->items[i];
+                if (item->type == NODE_COLOR || item->type == NODE_WIDTH ||
+                    item->type == NODE_ALIGNMENT)
+                {
+                    continue;
+                }
+                infer_expression(inf, item, CTX_ANY);
+            }
+            break;
+        }
+
+        case NODE_IF:
+        {
+            IfStatementData* data = &node->data.ifstatement;
+            infer_condition(inf, node, data->condition);
+
+            unsigned char* before = state_copy(inf, inf->types);
+            infer_statement(inf, data->then_body);
+
+            unsigned char* after_then = state_copy(inf, inf->types);
+            memcpy(inf->types, before, state_size(inf));
+            infer_statement(inf, data->else_body);
+
+            state_join(inf, inf->types, after_then);
+            a89free(after_then);
+            a89free(before);
+            break;
+        }
+
+        case NODE_WHILE:
+            infer_while(inf, node);
+            break;
+
+        case NODE_BREAK:
+        case NODE_CONTINUE:
+            if (inf->loop)
+            {
+                state_join(inf, inf->loop->exits, inf->types);
+            }
+            break;
+
+        default:
+            break;  // Cores, width, alinhamento
+    }
+}
+
+int infer_program(ASTNode* ast, ExecutionContext* ctx)
+{
+    if (!ast || !ctx) return 0;
+
+    Inference inf;
+    inf.ctx = ctx;
+    inf.slot_count = symbol_table_slot_count(ctx->symbols);
+    inf.types = A89ALLOC(state_size(&inf) + 1);
+    inf.assigned = inf.types + inf.slot_count;
+    inf.loop = NULL;
+    inf.quiet = 0;
+    inf.definite = 1;
+    inf.statement_error = 0;
+    inf.errors = 0;
+
+    // Estado inicial: variáveis que já têm valor (REPL) mantêm o tipo
+    for (int i = 0; i < inf.slot_count; i++)
+    {
+        SymbolValue* symbol = symbol_table_slot(ctx->symbols, i);
+        switch (symbol_type_of(symbol->value))
+        {
+            case SYM_NUMBER: inf.types[i] = TYPE_NUMBER; break;
+            case SYM_STRING: inf.types[i] = TYPE_STRING; break;
+            case SYM_BOOL:   inf.types[i] = TYPE_BOOL; break;
+            case SYM_ARRAY:  inf.types[i] = TYPE_ARRAY; break;
+            default:         inf.types[i] = SLOT_UNASSIGNED; break;
+        }
+        inf.assigned[i] = inf.types[i] != SLOT_UNASSIGNED;
+    }
+
+    infer_statement(&inf, ast);
+
+    a89free(inf.types);
+    return inf.errors == 0;
+}
+
+
+#ifdef TESTINFERENCE
+// gcc -DTESTINFERENCE inference.c optimizer.c resolver.c evaluator.c builtins.c lexer.c parser.c ast.c symbol_table.c color_mapping.c output.c number_format.c a89alloc.c utils.c work_stack.c zzstring.c -lm -o test_inference
+#include "color.h"
+#include "utils.h"
+#include "lexer.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "resolver.h"
+
+// Valor do último statement: expressão solta ou lado direito do let
+static ASTNode* last_expression(ASTNode* ast)
+{
+    StatementListData* list = &ast->data.statementlist;
+    if (list->count == 0) return NULL;
+    ASTNode* last = list->statements[list->count - 1];
+    return last->type == NODE_ASSIGNMENT ? last->data.assignment.value : last;
+}
+
+int main()
+{
+    setup_utf8();
+
+    printf("%s=== TESTE INFERENCE ===%s\n\n", COLOR_HEADER, COLOR_RESET);
+
+    struct {
+        const char* code;
+        int success;            // infer_program() deve devolver
+        VariableType type;      // Tipo provado da última expressão
+    } testes[] =
+    {
+        { "let x = 1\nx * 2",                                 1, TYPE_NUMBER },
+        { "let s = \"a\"\ns",                                 1, TYPE_STRING },
+        { "let x = 1\nx < 2 and x > 0",                       1, TYPE_BOOL },
+        { "x + 1",                                            1, TYPE_NUMBER },
+        { "x",                                                1, TYPE_NULL },
+        { "input x\nx",                                       1, TYPE_NULL },
+        { "let x = 1\nlet x = \"a\"\nx",                      0, TYPE_NULL },
+        { "let x = 1\nwhile (x < 2) do\nlet x = true\nend while", 0, TYPE_NULL },
+        { "input c\nif (c == 1) then\nlet v = 1\nend if\nlet v = \"a\"\nv",
+                                                              1, TYPE_NULL },
+        { "input c\nlet v = 1 / c\nlet v = \"a\"\nv",           1, TYPE_NULL },
+        { "let x = 1\nlet y = x\nlet y = \"a\"",                 0, TYPE_NULL },
+        { "let i = 0\nwhile (i < 3) do\nlet i = i + 1\nend while\ni",
+                                                              1, TYPE_NUMBER },
+        { "if (1 < 2) then\nlet v = 1\nelse\nlet v = true\nend if\nv",
+                                                              1, TYPE_NUMBER },
+        { "input c\nif (c == 1) then\nlet v = 1\nelse\nlet v = true\nend if\nv",
+                                                              1, TYPE_NULL },
+        { "let b = false\nlet s = \"a\"\nb and s * 2 > 1",   1, TYPE_BOOL },
+        { "let s = \"a\"\ns * 2",                             0, TYPE_NULL },
+        { "let x = 7\nx % 2 + x \\ 2",                         1, TYPE_NUMBER },
+        { "let s = \"a\"\ns % 2",                             0, TYPE_NULL },
+        { "let b = true\n-b",                                 0, TYPE_NULL },
+        { "let x = 1\nlet b = true\nx == b",                  0, TYPE_NULL },
+        { "let s = \"a\"\nlet t = \"b\"\ns < t",              1, TYPE_BOOL },
+        { "let s = \"a\"\nlet t = s + \"b\"\nt",               1, TYPE_STRING },
+        { "let s = \"a\"\ns + 1",                             0, TYPE_NULL },
+        { "let s = \"a,b\"\nlen(field(s, \",\", 2)) * 2",         1, TYPE_NUMBER },
+        { "let s = \"a\"\nmid(s, 1)",                          1, TYPE_STRING },
+        { "let x = 1\nlen(x)",                                0, TYPE_NULL },
+        { "input p\nlet x = 1\nmid(x, p)",                   0, TYPE_NULL },
+        { "input s\nlet x = 1\nmid(s, x, x)",                1, TYPE_STRING },
+        { "let x = 1\nnot x",                                 0, TYPE_NULL },
+        { "let x = 1\nwhile (x) do\nbreak\nend while",        0, TYPE_NULL },
+        { "dim a(3)\nlet a(1) = 2\na(1) * 2",                  1, TYPE_NUMBER },
+        { "dim a(3)\na(2)",                                   1, TYPE_NUMBER },
+        { "dim a(3)\n? a",                                    0, TYPE_NULL },
+        { "dim a(3)\nlet a(1) = \"s\"",                       0, TYPE_NULL },
+        { "dim a(3)\na(mid(\"1\", 1))",                        0, TYPE_NULL },
+        { "let x = 1\nx(1)",                                  0, TYPE_NULL },
+        { "let x = 1\ndim x(3)\nx(1)",                         0, TYPE_NULL },
+        { "input c\nif (c == 1) then\nlet x = 1\nend if\ndim x(3)\nx(1)",
+                                                              1, TYPE_NUMBER },
+        { "dim a(mid(\"3\", 1))",                              0, TYPE_NULL },
+    };
+
+    int num_testes = sizeof(testes) / sizeof(testes[0]);
+    int falhas = 0;
+
+    for (int i = 0; i < num_testes; i++)
+    {
+        // Contexto novo: cada caso começa sem variáveis
+        ExecutionContext* ctx = execution_context_create();
+        Lexer lexer;
+        lexer_init(&lexer, testes[i].code);
+        ASTArena* arena = ast_arena_create();
+        ASTNode* ast = parse(&lexer, arena);
+
+        int success = -1;
+        if (ast && optimize_program(ast, ctx) && resolve_program(ast, ctx->symbols))
+        {
+            success = infer_program(ast, ctx);
+        }
+        ASTNode* last = ast ? last_expression(ast) : NULL;
+        int ok = success == testes[i].success &&
+                 (!success || (last && last->value_type == testes[i].type));
+
+        printf("%s%-4s%s %s\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO",
+               COLOR_RESET, testes[i].code);
+        if (!ok)
+        {
+            falhas++;
+            if (ast) print_ast(ast, 1);
+        }
+
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
+        execution_context_destroy(ctx);
+    }
+
+    printf("\n%s%d de %d testes OK%s\n", falhas ? COLOR_ERROR : COLOR_SUCCESS,
+           num_testes - falhas, num_testes, COLOR_RESET);
+
+    a89check_leaks();
+    return falhas != 0;
+}
+#endif
+
+
+#ifdef BENCHINFERENCE
+// gcc -O2 -DBENCHINFERENCE <todos os .c menos main.c> -lm -o bench_inference
+#include <time.h>
+#include "color.h"
+#include "utils.h"
+#include "lexer.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "resolver.h"
+#include "compiler.h"
+#include "vm.h"
+
+#define BENCH_ITERATIONS 2000000
+
+static const char* bench_source =
+    "let i = 0\n"
+    "let s = 0\n"
+    "let x = 1.5\n"
+    "while (i < 2000000) do\n"
+    "    let s = s + i * x - (i / 3)\n"
+    "    if (s > 1000000000) then\n"
+    "        let s = s - 1000000000\n"
+    "    end if\n"
+    "    let i = i + 1\n"
+    "end while\n";
+
+// Uma execução do laço com contexto novo; devolve os ms da execução
+static double bench_run(int use_inference, int use_vm, double* result)
+{
+    ExecutionContext* ctx = execution_context_create();
+    Lexer lexer;
+    lexer_init(&lexer, bench_source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+
+    double ms = -1.0;
+    if (ast && optimize_program(ast, ctx) && resolve_program(ast, ctx->symbols) &&
+        (!use_inference || infer_program(ast, ctx)))
+    {
+        Chunk chunk;
+        chunk_init(&chunk);
+        if (!use_vm || compile_program(ast, &chunk))
+        {
+            clock_t start = clock();
+            if (use_vm) vm_run(&chunk, ctx);
+            else evaluate_program(ast, ctx);
+            ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+        }
+        chunk_free(&chunk);
+
+        SymbolHandle s = symbol_table_lookup(ctx->symbols, "s");
+        *result = value_as_number(s.value->value);
+    }
+
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(ctx);
+    return ms;
+}
+
+int main()
+{
+    setup_utf8();
+
+    printf("%s=== Benchmark inferência de tipos: %d voltas ===%s\n\n",
+           COLOR_HEADER, BENCH_ITERATIONS, COLOR_RESET);
+
+    for (int use_vm = 1; use_vm >= 0; use_vm--)
+    {
+        double plain_result = 0.0, typed_result = 0.0;
+        double plain = bench_run(0, use_vm, &plain_result);
+        double typed = bench_run(1, use_vm, &typed_result);
+        int ok = plain >= 0.0 && typed >= 0.0 && plain_result == typed_result;
+
+        printf("%-3s | sem inferência %8.1f ms | com inferência %8.1f ms | %5.2fx | %s%s%s\n",
+               use_vm ? "vm" : "ast", plain, typed, plain / typed,
+               ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    }
+
+    a89check_leaks();
+    return 0;
+}
+#endif
+// Fim de inference.c
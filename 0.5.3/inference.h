@@ -0,0 +1,40 @@
+// inference.h
+
+#ifndef INFERENCE_H
+#define INFERENCE_H
+
+#include "ast.h"
+#include "evaluator.h"
+
+/********************************************************************
+Inferência de tipos, depois de resolve_program() e antes da execução.
+
+Anota cada expressão com o tipo provado do resultado (campo
+value_type do nó; TYPE_NULL = não provado). Para variáveis o tipo
+segue o fluxo do programa: a SymbolTable recusa trocar o tipo de uma
+variável, então depois da primeira atribuição ele não muda mais.
+Junções (if/else, volta do while, break/continue) só mantêm o tipo
+quando todos os caminhos concordam. dim dá à variável o tipo array,
+e a(i) é sempre number (elementos só guardam numbers).
+
+"Provado" quer dizer: se a avaliação não der erro, o valor tem esse
+tipo. Variável ainda sem valor e divisão por zero continuam sendo
+verificadas na execução.
+
+Erros de tipo certos (ex: let s = "a" seguido de s * 2, ou de
+let s = 1, que a SymbolTable recusaria) são reportados aqui com linha
+e coluna e o programa não é executado. Trocar o tipo só é erro certo
+quando a variável com certeza tem valor até ali (a execução segue
+depois de um erro: só conta a atribuição que não pode falhar). O
+lado direito de and/or pode não ser avaliado (curto-circuito): ali
+nada é reportado, só anotado.
+
+O evaluator e o compilador usam as anotações para escolher caminhos
+e opcodes sem checagem de tipo.
+
+Retorno: 1 = sucesso, 0 = erro de tipo (já reportado)
+********************************************************************/
+int infer_program(ASTNode* ast, ExecutionContext* ctx);
+
+#endif // INFERENCE_H
+// Fim de inference.h
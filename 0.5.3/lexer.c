@@ -1,40 +1,37 @@
 // lexer.c
 
-#include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdarg.h> 
+#include <errno.h>
 
 #include "color.h"
 #include "lexer.h"
+#include "a89alloc.h"
+#include "output.h"
 
-static void lexer_advance(Lexer* lexer);
+static void lexer_advance_to(Lexer* lexer, int position);
+static void lexer_skip(Lexer* lexer, int count);
 static char lexer_peek(Lexer* lexer);
-static char lexer_peek_next(Lexer* lexer);
-static void lexer_skip_whitespace(Lexer* lexer);
 
 static Token lexer_make_token(Lexer* lexer,
                               TokenType type,
-                              double number_value,
-                              char operator_char,
-                              const char* text,
+                              int start,
                               int line,
                               int column);
 
-static Token lexer_check_buffer_overflow_number(Lexer* lexer,
-                                                char* buffer,
-                                                int current_index);
-
 static Token lexer_report_error(Lexer* lexer,
                                 int line,
                                 int column,
                                 const char* format,
                                 ...);
 
-static int lexer_read_digits(Lexer* lexer, char* buffer, int* index);
+static int lexer_scan_digits(const unsigned char* source, int position);
 static Token lexer_read_number(Lexer* lexer);
-static TokenType check_keyword(const char *lexeme);
+static TokenType check_keyword(const char *lexeme, int length, uint32_t hash);
+static int lexer_intern_identifier(Lexer* lexer, int start, int length, uint32_t hash);
 static Token lexer_read_identifier(Lexer* lexer);
 static Token lexer_read_string(Lexer* lexer);
 
@@ -54,6 +51,7 @@ static const char* TOKEN_STRINGS[] =
     "STAR",             // TOKEN_STAR
     "SLASH",            // TOKEN_SLASH
     "PERCENT",          // TOKEN_PERCENT
+    "BACKSLASH",        // TOKEN_BACKSLASH
 
     "LPAREN",           // TOKEN_LPAREN
     "RPAREN",           // TOKEN_RPAREN
@@ -64,6 +62,7 @@ static const char* TOKEN_STRINGS[] =
 
     "COLON",            // TOKEN_COLON      
     "SEMICOLON",        // TOKEN_SEMICOLON   
+    "COMMA",            // TOKEN_COMMA
 
     "NL",               // TOKEN_NL   
 
@@ -131,72 +130,136 @@ static const char* TOKEN_STRINGS[] =
     "BREAK",            // TOKEN_BREAK
     "CONTINUE",          // TOKEN_CONTINUE
 
+    "DIM",              // TOKEN_DIM
+
     "NOERROR"           // TOKEN_NOERROR
 };
 
 
 // ==================================================================
-// Tabela de palavras-chave para busca rápida
+// Classes de caracteres
+//
+// O lexer é um autômato dirigido por tabela: a classe do primeiro
+// caractere escolhe o estado (número, identificador, string...) e os
+// laços de cada estado consultam a mesma tabela em vez de chamar
+// isdigit/isalpha. Bytes >= 0x80 só são válidos dentro de strings e
+// comentários.
 // ==================================================================
-typedef struct
+typedef enum
 {
-    const char *lexeme;
-    TokenType type;
-} Keyword;
+    CHAR_INVALID = 0,   // Caractere inesperado
+    CHAR_END,           // '\0'
+    CHAR_SPACE,         // ' ', '\t'
+    CHAR_NEWLINE,       // '\n' e '\r' (ver is_line_end)
+    CHAR_DIGIT,         // 0-9
+    CHAR_DOT,           // '.' (início de número)
+    CHAR_ALPHA,         // a-z, A-Z, '_'
+    CHAR_QUOTE,         // '"'
+    CHAR_HASH,          // '#' (comentário)
+    CHAR_SINGLE,        // Token de um caractere: + - * / ( ) , : ; ?
+    CHAR_COMPARE        // = ! < > (podem ser seguidos de '=')
+} CharClass;
+
+#define XX CHAR_INVALID
+#define EN CHAR_END
+#define SP CHAR_SPACE
+#define NL CHAR_NEWLINE
+#define DG CHAR_DIGIT
+#define DT CHAR_DOT
+#define AL CHAR_ALPHA
+#define QT CHAR_QUOTE
+#define HS CHAR_HASH
+#define OP CHAR_SINGLE
+#define CP CHAR_COMPARE
+
+static const unsigned char char_class[256] =
+{
+//  0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F
+    EN, XX, XX, XX, XX, XX, XX, XX, XX, SP, NL, XX, XX, NL, XX, XX,  // 0x00
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,  // 0x10
+    SP, CP, QT, HS, XX, OP, XX, XX, OP, OP, OP, OP, OP, OP, DT, OP,  // 0x20  !"#$%&'()*+,-./
+    DG, DG, DG, DG, DG, DG, DG, DG, DG, DG, OP, OP, CP, CP, CP, OP,  // 0x30 0-9:;<=>?
+    XX, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,  // 0x40 @A-O
+    AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, XX, OP, XX, XX, AL,  // 0x50 P-Z[\]^_
+    XX, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,  // 0x60 `a-o
+    AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, XX, XX, XX, XX, XX,  // 0x70 p-z{|}~
+    // 0x80-0xFF: CHAR_INVALID
+};
 
-static Keyword keywords[] = 
+#undef XX
+#undef EN
+#undef SP
+#undef NL
+#undef DG
+#undef DT
+#undef AL
+#undef QT
+#undef HS
+#undef OP
+#undef CP
+
+// Fim de linha: "\n" ou "\r\n" (arquivos do Windows são lidos sem
+// conversão). Um '\r' sozinho é tratado como espaço.
+static int is_line_end(const unsigned char* source, int position)
 {
-    {"let", TOKEN_LET},
-    {"nl", TOKEN_NL},
-    {"print", TOKEN_PRINT},
-    {"width", TOKEN_WIDTH},
-    {"left", TOKEN_LEFT},
-    {"right", TOKEN_RIGHT},
-    {"center", TOKEN_CENTER},
-    {"nocolor", TOKEN_NOCOLOR},
-    {"black", TOKEN_BLACK},
-    {"red", TOKEN_RED},
-    {"green", TOKEN_GREEN},
-    {"yellow", TOKEN_YELLOW},
-    {"blue", TOKEN_BLUE},
-    {"magenta", TOKEN_MAGENTA},
-    {"cyan", TOKEN_CYAN},
-    {"white", TOKEN_WHITE},
-    {"bred", TOKEN_BRED},
-    {"bgreen", TOKEN_BGREEN},
-    {"byellow", TOKEN_BYELLOW},
-    {"bblue", TOKEN_BBLUE},
-    {"bmagenta", TOKEN_BMAGENTA},
-    {"bcyan", TOKEN_BCYAN},
-    {"bwhite", TOKEN_BWHITE},
-    {"bgblack", TOKEN_BGBLACK},
-    {"bgred", TOKEN_BGRED},
-    {"bggreen", TOKEN_BGGREEN},
-    {"bgyellow", TOKEN_BGYELLOW},
-    {"bgblue", TOKEN_BGBLUE},
-    {"bgmagenta", TOKEN_BGMAGENTA},
-    {"bgcyan", TOKEN_BGCYAN},
-    {"bgwhite", TOKEN_BGWHITE},
-    {"input", TOKEN_INPUT},
-    {"true", TOKEN_TRUE},
-    {"false", TOKEN_FALSE},
+    return source[position] == '\n' ||
+           (source[position] == '\r' && source[position + 1] == '\n');
+}
 
-    {"if", TOKEN_IF},
-    {"then", TOKEN_THEN},
-    {"else", TOKEN_ELSE},
-    {"end", TOKEN_END},
+// Token de cada caractere CHAR_SINGLE
+static const unsigned char single_char_token[128] =
+{
+    ['+'] = TOKEN_PLUS,
+    ['-'] = TOKEN_MINUS,
+    ['*'] = TOKEN_STAR,
+    ['/'] = TOKEN_SLASH,
+    ['%'] = TOKEN_PERCENT,
+    ['\\'] = TOKEN_BACKSLASH,
+    ['('] = TOKEN_LPAREN,
+    [')'] = TOKEN_RPAREN,
+    [','] = TOKEN_COMMA,
+    [':'] = TOKEN_COLON,
+    [';'] = TOKEN_SEMICOLON,
+    ['?'] = TOKEN_QUESTION,
+};
 
-    {"and", TOKEN_AND},
-    {"or", TOKEN_OR},
-    {"not", TOKEN_NOT},
+// CHAR_COMPARE: { sozinho, seguido de '=' }
+static const unsigned char compare_token[128][2] =
+{
+    ['='] = { TOKEN_ASSIGN,  TOKEN_EQUAL },
+    ['!'] = { TOKEN_NOT,     TOKEN_NOT_EQUAL },
+    ['<'] = { TOKEN_LESS,    TOKEN_LESS_EQUAL },
+    ['>'] = { TOKEN_GREATER, TOKEN_GREATER_EQUAL },
+};
 
-    {"while", TOKEN_WHILE},
-    {"do", TOKEN_DO},
-    {"break", TOKEN_BREAK},
-    {"continue", TOKEN_CONTINUE},
 
-    {NULL, TOKEN_NULL}
-};
+// ==================================================================
+// Palavras-chave: hash perfeito
+//
+// O hash FNV-1a do identificador é calculado enquanto ele é lido.
+// A posição na tabela vem dos bits altos de (hash * KEYWORD_HASH_SEED);
+// a semente foi escolhida pelo gerador para que nenhuma palavra-chave
+// colida. Cada identificador custa um acesso e um memcmp.
+//
+// A lista de palavras-chave fica no bloco GENKEYWORDS, no fim do
+// arquivo. Depois de alterá-la, gere a tabela de novo:
+// gcc -DGENKEYWORDS lexer.c a89alloc.c utils.c output.c number_format.c -o gen_keywords
+// ./gen_keywords > lexer_keywords.h
+// ==================================================================
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME        16777619u
+
+typedef struct
+{
+    const char *lexeme;
+    unsigned char length;
+    unsigned char type;     // TokenType
+} Keyword;
+
+#include "lexer_keywords.h"
+
+#define KEYWORD_SLOT(hash) \
+    ((uint32_t)((hash) * KEYWORD_HASH_SEED) >> (32 - KEYWORD_HASH_BITS))
 
 const char* token_type_to_string(TokenType type)
 {
@@ -238,31 +301,33 @@ Bytes starting with 110xxxxx: start of 2-byte character
 
 Bytes starting with 10xxxxxx: continuation byte
 
-Your code (lexer->current_char & 0b11000000) != 0b10000000 checks:
+The check (uc & 0b11000000) != 0b10000000 in lexer_advance_to:
 
 If it's NOT a continuation byte (10xxxxxx)
 
 Then it's a new character ==> increment column
 *******************************************************************/
-static void lexer_advance(Lexer* lexer)
+static void lexer_advance_to(Lexer* lexer, int position)
 {
-    // Convert to unsigned to avoid problems with signed char
-    unsigned char uc = (unsigned char)lexer->current_char;
+    const unsigned char* source = (const unsigned char*)lexer->source;
 
-    if(lexer->current_char == '\n')
-    {        
-        lexer->line++;
-        lexer->column = 1;
-    }
-    else
+    for (int p = lexer->position; p < position; p++)
     {
-        if ((uc & 0b11000000) != 0b10000000)
+        // Convert to unsigned to avoid problems with signed char
+        unsigned char uc = source[p];
+
+        if (uc == '\n')
+        {        
+            lexer->line++;
+            lexer->column = 1;
+        }
+        else if ((uc & 0b11000000) != 0b10000000)
         {
             lexer->column++;        
         }
     }
 
-    lexer->position++;
+    lexer->position = position;
     if (lexer->position >= lexer->source_size)
     {
         lexer->current_char = '\0';
@@ -273,6 +338,15 @@ static void lexer_advance(Lexer* lexer)
     }
 }
 
+// Avança count caracteres ASCII sem '\n' (identificadores,
+// números, espaços e operadores): a coluna anda o mesmo tanto
+static void lexer_skip(Lexer* lexer, int count)
+{
+    lexer->position += count;
+    lexer->column += count;
+    lexer->current_char = lexer->source[lexer->position];
+}
+
 static char lexer_peek(Lexer* lexer)
 {
     if (lexer->source[lexer->position] == '\0')
@@ -282,45 +356,23 @@ static char lexer_peek(Lexer* lexer)
     return lexer->source[lexer->position + 1];
 }
 
-// Returns the next character without advancing (lookahead)
-static char lexer_peek_next(Lexer* lexer)
-{
-    if (lexer->position + 1 < lexer->source_size)
-    {
-        return lexer->source[lexer->position + 1];
-    }
-    return '\0';
-}
 
-static void lexer_skip_whitespace(Lexer* lexer)
+// Token cujo lexema vai de start até a posição atual do lexer
+static Token lexer_make_token(Lexer* lexer,
+                              TokenType type,
+                              int start,
+                              int line,
+                              int column)
 {
-    while (lexer->current_char == ' ' || 
-           lexer->current_char == '\t' ||
-           lexer->current_char == '\r')
-    {  
-        lexer_advance(lexer);
-    }
-}
+    Token token;
+    memset(&token, 0, sizeof(token));
 
+    token.type = (unsigned char)type;
+    token.start = start;
+    token.length = (unsigned short)(lexer->position - start);
+    token.line = line;
+    token.column = column;
 
-// Helper function to check buffer overflow and report error
-static Token lexer_check_buffer_overflow_number(Lexer* lexer,
-                                                char* buffer,
-                                                int current_index)
-{
-    if (current_index > NUMBER_SIZE - 1)
-    {
-        buffer[NUMBER_SIZE - 1] = '\0';
-        return lexer_report_error(lexer,
-                                  lexer->line,
-                                  lexer->column,
-                                  "buffer overflow (maximum %d characters)",
-                                  NUMBER_SIZE);      
-    }
- 
-    Token token;
-    memset(&token, 0, sizeof(token));  
-    token.type = TOKEN_NOERROR;
     return token;
 }
 
@@ -337,9 +389,9 @@ static Token lexer_report_error(Lexer* lexer,
     vsnprintf(message, sizeof(message), format, args);
     va_end(args);
     
-    char error_text[TOKENTEXT_SIZE];
-    snprintf(error_text,
-             sizeof(error_text),
+    // A mensagem fica no lexer; o token só guarda a posição
+    snprintf(lexer->error_message,
+             sizeof(lexer->error_message),
              "Lexer error: %s",
              message);
     
@@ -347,103 +399,103 @@ static Token lexer_report_error(Lexer* lexer,
     memset(&token, 0, sizeof(token));  
 
     token.type = TOKEN_ERROR;
-    strncpy(token.text, error_text, TOKENTEXT_SIZE - 1);
-    token.text[TOKENTEXT_SIZE - 1] = '\0';
+    token.start = lexer->position;
     token.line = line;
     token.column = column;
 
     return token;
 }
 
-static int lexer_read_digits(Lexer* lexer,
-                             char* buffer,
-                             int* index)
+static int lexer_scan_digits(const unsigned char* source, int position)
 {
-    while (isdigit(lexer->current_char) && lexer->current_char != '\0')
+    while (char_class[source[position]] == CHAR_DIGIT)
     {
-        // CHECK BUFFER OVERFLOW
-        if((*index) > NUMBER_SIZE - 1)
-        {
-            return 0;
-        }
-
-        buffer[(*index)++] = lexer->current_char;
-        lexer_advance(lexer);
+        position++;
     }
-    
-    return 1;
+    return position;
 }
 
 static Token lexer_read_number(Lexer* lexer)
 {
-    char buffer[NUMBER_SIZE];
-    int i = 0;
+    const unsigned char* source = (const unsigned char*)lexer->source;
+    int start = lexer->position;
 
     int nr_line = lexer->line;
     int nr_column = lexer->column;
 
     // Integer part
-    if (!lexer_read_digits(lexer, buffer, &i))
-    {
-        return lexer_report_error(lexer,
-                                  nr_line,
-                                  nr_column, 
-                                 "buffer overflow while reading integer part");
-    }
+    int p = lexer_scan_digits(source, start);
+    int has_fraction = 0;
 
     // Decimal part (optional)
-    if (lexer->current_char == '.')
+    if (source[p] == '.')
     {
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
+        has_fraction = 1;
+        p++;
 
-        if (!isdigit(lexer->current_char))
+        if (char_class[source[p]] != CHAR_DIGIT)
         {
-            // Add invalid char to buffer to show in error
-            buffer[i++] = lexer->current_char;
-            lexer_advance(lexer);
+            // Consume invalid char to show in error
+            if (source[p] != '\0') p++;
 
-            // Try to read more digits (to capture complete invalid pattern)
-            lexer_read_digits(lexer, buffer, &i);  // Ignore error here, just want to capture
-            
-            buffer[i] = '\0';
+            // Read more digits (to capture complete invalid pattern)
+            p = lexer_scan_digits(source, p);
+            lexer_advance_to(lexer, p);
 
-            return lexer_report_error(lexer, nr_line, nr_column, "invalid number '%s'", buffer);     
+            return lexer_report_error(lexer, nr_line, nr_column, "invalid number '%.*s'",
+                                      p - start, lexer->source + start);
         }
 
         // Read digits after decimal point
-        if (!lexer_read_digits(lexer, buffer, &i))
-        {
-            return lexer_report_error(lexer,
-                                      nr_line,
-                                      nr_column,
-                                      "buffer overflow while reading decimal part");
-        }
+        p = lexer_scan_digits(source, p);
     }
     // End of decimal part
 
     // DETECT SECOND POINT (BUG!)
-    if (lexer->current_char == '.')
+    if (source[p] == '.')
     {
-        Token error_check = lexer_check_buffer_overflow_number(lexer, buffer, i);
-        if (error_check.type == TOKEN_ERROR) return error_check;
+        p = lexer_scan_digits(source, p + 1);
+        lexer_skip(lexer, p - start);
 
-        // Add second point to buffer to show in error
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
+        return lexer_report_error(lexer, nr_line, nr_column, "invalid number '%.*s'",
+                                  p - start, lexer->source + start);
+    } 
 
-        // Try to read more digits (to capture complete invalid pattern)
-        lexer_read_digits(lexer, buffer, &i);  // Ignore error here, just want to capture
+    lexer_skip(lexer, p - start);
 
-        buffer[i] = '\0';
-        return lexer_report_error(lexer, nr_line, nr_column, "invalid number '%s'", buffer);           
-    } 
+    int length = p - start;
+    if (length > NUMBER_SIZE - 1)
+    {
+        return lexer_report_error(lexer,
+                                  nr_line,
+                                  nr_column,
+                                  "buffer overflow (maximum %d characters)",
+                                  NUMBER_SIZE);
+    }
 
-    // Terminate string
-    buffer[i] = '\0';
+    // strtoll/strtod precisam de string terminada: copia só o lexema
+    char buffer[NUMBER_SIZE];
+    memcpy(buffer, lexer->source + start, length);
+    buffer[length] = '\0';
 
-    // Convert to double
+    Token token = lexer_make_token(lexer, TOKEN_NUMBER, start, nr_line, nr_column);
     char* endptr;
+
+    // Sem parte decimal: inteiro exato em int64. Só o que não cabe
+    // (acima de 9223372036854775807) vai para double
+    if (!has_fraction)
+    {
+        errno = 0;
+        long long integer = strtoll(buffer, &endptr, 10);
+        if (errno != ERANGE && *endptr == '\0')
+        {
+            token.value.integer = (int64_t)integer;
+            token.is_integer = 1;
+            return token;
+        }
+    }
+
+    // Convert to double
     double valor = strtod(buffer, &endptr);
     
     if (*endptr != '\0')
@@ -452,124 +504,172 @@ static Token lexer_read_number(Lexer* lexer)
                                   buffer);
     }
 
-    Token token;
-    memset(&token, 0, sizeof(token));
-
-    token.type = TOKEN_NUMBER;
     token.value.number = valor;
-    strncpy(token.text, buffer, TOKENTEXT_SIZE - 1);
-    token.text[TOKENTEXT_SIZE - 1] = '\0';
-    token.line = nr_line;
-    token.column = nr_column;
 
     return token;
 }
 
-// Verifica se o lexeme é uma palavra-chave
-static TokenType check_keyword(const char *lexeme)
+// Verifica se o lexeme (não terminado em '\0') é uma palavra-chave
+static TokenType check_keyword(const char *lexeme, int length, uint32_t hash)
+{
+    const Keyword* keyword = &keyword_table[KEYWORD_SLOT(hash)];
+
+    if (keyword->length == length &&
+        memcmp(keyword->lexeme, lexeme, length) == 0)
+    {
+        return keyword->type;
+    }
+    return TOKEN_NULL; // Não é palavra-chave
+}
+
+/*******************************************************************
+Internação de identificadores
+
+Cada nome distinto recebe um id sequencial (0, 1, 2...). A tabela é
+de endereçamento aberto (sondagem linear) e guarda apenas offsets no
+source, então nenhum nome é copiado. O hash é o mesmo FNV-1a usado
+para as palavras-chave. Cresce ao passar de 50% de ocupação.
+*******************************************************************/
+static void lexer_identifiers_grow(Lexer* lexer)
 {
-    for (int i = 0; keywords[i].lexeme != NULL; i++)
+    int old_capacity = lexer->identifier_capacity;
+    LexerIdentifier* old_entries = lexer->identifiers;
+
+    int capacity = old_capacity == 0 ? 64 : old_capacity * 2;
+    LexerIdentifier* entries = A89ALLOC(capacity * sizeof(LexerIdentifier));
+    for (int i = 0; i < capacity; i++)
+    {
+        entries[i].id = -1;
+    }
+
+    // Reinsere as entradas existentes
+    for (int i = 0; i < old_capacity; i++)
     {
-        if (strcmp(lexeme, keywords[i].lexeme) == 0)
+        if (old_entries[i].id < 0) continue;
+
+        int index = old_entries[i].hash & (capacity - 1);
+        while (entries[index].id >= 0)
         {
-            return keywords[i].type;
+            index = (index + 1) & (capacity - 1);
         }
+        entries[index] = old_entries[i];
     }
-    return TOKEN_NULL; // Não é palavra-chave
+
+    a89free(old_entries);
+    lexer->identifiers = entries;
+    lexer->identifier_capacity = capacity;
+}
+
+static int lexer_intern_identifier(Lexer* lexer, int start, int length, uint32_t hash)
+{
+    if ((lexer->identifier_count + 1) * 2 > lexer->identifier_capacity)
+    {
+        lexer_identifiers_grow(lexer);
+    }
+
+    const char* text = lexer->source + start;
+    int mask = lexer->identifier_capacity - 1;
+    int index = hash & mask;
+
+    while (lexer->identifiers[index].id >= 0)
+    {
+        LexerIdentifier* entry = &lexer->identifiers[index];
+        if (entry->hash == hash &&
+            entry->length == length &&
+            memcmp(lexer->source + entry->start, text, length) == 0)
+        {
+            return entry->id;
+        }
+        index = (index + 1) & mask;
+    }
+
+    LexerIdentifier* entry = &lexer->identifiers[index];
+    entry->hash = hash;
+    entry->start = start;
+    entry->length = length;
+    entry->id = lexer->identifier_count++;
+
+    return entry->id;
 }
 
 static Token lexer_read_identifier(Lexer* lexer)
 {
-    char buffer[VARNAME_SIZE];
-    int i = 0;
+    const unsigned char* source = (const unsigned char*)lexer->source;
+    int start = lexer->position;
 
     int id_line = lexer->line;
     int id_column = lexer->column;
     
-    // Read identifier
-    while (isalnum(lexer->current_char) || lexer->current_char == '_')
+    // Read identifier (hash calculado na mesma passada)
+    uint32_t hash = FNV_OFFSET_BASIS;
+    int p = start;
+    while (char_class[source[p]] == CHAR_ALPHA || char_class[source[p]] == CHAR_DIGIT)
     {
-        if (i > VARNAME_SIZE - 1)
-        {
-            buffer[VARNAME_SIZE - 1] = '\0';
-            return lexer_report_error(lexer,
-                                      id_line,
-                                      id_column,
-                                      "Identifier too long (max %d chars): '%.30s...'",
-                                      VARNAME_SIZE,
-                                      buffer);
-        }
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
+        hash ^= source[p];
+        hash *= FNV_PRIME;
+        p++;
     }
-    buffer[i] = '\0';
-    
-    Token token;
-    memset(&token, 0, sizeof(token));
+    lexer_skip(lexer, p - start);
 
+    int length = p - start;
+    if (length > VARNAME_SIZE - 1)
+    {
+        return lexer_report_error(lexer,
+                                  id_line,
+                                  id_column,
+                                  "Identifier too long (max %d chars): '%.30s...'",
+                                  VARNAME_SIZE,
+                                  lexer->source + start);
+    }
+    
     // Check keywords
-    TokenType token_type = check_keyword(buffer);
+    TokenType token_type = check_keyword(lexer->source + start, length, hash);
     if (token_type != TOKEN_NULL)
     {
-        token.type = token_type;
-        strcpy(token.text, buffer);
-        strcpy(token.value.string, buffer);
+        return lexer_make_token(lexer, token_type, start, id_line, id_column);
     }
     //================ SE CHEGOU AQUI NÃO É PALAVRA-CHAVE ==========================
-    else
-    {
-        token.type = TOKEN_IDENTIFIER;
-        strcpy(token.value.varname, buffer);
-    }
 
-    token.line = id_line;
-    token.column = id_column;
+    Token token = lexer_make_token(lexer, TOKEN_IDENTIFIER, start, id_line, id_column);
+    token.value.id = lexer_intern_identifier(lexer, start, length, hash);
 
     return token; 
 }
 
 static Token lexer_read_string(Lexer* lexer) {
-    char buffer[STRING_SIZE];
-    int i = 0;
+    const unsigned char* source = (const unsigned char*)lexer->source;
+    int start = lexer->position;
 
     int str_line = lexer->line;
     int str_column = lexer->column;
     
-    lexer_advance(lexer); // Skip opening quote
+    int p = start + 1; // Skip opening quote
     
-    while (lexer->current_char != '"' && 
-           lexer->current_char != '\0' && 
-           lexer->current_char != '\n' &&
-           i < STRING_SIZE-1)
+    while (source[p] != '"' && 
+           source[p] != '\0' && 
+           !is_line_end(source, p))
     {
-        buffer[i++] = lexer->current_char;
-        lexer_advance(lexer);
+        p++;
     }
+
+    // Conteúdo pode ter UTF-8: a coluna conta caracteres, não bytes
+    lexer_advance_to(lexer, p);
     
-    if (lexer->current_char != '"')
+    if (source[p] != '"')
     {
-        buffer[i] = '\0';
         return lexer_report_error(lexer,
                                   str_line,
                                   str_column,
-                                  "missing terminating \" character: %s",
-                                  buffer);
+                                  "missing terminating \" character: %.*s",
+                                  p - start - 1,
+                                  lexer->source + start + 1);
     }
     
-    buffer[i] = '\0';
-    lexer_advance(lexer); // Skip closing quote
+    lexer_skip(lexer, 1); // Skip closing quote
  
-    Token token;
-    memset(&token, 0, sizeof(token));
-
-    token.type = TOKEN_STRING;
-
-    strcpy(token.text, "\""); // For debug, keep quotes in text
-    strcat(token.text, buffer);
-    strcat(token.text, "\"");
-    
-    // Store content without quotes in string_value field
-    strcpy(token.value.string, buffer);
+    // Lexema inclui as aspas (ver lexer_token_string para o conteúdo)
+    // Linha e coluna ficam zeradas, como sempre foi para strings
+    Token token = lexer_make_token(lexer, TOKEN_STRING, start, 0, 0);
     
     return token;
 }
@@ -580,285 +680,233 @@ static Token lexer_read_string(Lexer* lexer) {
 // ============================================
 void lexer_init(Lexer* lexer,
                 const char* source)
+{
+    lexer_init_buffer(lexer, source, strlen(source));
+}
+
+// source[length] precisa ser '\0': o lexer usa o terminador como
+// sentinela em vez de comparar a posição com o tamanho
+void lexer_init_buffer(Lexer* lexer,
+                       const char* source,
+                       size_t length)
 {
     lexer->source = source;
-    lexer->source_size = (int)strlen(source);
+    lexer->source_size = (int)length;
     lexer->position = 0;
     lexer->line = 1;
     lexer->column = 1;
     lexer->current_char = source[0];
+
+    lexer->identifiers = NULL;
+    lexer->identifier_capacity = 0;
+    lexer->identifier_count = 0;
+
+    lexer->error_message[0] = '\0';
+}
+
+void lexer_free(Lexer* lexer)
+{
+    a89free(lexer->identifiers);
+    lexer->identifiers = NULL;
+    lexer->identifier_capacity = 0;
+    lexer->identifier_count = 0;
 }
 
 Token lexer_get_next_token(Lexer* lexer)
 {
+    const unsigned char* source = (const unsigned char*)lexer->source;
+    int p = lexer->position;
+
+    // Estado inicial: espaços e comentários não geram token
     while (1)  
     {
-        lexer_skip_whitespace(lexer);
+        CharClass char_type = char_class[source[p]];
+
+        if (char_type == CHAR_SPACE)
+        {
+            while (char_class[source[p]] == CHAR_SPACE) p++;
+            lexer_skip(lexer, p - lexer->position);
+            continue;
+        }
 
         // COMMENTS
-        if (lexer->current_char == '#')
+        if (char_type == CHAR_HASH)
         {
             // Skip everything until end of line BUT DON'T consume the \n
-            while (lexer->current_char != '\n' && 
-                   lexer->current_char != '\0')
-            {
-                lexer_advance(lexer);
-            }
+            while (!is_line_end(source, p) && source[p] != '\0') p++;
+            lexer_advance_to(lexer, p);
             // DON'T consume the \n! It will be returned as TOKEN_EOL
             // Continue in loop to check for more spaces/comments
             continue;
         }
+
+        if (char_type == CHAR_NEWLINE && !is_line_end(source, p))
+        {
+            // '\r' solto
+            lexer_skip(lexer, 1);
+            p++;
+            continue;
+        }
         // If not a comment, break from loop and process token
         break;
     }
 
     // NOW process token normally
-    Token token;
-    memset(&token, 0, sizeof(token));
-
+    int start = p;
     int line = lexer->line;
     int column = lexer->column;        
-    char c = lexer->current_char;
-    
-    // End of file
-    if (c == '\0')
-    {
-        token.type = TOKEN_EOF;
-        token.line = line;
-        token.column = column;
-
-        return token;
-    }
-    
-    // Numbers
-    if (isdigit(c) || c == '.')
-    {
-        return lexer_read_number(lexer);
-    }
+    unsigned char c = source[p];
+    TokenType type;
     
-    // Identifiers
-    if (isalpha(c) || c == '_')
+    switch ((CharClass)char_class[c])
     {
-        return lexer_read_identifier(lexer);
-    }
-
-    if(c == '"')
-    {
-        return lexer_read_string(lexer);
-    }
-
-    // Operators and special characters
-    switch (c)
-    {
-        case '+':
-            lexer_advance(lexer);
-            token.type = TOKEN_PLUS;
-            strcpy(token.text, "+");
-            token.line = line;
-            token.column = column;
-            return token;
-
-        case '-':
-            lexer_advance(lexer);
-            token.type = TOKEN_MINUS;
-            strcpy(token.text, "-");
-            token.line = line;
-            token.column = column;
-            return token;
-            
-        case '*':
-            lexer_advance(lexer);
-            token.type = TOKEN_STAR;
-            strcpy(token.text, "*");
-            token.line = line;
-            token.column = column;
-            return token;
-
-            
-        case '/':
-            lexer_advance(lexer);
-            token.type = TOKEN_SLASH;
-            strcpy(token.text, "/");
-            token.line = line;
-            token.column = column;
-            return token;
-            
-        case '(':
-            lexer_advance(lexer);
-            token.type = TOKEN_LPAREN;
-            strcpy(token.text, "(");
-            token.line = line;
-            token.column = column;
-            return token;
-            
-        case ')':
-            lexer_advance(lexer);
-            token.type = TOKEN_RPAREN;
-            strcpy(token.text, ")");
-            token.line = line;
-            token.column = column;
-            return token;
-
-        case '=':
-        {
-            if(lexer_peek_next(lexer) == '=')
+        // End of file
+        case CHAR_END:
+            return lexer_make_token(lexer, TOKEN_EOF, start, line, column);
+
+        // Numbers
+        case CHAR_DIGIT:
+        case CHAR_DOT:
+            return lexer_read_number(lexer);
+
+        // Identifiers
+        case CHAR_ALPHA:
+            return lexer_read_identifier(lexer);
+
+        case CHAR_QUOTE:
+            return lexer_read_string(lexer);
+
+        case CHAR_NEWLINE:
+            // "\r\n" vira um único TOKEN_EOL
+            lexer_advance_to(lexer, p + (c == '\r' ? 2 : 1));
+            return lexer_make_token(lexer, TOKEN_EOL, start, line, column);
+
+        // Operators and special characters
+        case CHAR_SINGLE:
+            type = single_char_token[c];
+            lexer_skip(lexer, 1);
+            return lexer_make_token(lexer, type, start, line, column);
+
+        case CHAR_COMPARE:
+            if (source[p + 1] == '=')
             {
-                token.type = TOKEN_EQUAL;
-                strcpy(token.text, "==");
-                token.line = line;
-                token.column = column;
-                lexer_advance(lexer); // Primeiro '='
-                lexer_advance(lexer); // Segundo '='
-                return token;
+                type = compare_token[c][1];
+                lexer_skip(lexer, 2);
             }
-            token.type = TOKEN_ASSIGN;
-            strcpy(token.text, "=");
-            token.line = line;
-            token.column = column;
-            lexer_advance(lexer);
-            return token;             
-        }
-
-        case '!':
-        {
-            if(lexer_peek_next(lexer) == '=')
-            {
-                token.type = TOKEN_NOT_EQUAL;
-                strcpy(token.text, "!=");
-                token.line = line;
-                token.column = column;
-                lexer_advance(lexer); 
-                lexer_advance(lexer); 
-                return token;
-            } 
-            token.type = TOKEN_NOT;
-            strcpy(token.text, "!");
-            token.line = line;
-            token.column = column;
-            lexer_advance(lexer);
-            return token;         
-        }
-
-        case '<':
-        {
-            if(lexer_peek_next(lexer) == '=')
-            {
-                token.type = TOKEN_LESS_EQUAL;
-                strcpy(token.text, "<=");
-                token.line = line;
-                token.column = column;
-                lexer_advance(lexer); 
-                lexer_advance(lexer); 
-                return token;
-            } 
-            token.type = TOKEN_LESS;
-            strcpy(token.text, "<");
-            token.line = line;
-            token.column = column;
-            lexer_advance(lexer);
-            return token; 
-        }  
-
-        case '>':
-        {
-            if(lexer_peek_next(lexer) == '=')
+            else
             {
-                token.type = TOKEN_GREATER_EQUAL;
-                strcpy(token.text, ">=");
-                token.line = line;
-                token.column = column;
-                lexer_advance(lexer); 
-                lexer_advance(lexer); 
-                return token;
-            } 
-            token.type = TOKEN_GREATER;
-            strcpy(token.text, ">");
-            token.line = line;
-            token.column = column;
-            lexer_advance(lexer);
-            return token; 
-        } 
-
-        case '\n':
-            lexer_advance(lexer);
-            token.type = TOKEN_EOL;
-            strcpy(token.text, "EOL");
-            token.line = line;
-            token.column = column;
-            return token; 
-
-        case ':':
-            lexer_advance(lexer);
-            token.type = TOKEN_COLON;
-            strcpy(token.text, ":");
-            token.line = line;
-            token.column = column;
-            return token;
-
-        case ';':
-            lexer_advance(lexer);
-            token.type = TOKEN_SEMICOLON;
-            strcpy(token.text, ";");
-            token.line = line;
-            token.column = column;
-            return token;
+                type = compare_token[c][0];
+                lexer_skip(lexer, 1);
+            }
+            return lexer_make_token(lexer, type, start, line, column);
 
-        case '?':
-            lexer_advance(lexer);
-            token.type = TOKEN_QUESTION;
-            strcpy(token.text, "?");
-            token.line = line;
-            token.column = column;
-            return token;
-            
         default:
         {
             char error_msg[BUFFER_SIZE];
             snprintf(error_msg,
                      sizeof(error_msg),
                      "Unexpected character: '%c' (ASCII %d)",
-                     c,
-                     (int)c);
+                     (char)c,
+                     (int)(char)c);
             return lexer_report_error(lexer, line, column, "%s", error_msg);
         }
     }
 }
 
-void lexer_print_token(Token token)
+// Ponteiro para o início do lexema no source (não terminado em '\0')
+const char* lexer_token_start(const Lexer* lexer, Token token)
+{
+    return lexer->source + token.start;
+}
+
+// Copia o texto do token para buffer:
+// - EOL: "EOL"; EOF: ""; ERROR: mensagem do lexer
+// - STRING: lexema com aspas
+// - demais: o lexema
+void lexer_token_text(const Lexer* lexer, Token token, char* buffer, size_t size)
+{
+    if (size == 0) return;
+
+    const char* text;
+    size_t length;
+
+    switch (token.type)
+    {
+        case TOKEN_EOL:   text = "EOL"; length = 3; break;
+        case TOKEN_EOF:   text = "";    length = 0; break;
+        case TOKEN_ERROR:
+            text = lexer->error_message;
+            length = strlen(text);
+            break;
+        default:
+            text = lexer->source + token.start;
+            length = token.length;
+            break;
+    }
+
+    if (length > size - 1) length = size - 1;
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+}
+
+// Copia o conteúdo de um TOKEN_STRING (sem as aspas) para buffer
+void lexer_token_string(const Lexer* lexer, Token token, char* buffer, size_t size)
+{
+    if (size == 0) return;
+
+    size_t length = token.length >= 2 ? token.length - 2 : 0;
+    if (length > size - 1) length = size - 1;
+
+    memcpy(buffer, lexer->source + token.start + 1, length);
+    buffer[length] = '\0';
+}
+
+const char* lexer_token_contents(const Lexer* lexer, Token token, size_t* length)
+{
+    *length = token.length >= 2 ? token.length - 2 : 0;
+    return lexer->source + token.start + 1;
+}
+
+void lexer_print_token(const Lexer* lexer, Token token)
 {
     printf("(%d:%d)", token.line, token.column);
     printf("[%s]", TOKEN_STRINGS[token.type]);
     
+    const char* lexeme = lexer_token_start(lexer, token);
+
     if (token.type == TOKEN_NUMBER)
     {
-        printf(": %g", token.value.number);
-        if (token.text[0] != '\0')
-        {
-            printf(" (text: %s)", token.text);
-        }
+        if (token.is_integer) printf(": %lld", (long long)token.value.integer);
+        else printf(": %g", token.value.number);
+        printf(" (text: %.*s)", token.length, lexeme);
     }
     else if (token.type == TOKEN_STRING)
     {
-        printf(": %s", token.value.string);
+        printf(": %.*s", token.length - 2, lexeme + 1);
     }
     else if (token.type == TOKEN_IDENTIFIER)
     {
-        printf(": %s", token.value.varname);
+        printf(": %.*s", token.length, lexeme);
     }
     else if (token.type == TOKEN_ERROR)
     {
-        printf("%s\n%s\n%s", COLOR_ERROR, token.text, COLOR_RESET);
+        printf("%s\n%s\n%s", output_ansi(COLOR_ERROR), lexer->error_message, output_ansi(COLOR_RESET));
+    }
+    else if (token.type == TOKEN_EOL)
+    {
+        printf(": EOL");
     }
-    // keywords, se não estiverem nos else if acima, caem aqui
-    else if (token.text[0] != '\0')
+    // keywords e operadores, se não estiverem nos else if acima, caem aqui
+    else if (token.length > 0)
     {
-        printf(": %s", token.text);
+        printf(": %.*s", token.length, lexeme);
     }
 }
 
+
 void lexer_print_all_tokens(const char* source)
 {
-    printf("%s=== LEXICAL ANALYSIS ===\n%s", COLOR_HEADER, COLOR_RESET);
+    printf("%s=== LEXICAL ANALYSIS ===\n%s", output_ansi(COLOR_HEADER), output_ansi(COLOR_RESET));
     printf("Source code: \"%s\"\n\n", source);
     
     Lexer lexer;
@@ -871,14 +919,17 @@ void lexer_print_all_tokens(const char* source)
     {
         token = lexer_get_next_token(&lexer);
         printf("%3d: ", ++token_count);
-        lexer_print_token(token);
+        lexer_print_token(&lexer, token);
         printf("\n");
     }
     while (token.type != TOKEN_EOF && token.type != TOKEN_ERROR);
+
+    lexer_free(&lexer);
     
     if (token.type == TOKEN_ERROR)
     {
-        printf(COLOR_WARNING "\nAnalysis interrupted due to lexical error.\n" COLOR_RESET);
+        printf("%s\nAnalysis interrupted due to lexical error.\n%s",
+               output_ansi(COLOR_WARNING), output_ansi(COLOR_RESET));
     }
     
     printf("\nTotal tokens: %d\n", token_count);
@@ -901,4 +952,243 @@ int main()
 }
 #endif
 
+// ============================================
+// BENCHMARK: tokens por segundo
+// Gera bench_lexer.zz (vários MB) e tokeniza o arquivo inteiro
+// gcc -O2 -DBENCHLEXER lexer.c a89alloc.c utils.c output.c number_format.c -o bench_lexer
+// ============================================
+
+#ifdef BENCHLEXER
+#include <time.h>
+#include "utils.h"
+#include "a89alloc.h"
+
+#define BENCH_FILE   "bench_lexer.zz"
+#define BENCH_BLOCKS 40000
+
+// Escreve um programa com a mistura usual de comandos, cores e comentários
+static void bench_generate(const char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        printf("%sErro criando %s%s\n", COLOR_ERROR, filename, COLOR_RESET);
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int i = 0; i < BENCH_BLOCKS; i++)
+    {
+        int v = i % 500;
+        fprintf(file, "# bloco %d: cálculo e saída\n", i);
+        fprintf(file, "let total_%d = (preco_%d + 3.25) * quantidade - 42 / desconto\n", v, v);
+        fprintf(file, "let nome_%d = \"cliente número %d\"\n", v, i);
+        fprintf(file, "if (total_%d >= 100 and not bloqueado) then\r\n", v);
+        fprintf(file, "    print bgreen \"total: \" width 12 right total_%d nl\n", v);
+        fprintf(file, "else\n");
+        fprintf(file, "    ? yellow nome_%d ; total_%d != 0 ; total_%d <= limite nl\n", v, v, v);
+        fprintf(file, "end if\n");
+    }
+    
+    fclose(file);
+}
+
+static char* bench_read(const char* filename, long* size)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file) exit(EXIT_FAILURE);
+    
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    char* source = A89ALLOC(*size + 1);
+    if (fread(source, 1, *size, file) != (size_t)*size) exit(EXIT_FAILURE);
+    source[*size] = '\0';
+    
+    fclose(file);
+    return source;
+}
+
+int main()
+{
+    setup_utf8();
+    printf("%s=== Benchmark Lexer ===%s\n\n", COLOR_HEADER, COLOR_RESET);
+    
+    bench_generate(BENCH_FILE);
+    
+    long size;
+    char* source = bench_read(BENCH_FILE, &size);
+    
+    int rounds = 5;
+    long tokens = 0;
+    int errors = 0;
+    
+    clock_t start = clock();
+    for (int r = 0; r < rounds; r++)
+    {
+        Lexer lexer;
+        lexer_init(&lexer, source);
+        
+        Token token;
+        do
+        {
+            token = lexer_get_next_token(&lexer);
+            tokens++;
+            if (token.type == TOKEN_ERROR) errors++;
+        }
+        while (token.type != TOKEN_EOF);
+        
+        lexer_free(&lexer);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    double mb = (double)size * rounds / (1024.0 * 1024.0);
+    printf("%s: %.1f MB x %d | %ld tokens | %.1f ms\n",
+           BENCH_FILE, (double)size / (1024.0 * 1024.0), rounds, tokens, seconds * 1000.0);
+    printf("%.2f Mtokens/s | %.1f MB/s | %s%s%s\n",
+           tokens / seconds / 1e6, mb / seconds,
+           errors ? COLOR_ERROR : COLOR_SUCCESS, errors ? "ERRO" : "OK", COLOR_RESET);
+    
+    a89free(source);
+    remove(BENCH_FILE);
+    
+    a89check_leaks();
+    return 0;
+}
+#endif
+
+// ============================================
+// GERADOR da tabela de palavras-chave (lexer_keywords.h)
+// gcc -DGENKEYWORDS lexer.c a89alloc.c utils.c output.c number_format.c -o gen_keywords
+// ./gen_keywords > lexer_keywords.h
+// ============================================
+
+#ifdef GENKEYWORDS
+
+// Fonte da tabela: para criar uma palavra-chave, inclua aqui e gere de novo
+static const struct
+{
+    const char *lexeme;
+    TokenType type;
+} keywords[] = 
+{
+    {"let", TOKEN_LET},
+    {"nl", TOKEN_NL},
+    {"print", TOKEN_PRINT},
+    {"width", TOKEN_WIDTH},
+    {"left", TOKEN_LEFT},
+    {"right", TOKEN_RIGHT},
+    {"center", TOKEN_CENTER},
+    {"nocolor", TOKEN_NOCOLOR},
+    {"black", TOKEN_BLACK},
+    {"red", TOKEN_RED},
+    {"green", TOKEN_GREEN},
+    {"yellow", TOKEN_YELLOW},
+    {"blue", TOKEN_BLUE},
+    {"magenta", TOKEN_MAGENTA},
+    {"cyan", TOKEN_CYAN},
+    {"white", TOKEN_WHITE},
+    {"bred", TOKEN_BRED},
+    {"bgreen", TOKEN_BGREEN},
+    {"byellow", TOKEN_BYELLOW},
+    {"bblue", TOKEN_BBLUE},
+    {"bmagenta", TOKEN_BMAGENTA},
+    {"bcyan", TOKEN_BCYAN},
+    {"bwhite", TOKEN_BWHITE},
+    {"bgblack", TOKEN_BGBLACK},
+    {"bgred", TOKEN_BGRED},
+    {"bggreen", TOKEN_BGGREEN},
+    {"bgyellow", TOKEN_BGYELLOW},
+    {"bgblue", TOKEN_BGBLUE},
+    {"bgmagenta", TOKEN_BGMAGENTA},
+    {"bgcyan", TOKEN_BGCYAN},
+    {"bgwhite", TOKEN_BGWHITE},
+    {"input", TOKEN_INPUT},
+    {"true", TOKEN_TRUE},
+    {"false", TOKEN_FALSE},
+
+    {"if", TOKEN_IF},
+    {"then", TOKEN_THEN},
+    {"else", TOKEN_ELSE},
+    {"end", TOKEN_END},
+
+    {"and", TOKEN_AND},
+    {"or", TOKEN_OR},
+    {"not", TOKEN_NOT},
+
+    {"while", TOKEN_WHILE},
+    {"do", TOKEN_DO},
+    {"break", TOKEN_BREAK},
+    {"continue", TOKEN_CONTINUE},
+
+    {"dim", TOKEN_DIM},
+};
+
+#define KEYWORD_COUNT ((int)(sizeof(keywords) / sizeof(keywords[0])))
+#define GEN_HASH_BITS 7
+#define GEN_SLOT(hash, seed) \
+    ((uint32_t)((hash) * (seed)) >> (32 - GEN_HASH_BITS))
+
+static uint32_t keyword_hash(const char* lexeme)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (const char* c = lexeme; *c; c++)
+    {
+        hash ^= (unsigned char)*c;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Semente ímpar em que nenhuma palavra-chave divide posição com outra
+static uint32_t find_seed(void)
+{
+    for (uint32_t seed = 0x9E3779B1u; ; seed += 2)
+    {
+        unsigned char used[1 << GEN_HASH_BITS] = {0};
+        int ok = 1;
+        
+        for (int i = 0; i < KEYWORD_COUNT && ok; i++)
+        {
+            uint32_t slot = GEN_SLOT(keyword_hash(keywords[i].lexeme), seed);
+            ok = !used[slot];
+            used[slot] = 1;
+        }
+        if (ok) return seed;
+    }
+}
+
+int main()
+{
+    uint32_t seed = find_seed();
+    
+    const char* table[1 << GEN_HASH_BITS] = {0};
+    TokenType types[1 << GEN_HASH_BITS] = {0};
+    for (int i = 0; i < KEYWORD_COUNT; i++)
+    {
+        uint32_t slot = GEN_SLOT(keyword_hash(keywords[i].lexeme), seed);
+        table[slot] = keywords[i].lexeme;
+        types[slot] = keywords[i].type;
+    }
+    
+    printf("// lexer_keywords.h\n");
+    printf("// GERADO por gen_keywords (bloco GENKEYWORDS em lexer.c). Não edite.\n");
+    printf("// Incluído apenas por lexer.c: %d palavras-chave, %d posições\n\n",
+           KEYWORD_COUNT, 1 << GEN_HASH_BITS);
+    printf("#ifndef LEXER_KEYWORDS_H\n#define LEXER_KEYWORDS_H\n\n");
+    printf("#define KEYWORD_HASH_SEED 0x%08Xu\n", seed);
+    printf("#define KEYWORD_HASH_BITS %d\n\n", GEN_HASH_BITS);
+    printf("static const Keyword keyword_table[1 << KEYWORD_HASH_BITS] =\n{\n");
+    for (int slot = 0; slot < (1 << GEN_HASH_BITS); slot++)
+    {
+        if (!table[slot]) continue;
+        printf("    [%3d] = { \"%s\", %d, TOKEN_%s },\n",
+               slot, table[slot], (int)strlen(table[slot]), token_type_to_string(types[slot]));
+    }
+    printf("};\n\n#endif // LEXER_KEYWORDS_H\n// Fim de lexer_keywords.h\n");
+    
+    return 0;
+}
+#endif
+
 // Fim de lexer.c
\ No newline at end of file
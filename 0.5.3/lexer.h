@@ -5,6 +5,8 @@
 
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "zzdefs.h"
 
@@ -27,6 +29,7 @@ typedef enum {
     TOKEN_STAR,         // *
     TOKEN_SLASH,        // /
     TOKEN_PERCENT,      // %
+    TOKEN_BACKSLASH,    // \ (divisão inteira)
 
     TOKEN_LPAREN,       // (
     TOKEN_RPAREN,       // )
@@ -37,6 +40,7 @@ typedef enum {
 
     TOKEN_COLON,        // :
     TOKEN_SEMICOLON,    // ;
+    TOKEN_COMMA,        // , (argumentos das funções)
 
     TOKEN_NL,           // nl - controla quebra de linha no print
 
@@ -105,30 +109,49 @@ typedef enum {
     TOKEN_BREAK,
     TOKEN_CONTINUE,
 
+    TOKEN_DIM,          // dim a(n)
+
     TOKEN_NOERROR
 } TokenType;
 
 
 // ============================================
-// Estrutura do Token (Expandida)
+// Estrutura do Token (24 bytes)
+//
+// O lexema não é copiado: start/length apontam para o
+// código-fonte, que precisa viver enquanto o token for usado.
+// Para TOKEN_STRING o lexema inclui as aspas.
 // ============================================
 typedef struct
 {
-    TokenType type;            
-    
     union
     {
-        double number;              // TOKEN_NUMBER
-        char string[STRING_SIZE];   // TOKEN_STRING e palavras-chave
-        char varname[VARNAME_SIZE]; // TOKEN_IDENTIFIER
+        double number;          // TOKEN_NUMBER com parte decimal (ou grande demais)
+        int64_t integer;        // TOKEN_NUMBER inteiro (is_integer)
+        int id;                 // TOKEN_IDENTIFIER: id interno (ver Lexer)
     } value;
     
-    char text[BUFFER_SIZE];       
+    int start;                  // Offset do lexema no source
+    unsigned short length;      // Tamanho do lexema em bytes
+    unsigned char type;         // TokenType
+    unsigned char is_integer;   // TOKEN_NUMBER: valor em value.integer
     
-    int line;                       // Número da linha
-    int column;                     // Coluna
+    int line;                   // Número da linha
+    int column;                 // Coluna
 } Token;
 
+// ============================================
+// Identificadores internados: mesmo nome => mesmo id
+// (a entrada aponta para a primeira ocorrência no source)
+// ============================================
+typedef struct
+{
+    uint32_t hash;
+    int start;
+    int length;
+    int id;                     // -1 = entrada vazia
+} LexerIdentifier;
+
 // ============================================
 // Estrutura do Lexer (Expandida)
 // ============================================
@@ -140,6 +163,12 @@ typedef struct
     int line;                   // Linha atual
     int column;                 // Coluna atual
     char current_char;          // NOVO: caractere atual (para conveniência)
+    
+    LexerIdentifier* identifiers;   // Tabela hash (alocada sob demanda)
+    int identifier_capacity;
+    int identifier_count;
+    
+    char error_message[TOKENTEXT_SIZE];  // Texto do último TOKEN_ERROR
 } Lexer;
 
 // ============================================
@@ -148,10 +177,19 @@ typedef struct
 
 // Inicialização e operação
 void lexer_init(Lexer* lexer, const char* source);
+void lexer_init_buffer(Lexer* lexer, const char* source, size_t length);
+void lexer_free(Lexer* lexer);
 Token lexer_get_next_token(Lexer* lexer);
 
+// Acesso ao lexema (sem cópia até o buffer do chamador)
+const char* lexer_token_start(const Lexer* lexer, Token token);
+void lexer_token_text(const Lexer* lexer, Token token, char* buffer, size_t size);
+void lexer_token_string(const Lexer* lexer, Token token, char* buffer, size_t size);
+// Conteúdo de um TOKEN_STRING (sem as aspas) direto no fonte, sem limite
+const char* lexer_token_contents(const Lexer* lexer, Token token, size_t* length);
+
 // Funções de utilidade/debug
-void lexer_print_token(Token token);
+void lexer_print_token(const Lexer* lexer, Token token);
 void lexer_print_all_tokens(const char* source);
 
 const char* token_type_to_string(TokenType type);
@@ -0,0 +1,62 @@
+// lexer_keywords.h
+// GERADO por gen_keywords (bloco GENKEYWORDS em lexer.c). Não edite.
+// Incluído apenas por lexer.c: 46 palavras-chave, 128 posições
+
+#ifndef LEXER_KEYWORDS_H
+#define LEXER_KEYWORDS_H
+
+#define KEYWORD_HASH_SEED 0x9E384177u
+#define KEYWORD_HASH_BITS 7
+
+static const Keyword keyword_table[1 << KEYWORD_HASH_BITS] =
+{
+    [  0] = { "bcyan", 5, TOKEN_BCYAN },
+    [  3] = { "else", 4, TOKEN_ELSE },
+    [  6] = { "bred", 4, TOKEN_BRED },
+    [  7] = { "bmagenta", 8, TOKEN_BMAGENTA },
+    [ 14] = { "width", 5, TOKEN_WIDTH },
+    [ 15] = { "or", 2, TOKEN_OR },
+    [ 18] = { "continue", 8, TOKEN_CONTINUE },
+    [ 19] = { "blue", 4, TOKEN_BLUE },
+    [ 29] = { "magenta", 7, TOKEN_MAGENTA },
+    [ 30] = { "bgblue", 6, TOKEN_BGBLUE },
+    [ 31] = { "red", 3, TOKEN_RED },
+    [ 32] = { "right", 5, TOKEN_RIGHT },
+    [ 33] = { "yellow", 6, TOKEN_YELLOW },
+    [ 35] = { "then", 4, TOKEN_THEN },
+    [ 36] = { "white", 5, TOKEN_WHITE },
+    [ 38] = { "dim", 3, TOKEN_DIM },
+    [ 41] = { "byellow", 7, TOKEN_BYELLOW },
+    [ 42] = { "nocolor", 7, TOKEN_NOCOLOR },
+    [ 46] = { "end", 3, TOKEN_END },
+    [ 47] = { "left", 4, TOKEN_LEFT },
+    [ 49] = { "black", 5, TOKEN_BLACK },
+    [ 50] = { "input", 5, TOKEN_INPUT },
+    [ 53] = { "bgred", 5, TOKEN_BGRED },
+    [ 56] = { "bgwhite", 7, TOKEN_BGWHITE },
+    [ 59] = { "bwhite", 6, TOKEN_BWHITE },
+    [ 64] = { "bblue", 5, TOKEN_BBLUE },
+    [ 66] = { "break", 5, TOKEN_BREAK },
+    [ 69] = { "do", 2, TOKEN_DO },
+    [ 74] = { "true", 4, TOKEN_TRUE },
+    [ 79] = { "bgyellow", 8, TOKEN_BGYELLOW },
+    [ 83] = { "center", 6, TOKEN_CENTER },
+    [ 84] = { "false", 5, TOKEN_FALSE },
+    [ 85] = { "print", 5, TOKEN_PRINT },
+    [ 87] = { "and", 3, TOKEN_AND },
+    [ 89] = { "if", 2, TOKEN_IF },
+    [ 92] = { "let", 3, TOKEN_LET },
+    [ 93] = { "nl", 2, TOKEN_NL },
+    [ 98] = { "bgmagenta", 9, TOKEN_BGMAGENTA },
+    [100] = { "while", 5, TOKEN_WHILE },
+    [105] = { "cyan", 4, TOKEN_CYAN },
+    [114] = { "not", 3, TOKEN_NOT },
+    [115] = { "bgcyan", 6, TOKEN_BGCYAN },
+    [118] = { "bggreen", 7, TOKEN_BGGREEN },
+    [119] = { "green", 5, TOKEN_GREEN },
+    [120] = { "bgreen", 6, TOKEN_BGREEN },
+    [125] = { "bgblack", 7, TOKEN_BGBLACK },
+};
+
+#endif // LEXER_KEYWORDS_H
+// Fim de lexer_keywords.h
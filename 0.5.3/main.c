@@ -6,6 +6,19 @@
 #include "utils.h"
 #include "zzbasic.h"
 #include "a89alloc.h"
+#include "output.h"
+
+static void print_usage(void)
+{
+    printf("Usage: zzbasic [--vm|--ast] [--dump-quick] [--color=auto|always|never] [file.zz]\n");
+    printf("  No arguments: starts REPL\n");
+    printf("  With filename: executes script\n");
+    printf("  Default engine: loops on the bytecode VM, other statements on the AST evaluator\n");
+    printf("  --vm: compile the whole program to bytecode\n");
+    printf("  --ast: run with the AST evaluator only\n");
+    printf("  --dump-quick: with --ast, list the nodes specialized at run time\n");
+    printf("  --color: print colors (auto: only on a terminal, without NO_COLOR or TERM=dumb)\n");
+}
 
 // ============================================
 // Função Principal
@@ -14,18 +27,55 @@ int main(int argc, char* argv[])
 {
     setup_utf8();
     
-    if (argc == 1)
+    // Opções começam com "--" e podem vir antes do arquivo
+    char* filename = NULL;
+    for (int i = 1; i < argc; i++)
     {
-        // Modo REPL: nenhum argumento
+        if (strcmp(argv[i], "--vm") == 0)
+        {
+            set_exec_mode(EXEC_VM);
+        }
+        else if (strcmp(argv[i], "--ast") == 0)
+        {
+            set_exec_mode(EXEC_AST);
+        }
+        else if (strcmp(argv[i], "--dump-quick") == 0)
+        {
+            set_quick_dump(1);
+        }
+        else if (strcmp(argv[i], "--color=auto") == 0)
+        {
+            output_set_color_mode(OUTPUT_COLOR_AUTO);
+        }
+        else if (strcmp(argv[i], "--color=always") == 0)
+        {
+            output_set_color_mode(OUTPUT_COLOR_ALWAYS);
+        }
+        else if (strcmp(argv[i], "--color=never") == 0)
+        {
+            output_set_color_mode(OUTPUT_COLOR_NEVER);
+        }
+        else if (strncmp(argv[i], "--", 2) != 0 && filename == NULL)
+        {
+            filename = argv[i];
+        }
+        else
+        {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (filename == NULL)
+    {
+        // Modo REPL: nenhum arquivo
         print_banner();
         printf("Enter \"help\", a statement or \"exit\" to quit.\n\n");
         run_repl();
     }
-    else if (argc == 2)
+    else
     {
-        // Modo arquivo: um argumento
-        char* filename = argv[1];
-
+        // Modo arquivo
         // Verifica se tem extensão .zz
         if (!has_zz_extension(filename)) {
             printf("%sError: ZzBasic scripts must have .zz extension\n", 
@@ -36,28 +86,13 @@ int main(int argc, char* argv[])
             return 1;
         }
         
-        // Tenta abrir o arquivo para verificar existência
-        FILE* test = fopen(filename, "r");
-        if (!test) {
-            printf("%sError: cannot open file '%s'%s\n", 
-                   COLOR_ERROR, filename, COLOR_RESET);
-            printf("Check if file exists and you have read permission.\n");
-            return 1;
-        }
-        fclose(test);
-        
         printf("ZzBasic v%s on %s\n", ZZ_VERSION, get_os_name());
         printf("Executing: %s\n", filename);
 
-        run_file(filename);  
-    }
-    else
-    {
-        // Mais de um argumento - ERRO
-        printf("Usage: zzbasic [file.zz]\n");
-        printf("  No arguments: starts REPL\n");
-        printf("  With filename: executes script\n");
-        return 1;
+        // run_file abre o arquivo (uma vez) e mostra o erro se falhar
+        if (!run_file(filename)) {
+            return 1;
+        }
     }
 
     a89check_leaks();
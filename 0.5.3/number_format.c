@@ -0,0 +1,760 @@
+// number_format.c
+
+#include <stdint.h>
+#include <string.h>
+
+#include "number_format.h"
+
+// ==================================================================
+// Ryu (Ulf Adams, PLDI 2018): menor representação decimal de um
+// double que faz o caminho de volta sem perda.
+//
+// As potências de 5 (e seus inversos) com 125 bits significativos
+// ficam em number_format_tables.h, gerado pelo bloco
+// GENNUMBERTABLES no fim deste arquivo:
+// gcc -DGENNUMBERTABLES number_format.c -o gen_number_tables
+// ./gen_number_tables > number_format_tables.h
+// ==================================================================
+#define DOUBLE_MANTISSA_BITS 52
+#define DOUBLE_EXPONENT_BITS 11
+#define DOUBLE_BIAS          1023
+
+#define POW5_INV_BITCOUNT    125
+#define POW5_BITCOUNT        125
+#define POW5_INV_TABLE_SIZE  342
+#define POW5_TABLE_SIZE      326
+
+#include "number_format_tables.h"
+
+// Expoente decimal a partir do qual o número sai em notação científica
+#define SCIENTIFIC_MIN_EXPONENT  (-4)
+#define SCIENTIFIC_MAX_EXPONENT  21
+
+typedef struct
+{
+    uint64_t mantissa;
+    int32_t exponent;       // valor = mantissa * 10^exponent
+} DecimalNumber;
+
+
+// ============================================
+// Aritmética auxiliar
+// ============================================
+
+// ceil(log2(5^e)) para 0 < e <= 3528 (1 para e == 0)
+static inline int32_t pow5bits(int32_t e)
+{
+    return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^e)) para 0 <= e <= 1650
+static inline uint32_t log10_pow2(int32_t e)
+{
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+// floor(log10(5^e)) para 0 <= e <= 2620
+static inline uint32_t log10_pow5(int32_t e)
+{
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+static inline uint32_t pow5_factor(uint64_t value)
+{
+    uint32_t count = 0;
+    while (value % 5 == 0)
+    {
+        value /= 5;
+        count++;
+    }
+    return count;
+}
+
+static inline int multiple_of_pow5(uint64_t value, uint32_t p)
+{
+    return pow5_factor(value) >= p;
+}
+
+static inline int multiple_of_pow2(uint64_t value, uint32_t p)
+{
+    return (value & ((1ull << p) - 1)) == 0;
+}
+
+// Produto 64x64 -> 128 bits: devolve a parte baixa, a alta em *high
+static inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t* high)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *high = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+// (m * mul) >> j, com mul de 128 bits e 64 < j < 128
+static inline uint64_t mul_shift64(uint64_t m, const uint64_t* mul, int32_t j)
+{
+    uint64_t high0;
+    umul128(m, mul[0], &high0);
+
+    uint64_t high1;
+    uint64_t low1 = umul128(m, mul[1], &high1);
+
+    uint64_t sum = high0 + low1;
+    if (sum < high0) high1++;
+
+    int32_t shift = j - 64;
+    return (high1 << (64 - shift)) | (sum >> shift);
+}
+
+static inline uint32_t decimal_length(uint64_t v)
+{
+    // Mantissa do Ryu tem no máximo 17 dígitos
+    uint32_t length = 1;
+    while (v >= 10)
+    {
+        v /= 10;
+        length++;
+    }
+    return length;
+}
+
+
+// ============================================
+// Núcleo do Ryu (double finito, diferente de zero)
+// ============================================
+static DecimalNumber ryu_decimal(uint64_t ieee_mantissa, uint32_t ieee_exponent)
+{
+    int32_t e2;
+    uint64_t m2;
+    if (ieee_exponent == 0)
+    {
+        // Subnormal
+        e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = (int32_t)ieee_exponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = (1ull << DOUBLE_MANTISSA_BITS) | ieee_mantissa;
+    }
+    const int accept_bounds = (m2 & 1) == 0;
+
+    // Intervalo de valores que leem de volta para o mesmo double,
+    // em unidades de 1/4: [mv - 1 - mm_shift, mv + 2]
+    const uint64_t mv = 4 * m2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    int vm_trailing_zeros = 0;
+    int vr_trailing_zeros = 0;
+
+    if (e2 >= 0)
+    {
+        const uint32_t q = log10_pow2(e2) - (e2 > 3);
+        e10 = (int32_t)q;
+        const int32_t k = POW5_INV_BITCOUNT + pow5bits((int32_t)q) - 1;
+        const int32_t i = -e2 + (int32_t)q + k;
+        const uint64_t* mul = NUMBER_POW5_INV_SPLIT[q];
+
+        vr = mul_shift64(4 * m2, mul, i);
+        vp = mul_shift64(4 * m2 + 2, mul, i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, mul, i);
+
+        if (q <= 21)
+        {
+            // No máximo um entre mp, mv e mm é múltiplo de 5
+            if (mv % 5 == 0)
+            {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            }
+            else if (accept_bounds)
+            {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            }
+            else
+            {
+                vp -= multiple_of_pow5(mv + 2, q);
+            }
+        }
+    }
+    else
+    {
+        const uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = (int32_t)q + e2;
+        const int32_t i = -e2 - (int32_t)q;
+        const int32_t k = pow5bits(i) - POW5_BITCOUNT;
+        const int32_t j = (int32_t)q - k;
+        const uint64_t* mul = NUMBER_POW5_SPLIT[i];
+
+        vr = mul_shift64(4 * m2, mul, j);
+        vp = mul_shift64(4 * m2 + 2, mul, j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, mul, j);
+
+        if (q <= 1)
+        {
+            // mv = 4 * m2 sempre tem ao menos dois bits zero no fim
+            vr_trailing_zeros = 1;
+            if (accept_bounds)
+            {
+                vm_trailing_zeros = mm_shift == 1;
+            }
+            else
+            {
+                vp--;
+            }
+        }
+        else if (q < 63)
+        {
+            vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Remove dígitos enquanto o intervalo ainda contém um valor
+    int32_t removed = 0;
+    uint32_t last_removed_digit = 0;
+    uint64_t output;
+
+    if (vm_trailing_zeros || vr_trailing_zeros)
+    {
+        // Caso geral (raro): acompanha se o que saiu era só zeros
+        while (vp / 10 > vm / 10)
+        {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (uint32_t)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (uint32_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+        {
+            // Exatamente ...50..0: arredonda para o par
+            last_removed_digit = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros))
+                       || last_removed_digit >= 5);
+    }
+    else
+    {
+        // Caso comum: basta saber se arredonda para cima
+        int round_up = 0;
+        if (vp / 100 > vm / 100)
+        {
+            // Dois dígitos de uma vez
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10)
+        {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+
+    DecimalNumber result;
+    result.mantissa = output;
+    result.exponent = e10 + removed;
+    return result;
+}
+
+
+// ============================================
+// Escrita do texto
+// ============================================
+
+// Escreve os dígitos de value em buffer e devolve quantos foram
+static inline size_t write_digits(uint64_t value, uint32_t length, char* buffer)
+{
+    for (uint32_t i = length; i > 0; i--)
+    {
+        buffer[i - 1] = (char)('0' + value % 10);
+        value /= 10;
+    }
+    return length;
+}
+
+static size_t write_integer(uint64_t magnitude, int negative, char* buffer)
+{
+    size_t length = 0;
+    if (negative) buffer[length++] = '-';
+
+    length += write_digits(magnitude, decimal_length(magnitude), buffer + length);
+    buffer[length] = '\0';
+    return length;
+}
+
+// "d.ddde+XX", com expoente de pelo menos dois dígitos (como printf)
+static size_t write_scientific(uint64_t mantissa, uint32_t digits,
+                               int32_t exponent, char* buffer)
+{
+    // Escreve a partir de buffer[1] e sobe o primeiro dígito
+    write_digits(mantissa, digits, buffer + 1);
+    buffer[0] = buffer[1];
+
+    size_t length = 1;
+    if (digits > 1)
+    {
+        buffer[1] = '.';
+        length = digits + 1;
+    }
+
+    buffer[length++] = 'e';
+    if (exponent < 0)
+    {
+        buffer[length++] = '-';
+        exponent = -exponent;
+    }
+    else
+    {
+        buffer[length++] = '+';
+    }
+
+    if (exponent >= 100)
+    {
+        buffer[length++] = (char)('0' + exponent / 100);
+        exponent %= 100;
+    }
+    buffer[length++] = (char)('0' + exponent / 10);
+    buffer[length++] = (char)('0' + exponent % 10);
+    return length;
+}
+
+// Decimal por extenso: "123.45", "0.00123", "12300"
+static size_t write_fixed(uint64_t mantissa, uint32_t digits,
+                          int32_t exponent, char* buffer)
+{
+    int32_t point = (int32_t)digits + exponent;     // dígitos antes do ponto
+
+    if (point <= 0)
+    {
+        buffer[0] = '0';
+        buffer[1] = '.';
+        memset(buffer + 2, '0', (size_t)-point);
+        return 2 + (size_t)-point + write_digits(mantissa, digits, buffer + 2 - point);
+    }
+
+    if (exponent >= 0)
+    {
+        write_digits(mantissa, digits, buffer);
+        memset(buffer + digits, '0', (size_t)exponent);
+        return digits + (size_t)exponent;
+    }
+
+    // Escreve a partir de buffer[1] e desce a parte inteira
+    write_digits(mantissa, digits, buffer + 1);
+    memmove(buffer, buffer + 1, (size_t)point);
+    buffer[point] = '.';
+    return digits + 1;
+}
+
+size_t number_format_integer(int64_t value, char* buffer)
+{
+    if (value < 0)
+    {
+        return write_integer(0 - (uint64_t)value, 1, buffer);
+    }
+    return write_integer((uint64_t)value, 0, buffer);
+}
+
+size_t number_format(double value, char* buffer)
+{
+    // Caminho rápido: inteiro exato em int64 (inclui -0)
+    if (value >= -9223372036854775808.0 && value < 9223372036854775808.0)
+    {
+        int64_t integer = (int64_t)value;
+        if ((double)integer == value)
+        {
+            return number_format_integer(integer, buffer);
+        }
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const int negative = (bits >> 63) != 0;
+    const uint64_t ieee_mantissa = bits & ((1ull << DOUBLE_MANTISSA_BITS) - 1);
+    const uint32_t ieee_exponent =
+        (uint32_t)((bits >> DOUBLE_MANTISSA_BITS) & ((1u << DOUBLE_EXPONENT_BITS) - 1));
+
+    size_t length = 0;
+
+    if (ieee_exponent == (1u << DOUBLE_EXPONENT_BITS) - 1)
+    {
+        if (ieee_mantissa != 0)
+        {
+            memcpy(buffer, "nan", 4);
+            return 3;
+        }
+        if (negative) buffer[length++] = '-';
+        memcpy(buffer + length, "inf", 4);
+        return length + 3;
+    }
+
+    if (negative) buffer[length++] = '-';
+
+    DecimalNumber decimal = ryu_decimal(ieee_mantissa, ieee_exponent);
+    uint32_t digits = decimal_length(decimal.mantissa);
+    int32_t scientific_exponent = decimal.exponent + (int32_t)digits - 1;
+
+    if (scientific_exponent < SCIENTIFIC_MIN_EXPONENT ||
+        scientific_exponent >= SCIENTIFIC_MAX_EXPONENT)
+    {
+        length += write_scientific(decimal.mantissa, digits,
+                                   scientific_exponent, buffer + length);
+    }
+    else
+    {
+        length += write_fixed(decimal.mantissa, digits,
+                              decimal.exponent, buffer + length);
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+
+// ============================================
+// GERADOR DAS TABELAS
+// gcc -DGENNUMBERTABLES number_format.c -o gen_number_tables
+// ./gen_number_tables > number_format_tables.h
+// ============================================
+
+#ifdef GENNUMBERTABLES
+
+#include <stdio.h>
+
+// Inteiro grande o bastante para 2^(125 + log2(5^341)) (~920 bits)
+#define BIG_LIMBS 32
+
+typedef struct
+{
+    uint32_t limb[BIG_LIMBS];   // limb[0] é o menos significativo
+} BigNumber;
+
+static void big_set(BigNumber* a, uint32_t value)
+{
+    memset(a, 0, sizeof(*a));
+    a->limb[0] = value;
+}
+
+static void big_mul_small(BigNumber* a, uint32_t factor)
+{
+    uint64_t carry = 0;
+    for (int i = 0; i < BIG_LIMBS; i++)
+    {
+        uint64_t product = (uint64_t)a->limb[i] * factor + carry;
+        a->limb[i] = (uint32_t)product;
+        carry = product >> 32;
+    }
+}
+
+static int big_bit(const BigNumber* a, int bit)
+{
+    return (a->limb[bit / 32] >> (bit % 32)) & 1;
+}
+
+static int big_bitlength(const BigNumber* a)
+{
+    for (int bit = BIG_LIMBS * 32 - 1; bit >= 0; bit--)
+    {
+        if (big_bit(a, bit)) return bit + 1;
+    }
+    return 0;
+}
+
+static int big_compare(const BigNumber* a, const BigNumber* b)
+{
+    for (int i = BIG_LIMBS - 1; i >= 0; i--)
+    {
+        if (a->limb[i] != b->limb[i]) return a->limb[i] < b->limb[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static void big_sub(BigNumber* a, const BigNumber* b)
+{
+    int64_t borrow = 0;
+    for (int i = 0; i < BIG_LIMBS; i++)
+    {
+        int64_t diff = (int64_t)a->limb[i] - b->limb[i] - borrow;
+        borrow = diff < 0;
+        a->limb[i] = (uint32_t)diff;
+    }
+}
+
+static void big_shift_left1(BigNumber* a, int bit_in)
+{
+    for (int i = BIG_LIMBS - 1; i > 0; i--)
+    {
+        a->limb[i] = (a->limb[i] << 1) | (a->limb[i - 1] >> 31);
+    }
+    a->limb[0] = (a->limb[0] << 1) | (uint32_t)bit_in;
+}
+
+// 128 bits de a a partir do bit shift (shift negativo desloca à esquerda)
+static void big_extract128(const BigNumber* a, int shift, uint64_t out[2])
+{
+    out[0] = out[1] = 0;
+    for (int bit = 0; bit < 128; bit++)
+    {
+        int source = bit + shift;
+        if (source >= 0 && source < BIG_LIMBS * 32 && big_bit(a, source))
+        {
+            out[bit / 64] |= 1ull << (bit % 64);
+        }
+    }
+}
+
+// floor(2^exponent / divisor) + 1, por divisão binária longa
+static void big_inverse128(const BigNumber* divisor, int exponent, uint64_t out[2])
+{
+    BigNumber remainder, quotient;
+    big_set(&remainder, 0);
+    big_set(&quotient, 0);
+
+    for (int bit = exponent; bit >= 0; bit--)
+    {
+        big_shift_left1(&remainder, bit == exponent);
+        big_shift_left1(&quotient, 0);
+        if (big_compare(&remainder, divisor) >= 0)
+        {
+            big_sub(&remainder, divisor);
+            quotient.limb[0] |= 1;
+        }
+    }
+
+    big_extract128(&quotient, 0, out);
+    if (++out[0] == 0) out[1]++;
+}
+
+int main(void)
+{
+    BigNumber pow5;
+
+    printf("// number_format_tables.h\n");
+    printf("// GERADO por gen_number_tables (bloco GENNUMBERTABLES em number_format.c). Não edite.\n");
+    printf("// Incluído apenas por number_format.c: {parte baixa, parte alta}\n\n");
+    printf("#ifndef NUMBER_FORMAT_TABLES_H\n");
+    printf("#define NUMBER_FORMAT_TABLES_H\n\n");
+
+    // floor(2^(bits(5^i) - 1 + 125) / 5^i) + 1
+    printf("static const uint64_t NUMBER_POW5_INV_SPLIT[%d][2] =\n{\n", POW5_INV_TABLE_SIZE);
+    big_set(&pow5, 1);
+    for (int i = 0; i < POW5_INV_TABLE_SIZE; i++)
+    {
+        uint64_t entry[2];
+        big_inverse128(&pow5, big_bitlength(&pow5) - 1 + POW5_INV_BITCOUNT, entry);
+        printf("    { 0x%016llXu, 0x%016llXu },\n",
+               (unsigned long long)entry[0], (unsigned long long)entry[1]);
+        big_mul_small(&pow5, 5);
+    }
+    printf("};\n\n");
+
+    // 125 bits mais significativos de 5^i
+    printf("static const uint64_t NUMBER_POW5_SPLIT[%d][2] =\n{\n", POW5_TABLE_SIZE);
+    big_set(&pow5, 1);
+    for (int i = 0; i < POW5_TABLE_SIZE; i++)
+    {
+        uint64_t entry[2];
+        big_extract128(&pow5, big_bitlength(&pow5) - POW5_BITCOUNT, entry);
+        printf("    { 0x%016llXu, 0x%016llXu },\n",
+               (unsigned long long)entry[0], (unsigned long long)entry[1]);
+        big_mul_small(&pow5, 5);
+    }
+    printf("};\n\n");
+
+    printf("#endif // NUMBER_FORMAT_TABLES_H\n");
+    printf("// Fim de number_format_tables.h\n");
+    return 0;
+}
+
+#endif
+
+
+// ============================================
+// BENCHMARK (e conferência do caminho de volta)
+// gcc -O2 -DBENCHNUMBERFORMAT number_format.c -o bench_number_format
+// ============================================
+
+#ifdef BENCHNUMBERFORMAT
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_VALUES 200000
+#define BENCH_ROUNDS 10
+
+// Formatação anterior de evaluator.c (cópia para comparação)
+#define EPSILON 1e-12
+static void legacy_format_number(double num, char* buffer, size_t size)
+{
+    if (fabs(num - (int)num) < EPSILON) {
+        snprintf(buffer, size, "%d", (int)num);
+    } else {
+        char temp[64];
+        snprintf(temp, sizeof(temp), "%.10g", num);
+        
+        char* dot = strchr(temp, '.');
+        if (dot) {
+            char* end = temp + strlen(temp) - 1;
+            while (end > dot && *end == '0') {
+                *end = '\0';
+                end--;
+            }
+            if (*(end) == '.') {
+                *end = '\0';
+            }
+        }
+        snprintf(buffer, size, "%s", temp);
+    }
+}
+
+static double elapsed_ms(clock_t start)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static uint64_t bench_random(uint64_t* state)
+{
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ull;
+}
+
+static void bench_set(const char* name, const double* values, int count)
+{
+    char buffer[NUMBER_FORMAT_SIZE];
+    size_t total = 0;
+
+    clock_t start = clock();
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            legacy_format_number(values[i], buffer, sizeof(buffer));
+            total += (unsigned char)buffer[0];
+        }
+    }
+    double legacy_ms = elapsed_ms(start);
+
+    start = clock();
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            total += number_format(values[i], buffer);
+        }
+    }
+    double new_ms = elapsed_ms(start);
+
+    // Todo valor precisa ler de volta exatamente
+    int failures = 0;
+    for (int i = 0; i < count; i++)
+    {
+        number_format(values[i], buffer);
+        double back = strtod(buffer, NULL);
+        if (memcmp(&back, &values[i], sizeof(back)) != 0 &&
+            !(values[i] == 0 && back == 0) && !isnan(values[i]))
+        {
+            if (failures++ < 5) printf("  round-trip: %.17g -> %s\n", values[i], buffer);
+        }
+    }
+
+    double per_value = 1e6 / ((double)count * BENCH_ROUNDS);
+    printf("%-12s | legacy %7.1f ns | number_format %6.1f ns | %5.1fx | %s (%zu)\n",
+           name, legacy_ms * per_value, new_ms * per_value,
+           new_ms > 0 ? legacy_ms / new_ms : 0.0,
+           failures ? "ERRO" : "OK", total % 10);
+}
+
+int main(void)
+{
+    double* values = malloc(sizeof(double) * BENCH_VALUES);
+    uint64_t state = 88172645463325252ull;
+
+    // Contadores de laço e totais
+    for (int i = 0; i < BENCH_VALUES; i++) values[i] = i - BENCH_VALUES / 2;
+    bench_set("integers", values, BENCH_VALUES);
+
+    // Preços: centavos
+    for (int i = 0; i < BENCH_VALUES; i++) values[i] = (i % 100000) / 100.0;
+    bench_set("cents", values, BENCH_VALUES);
+
+    // Resultados de divisão
+    for (int i = 0; i < BENCH_VALUES; i++) values[i] = (i + 1) / 7.0;
+    bench_set("quotients", values, BENCH_VALUES);
+
+    // Qualquer padrão de bits finito (inclui subnormais e 1e300)
+    for (int i = 0; i < BENCH_VALUES; i++)
+    {
+        uint64_t bits;
+        double d;
+        do {
+            bits = bench_random(&state);
+            memcpy(&d, &bits, sizeof(d));
+        } while (!isfinite(d));
+        values[i] = d;
+    }
+    bench_set("random bits", values, BENCH_VALUES);
+
+    // Casos de borda
+    static const double edges[] = {
+        0.0, -0.0, 0.1, 0.2, 0.3, 0.1 + 0.2, 1.0 / 3.0, 2.5, -2.5, 1e-5, 1.5e-5,
+        0.0001, 123456.789, 2147483648.0, -2147483649.0, 9007199254740993.0,
+        9223372036854775807.0, -9223372036854775808.0, 1e20, 1e21, 1.5e300,
+        5e-324, 2.2250738585072014e-308, 1.7976931348623157e308
+    };
+    int edge_count = (int)(sizeof(edges) / sizeof(edges[0]));
+    for (int i = 0; i < edge_count; i++)
+    {
+        char buffer[NUMBER_FORMAT_SIZE];
+        char legacy[64];
+        number_format(edges[i], buffer);
+        legacy_format_number(edges[i], legacy, sizeof(legacy));
+        printf("  %-25.17g %-26s (antes: %s)\n", edges[i], buffer, legacy);
+    }
+    bench_set("edges", edges, edge_count);
+
+    free(values);
+    return 0;
+}
+
+#endif
+// Fim de number_format.c
@@ -0,0 +1,32 @@
+// number_format.h - FORMATAÇÃO DE NÚMEROS
+
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/********************************************************************
+Converte double para texto sem snprintf.
+
+* Inteiro exato que cabe em int64: dígitos do inteiro ("42", "-7")
+* Demais valores: menor sequência de dígitos que, lida de volta,
+  reproduz exatamente o mesmo double (algoritmo Ryu)
+
+Notação científica ("1e-05", "1.5e+21") só quando o expoente
+decimal é < -4 ou >= 21; fora disso o número sai por extenso.
+-0 sai como "0"; infinito e NaN saem como "inf", "-inf" e "nan".
+********************************************************************/
+
+// Maior texto possível, incluindo o '\0'
+#define NUMBER_FORMAT_SIZE 32
+
+// Escreve o texto em buffer (>= NUMBER_FORMAT_SIZE bytes, com '\0')
+// e devolve o tamanho sem o '\0'
+size_t number_format(double value, char* buffer);
+
+// Inteiro exato (numbers inteiros de value.h): só os dígitos
+size_t number_format_integer(int64_t value, char* buffer);
+
+#endif // NUMBER_FORMAT_H
+// Fim de number_format.h
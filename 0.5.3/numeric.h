@@ -0,0 +1,220 @@
+// numeric.h
+
+#ifndef NUMERIC_H
+#define NUMERIC_H
+
+#include <math.h>
+
+#include "value.h"
+#include "work_stack.h"
+
+/********************************************************************
+ARITMÉTICA DE NUMBERS
+
+Compartilhada pelo evaluator e pela VM; os operandos já foram
+conferidos com value_is_number. Inteiro com inteiro (value.h) é conta
+inteira em int64, exata em toda a faixa: com operandos inline (48
+bits) soma, subtração e negação nem chegam perto de estourar, e a
+multiplicação confere o estouro. Só um resultado fora do int64 vira
+double. Com um double envolvido a conta é em double, como sempre foi.
+
+    /   inteiro se a divisão for exata (6 / 3 = 2), senão double
+    \   divisão inteira, truncada para zero (7 \ 2 = 3, -7 \ 2 = -3)
+    %   resto com o sinal do dividendo (7 % 3 = 1, -7 % 3 = -1)
+
+Os três devolvem VALUE_ERROR na divisão por zero; a mensagem fica
+com quem chama. Em double, zero é |divisor| < NUMERIC_EPSILON, e a
+igualdade tem a mesma tolerância. Entre inteiros, tudo é exato.
+
+'temps' é a pilha de temporários do contexto (ExecutionContext):
+um resultado fora da faixa inline sai numa caixa nova que ela retém
+até o fim do statement, como as strings da concatenação.
+********************************************************************/
+
+#define NUMERIC_EPSILON 1e-12
+
+// Resultado inteiro: inline se couber, senão caixa retida por 'temps'
+static inline Value numeric_integer(WorkStack* temps, int64_t integer)
+{
+    if (value_int_fits(integer)) return value_int(integer);
+
+    Value box = value_box_int(integer);
+    *WORK_STACK_PUSH(temps, Value) = box;
+    return box;
+}
+
+// Contas em int64; 0 = estourou (o chamador refaz em double)
+static inline int numeric_checked_add(int64_t x, int64_t y, int64_t* out)
+{
+    int64_t sum = (int64_t)((uint64_t)x + (uint64_t)y);
+    if (((x ^ sum) & (y ^ sum)) < 0) return 0;  // Sinal dos dois operandos trocou
+    *out = sum;
+    return 1;
+}
+
+static inline int numeric_checked_multiply(int64_t x, int64_t y, int64_t* out)
+{
+    int64_t product = (int64_t)((uint64_t)x * (uint64_t)y);
+    if (x != 0 && (product / x != y || (x == -1 && y == INT64_MIN))) return 0;
+    *out = product;
+    return 1;
+}
+
+static inline Value numeric_add(WorkStack* temps, Value a, Value b)
+{
+    if (value_both_inline_int(a, b))
+    {
+        return numeric_integer(temps, value_inline_int(a) + value_inline_int(b));
+    }
+    if (value_is_int(a) && value_is_int(b))
+    {
+        int64_t sum;
+        if (numeric_checked_add(value_as_int(a), value_as_int(b), &sum))
+        {
+            return numeric_integer(temps, sum);
+        }
+    }
+    return value_number(value_as_number(a) + value_as_number(b));
+}
+
+static inline Value numeric_subtract(WorkStack* temps, Value a, Value b)
+{
+    if (value_both_inline_int(a, b))
+    {
+        return numeric_integer(temps, value_inline_int(a) - value_inline_int(b));
+    }
+    if (value_is_int(a) && value_is_int(b))
+    {
+        int64_t y = value_as_int(b);
+        int64_t difference;
+        if (y != INT64_MIN && numeric_checked_add(value_as_int(a), -y, &difference))
+        {
+            return numeric_integer(temps, difference);
+        }
+    }
+    return value_number(value_as_number(a) - value_as_number(b));
+}
+
+static inline Value numeric_multiply(WorkStack* temps, Value a, Value b)
+{
+    if (value_both_inline_int(a, b))
+    {
+        int64_t x = value_inline_int(a);
+        int64_t y = value_inline_int(b);
+
+        // Os dois com menos de 32 bits: o produto cabe em int64
+        if ((uint64_t)(x + INT32_MAX) <= UINT32_MAX && (uint64_t)(y + INT32_MAX) <= UINT32_MAX)
+        {
+            return numeric_integer(temps, x * y);
+        }
+    }
+    if (value_is_int(a) && value_is_int(b))
+    {
+        int64_t product;
+        if (numeric_checked_multiply(value_as_int(a), value_as_int(b), &product))
+        {
+            return numeric_integer(temps, product);
+        }
+    }
+    return value_number(value_as_number(a) * value_as_number(b));
+}
+
+static inline Value numeric_negate(WorkStack* temps, Value a)
+{
+    if (value_is_int(a))
+    {
+        int64_t x = value_as_int(a);
+        if (x != INT64_MIN) return numeric_integer(temps, -x);
+    }
+    return value_number(-value_as_number(a));
+}
+
+static inline Value numeric_divide(WorkStack* temps, Value a, Value b)
+{
+    if (value_is_int(a) && value_is_int(b))
+    {
+        int64_t x = value_as_int(a);
+        int64_t y = value_as_int(b);
+        if (y == 0) return VALUE_ERROR;
+        if (y == -1) return numeric_negate(temps, a);  // INT64_MIN / -1 estoura
+        if (x % y == 0) return numeric_integer(temps, x / y);
+        return value_number((double)x / (double)y);
+    }
+
+    double divisor = value_as_number(b);
+    if (fabs(divisor) < NUMERIC_EPSILON) return VALUE_ERROR;
+    return value_number(value_as_number(a) / divisor);
+}
+
+// a \ b
+static inline Value numeric_quotient(WorkStack* temps, Value a, Value b)
+{
+    if (value_is_int(a) && value_is_int(b))
+    {
+        int64_t y = value_as_int(b);
+        if (y == 0) return VALUE_ERROR;
+        if (y == -1) return numeric_negate(temps, a);
+        return numeric_integer(temps, value_as_int(a) / y);
+    }
+
+    double divisor = value_as_number(b);
+    if (fabs(divisor) < NUMERIC_EPSILON) return VALUE_ERROR;
+    return value_from_double(trunc(value_as_number(a) / divisor));
+}
+
+// a % b
+static inline Value numeric_remainder(WorkStack* temps, Value a, Value b)
+{
+    if (value_is_int(a) && value_is_int(b))
+    {
+        int64_t y = value_as_int(b);
+        if (y == 0) return VALUE_ERROR;
+        if (y == -1) return value_int(0);  // INT64_MIN % -1 é indefinido em C
+        return numeric_integer(temps, value_as_int(a) % y);
+    }
+
+    double divisor = value_as_number(b);
+    if (fabs(divisor) < NUMERIC_EPSILON) return VALUE_ERROR;
+    return value_number(fmod(value_as_number(a), divisor));
+}
+
+// Operador de NODE_BINARY_OP; VALUE_ERROR = divisão por zero
+// (ou operador desconhecido, que o evaluator confere antes)
+static inline Value numeric_operation(WorkStack* temps, char op, Value a, Value b)
+{
+    switch (op)
+    {
+        case '+':  return numeric_add(temps, a, b);
+        case '-':  return numeric_subtract(temps, a, b);
+        case '*':  return numeric_multiply(temps, a, b);
+        case '/':  return numeric_divide(temps, a, b);
+        case '\\': return numeric_quotient(temps, a, b);
+        case '%':  return numeric_remainder(temps, a, b);
+        default:   return VALUE_ERROR;
+    }
+}
+
+// ============================================
+// COMPARAÇÃO (a > b é numeric_less(b, a))
+// ============================================
+static inline int numeric_equal(Value a, Value b)
+{
+    if (value_both_inline_int(a, b)) return a == b;  // Mesmo inteiro, mesmos bits
+    if (value_is_int(a) && value_is_int(b)) return value_as_int(a) == value_as_int(b);
+    return fabs(value_as_number(a) - value_as_number(b)) < NUMERIC_EPSILON;
+}
+
+static inline int numeric_less(Value a, Value b)
+{
+    if (value_is_int(a) && value_is_int(b)) return value_as_int(a) < value_as_int(b);
+    return value_as_number(a) < value_as_number(b);
+}
+
+static inline int numeric_less_equal(Value a, Value b)
+{
+    if (value_is_int(a) && value_is_int(b)) return value_as_int(a) <= value_as_int(b);
+    return value_as_number(a) <= value_as_number(b);
+}
+
+#endif // NUMERIC_H
+// Fim de numeric.h
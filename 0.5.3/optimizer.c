@@ -0,0 +1,817 @@
+// optimizer.c
+
+#include <stdio.h>
+#include <math.h>
+
+#include "optimizer.h"
+#include "work_stack.h"
+
+static int optimize_statement(ASTNode* node, ExecutionContext* ctx);
+
+static int is_literal(ASTNode* node)
+{
+    return node->type == NODE_NUMBER || node->type == NODE_BOOL ||
+           node->type == NODE_STRING;
+}
+
+// Avalia um nó cujos operandos já são literais e o troca pelo resultado
+static int fold_node(ASTNode* node, ExecutionContext* ctx)
+{
+    Value value = evaluate_expression(node, ctx, CTX_ANY);
+    evaluator_release_temps(ctx);  // Concatenação: o texto não é guardado
+    if (value_is_error(value))
+    {
+        evaluator_report_error(ctx);
+        return 0;
+    }
+
+    if (value_is_boxed_int(value))
+    {
+        return 1;  // Inteiro em caixa (já solto com os temporários): fica como está
+    }
+    else if (value_is_number(value))
+    {
+        node->type = NODE_NUMBER;
+        node->data.number.value = value;
+    }
+    else if (value_is_bool(value))
+    {
+        node->type = NODE_BOOL;
+        node->data.boolean.value = value_as_bool(value) ? TRUE : FALSE;
+    }
+    else
+    {
+        return 1;  // Resultado string: o nó fica como está
+    }
+
+    node->height = 0;  // Virou folha
+    return 1;
+}
+
+//===================================================================
+// DOBRA DE CONSTANTES
+// Folhas primeiro; 0 = erro numa subárvore de literais. O percurso
+// usa uma pilha de trabalho: a profundidade da expressão não consome
+// pilha do C
+//===================================================================
+typedef struct
+{
+    ASTNode* node;
+    int state;      // 0 = filhos pendentes; 1 = esquerdo pronto; 2 = todos prontos
+} FoldFrame;
+
+static void push_fold(WorkStack* frames, ASTNode* node)
+{
+    FoldFrame* frame = WORK_STACK_PUSH(frames, FoldFrame);
+    frame->node = node;
+    frame->state = 0;
+}
+
+// Esquerdo literal de and/or que decide sozinho (curto-circuito ou
+// erro de tipo): o direito nunca seria avaliado
+static int decides_alone(ASTNode* node)
+{
+    ASTNode* left = node->data.logicalop.left;
+    LogicalOperator op = node->data.logicalop.operator;
+    return is_literal(left) &&
+           (left->type != NODE_BOOL ||
+            (op == OP_AND && !left->data.boolean.value) ||
+            (op == OP_OR && left->data.boolean.value));
+}
+
+// Dobra o nó se todos os filhos viraram literais
+static int fold_if_literal(ASTNode* node, ExecutionContext* ctx)
+{
+    switch (node->type)
+    {
+        case NODE_BINARY_OP:
+            if (!is_literal(node->data.binaryop.left) ||
+                !is_literal(node->data.binaryop.right)) return 1;
+            break;
+
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+            if (!is_literal(node->data.logicalop.left) ||
+                !is_literal(node->data.logicalop.right)) return 1;
+            break;
+
+        case NODE_UNARY_OP:
+            if (!is_literal(node->data.unaryop.operand)) return 1;
+            break;
+
+        case NODE_NOT_LOGICAL_OP:
+            if (!is_literal(node->data.notop.operand)) return 1;
+            break;
+
+        case NODE_CALL:
+            for (int i = 0; i < node->data.call.argc; i++)
+            {
+                if (!is_literal(node->data.call.args[i])) return 1;
+            }
+            break;
+
+        default:
+            return 1;  // Literais e variáveis
+    }
+    return fold_node(node, ctx);
+}
+
+static int fold_expression(ASTNode* node, ExecutionContext* ctx)
+{
+    if (!node) return 1;
+
+    WorkStack frames;
+    work_stack_init(&frames, sizeof(FoldFrame));
+    push_fold(&frames, node);
+
+    int success = 1;
+    while (success && !work_stack_empty(&frames))
+    {
+        FoldFrame* frame = WORK_STACK_TOP(&frames, FoldFrame);
+        ASTNode* current = frame->node;
+
+        if (frame->state == 0)
+        {
+            // Desce pelo primeiro filho; and/or param no esquerdo
+            frame->state = current->type == NODE_LOGICAL_OP ? 1 : 2;
+            switch (current->type)
+            {
+                case NODE_BINARY_OP:
+                    push_fold(&frames, current->data.binaryop.right);
+                    push_fold(&frames, current->data.binaryop.left);
+                    continue;
+
+                case NODE_COMPARISON_OP:
+                    push_fold(&frames, current->data.logicalop.right);
+                    push_fold(&frames, current->data.logicalop.left);
+                    continue;
+
+                case NODE_LOGICAL_OP:
+                    push_fold(&frames, current->data.logicalop.left);
+                    continue;
+
+                case NODE_UNARY_OP:
+                    push_fold(&frames, current->data.unaryop.operand);
+                    continue;
+
+                case NODE_NOT_LOGICAL_OP:
+                    push_fold(&frames, current->data.notop.operand);
+                    continue;
+
+                case NODE_CALL:
+                    for (int i = current->data.call.argc - 1; i >= 0; i--)
+                    {
+                        push_fold(&frames, current->data.call.args[i]);
+                    }
+                    continue;
+
+                case NODE_INDEX:
+                    push_fold(&frames, current->data.array.index);
+                    continue;  // a(i) em si nunca é literal
+
+                default:
+                    break;  // Folha: nada a dobrar
+            }
+        }
+        else if (frame->state == 1)
+        {
+            // and/or com o esquerdo já dobrado
+            if (decides_alone(current))
+            {
+                work_stack_pop(&frames);
+                success = fold_node(current, ctx);
+                continue;
+            }
+            frame->state = 2;
+            push_fold(&frames, current->data.logicalop.right);
+            continue;
+        }
+
+        work_stack_pop(&frames);
+        success = fold_if_literal(current, ctx);
+    }
+
+    work_stack_free(&frames);
+    return success;
+}
+
+//===================================================================
+// RAMOS MORTOS
+//===================================================================
+
+// Transforma o nó numa lista sem statements
+static void make_empty_list(ASTNode* node)
+{
+    node->type = NODE_STATEMENT_LIST;
+    node->data.statementlist.statements = NULL;
+    node->data.statementlist.count = 0;
+    node->data.statementlist.capacity = 0;
+}
+
+// Dobra a condição de if/while. Devolve 1 e *constant = -1 (não é
+// constante), 0 (false) ou 1 (true); 0 = erro já reportado
+static int fold_condition(ASTNode* node, ASTNode* condition, ExecutionContext* ctx,
+                          int* constant)
+{
+    *constant = -1;
+    if (!fold_expression(condition, ctx)) return 0;
+    if (!is_literal(condition)) return 1;
+
+    if (condition->type != NODE_BOOL)
+    {
+        // Mesmo erro que a execução daria a cada passagem
+        Value value = evaluate_expression(condition, ctx, CTX_BOOL);
+        evaluator_report_error_at(ctx, node->line, node->column,
+                                  "Evaluator error: condition must be boolean, got %s",
+                                  value_type_name(value));
+        return 0;
+    }
+
+    *constant = condition->data.boolean.value ? 1 : 0;
+    return 1;
+}
+
+//===================================================================
+// LIMITES DE ÍNDICE
+// Laço contado sobre um array dimensionado logo antes:
+//
+//     dim a(n)                    ou dim a(10) com while (i <= 10)
+//     let i = 1                   inteiro >= 1, na mesma lista do while
+//     while (i <= n) do           ou i < n
+//         ... a(i) ...
+//         let i = i + 1           passo inteiro >= 1, último statement
+//     end while
+//
+// No corpo i é inteiro e fica em 1..tamanho de a, então a(i) dispensa
+// a verificação (checked = 0). Nada no corpo atribui i (fora o passo),
+// n ou a, e nada entre o dim e o laço muda a ou n. O dim pode estar
+// numa lista de fora (laços aninhados) se o if ou while no caminho
+// também não mudar a nem n. Se o dim falhou (a execução segue depois
+// do erro), a fica sem array: evaluator_dim solta o slot quando n não
+// é number ou está fora da faixa (symbol_table_slot_dim com NULL) e
+// deixa como está o escalar que recusa. Por isso o acesso direto ainda
+// confere que há array e que o índice é inteiro (i pode não ser number
+// se let i = 1 foi recusado) e, senão, segue o caminho verificado, que
+// dá a mensagem de erro.
+// Roda antes do resolver: as variáveis são comparadas pelo nome
+// internado (mesmo nome, mesmo ponteiro)
+//===================================================================
+
+// Statement examinado e as listas que o contêm
+typedef struct Scope
+{
+    struct Scope* enclosing;
+    StatementListData* list;
+    int position;
+} Scope;
+
+typedef struct
+{
+    const Scope* scope;         // Posição do while
+    ASTNode* body;
+    const char* counter;        // i
+    LogicalOperator op;         // OP_LESS_EQUAL ou OP_LESS
+    ASTNode* bound;             // NODE_VARIABLE n ou NODE_NUMBER
+} CountedLoop;
+
+// Literal inteiro >= 1
+static int is_positive_int(ASTNode* node)
+{
+    return node->type == NODE_NUMBER && value_is_int(node->data.number.value) &&
+           value_as_int(node->data.number.value) >= 1;
+}
+
+static int is_variable(ASTNode* node, const char* name)
+{
+    return node->type == NODE_VARIABLE && node->data.variable.var_name == name;
+}
+
+// O statement (ou algum dentro dele) atribui a variável?
+static int writes(ASTNode* node, const char* name)
+{
+    if (!node) return 0;
+
+    switch (node->type)
+    {
+        case NODE_ASSIGNMENT: return node->data.assignment.var_name == name;
+        case NODE_INPUT:      return node->data.inputstatement.var_name == name;
+        case NODE_DIM:        return node->data.array.var_name == name;
+
+        case NODE_STATEMENT_LIST:
+        {
+            StatementListData* list = &node->data.statementlist;
+            for (int i = 0; i < list->count; i++)
+            {
+                if (writes(list->statements[i], name)) return 1;
+            }
+            return 0;
+        }
+
+        case NODE_IF:
+            return writes(node->data.ifstatement.then_body, name) ||
+                   writes(node->data.ifstatement.else_body, name);
+
+        case NODE_WHILE:
+            return writes(node->data.whilestatement.body, name);
+
+        default:
+            return 0;  // Expressões e let a(i) não mudam variáveis
+    }
+}
+
+// Reconhece o while na posição do escopo; 0 = não é um laço contado
+static int counted_loop(const Scope* scope, CountedLoop* loop)
+{
+    StatementListData* list = scope->list;
+    int position = scope->position;
+    ASTNode* node = list->statements[position];
+    ASTNode* condition = node->data.whilestatement.condition;
+    ASTNode* body = node->data.whilestatement.body;
+
+    if (condition->type != NODE_COMPARISON_OP) return 0;
+    LogicalOperator op = condition->data.logicalop.operator;
+    ASTNode* left = condition->data.logicalop.left;
+    ASTNode* bound = condition->data.logicalop.right;
+
+    if ((op != OP_LESS_EQUAL && op != OP_LESS) || left->type != NODE_VARIABLE) return 0;
+    const char* counter = left->data.variable.var_name;
+
+    if (!(bound->type == NODE_NUMBER ||
+          (bound->type == NODE_VARIABLE && bound->data.variable.var_name != counter)))
+    {
+        return 0;
+    }
+
+    // Corpo: ... let i = i + passo
+    if (body->type != NODE_STATEMENT_LIST || body->data.statementlist.count == 0) return 0;
+    StatementListData* statements = &body->data.statementlist;
+    ASTNode* step = statements->statements[statements->count - 1];
+    if (step->type != NODE_ASSIGNMENT || step->data.assignment.var_name != counter) return 0;
+
+    ASTNode* sum = step->data.assignment.value;
+    if (sum->type != NODE_BINARY_OP || sum->data.binaryop.operator != '+' ||
+        !is_variable(sum->data.binaryop.left, counter) || !is_positive_int(sum->data.binaryop.right))
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < statements->count - 1; i++)
+    {
+        if (writes(statements->statements[i], counter)) return 0;
+    }
+    if (bound->type == NODE_VARIABLE && writes(body, bound->data.variable.var_name)) return 0;
+
+    // Valor inicial: a última atribuição antes do laço
+    int i = position - 1;
+    while (i >= 0 && !writes(list->statements[i], counter)) i--;
+    if (i < 0) return 0;
+
+    ASTNode* init = list->statements[i];
+    if (init->type != NODE_ASSIGNMENT || !is_positive_int(init->data.assignment.value)) return 0;
+
+    loop->scope = scope;
+    loop->body = body;
+    loop->counter = counter;
+    loop->op = op;
+    loop->bound = bound;
+    return 1;
+}
+
+// O último dim de 'array' antes do laço cobre o limite da condição?
+static int covers_bound(const CountedLoop* loop, const char* array)
+{
+    const char* bound_name = loop->bound->type == NODE_VARIABLE
+                           ? loop->bound->data.variable.var_name : NULL;
+
+    if (array == loop->counter || array == bound_name || writes(loop->body, array)) return 0;
+
+    // Última atribuição de a ou n antes do laço, subindo pelas listas
+    const Scope* scope = loop->scope;
+    int i = scope->position - 1;
+    for (;;)
+    {
+        while (i >= 0 && !writes(scope->list->statements[i], array) &&
+               !(bound_name && writes(scope->list->statements[i], bound_name)))
+        {
+            i--;
+        }
+        if (i >= 0) break;
+
+        scope = scope->enclosing;
+        if (!scope) return 0;
+
+        // O if/while que contém o laço é refeito inteiro a cada volta
+        ASTNode* outer = scope->list->statements[scope->position];
+        if (writes(outer, array) || (bound_name && writes(outer, bound_name))) return 0;
+        i = scope->position - 1;
+    }
+
+    ASTNode* dim = scope->list->statements[i];
+    if (dim->type != NODE_DIM || dim->data.array.var_name != array) return 0;
+
+    ASTNode* size = dim->data.array.index;
+    if (bound_name) return is_variable(size, bound_name);
+    if (size->type != NODE_NUMBER) return 0;
+
+    // Maior i que passa na condição <= tamanho (dim trunca)
+    double bound = value_as_number(loop->bound->data.number.value);
+    double last = loop->op == OP_LESS_EQUAL ? floor(bound) : ceil(bound) - 1;
+    return last <= floor(value_as_number(size->data.number.value));
+}
+
+// Desce por statements e expressões do corpo marcando a(i)
+static void push_body_children(WorkStack* pending, ASTNode* node)
+{
+    ASTNode* children[3] = { NULL, NULL, NULL };
+    int count = 0;
+
+    switch (node->type)
+    {
+        case NODE_STATEMENT_LIST:
+            for (int i = 0; i < node->data.statementlist.count; i++)
+            {
+                *WORK_STACK_PUSH(pending, ASTNode*) = node->data.statementlist.statements[i];
+            }
+            return;
+
+        case NODE_PRINT:
+            for (int i = 0; i < node->data.printstatement.count; i++)
+            {
+                *WORK_STACK_PUSH(pending, ASTNode*) = node->data.printstatement.items[i];
+            }
+            return;
+
+        case NODE_CALL:
+            for (int i = 0; i < node->data.call.argc; i++)
+            {
+                *WORK_STACK_PUSH(pending, ASTNode*) = node->data.call.args[i];
+            }
+            return;
+
+        case NODE_ASSIGNMENT:
+            children[count++] = node->data.assignment.value;
+            break;
+
+        case NODE_BINARY_OP:
+            children[count++] = node->data.binaryop.left;
+            children[count++] = node->data.binaryop.right;
+            break;
+
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+            children[count++] = node->data.logicalop.left;
+            children[count++] = node->data.logicalop.right;
+            break;
+
+        case NODE_UNARY_OP:
+            children[count++] = node->data.unaryop.operand;
+            break;
+
+        case NODE_NOT_LOGICAL_OP:
+            children[count++] = node->data.notop.operand;
+            break;
+
+        case NODE_IF:
+            children[count++] = node->data.ifstatement.condition;
+            children[count++] = node->data.ifstatement.then_body;
+            children[count++] = node->data.ifstatement.else_body;
+            break;
+
+        case NODE_WHILE:
+            children[count++] = node->data.whilestatement.condition;
+            children[count++] = node->data.whilestatement.body;
+            break;
+
+        case NODE_DIM:
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGNMENT:
+            children[count++] = node->data.array.index;
+            children[count++] = node->data.array.value;
+            break;
+
+        default:
+            return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (children[i]) *WORK_STACK_PUSH(pending, ASTNode*) = children[i];
+    }
+}
+
+static void mark_loop(const Scope* scope)
+{
+    CountedLoop loop;
+    if (!counted_loop(scope, &loop)) return;
+
+    WorkStack pending;
+    work_stack_init(&pending, sizeof(ASTNode*));
+    *WORK_STACK_PUSH(&pending, ASTNode*) = loop.body;
+
+    while (!work_stack_empty(&pending))
+    {
+        ASTNode* current = *WORK_STACK_TOP(&pending, ASTNode*);
+        work_stack_pop(&pending);
+
+        if ((current->type == NODE_INDEX || current->type == NODE_INDEX_ASSIGNMENT) &&
+            is_variable(current->data.array.index, loop.counter) &&
+            covers_bound(&loop, current->data.array.var_name))
+        {
+            current->data.array.checked = 0;
+        }
+        push_body_children(&pending, current);
+    }
+
+    work_stack_free(&pending);
+}
+
+// Percorre os statements (já otimizados) atrás de laços contados
+static void prove_index_bounds(ASTNode* node, Scope* enclosing)
+{
+    if (!node) return;
+
+    switch (node->type)
+    {
+        case NODE_STATEMENT_LIST:
+        {
+            Scope scope;
+            scope.enclosing = enclosing;
+            scope.list = &node->data.statementlist;
+            for (int i = 0; i < scope.list->count; i++)
+            {
+                scope.position = i;
+                ASTNode* statement = scope.list->statements[i];
+                if (statement->type == NODE_WHILE) mark_loop(&scope);
+                prove_index_bounds(statement, &scope);
+            }
+            break;
+        }
+
+        case NODE_IF:
+            prove_index_bounds(node->data.ifstatement.then_body, enclosing);
+            prove_index_bounds(node->data.ifstatement.else_body, enclosing);
+            break;
+
+        case NODE_WHILE:
+            prove_index_bounds(node->data.whilestatement.body, enclosing);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static int optimize_statement(ASTNode* node, ExecutionContext* ctx)
+{
+    if (!node) return 1;
+
+    switch (node->type)
+    {
+        case NODE_STATEMENT_LIST:
+        {
+            // Continua depois de um erro para reportar todos
+            StatementListData* list = &node->data.statementlist;
+            int success = 1;
+            for (int i = 0; i < list->count; i++)
+            {
+                if (!optimize_statement(list->statements[i], ctx)) success = 0;
+            }
+            return success;
+        }
+
+        case NODE_ASSIGNMENT:
+            return fold_expression(node->data.assignment.value, ctx);
+
+        case NODE_DIM:
+            return fold_expression(node->data.array.index, ctx);
+
+        case NODE_INDEX_ASSIGNMENT:
+        {
+            int index_ok = fold_expression(node->data.array.index, ctx);
+            int value_ok = fold_expression(node->data.array.value, ctx);
+            return index_ok && value_ok;
+        }
+
+        case NODE_BINARY_OP:
+        case NODE_UNARY_OP:
+        case NODE_COMPARISON_OP:
+        case NODE_LOGICAL_OP:
+        case NODE_NOT_LOGICAL_OP:
+        case NODE_CALL:
+        case NODE_INDEX:
+            return fold_expression(node, ctx);
+
+        case NODE_PRINT:
+        {
+            PrintStatementData* print = &node->data.printstatement;
+            int success = 1;
+            for (int i = 0; i < print->count; i++)
+            {
+                if (!fold_expression(print->items[i], ctx)) success = 0;
+            }
+            return success;
+        }
+
+        case NODE_IF:
+        {
+            IfStatementData* data = &node->data.ifstatement;
+            int constant;
+            if (!fold_condition(node, data->condition, ctx, &constant)) return 0;
+
+            if (constant < 0)
+            {
+                int then_ok = optimize_statement(data->then_body, ctx);
+                int else_ok = optimize_statement(data->else_body, ctx);
+                return then_ok && else_ok;
+            }
+
+            // O if vira o ramo tomado (lista ou o if do "else if")
+            ASTNode* taken = constant ? data->then_body : data->else_body;
+            if (!taken)
+            {
+                make_empty_list(node);
+                return 1;
+            }
+            *node = *taken;
+            return optimize_statement(node, ctx);
+        }
+
+        case NODE_WHILE:
+        {
+            WhileStatementData* data = &node->data.whilestatement;
+            int constant;
+            if (!fold_condition(node, data->condition, ctx, &constant)) return 0;
+
+            if (constant == 0)
+            {
+                make_empty_list(node);
+                return 1;
+            }
+            return optimize_statement(data->body, ctx);
+        }
+
+        default:
+            return 1;  // Literais, variáveis, input, cores, break...
+    }
+}
+
+int optimize_program(ASTNode* ast, ExecutionContext* ctx)
+{
+    if (!ast || !ctx) return 0;
+    if (!optimize_statement(ast, ctx)) return 0;
+
+    prove_index_bounds(ast, NULL);
+    return 1;
+}
+
+
+#ifdef TESTOPTIMIZER
+// gcc -DTESTOPTIMIZER optimizer.c evaluator.c builtins.c lexer.c parser.c ast.c symbol_table.c color_mapping.c output.c number_format.c a89alloc.c utils.c work_stack.c zzstring.c -lm -o test_optimizer
+#include "color.h"
+#include "utils.h"
+#include "lexer.h"
+#include "parser.h"
+#include "a89alloc.h"
+
+// a(i) e let a(i) = x marcados pelo prove_index_bounds()
+static int count_unchecked(ASTNode* ast)
+{
+    WorkStack pending;
+    work_stack_init(&pending, sizeof(ASTNode*));
+    *WORK_STACK_PUSH(&pending, ASTNode*) = ast;
+
+    int count = 0;
+    while (!work_stack_empty(&pending))
+    {
+        ASTNode* current = *WORK_STACK_TOP(&pending, ASTNode*);
+        work_stack_pop(&pending);
+        if ((current->type == NODE_INDEX || current->type == NODE_INDEX_ASSIGNMENT) &&
+            !current->data.array.checked)
+        {
+            count++;
+        }
+        push_body_children(&pending, current);
+    }
+
+    work_stack_free(&pending);
+    return count;
+}
+
+int main()
+{
+    setup_utf8();
+
+    printf("%s=== TESTE OPTIMIZER ===%s\n\n", COLOR_HEADER, COLOR_RESET);
+
+    struct {
+        const char* code;
+        int success;            // optimize_program() deve devolver
+        NodeType type;          // Tipo do primeiro statement depois
+    } testes[] =
+    {
+        { "(2 + 3) * 4",                       1, NODE_NUMBER },
+        { "-(10 / 4)",                         1, NODE_NUMBER },
+        { "1 < 2 and not false",               1, NODE_BOOL },
+        { "false and x",                       1, NODE_BOOL },
+        { "true or 1 / 0",                     1, NODE_BOOL },
+        { "true and x",                        1, NODE_LOGICAL_OP },
+        { "x * (2 + 3)",                       1, NODE_BINARY_OP },
+        { "let y = 3 * 3",                     1, NODE_ASSIGNMENT },
+        { "if (true) then\nprint 1\nend if",   1, NODE_STATEMENT_LIST },
+        { "if (1 > 2) then\nprint 1\nelse if (2 > 1) then\nprint 2\nend if",
+                                               1, NODE_STATEMENT_LIST },
+        { "if (false) then\nprint 1 / 0\nend if", 1, NODE_STATEMENT_LIST },
+        { "while (false) do\nprint x\nend while", 1, NODE_STATEMENT_LIST },
+        { "while (x < 3) do\nbreak\nend while",   1, NODE_WHILE },
+        { "1 / 0",                             0, NODE_BINARY_OP },
+        { "print 2 * (3 - 3 / 0)",             0, NODE_PRINT },
+        { "1 + true",                          0, NODE_BINARY_OP },
+        { "if (2 + 2) then\nprint 1\nend if",  0, NODE_IF },
+    };
+
+    int num_testes = sizeof(testes) / sizeof(testes[0]);
+    int falhas = 0;
+    ExecutionContext* ctx = execution_context_create();
+
+    for (int i = 0; i < num_testes; i++)
+    {
+        Lexer lexer;
+        lexer_init(&lexer, testes[i].code);
+        ASTArena* arena = ast_arena_create();
+        ASTNode* ast = parse(&lexer, arena);
+
+        int success = ast ? optimize_program(ast, ctx) : -1;
+        ASTNode* first = (ast && ast->data.statementlist.count > 0)
+                       ? ast->data.statementlist.statements[0] : NULL;
+        int ok = success == testes[i].success && first && first->type == testes[i].type;
+
+        printf("%s%-4s%s %s\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO",
+               COLOR_RESET, testes[i].code);
+        if (!ok)
+        {
+            falhas++;
+            if (ast) print_ast(ast, 1);
+        }
+
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
+    }
+
+    // Limites de índice: quantos acessos ficam sem verificação
+    struct {
+        const char* code;
+        int unchecked;
+    } limites[] =
+    {
+        { "let n = 10\ndim a(n)\nlet i = 1\nwhile (i <= n) do\n"
+          "let a(i) = a(i) + i\nlet i = i + 1\nend while",                     2 },
+        { "dim a(10)\nlet i = 1\nwhile (i < 10.5) do\n? a(i)\nlet i = i + 3\nend while", 1 },
+        { "dim a(10)\nlet i = 1\nwhile (i <= 11) do\n? a(i)\nlet i = i + 1\nend while",  0 },
+        { "dim a(10)\nlet i = 0\nwhile (i <= 10) do\n? a(i)\nlet i = i + 1\nend while",  0 },
+        { "dim a(n)\nlet n = 20\nlet i = 1\nwhile (i <= n) do\n? a(i)\nlet i = i + 1\nend while", 0 },
+        { "dim a(n)\nlet i = 1\nwhile (i <= n) do\n? a(i)\nlet n = n - 1\nlet i = i + 1\nend while", 0 },
+        { "dim a(n)\nlet i = 1\nwhile (i <= n) do\n? a(i + 1)\nlet i = i + 1\nend while", 0 },
+        { "dim a(n)\nlet i = 1\nwhile (i <= n) do\nlet i = i + 1\n? a(i)\nend while",     0 },
+        { "dim a(n)\nlet i = 1\nwhile (i <= n) do\ndim a(1)\n? a(i)\nlet i = i + 1\nend while", 0 },
+        { "dim a(n)\nlet i = 1\nwhile (i <= n) do\nif (a(i) > 0) then\ninput i\nend if\n"
+          "let i = i + 1\nend while",                                           0 },
+        { "dim m(n)\nlet i = 1\nwhile (i <= n) do\nlet j = 1\nwhile (j <= n) do\n"
+          "let m(j) = m(i)\nlet j = j + 1\nend while\nlet i = i + 1\nend while", 2 },
+        { "dim a(n)\nlet k = 1\nwhile (k <= 2) do\nlet i = 1\nwhile (i <= n) do\n? a(i)\n"
+          "let i = i + 1\nend while\ndim a(1)\nlet k = k + 1\nend while",   0 },
+    };
+
+    int num_limites = sizeof(limites) / sizeof(limites[0]);
+    for (int i = 0; i < num_limites; i++)
+    {
+        Lexer lexer;
+        lexer_init(&lexer, limites[i].code);
+        ASTArena* arena = ast_arena_create();
+        ASTNode* ast = parse(&lexer, arena);
+
+        int unchecked = ast && optimize_program(ast, ctx) ? count_unchecked(ast) : -1;
+        int ok = unchecked == limites[i].unchecked;
+
+        printf("%s%-4s%s %s\n", ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO",
+               COLOR_RESET, limites[i].code);
+        if (!ok)
+        {
+            falhas++;
+            printf("     %d sem verificação, esperado %d\n", unchecked, limites[i].unchecked);
+        }
+
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
+    }
+    num_testes += num_limites;
+
+    execution_context_destroy(ctx);
+
+    printf("\n%s%d de %d testes OK%s\n", falhas ? COLOR_ERROR : COLOR_SUCCESS,
+           num_testes - falhas, num_testes, COLOR_RESET);
+
+    a89check_leaks();
+    return falhas != 0;
+}
+#endif
+// Fim de optimizer.c
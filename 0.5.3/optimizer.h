@@ -0,0 +1,36 @@
+// optimizer.h
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "ast.h"
+#include "evaluator.h"
+
+/********************************************************************
+Otimiza a AST produzida por parse(), antes de resolve_program():
+
+* Dobra constantes: operações aritméticas, de comparação e lógicas
+  cujos operandos são literais viram um NODE_NUMBER / NODE_BOOL.
+  "false and x" e "true or x" também (o curto-circuito não avalia x)
+* Remove ramos mortos: if com condição constante vira o ramo tomado;
+  while (false) vira uma lista vazia
+* Tira a verificação de limites de a(i) em laços contados
+  (while (i <= n) ... let i = i + 1) quando o último dim de a usou o
+  mesmo n: o índice fica em 1..n em todo o corpo
+
+O valor de cada dobra é calculado pelo próprio evaluate_expression(),
+então a semântica (tipos, EPSILON, mensagens) é a mesma da execução.
+Um erro numa subárvore só de literais (ex: 1 / 0) é reportado aqui,
+com linha e coluna, e o programa não é executado. Código em ramo
+morto não é examinado.
+
+Os nós são reescritos no lugar: a AST continua pertencendo à arena
+do parse. O contexto é usado para avaliar e reportar erros; as
+variáveis dele não são tocadas.
+
+Retorno: 1 = sucesso, 0 = erro de compilação (já reportado)
+********************************************************************/
+int optimize_program(ASTNode* ast, ExecutionContext* ctx);
+
+#endif // OPTIMIZER_H
+// Fim de optimizer.h
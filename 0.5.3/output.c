@@ -0,0 +1,157 @@
+// output.c
+
+#define _POSIX_C_SOURCE 200809L  // fileno e isatty também com -std=c11
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+#include "output.h"
+#include "number_format.h"
+
+// Modo de cor do processo (--color) e a decisão tomada a partir dele
+static OutputColorMode color_mode = OUTPUT_COLOR_AUTO;
+static int colors = 0;
+static int colors_resolved = 0;
+
+void output_init(OutputBuffer* out, FILE* stream)
+{
+    out->length = 0;
+    out->stream = stream;
+    out->is_tty = isatty(fileno(stream));
+}
+
+// Convenção https://no-color.org: definida e não vazia desliga cores
+static int output_detect_colors(void)
+{
+    const char* no_color = getenv("NO_COLOR");
+    if (no_color && no_color[0] != '\0') return 0;
+
+    const char* term = getenv("TERM");
+    if (term && strcmp(term, "dumb") == 0) return 0;
+
+    return isatty(fileno(stdout));
+}
+
+void output_set_color_mode(OutputColorMode mode)
+{
+    color_mode = mode;
+    colors_resolved = 0;
+}
+
+int output_colors_enabled(void)
+{
+    if (!colors_resolved)
+    {
+        switch (color_mode)
+        {
+            case OUTPUT_COLOR_ALWAYS: colors = 1; break;
+            case OUTPUT_COLOR_NEVER:  colors = 0; break;
+            default:                  colors = output_detect_colors(); break;
+        }
+        colors_resolved = 1;
+    }
+    return colors;
+}
+
+const char* output_ansi(const char* sequence)
+{
+    return output_colors_enabled() ? sequence : "";
+}
+
+void output_flush(OutputBuffer* out)
+{
+    if (out->length > 0)
+    {
+        fwrite(out->data, 1, out->length, out->stream);
+        out->length = 0;
+    }
+    fflush(out->stream);
+}
+
+void output_write(OutputBuffer* out, const char* text, size_t length)
+{
+    if (out->length + length > OUTPUT_BUFFER_SIZE)
+    {
+        output_flush(out);
+
+        // Maior que o buffer inteiro: escreve direto
+        if (length > OUTPUT_BUFFER_SIZE)
+        {
+            fwrite(text, 1, length, out->stream);
+            return;
+        }
+    }
+
+    memcpy(out->data + out->length, text, length);
+    out->length += length;
+}
+
+void output_text(OutputBuffer* out, const char* text)
+{
+    output_write(out, text, strlen(text));
+}
+
+void output_char(OutputBuffer* out, char c)
+{
+    if (out->length == OUTPUT_BUFFER_SIZE)
+    {
+        output_flush(out);
+    }
+    out->data[out->length++] = c;
+}
+
+void output_spaces(OutputBuffer* out, int count)
+{
+    while (count > 0)
+    {
+        if (out->length == OUTPUT_BUFFER_SIZE)
+        {
+            output_flush(out);
+        }
+
+        size_t chunk = OUTPUT_BUFFER_SIZE - out->length;
+        if (chunk > (size_t)count) chunk = count;
+
+        memset(out->data + out->length, ' ', chunk);
+        out->length += chunk;
+        count -= (int)chunk;
+    }
+}
+
+void output_number(OutputBuffer* out, double value)
+{
+    if (out->length + NUMBER_FORMAT_SIZE > OUTPUT_BUFFER_SIZE)
+    {
+        output_flush(out);
+    }
+    out->length += number_format(value, out->data + out->length);
+}
+
+void output_integer(OutputBuffer* out, int64_t value)
+{
+    if (out->length + NUMBER_FORMAT_SIZE > OUTPUT_BUFFER_SIZE)
+    {
+        output_flush(out);
+    }
+    out->length += number_format_integer(value, out->data + out->length);
+}
+
+void output_newline(OutputBuffer* out)
+{
+    output_char(out, '\n');
+    if (out->is_tty)
+    {
+        output_flush(out);
+    }
+}
+
+// Fim de output.c
@@ -0,0 +1,71 @@
+// output.h - SAÍDA BUFERIZADA DO INTERPRETADOR
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/********************************************************************
+Toda a saída de print (texto, espaços de alinhamento, separadores e
+sequências ANSI de cor) passa pelo buffer do interpretador, em vez de
+um printf/putchar por pedaço. Cada interpretador (ExecutionContext,
+ver evaluator.h) tem o seu OutputBuffer.
+
+* destino é terminal: esvazia a cada '\n' (a linha aparece na hora)
+* destino redirecionado: esvazia só quando o buffer enche
+
+Quem escreve direto no destino (mensagens de erro, prompt do input,
+REPL) deve chamar output_flush() antes, para manter a ordem.
+
+Cores do print (--color=auto|always|never), uma decisão por processo:
+
+* auto (padrão): só com stdout em terminal, sem NO_COLOR definida
+  e com TERM diferente de "dumb"
+* always / never: forçado, independente do destino
+
+A decisão é tomada uma vez; com cores desligadas o parser descarta
+as diretivas de cor e nenhuma sequência ANSI chega ao buffer.
+********************************************************************/
+
+#define OUTPUT_BUFFER_SIZE 16384
+
+typedef enum
+{
+    OUTPUT_COLOR_AUTO,
+    OUTPUT_COLOR_ALWAYS,
+    OUTPUT_COLOR_NEVER
+} OutputColorMode;
+
+typedef struct
+{
+    char data[OUTPUT_BUFFER_SIZE];
+    size_t length;
+    FILE* stream;       // Destino (stdout no interpretador)
+    int is_tty;         // Destino é terminal?
+} OutputBuffer;
+
+void output_init(OutputBuffer* out, FILE* stream);
+
+void output_write(OutputBuffer* out, const char* text, size_t length);
+void output_text(OutputBuffer* out, const char* text);
+void output_char(OutputBuffer* out, char c);
+void output_spaces(OutputBuffer* out, int count);
+void output_newline(OutputBuffer* out);
+
+// Número formatado direto no buffer (ver number_format.h)
+void output_number(OutputBuffer* out, double value);
+void output_integer(OutputBuffer* out, int64_t value);
+
+void output_flush(OutputBuffer* out);
+
+// Deve ser chamada antes da primeira consulta (main, ao ler --color)
+void output_set_color_mode(OutputColorMode mode);
+int output_colors_enabled(void);
+
+// A própria sequência com cores ligadas, "" sem cores (mensagens de erro)
+const char* output_ansi(const char* sequence);
+
+#endif // OUTPUT_H
+// Fim de output.h
@@ -5,19 +5,25 @@ OBSERVÇÕES:
 * As funções de criação de nodes não testam se o node foi criado 
   com sucesso porque:
     * estas funções chamam create_node()
-    * create_node() aloca memória através de A89ALLOC
-    * A89ALLOC, se não conseguir alocar memória, chama exit() para
-      encerrar o programa. 
+    * create_node() aloca memória da arena (ast_arena_alloc)
+    * a arena aloca seus blocos através de A89ALLOC, que, se não
+      conseguir alocar memória, chama exit() para encerrar o programa. 
+
+* Os nós pertencem à arena passada para parse(): em caso de erro
+  nada é liberado aqui, quem chamou destrói a arena inteira.
 ********************************************************************/
 #include "color.h"
 #include "ast.h"
 #include "parser.h"
 #include "a89alloc.h"
+#include "output.h"
+#include "work_stack.h"
+#include "builtins.h"
 
 //===================================================================
 // PROTÓTIPOS DAS FUNÇÕES DESTE ARQUIVO
 //===================================================================
-static void parser_init(Parser* parser, Lexer* lexer);
+static void parser_init(Parser* parser, Lexer* lexer, ASTArena* arena);
 static void parser_advance(Parser* parser);
 static int parser_expect(Parser* parser, TokenType expected_type);
 static void parser_set_error(Parser* parser, const char* message);
@@ -35,39 +41,36 @@ static ASTNode* parse_assignment_stmt(Parser* parser);
 static ASTNode* parse_print_statement(Parser* parser);
 static ASTNode* parse_color_statement(Parser* parser);
 static ASTNode* parse_input_statement(Parser* parser);
+static ASTNode* parse_dim_statement(Parser* parser);
 
 static ASTNode* parse_if_statement(Parser* parser);
+static ASTNode* parse_while_statement(Parser* parser);
+static ASTNode* parse_loop_control(Parser* parser);
 
 static ASTNode* parse_expression_stmt(Parser* parser);
 
-// EXPRESSÕES LÓGICAS
+// EXPRESSÕES (lógicas e aritméticas, sem recursão)
 static ASTNode* parse_logical_expr(Parser* parser);
-static ASTNode* parse_logical_or_expr(Parser* parser);
-static ASTNode* parse_logical_and_expr(Parser* parser);
-static ASTNode* parse_not_expr(Parser* parser);
-static ASTNode* parse_comparison_expr(Parser* parser);
-
-// EXPRESSÕES ARITMÉTICAS
 static ASTNode* parse_expression(Parser* parser);
-static ASTNode* parse_term(Parser* parser);
-static ASTNode* parse_factor(Parser* parser);
 static ASTNode* parse_atom(Parser* parser);
 
-// ASTNode* parse(Lexer* lexer)
-// ASTNode* parse_single_statement(Lexer* lexer) 
+// ASTNode* parse(Lexer* lexer, ASTArena* arena)
+// ASTNode* parse_single_statement(Lexer* lexer, ASTArena* arena) 
 //===================================================================
 
 
 //=============================
 // PARSER HELPER FUNCTIONS
 //=============================
-static void parser_init(Parser* parser, Lexer* lexer)
+static void parser_init(Parser* parser, Lexer* lexer, ASTArena* arena)
 {
     parser->lexer = lexer;
+    parser->arena = arena;
     memset(&parser->current_token, 0, sizeof(Token));  
     parser->current_token = lexer_get_next_token(lexer);
     parser->has_error = 0;
     parser->error_message[0] = '\0';
+    parser->loop_depth = 0;
 }
 
 static void parser_advance(Parser* parser)
@@ -88,11 +91,11 @@ static void parser_set_error(Parser* parser, const char* message)
     char formatted_message[BUFFER_SIZE];
     snprintf(formatted_message, sizeof(formatted_message),
              "%s[%d:%d] %s%s",
-             COLOR_ERROR,
+             output_ansi(COLOR_ERROR),
              parser->current_token.line,
              parser->current_token.column,
              message,
-             COLOR_RESET);
+             output_ansi(COLOR_RESET));
     
     // Copia para o buffer do parser
     strncpy(parser->error_message, formatted_message, 
@@ -108,6 +111,7 @@ static int is_keyword_token(TokenType type)
         case TOKEN_PRINT:   
         case TOKEN_QUESTION: // ?
         case TOKEN_INPUT:     
+        case TOKEN_DIM:
         // FUTURO: adicionar novos comandos aqui
         // case TOKEN_IF:
         // case TOKEN_FOR:
@@ -129,6 +133,7 @@ static const char* get_keyword_name(TokenType type)
         case TOKEN_PRINT:    return "print";
         case TOKEN_QUESTION: return "?";
         case TOKEN_INPUT:    return "input";
+        case TOKEN_DIM:      return "dim";
         // FUTURO: adicionar novos comandos aqui
         // case TOKEN_IF:       return "if";
         // case TOKEN_FOR:      return "for";
@@ -215,9 +220,11 @@ static void report_print_keyword_error(Parser* parser, Token token) {
     }
     else {
         // Erro genérico para outros tokens inesperados
+        char text[TOKENTEXT_SIZE];
+        lexer_token_text(parser->lexer, token, text, sizeof(text));
         snprintf(error_msg, sizeof(error_msg),
             "Parser error [%d:%d]: Unexpected '%s' in print statement",
-            token.line, token.column, token.text[0] ? token.text : "token");
+            token.line, token.column, text[0] ? text : "token");
     }
     
     parser_set_error(parser, error_msg);
@@ -226,30 +233,33 @@ static void report_print_keyword_error(Parser* parser, Token token) {
 static int is_operator_token(TokenType type)
 {
     return type == TOKEN_PLUS || type == TOKEN_MINUS || 
-           type == TOKEN_STAR || type == TOKEN_SLASH;
+           type == TOKEN_STAR || type == TOKEN_SLASH ||
+           type == TOKEN_PERCENT || type == TOKEN_BACKSLASH;
 }
 
 static void report_unexpected_token_error(Parser* parser, const char* context)
 {
     Token token = parser->current_token;
     char error_msg[BUFFER_SIZE];
+    char text[TOKENTEXT_SIZE];
+    lexer_token_text(parser->lexer, token, text, sizeof(text));
     
     if (is_operator_token(token.type))
     {
         snprintf(error_msg, sizeof(error_msg),
             "Parser error: Operator    '%s ' cannot appear at this position in %s",
-            token.text, context);
+            text, context);
     }
     else if (token.type == TOKEN_ERROR)
     {
         // Já tem mensagem de erro do lexer
-        strncpy(error_msg, token.text, sizeof(error_msg) - 1);
+        strncpy(error_msg, text, sizeof(error_msg) - 1);
     }
     else
     {
         snprintf(error_msg, sizeof(error_msg),
             "Parser error: Unexpected  '%s ' in %s (expected number, string, identifier or '(  ')",
-            token.text, context);
+            text, context);
     }
     
     parser_set_error(parser, error_msg);
@@ -276,7 +286,7 @@ static ASTNode* parse_program(Parser* parser)
 
 static ASTNode* parse_statement_list(Parser* parser)
 {
-    ASTNode* list = create_statement_list_node(
+    ASTNode* list = create_statement_list_node(parser->arena,
         parser->current_token.line,
         parser->current_token.column
     );
@@ -284,10 +294,9 @@ static ASTNode* parse_statement_list(Parser* parser)
     // Parseia o primeiro statement
     ASTNode* stmt = parse_statement(parser);
     if (!stmt || parser->has_error) {
-        free_ast(list);
         return NULL;
     }
-    statement_list_add(list, stmt);
+    statement_list_add(parser->arena, list, stmt);
     
     // Continua parseando enquanto encontrar separadores
     while (!parser->has_error && 
@@ -330,10 +339,9 @@ static ASTNode* parse_statement_list(Parser* parser)
             stmt = parse_statement(parser);
             if (!stmt || parser->has_error)
             {
-                free_ast(list);
                 return NULL;
             }
-            statement_list_add(list, stmt);
+            statement_list_add(parser->arena, list, stmt);
         }
         else
         {
@@ -350,7 +358,11 @@ static ASTNode* parse_statement_list(Parser* parser)
 //                     | print_stmt
 //                     | color_stmt 
 //                     | input_stmt 
+//                     | dim_stmt
 //                     | if_stmt
+//                     | while_stmt
+//                     | break_stmt
+//                     | continue_stmt
 //                     | expression_stmt
 //==============================================================================
 static ASTNode* parse_statement(Parser* parser)
@@ -373,10 +385,23 @@ static ASTNode* parse_statement(Parser* parser)
     {
         return parse_input_statement(parser);
     } 
+    else if (parser->current_token.type == TOKEN_DIM)
+    {
+        return parse_dim_statement(parser);
+    }
     else if (parser->current_token.type == TOKEN_IF)  
     {
         return parse_if_statement(parser);            
     }
+    else if (parser->current_token.type == TOKEN_WHILE)
+    {
+        return parse_while_statement(parser);
+    }
+    else if (parser->current_token.type == TOKEN_BREAK ||
+             parser->current_token.type == TOKEN_CONTINUE)
+    {
+        return parse_loop_control(parser);
+    }
     else
     {
         return parse_expression_stmt(parser);
@@ -385,7 +410,7 @@ static ASTNode* parse_statement(Parser* parser)
 
 
 //===================================================================
-// assignment_stmt := LET identifier '=' expression
+// assignment_stmt := LET identifier ('(' logical_expr ')')? '=' expression
 //===================================================================
 static ASTNode* parse_assignment_stmt(Parser* parser)
 {
@@ -413,11 +438,35 @@ static ASTNode* parse_assignment_stmt(Parser* parser)
     }
 
     char var_name[VARNAME_SIZE];
-    strncpy(var_name, parser->current_token.value.varname, VARNAME_SIZE - 1);
-    var_name[VARNAME_SIZE - 1] = '\0';
+    lexer_token_text(parser->lexer, parser->current_token, var_name, sizeof(var_name));
+    Token name = parser->current_token;
 
     parser_advance(parser);  // Consume identifier
     
+    // let a(i) = valor: elemento de array
+    ASTNode* index = NULL;
+    if (parser->current_token.type == TOKEN_LPAREN)
+    {
+        if (builtin_lookup(var_name) >= 0)
+        {
+            char error_msg[BUFFER_SIZE];
+            snprintf(error_msg, sizeof(error_msg),
+                     "Parser error: '%s' is a function name, cannot be used as array", var_name);
+            parser_set_error(parser, error_msg);
+            return NULL;
+        }
+        parser_advance(parser);  // Consume '('
+        index = parse_logical_expr(parser);
+        if (parser->has_error) {
+            return NULL;
+        }
+        if (parser->current_token.type != TOKEN_RPAREN) {
+            parser_set_error(parser, "Parser error: Expected ')' after array index");
+            return NULL;
+        }
+        parser_advance(parser);  // Consume ')'
+    }
+    
      // Check '='
     if (parser->current_token.type != TOKEN_ASSIGN) {
         parser_set_error(parser, "Parser error: Expected '=' after variable name");
@@ -426,26 +475,17 @@ static ASTNode* parse_assignment_stmt(Parser* parser)
     
     parser_advance(parser);  // Consume '='
 
-    // For string variables: expect STRING_LITERAL
-    if(parser->current_token.type == TOKEN_STRING)
-    {
-        ASTNode* string_node = create_string_node(parser->current_token.value.string,
-                                                  parser->current_token.line,
-                                                  parser->current_token.column);
-
-        parser_advance(parser);  // Consume STRING_LITERAL
-
-        return create_assignment_node(var_name, string_node,
-                                      string_node->line,
-                                      string_node->column);
-    }
-
     ASTNode* expr = parse_expression(parser);
     if (parser->has_error) {
         return NULL;
     }
 
-    return create_assignment_node(var_name, expr, expr->line, expr->column);
+    if (index)
+    {
+        return create_array_node(parser->arena, NODE_INDEX_ASSIGNMENT, var_name, index, expr,
+                                 name.line, name.column);
+    }
+    return create_assignment_node(parser->arena, var_name, expr, name.line, name.column);
 }
 
 
@@ -463,7 +503,10 @@ static ASTNode* parse_print_statement(Parser* parser)
     parser_advance(parser); // Consome o token print ou ?
     
     // Cria nó do comando print
-    ASTNode* print_node = create_print_node(line, column);
+    ASTNode* print_node = create_print_node(parser->arena, line, column);
+    
+    // Última diretiva de cor descartada (cores desligadas)
+    Token dropped_color = { .type = TOKEN_NULL };
     
     // Parseia os itens (expressões)
     while (!parser->has_error)
@@ -484,7 +527,6 @@ static ASTNode* parse_print_statement(Parser* parser)
             is_keyword_token(token.type))
         {
             report_print_keyword_error(parser, token);
-            free_ast(print_node);
             return NULL;
         }
         
@@ -493,14 +535,21 @@ static ASTNode* parse_print_statement(Parser* parser)
         // CASOS ESPECIAIS PARA PRINT
         // ============================================
         
-        // 1. CORES
+        // 1. CORES (sem cores na saída a diretiva nem entra na AST)
         if (is_color_token(token.type))
         {
-            ASTNode* color_node = create_color_node(token.type, 
+            if (!output_colors_enabled())
+            {
+                dropped_color = token;
+                parser_advance(parser);
+                continue;
+            }
+
+            ASTNode* color_node = create_color_node(parser->arena, token.type, 
                                                    token.line, 
                                                    token.column);
 
-            print_node_add_item(print_node, color_node);
+            print_node_add_item(parser->arena, print_node, color_node);
             parser_advance(parser);  // Consome o token de cor
             continue;  // Continua para próximo item
         }
@@ -511,7 +560,6 @@ static ASTNode* parse_print_statement(Parser* parser)
             if(parser->current_token.type != TOKEN_LPAREN)
             {
                 parser_set_error(parser, "Parser error: '(' expected");
-                free_ast(print_node);
                 return NULL;
             }
             parser_advance(parser);  // Consome o '('
@@ -520,16 +568,18 @@ static ASTNode* parse_print_statement(Parser* parser)
             if(parser->current_token.type != TOKEN_NUMBER)
             {
                 parser_set_error(parser, "Parser error: number expected in width()");
-                free_ast(print_node);
                 return NULL;
             }
 
-            int width_value  = parser->current_token.value.number;
+            // Fora de int (ou fração) cai no erro de intervalo abaixo
+            Token width_token = parser->current_token;
+            double width_number = width_token.is_integer ? (double)width_token.value.integer
+                                                         : width_token.value.number;
+            int width_value = (width_number >= 0 && width_number <= 256) ? (int)width_number : -1;
 
             // Valida o intervalo aceitável para width
             if (width_value < 0 || width_value > 256) {
                 parser_set_error(parser, "Parser error: width must be between 1 and 256");
-                free_ast(print_node);
                 return NULL;
             }
 
@@ -537,11 +587,10 @@ static ASTNode* parse_print_statement(Parser* parser)
             if(parser->current_token.type != TOKEN_RPAREN)
             {
                 parser_set_error(parser, "Parser error: ')' expected");
-                free_ast(print_node);
                 return NULL;
             }           
-            ASTNode* width_node = create_width_node(width_value, token.line, token.column);
-            print_node_add_item(print_node, width_node);
+            ASTNode* width_node = create_width_node(parser->arena, width_value, token.line, token.column);
+            print_node_add_item(parser->arena, print_node, width_node);
             parser_advance(parser);  // Consome o ')'
             continue;
         }
@@ -560,8 +609,8 @@ static ASTNode* parse_print_statement(Parser* parser)
                     token_type = TOKEN_CENTER;break;
              }
 
-            ASTNode* alignment_node = create_alignment_node(token_type, token.line, token.column);
-            print_node_add_item(print_node, alignment_node);
+            ASTNode* alignment_node = create_alignment_node(parser->arena, token_type, token.line, token.column);
+            print_node_add_item(parser->arena, print_node, alignment_node);
             parser_advance(parser);  // Consome o 'left'|'right'|'center'
             continue;
         }
@@ -571,11 +620,10 @@ static ASTNode* parse_print_statement(Parser* parser)
         ASTNode* item = parse_logical_expr(parser);
         if (parser->has_error)
         {
-            free_ast(print_node);
             return NULL;
         }        
         
-        print_node_add_item(print_node, item);
+        print_node_add_item(parser->arena, print_node, item);
     }
 
     // Verifica se tem 'nl' no final
@@ -584,6 +632,15 @@ static ASTNode* parse_print_statement(Parser* parser)
         parser_advance(parser);  // Consome o 'nl'
     } else {
         print_set_newline(print_node, 0);  // 0 = sem nl (mesma linha)
+        
+        // "print red" não pode virar print vazio (que quebra linha):
+        // mantém a diretiva, que não faz nada com cores desligadas
+        if (dropped_color.type != TOKEN_NULL && print_node->data.printstatement.count == 0)
+        {
+            print_node_add_item(parser->arena, print_node,
+                                create_color_node(parser->arena, dropped_color.type,
+                                                  dropped_color.line, dropped_color.column));
+        }
     }
     
     return print_node;
@@ -600,16 +657,19 @@ static ASTNode* parse_color_statement(Parser* parser)
     // Verifica se é um token de cor permitido como statement
     if (!is_color_statement_token(token.type))
     {
+        char text[TOKENTEXT_SIZE];
+        lexer_token_text(parser->lexer, token, text, sizeof(text));
+
         char error_msg[BUFFER_SIZE];
         snprintf(error_msg, sizeof(error_msg),
             "Parser error [%d:%d]: Color '%s' cannot be used as standalone statement",
-            token.line, token.column, token.text);
+            token.line, token.column, text);
         parser_set_error(parser, error_msg);
         return NULL;
     }
     
     // Cria nó de cor
-    ASTNode* node = create_color_node(token.type, token.line, token.column);
+    ASTNode* node = create_color_node(parser->arena, token.type, token.line, token.column);
 
     parser_advance(parser);  // Consome o token
     
@@ -628,13 +688,13 @@ static ASTNode* parse_input_statement(Parser* parser)
 
     parser_advance(parser); // Consome o token input
 
-    char prompt[STRING_SIZE] = {0};
+    const char* prompt = NULL;
+    size_t prompt_length = 0;
 
     // Verifica se tem prompt 
     if (parser->current_token.type == TOKEN_STRING)
     {
-        strncpy(prompt, parser->current_token.value.string, STRING_SIZE - 1);
-        prompt[STRING_SIZE - 1] = '\0';
+        prompt = lexer_token_contents(parser->lexer, parser->current_token, &prompt_length);
         
         parser_advance(parser);  // Consome string
     }
@@ -646,12 +706,65 @@ static ASTNode* parse_input_statement(Parser* parser)
     }
 
     char var_name[VARNAME_SIZE];
-    strncpy(var_name, parser->current_token.value.varname, VARNAME_SIZE - 1);
-    var_name[VARNAME_SIZE - 1] = '\0';
+    lexer_token_text(parser->lexer, parser->current_token, var_name, sizeof(var_name));
 
     parser_advance(parser);  // Consome IDENTIFIER
     
-    return create_input_node(prompt, var_name, line, column);
+    return create_input_node(parser->arena, prompt, prompt_length, var_name, line, column);
+}
+
+//===================================================================
+// dim_stmt         := 'DIM' IDENTIFIER '(' expression ')'
+//===================================================================
+static ASTNode* parse_dim_statement(Parser* parser)
+{
+    int line = parser->current_token.line;
+    int column = parser->current_token.column;
+
+    parser_advance(parser); // Consome o token dim
+
+    if (parser->current_token.type != TOKEN_IDENTIFIER)
+    {
+        parser_set_error(parser, "Parser error: Expected array name after 'dim'");
+        return NULL;
+    }
+
+    char var_name[VARNAME_SIZE];
+    lexer_token_text(parser->lexer, parser->current_token, var_name, sizeof(var_name));
+
+    // a(i) com o nome de uma função seria sempre a chamada da função
+    if (builtin_lookup(var_name) >= 0)
+    {
+        char error_msg[BUFFER_SIZE];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Parser error: '%s' is a function name, cannot be used as array", var_name);
+        parser_set_error(parser, error_msg);
+        return NULL;
+    }
+
+    parser_advance(parser);  // Consome IDENTIFIER
+
+    if (parser->current_token.type != TOKEN_LPAREN)
+    {
+        parser_set_error(parser, "Parser error: Expected '(' after array name");
+        return NULL;
+    }
+    parser_advance(parser);  // Consome '('
+
+    ASTNode* size = parse_expression(parser);
+    if (parser->has_error || !size)
+    {
+        return NULL;
+    }
+
+    if (parser->current_token.type != TOKEN_RPAREN)
+    {
+        parser_set_error(parser, "Parser error: Expected ')' after array size");
+        return NULL;
+    }
+    parser_advance(parser);  // Consome ')'
+
+    return create_array_node(parser->arena, NODE_DIM, var_name, size, NULL, line, column);
 }
 
 //===================================================================
@@ -686,7 +799,6 @@ static ASTNode* parse_if_statement(Parser* parser)
     if (parser->current_token.type != TOKEN_RPAREN)
     {
         parser_set_error(parser, "Parser error: ')' expected after condition");
-        free_ast(condition);
         return NULL;
     }
     parser_advance(parser);// Consome ')'
@@ -694,7 +806,6 @@ static ASTNode* parse_if_statement(Parser* parser)
     if (parser->current_token.type != TOKEN_THEN)
     {
         parser_set_error(parser, "Parser error: 'then' expected after condition");
-        free_ast(condition);
         return NULL;
     }
     parser_advance(parser);// Consome 'then'
@@ -704,7 +815,6 @@ static ASTNode* parse_if_statement(Parser* parser)
         parser->current_token.type != TOKEN_NL)
     {
         parser_set_error(parser, "Parser error: newline expected after 'then'");
-        free_ast(condition);
         return NULL;
     }
     parser_advance(parser);// Consome EOL/NL
@@ -713,7 +823,6 @@ static ASTNode* parse_if_statement(Parser* parser)
     ASTNode* then_body = parse_statement_list(parser);
     if (parser->has_error || !then_body)
     {
-        free_ast(condition);
         return NULL;
     }
     
@@ -733,9 +842,6 @@ static ASTNode* parse_if_statement(Parser* parser)
             if (parser->current_token.type != TOKEN_LPAREN)
             {
                 parser_set_error(parser, "Parser error: '(' expected after 'if'");
-                free_ast(condition);
-                free_ast(then_body);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             parser_advance(parser);  // Consome '('
@@ -743,19 +849,12 @@ static ASTNode* parse_if_statement(Parser* parser)
             ASTNode* elif_condition = parse_logical_expr(parser);
             if (parser->has_error || !elif_condition)
             {
-                free_ast(condition);
-                free_ast(then_body);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             
             if (parser->current_token.type != TOKEN_RPAREN)
             {
                 parser_set_error(parser, "Parser error: ')' expected after condition");
-                free_ast(condition);
-                free_ast(then_body);
-                free_ast(elif_condition);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             parser_advance(parser);  // Consome ')'
@@ -763,10 +862,6 @@ static ASTNode* parse_if_statement(Parser* parser)
             if (parser->current_token.type != TOKEN_THEN)
             {
                 parser_set_error(parser, "Parser error: 'then' expected after condition");
-                free_ast(condition);
-                free_ast(then_body);
-                free_ast(elif_condition);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             parser_advance(parser);  // Consome 'then'
@@ -776,10 +871,6 @@ static ASTNode* parse_if_statement(Parser* parser)
                 parser->current_token.type != TOKEN_NL)
             {
                 parser_set_error(parser, "Parser error: newline expected after 'then'");
-                free_ast(condition);
-                free_ast(then_body);
-                free_ast(elif_condition);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             parser_advance(parser);  // Consome EOL/NL
@@ -788,25 +879,16 @@ static ASTNode* parse_if_statement(Parser* parser)
             ASTNode* elif_body = parse_statement_list(parser);
             if (parser->has_error || !elif_body)
             {
-                free_ast(condition);
-                free_ast(then_body);
-                free_ast(elif_condition);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             
             // Cria um IF node para este 'else if'
             // Este IF será o else_body do IF anterior
-            ASTNode* elif_node = create_if_node(elif_condition, elif_body, NULL, 
+            ASTNode* elif_node = create_if_node(parser->arena, elif_condition, elif_body, NULL, 
                                                 elif_condition->line, elif_condition->column);
             if (!elif_node)
             {
                 parser_set_error(parser, "Parser error: could not create elif node");
-                free_ast(condition);
-                free_ast(then_body);
-                free_ast(elif_condition);
-                free_ast(elif_body);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             
@@ -833,9 +915,6 @@ static ASTNode* parse_if_statement(Parser* parser)
                 parser->current_token.type != TOKEN_NL)
             {
                 parser_set_error(parser, "Parser error: newline expected after 'else'");
-                free_ast(condition);
-                free_ast(then_body);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             parser_advance(parser);  // Consome EOL/NL
@@ -844,9 +923,6 @@ static ASTNode* parse_if_statement(Parser* parser)
             ASTNode* final_else_body = parse_statement_list(parser);
             if (parser->has_error || !final_else_body)
             {
-                free_ast(condition);
-                free_ast(then_body);
-                if (else_body) free_ast(else_body);
                 return NULL;
             }
             
@@ -876,9 +952,6 @@ static ASTNode* parse_if_statement(Parser* parser)
     if (parser->current_token.type != TOKEN_END)
     {
         parser_set_error(parser, "Parser error: 'end' expected");
-        free_ast(condition);
-        free_ast(then_body);
-        if (else_body) free_ast(else_body);
         return NULL;
     }
     parser_advance(parser);  // Consome 'end'
@@ -887,9 +960,6 @@ static ASTNode* parse_if_statement(Parser* parser)
     if (parser->current_token.type != TOKEN_IF)
     {
         parser_set_error(parser, "Parser error: 'if' expected after 'end'");
-        free_ast(condition);
-        free_ast(then_body);
-        if (else_body) free_ast(else_body);
         return NULL;
     }
     parser_advance(parser);  // Consome 'if'
@@ -900,295 +970,537 @@ static ASTNode* parse_if_statement(Parser* parser)
         parser->current_token.type != TOKEN_EOF)
     {
         parser_set_error(parser, "Parser error: newline expected after 'end if'");
-        free_ast(condition);
-        free_ast(then_body);
-        if (else_body) free_ast(else_body);
         return NULL;
     }
     
-    // Consome EOL/NL se existir
-    if (parser->current_token.type == TOKEN_EOL || 
-        parser->current_token.type == TOKEN_NL)
-    {
-        parser_advance(parser);  // Consome EOL/NL
-    }
+    // O EOL/NL depois de 'end if' fica para parse_statement_list,
+    // que o usa como separador antes do próximo statement
     
     // Create IF node
-    ASTNode* if_node = create_if_node(condition, then_body, else_body, line, column);
+    ASTNode* if_node = create_if_node(parser->arena, condition, then_body, else_body, line, column);
     if (!if_node)
     {
         parser_set_error(parser, "Parser error: could not create if node");
-        free_ast(condition);
-        free_ast(then_body);
-        if (else_body) free_ast(else_body);
         return NULL;
     }
     
     return if_node;
 }
-//===================================================================
-// expression_stmt := logical_expr
-//===================================================================
-static ASTNode* parse_expression_stmt(Parser* parser)
-{
-    return parse_logical_expr(parser);
-}
 
 //===================================================================
-// logical_expr := logical_or_expr
+// while_stmt := 'while' '(' logical_expr ')' 'do' EOL
+//                   statement_list*
+//               'end' 'while' EOL
 //===================================================================
-static ASTNode* parse_logical_expr(Parser* parser)
+static ASTNode* parse_while_statement(Parser* parser)
 {
-    return parse_logical_or_expr(parser);
-}
-
-//===================================================================
-// logical_or_expr := logical_and_expr ('or' logical_and_expr)*
-//===================================================================
-static ASTNode* parse_logical_or_expr(Parser* parser)
-{
-    ASTNode* left = parse_logical_and_expr(parser);
-    if (parser->has_error || !left) return NULL;
+    int line = parser->current_token.line;
+    int column = parser->current_token.column;
+    
+    parser_advance(parser);// Consome 'while'
     
-    while (parser->current_token.type == TOKEN_OR)
+    if (parser->current_token.type != TOKEN_LPAREN)
     {
-        parser_advance(parser);// consome 'or'
-        
-        ASTNode* right = parse_logical_and_expr(parser);
-        if (!right)
-        {
-            free_ast(left);
-            return NULL;
-        }
-        
-        left = create_logical_op_node(OP_OR, left, right, 
-                                     parser->current_token.line, 
-                                     parser->current_token.column);
+        parser_set_error(parser, "Parser error: '(' expected after 'while'");
+        return NULL;
     }
+    parser_advance(parser);// Consome '('
     
-    return left;
-}
-
-//===================================================================
-// logical_and_expr := not_expr ('and' not_expr)*
-//===================================================================
-static ASTNode* parse_logical_and_expr(Parser* parser)
-{
-    ASTNode* left = parse_not_expr(parser);
-    if (parser->has_error || !left) return NULL;
+    ASTNode* condition = parse_logical_expr(parser);
+    if (parser->has_error || !condition)
+    {
+        return NULL;
+    }
     
-    while (parser->current_token.type == TOKEN_AND) {
+    if (parser->current_token.type != TOKEN_RPAREN)
+    {
+        parser_set_error(parser, "Parser error: ')' expected after condition");
+        return NULL;
+    }
+    parser_advance(parser);// Consome ')'
+    
+    if (parser->current_token.type != TOKEN_DO)
+    {
+        parser_set_error(parser, "Parser error: 'do' expected after condition");
+        return NULL;
+    }
+    parser_advance(parser);// Consome 'do'
+    
+    // Espera EOL/NL
+    if (parser->current_token.type != TOKEN_EOL && 
+        parser->current_token.type != TOKEN_NL)
+    {
+        parser_set_error(parser, "Parser error: newline expected after 'do'");
+        return NULL;
+    }
+    
+    // Pula linhas em branco; o corpo pode ser vazio
+    while (parser->current_token.type == TOKEN_EOL ||
+           parser->current_token.type == TOKEN_NL)
+    {
         parser_advance(parser);
+    }
+    
+    ASTNode* body;
+    if (parser->current_token.type == TOKEN_END)
+    {
+        body = create_statement_list_node(parser->arena, line, column);
+    }
+    else
+    {
+        parser->loop_depth++;
+        body = parse_statement_list(parser);
+        parser->loop_depth--;
         
-        ASTNode* right = parse_not_expr(parser);
-        if (!right)
+        if (parser->has_error || !body)
         {
-            free_ast(left);
             return NULL;
         }
-
-        left = create_logical_op_node(OP_AND, left, right, 
-                                     parser->current_token.line, 
-                                     parser->current_token.column);
     }
     
-    return left;
+    // Verifica 'end while' (obrigatório)
+    if (parser->current_token.type != TOKEN_END)
+    {
+        parser_set_error(parser, "Parser error: 'end' expected");
+        return NULL;
+    }
+    parser_advance(parser);  // Consome 'end'
+    
+    if (parser->current_token.type != TOKEN_WHILE)
+    {
+        parser_set_error(parser, "Parser error: 'while' expected after 'end'");
+        return NULL;
+    }
+    parser_advance(parser);  // Consome 'while'
+    
+    // Expect EOL/NL (ou EOF); fica para parse_statement_list
+    if (parser->current_token.type != TOKEN_EOL && 
+        parser->current_token.type != TOKEN_NL &&
+        parser->current_token.type != TOKEN_EOF)
+    {
+        parser_set_error(parser, "Parser error: newline expected after 'end while'");
+        return NULL;
+    }
+    
+    return create_while_node(parser->arena, condition, body, line, column);
 }
 
 //===================================================================
-// not_expr := ('not' | '!')? comparison_expr
+// break_stmt    := 'break' EOL
+// continue_stmt := 'continue' EOL
 //===================================================================
-static ASTNode* parse_not_expr(Parser* parser)
+static ASTNode* parse_loop_control(Parser* parser)
 {
-    int line = parser->current_token.line;
-    int column = parser->current_token.column;
+    Token token = parser->current_token;
+    const char* name = token.type == TOKEN_BREAK ? "break" : "continue";
     
-    // Verifica se tem 'not' ou '!'
-    if (parser->current_token.type == TOKEN_NOT) 
+    if (parser->loop_depth == 0)
     {
-        parser_advance(parser);  // Consome 'not' ou '!'
-        
-        ASTNode* operand = parse_comparison_expr(parser);  // ← precisa de parse_comparison_expr
-        if (!operand) return NULL;
-        
-        return create_logical_not_node(operand, line, column);
+        char error_msg[BUFFER_SIZE];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Parser error: '%s' outside of a while loop", name);
+        parser_set_error(parser, error_msg);
+        return NULL;
+    }
+    parser_advance(parser);  // Consome 'break'/'continue'
+    
+    if (parser->current_token.type != TOKEN_EOL && 
+        parser->current_token.type != TOKEN_NL &&
+        parser->current_token.type != TOKEN_EOF)
+    {
+        char error_msg[BUFFER_SIZE];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Parser error: newline expected after '%s'", name);
+        parser_set_error(parser, error_msg);
+        return NULL;
     }
     
-    // Se não tem NOT, passa para comparação
-    return parse_comparison_expr(parser);
+    if (token.type == TOKEN_BREAK)
+    {
+        return create_break_node(parser->arena, token.line, token.column);
+    }
+    return create_continue_node(parser->arena, token.line, token.column);
 }
 
 //===================================================================
-// comparison_expr := expression (comparison_op expression)*
+// expression_stmt := logical_expr
 //===================================================================
-static ASTNode* parse_comparison_expr(Parser* parser)
+static ASTNode* parse_expression_stmt(Parser* parser)
 {
-    ASTNode* left = parse_expression(parser);  
-    if (parser->has_error || !left) return NULL;
-    
-    // Verifica operadores relacionais
-    while (1)
+    return parse_logical_expr(parser);
+}
+
+//===================================================================
+// EXPRESSÕES - precedence climbing sem recursão
+//
+// logical_expr     := logical_or_expr
+// logical_or_expr  := logical_and_expr ('or' logical_and_expr)*
+// logical_and_expr := not_expr ('and' not_expr)*
+// not_expr         := ('not' | '!')? comparison_expr
+// comparison_expr  := expression (comparison_op expression)*
+// expression       := term (('+' | '-') term)*
+// term             := factor (('*' | '/' | '%' | '\') factor)*
+// factor           := ('+' | '-')? atom
+// atom             := NUMBER | STRING | 'true' | 'false' | IDENTIFIER
+//                   | '(' logical_expr ')'
+//                   | FUNCTION '(' logical_expr (',' logical_expr)* ')'
+//                   | IDENTIFIER '(' logical_expr ')'   (sem espaço antes do '(')
+//
+// A gramática é a mesma da antiga descida recursiva (uma função por
+// nível), mas os operadores pendentes e os operandos ficam em pilhas
+// de trabalho: parênteses aninhados não consomem pilha do C. Cada
+// nível da gramática vira um ExprLevel; um operador só é reduzido
+// quando chega outro de nível menor ou igual (associatividade à
+// esquerda), ')' ou o fim da expressão. As posições (linha/coluna)
+// dos nós são as mesmas da versão recursiva.
+//
+// Uma função (builtins.h) é um '(' que sabe onde começam os seus
+// argumentos na pilha de operandos: cada ',' reduz o argumento atual
+// e o ')' junta todos num NODE_CALL. Um elemento de array a(i) é o
+// mesmo esquema com um único argumento (EXPR_INDEX). Para não mudar
+// "? x (1)" (dois itens), só vale com o '(' colado no nome.
+//===================================================================
+
+// Níveis em ordem de precedência; EXPR_PAREN marca um '(' aberto
+typedef enum
+{
+    EXPR_PAREN,
+    EXPR_CALL,              // '(' de função: argumentos separados por ','
+    EXPR_INDEX,             // '(' de a(i): um único índice
+    EXPR_OR,
+    EXPR_AND,
+    EXPR_NOT,               // Prefixo: o operando é um comparison_expr
+    EXPR_COMPARISON,
+    EXPR_ADDITIVE,
+    EXPR_MULTIPLICATIVE,
+    EXPR_SIGN               // Prefixo '+'/'-' de factor
+} ExprLevel;
+
+typedef struct
+{
+    ExprLevel level;
+    int op;                 // '+', '-', '*', '/', '%', '\', LogicalOperator ou BuiltinId
+    int line;               // Token do operador (EXPR_CALL: nome da função)
+    int column;
+    const char* name;       // EXPR_CALL: nome da função; EXPR_INDEX: do array
+    size_t base;            // EXPR_CALL: operandos antes do primeiro argumento
+} PendingOperator;
+
+// Operador binário do token atual; 0 = não é operador binário
+static int binary_operator(TokenType type, ExprLevel* level, int* op)
+{
+    switch (type)
     {
-        LogicalOperator op;
-        int has_op = 0;
-        
-        // Captura posição do operador
-        int op_line = parser->current_token.line;
-        int op_column = parser->current_token.column;
-        
-        // Verifica cada operador relacional
-        switch (parser->current_token.type)
-        {
-            case TOKEN_EQUAL:
-                op = OP_EQUAL;
-                has_op = 1;
-                break;
-            case TOKEN_NOT_EQUAL:
-                op = OP_NOT_EQUAL;
-                has_op = 1;
-                break;
-            case TOKEN_LESS:
-                op = OP_LESS;
-                has_op = 1;
-                break;
-            case TOKEN_GREATER:
-                op = OP_GREATER;
-                has_op = 1;
-                break;
-            case TOKEN_LESS_EQUAL:
-                op = OP_LESS_EQUAL;
-                has_op = 1;
-                break;
-            case TOKEN_GREATER_EQUAL:
-                op = OP_GREATER_EQUAL;
-                has_op = 1;
-                break;
-            default:
-                has_op = 0;
-                break;
-        }
-        
-        if (!has_op)
-        {
-            // Não tem operador relacional, retorna o left
-            return left;
-        }
-        
-        // Consome o operador
-        parser_advance(parser);
-        
-        // Parseia o lado direito
-        ASTNode* right = parse_expression(parser);
-        if (parser->has_error || !right)
+        case TOKEN_OR:            *level = EXPR_OR;             *op = OP_OR;            return 1;
+        case TOKEN_AND:           *level = EXPR_AND;            *op = OP_AND;           return 1;
+        case TOKEN_EQUAL:         *level = EXPR_COMPARISON;     *op = OP_EQUAL;         return 1;
+        case TOKEN_NOT_EQUAL:     *level = EXPR_COMPARISON;     *op = OP_NOT_EQUAL;     return 1;
+        case TOKEN_LESS:          *level = EXPR_COMPARISON;     *op = OP_LESS;          return 1;
+        case TOKEN_GREATER:       *level = EXPR_COMPARISON;     *op = OP_GREATER;       return 1;
+        case TOKEN_LESS_EQUAL:    *level = EXPR_COMPARISON;     *op = OP_LESS_EQUAL;    return 1;
+        case TOKEN_GREATER_EQUAL: *level = EXPR_COMPARISON;     *op = OP_GREATER_EQUAL; return 1;
+        case TOKEN_PLUS:          *level = EXPR_ADDITIVE;       *op = '+';              return 1;
+        case TOKEN_MINUS:         *level = EXPR_ADDITIVE;       *op = '-';              return 1;
+        case TOKEN_STAR:          *level = EXPR_MULTIPLICATIVE; *op = '*';              return 1;
+        case TOKEN_SLASH:         *level = EXPR_MULTIPLICATIVE; *op = '/';              return 1;
+        case TOKEN_PERCENT:       *level = EXPR_MULTIPLICATIVE; *op = '%';              return 1;
+        case TOKEN_BACKSLASH:     *level = EXPR_MULTIPLICATIVE; *op = '\\';             return 1;
+        default:                  return 0;
+    }
+}
+
+// Desempilha o operador do topo e seus operandos, empilha o nó criado
+static void reduce_operator(Parser* parser, WorkStack* operators, WorkStack* operands)
+{
+    PendingOperator op = *WORK_STACK_TOP(operators, PendingOperator);
+    work_stack_pop(operators);
+
+    ASTNode* right = *WORK_STACK_TOP(operands, ASTNode*);
+    ASTNode* node;
+
+    switch (op.level)
+    {
+        case EXPR_SIGN:
+            if (op.op == '+') return;  // +x == x: nenhum nó
+            node = create_unary_op_node(parser->arena, '-', right, op.line, op.column);
+            break;
+
+        case EXPR_NOT:
+            node = create_logical_not_node(parser->arena, right, op.line, op.column);
+            break;
+
+        default:
         {
-            free_ast(left);
-            return NULL;
+            work_stack_pop(operands);
+            ASTNode* left = *WORK_STACK_TOP(operands, ASTNode*);
+
+            if (op.level == EXPR_OR || op.level == EXPR_AND)
+            {
+                // and/or: posição do token que encerrou o operando direito
+                node = create_logical_op_node(parser->arena, (LogicalOperator)op.op,
+                                              left, right,
+                                              parser->current_token.line,
+                                              parser->current_token.column);
+            }
+            else if (op.level == EXPR_COMPARISON)
+            {
+                node = create_comparison_op_node(parser->arena, (LogicalOperator)op.op,
+                                                 left, right, op.line, op.column);
+            }
+            else
+            {
+                node = create_binary_op_node(parser->arena, (char)op.op, left, right,
+                                             left->line, left->column);
+            }
+            break;
         }
-        
-        // Cria nó de comparação
-        left = create_comparison_op_node(op,
-                                      left, right,
-                                      op_line, op_column);
     }
+
+    *WORK_STACK_TOP(operands, ASTNode*) = node;
 }
 
-//===================================================================
-// expression := term (('+' | '-') term)*
-//===================================================================
-static ASTNode* parse_expression(Parser* parser) {
-    ASTNode* node = parse_term(parser);
-    if (parser->has_error || !node) return NULL;
-    
-    while (parser->current_token.type == TOKEN_PLUS ||
-           parser->current_token.type == TOKEN_MINUS)
+// Reduz enquanto o topo tiver nível >= 'level' (para em '(')
+static void reduce_operators(Parser* parser, WorkStack* operators, WorkStack* operands,
+                             ExprLevel level)
+{
+    while (!work_stack_empty(operators))
+    {
+        ExprLevel top = WORK_STACK_TOP(operators, PendingOperator)->level;
+        if (top == EXPR_PAREN || top == EXPR_CALL || top == EXPR_INDEX || top < level) break;
+        reduce_operator(parser, operators, operands);
+    }
+}
+
+static void push_operator(WorkStack* operators, ExprLevel level, int op, Token token)
+{
+    PendingOperator* pending = WORK_STACK_PUSH(operators, PendingOperator);
+    pending->level = level;
+    pending->op = op;
+    pending->line = token.line;
+    pending->column = token.column;
+}
+
+// "Parser error: mid() expects 2 or 3 arguments"
+static void report_call_arity(Parser* parser, const PendingOperator* call)
+{
+    const BuiltinInfo* info = builtin_info((BuiltinId)call->op);
+    char error_msg[BUFFER_SIZE];
+
+    if (info->min_args == info->max_args)
     {
-        char op;
-        if(parser->current_token.type == TOKEN_PLUS)
+        snprintf(error_msg, sizeof(error_msg), "Parser error: %s() expects %d argument%s",
+                 call->name, info->min_args, info->min_args == 1 ? "" : "s");
+    }
+    else
+    {
+        snprintf(error_msg, sizeof(error_msg), "Parser error: %s() expects %d or %d arguments",
+                 call->name, info->min_args, info->max_args);
+    }
+    parser_set_error(parser, error_msg);
+}
+
+// ')' de função: os argumentos do topo da pilha viram um NODE_CALL.
+// 0 = quantidade de argumentos errada (erro reportado)
+static int reduce_call(Parser* parser, WorkStack* operators, WorkStack* operands)
+{
+    PendingOperator call = *WORK_STACK_TOP(operators, PendingOperator);
+    const BuiltinInfo* info = builtin_info((BuiltinId)call.op);
+    int argc = (int)(operands->count - call.base);
+
+    if (argc < info->min_args || argc > info->max_args)
+    {
+        report_call_arity(parser, &call);
+        return 0;
+    }
+
+    ASTNode* args[CALL_MAX_ARGS];
+    for (int i = argc - 1; i >= 0; i--)
+    {
+        args[i] = *WORK_STACK_TOP(operands, ASTNode*);
+        work_stack_pop(operands);
+    }
+    work_stack_pop(operators);
+
+    *WORK_STACK_PUSH(operands, ASTNode*) =
+        create_call_node(parser->arena, call.name, call.op, args, argc, call.line, call.column);
+    return 1;
+}
+
+// Expressão cujo operador de menor precedência fora de parênteses é
+// 'lowest': EXPR_OR para logical_expr, EXPR_ADDITIVE para expression
+static ASTNode* parse_operator_expr(Parser* parser, ExprLevel lowest)
+{
+    WorkStack operators;
+    WorkStack operands;
+    work_stack_init(&operators, sizeof(PendingOperator));
+    work_stack_init(&operands, sizeof(ASTNode*));
+
+    int open_parens = 0;
+    ASTNode* result = NULL;
+
+    for (;;)
+    {
+        // Posição de operando: prefixos e '(' ficam pendentes
+        Token token = parser->current_token;
+        ExprLevel top = work_stack_empty(&operators)
+                      ? (lowest <= EXPR_OR ? EXPR_PAREN : lowest)
+                      : WORK_STACK_TOP(&operators, PendingOperator)->level;
+
+        if (token.type == TOKEN_NOT &&
+            (top == EXPR_PAREN || top == EXPR_CALL || top == EXPR_INDEX ||
+             top == EXPR_OR || top == EXPR_AND))
         {
-            op = '+';
+            push_operator(&operators, EXPR_NOT, OP_NOT, token);
+            parser_advance(parser);
+            continue;
         }
-        else
+        if ((token.type == TOKEN_PLUS || token.type == TOKEN_MINUS) && top != EXPR_SIGN)
         {
-            op = '-';
+            push_operator(&operators, EXPR_SIGN, token.type == TOKEN_PLUS ? '+' : '-', token);
+            parser_advance(parser);
+            continue;
         }
-        parser_advance(parser);
-
-        ASTNode* right = parse_term(parser);
-        if (parser->has_error || !right)
+        if (token.type == TOKEN_LPAREN)
         {
-            free_ast(node);
-            return NULL;
+            push_operator(&operators, EXPR_PAREN, 0, token);
+            open_parens++;
+            parser_advance(parser);
+            continue;
         }
-        
-        node = create_binary_op_node(op, node, right, node->line, node->column);
-    }
-    
-    return node;
-}
 
-//===================================================================
-// term := factor (('*' | '/') factor)*
-//===================================================================
-static ASTNode* parse_term(Parser* parser) {
-    ASTNode* node = parse_factor(parser);
-    if (parser->has_error || !node) return NULL;
-    
-    while (parser->current_token.type == TOKEN_STAR ||
-           parser->current_token.type == TOKEN_SLASH)
-    {
-        char op;
-        if(parser->current_token.type == TOKEN_STAR)
+        ASTNode* atom = parse_atom(parser);
+        if (!atom) break;  // Erro já reportado
+
+        // nome(...) de função: os argumentos vêm em posição de operando
+        int builtin;
+        if (atom->type == NODE_VARIABLE && parser_expect(parser, TOKEN_LPAREN) &&
+            (builtin = builtin_lookup(atom->data.variable.var_name)) >= 0)
         {
-            op = '*';
+            PendingOperator* call = WORK_STACK_PUSH(&operators, PendingOperator);
+            call->level = EXPR_CALL;
+            call->op = builtin;
+            call->line = atom->line;
+            call->column = atom->column;
+            call->name = atom->data.variable.var_name;
+            call->base = operands.count;
+            open_parens++;
+            parser_advance(parser);
+
+            if (parser_expect(parser, TOKEN_RPAREN))
+            {
+                report_call_arity(parser, call);
+                break;
+            }
+            continue;
         }
-        else
+        // a(i): o '(' colado no nome
+        if (atom->type == NODE_VARIABLE && parser_expect(parser, TOKEN_LPAREN) &&
+            parser->current_token.start == token.start + token.length)
         {
-            op = '/';
+            push_operator(&operators, EXPR_INDEX, 0, token);
+            WORK_STACK_TOP(&operators, PendingOperator)->name = atom->data.variable.var_name;
+            open_parens++;
+            parser_advance(parser);
+
+            if (parser_expect(parser, TOKEN_RPAREN))
+            {
+                parser_set_error(parser, "Parser error: array index expected");
+                break;
+            }
+            continue;
         }
-        parser_advance(parser);
+        *WORK_STACK_PUSH(&operands, ASTNode*) = atom;
 
-        ASTNode* right = parse_factor(parser);
-        if (parser->has_error || !right)
+        // Depois do operando: ')' fecham grupos; um operador binário
+        // volta para a posição de operando; qualquer outro token encerra
+        int next_operand = 0;
+        while (!next_operand)
         {
-            free_ast(node);
-            return NULL;
+            ExprLevel level;
+            int op;
+            TokenType type = parser->current_token.type;
+
+            if (binary_operator(type, &level, &op) && (open_parens > 0 || level >= lowest))
+            {
+                reduce_operators(parser, &operators, &operands, level);
+                push_operator(&operators, level, op, parser->current_token);
+                parser_advance(parser);
+                next_operand = 1;
+            }
+            else if (open_parens > 0 && parser_expect(parser, TOKEN_RPAREN))
+            {
+                reduce_operators(parser, &operators, &operands, EXPR_OR);
+                PendingOperator* group = WORK_STACK_TOP(&operators, PendingOperator);
+                if (group->level == EXPR_CALL)
+                {
+                    if (!reduce_call(parser, &operators, &operands)) break;
+                }
+                else if (group->level == EXPR_INDEX)
+                {
+                    ASTNode** index = WORK_STACK_TOP(&operands, ASTNode*);
+                    *index = create_array_node(parser->arena, NODE_INDEX, group->name, *index,
+                                               NULL, group->line, group->column);
+                    work_stack_pop(&operators);
+                }
+                else
+                {
+                    work_stack_pop(&operators);  // O '('
+                }
+                open_parens--;
+                parser_advance(parser);
+            }
+            else if (open_parens > 0 && parser_expect(parser, TOKEN_COMMA))
+            {
+                // Fim de um argumento: só vale dentro de função
+                reduce_operators(parser, &operators, &operands, EXPR_OR);
+                PendingOperator* call = WORK_STACK_TOP(&operators, PendingOperator);
+                if (call->level == EXPR_INDEX)
+                {
+                    parser_set_error(parser, "Parser error: array index expects 1 argument");
+                    break;
+                }
+                if (call->level != EXPR_CALL)
+                {
+                    parser_set_error(parser, "Parser error: Expected ')'");
+                    break;
+                }
+                const BuiltinInfo* info = builtin_info((BuiltinId)call->op);
+                if (operands.count - call->base >= info->max_args)
+                {
+                    report_call_arity(parser, call);
+                    break;
+                }
+                parser_advance(parser);
+                next_operand = 1;
+            }
+            else if (open_parens > 0)
+            {
+                parser_set_error(parser, "Parser error: Expected ')'");
+                break;
+            }
+            else
+            {
+                reduce_operators(parser, &operators, &operands, EXPR_PAREN);
+                result = *WORK_STACK_TOP(&operands, ASTNode*);
+                break;
+            }
         }
-        node = create_binary_op_node(op, node, right, node->line, node->column);
+        if (!next_operand) break;
     }
-    
-    return node;
+
+    work_stack_free(&operators);
+    work_stack_free(&operands);
+    return result;
 }
 
-//===================================================================
-// factor := ('+' | '-')? atom
-//===================================================================
-static ASTNode* parse_factor(Parser* parser)
+static ASTNode* parse_logical_expr(Parser* parser)
 {
-    char op = '+';
-    int line = parser->current_token.line;
-    int column = parser->current_token.column;
-    
-    // Only advance if it's + or -
-    if (parser->current_token.type == TOKEN_PLUS || 
-        parser->current_token.type == TOKEN_MINUS)
-    {
-        
-        if (parser->current_token.type == TOKEN_MINUS)
-        {
-            op = '-';
-        }
-        parser_advance(parser);
-    }
-    
-    ASTNode* operand = parse_atom(parser);
-    if (parser->has_error || !operand) return NULL;
-    
-    if (op == '+')
-    {
-        return operand;  
-    }
-    
-    return create_unary_op_node(op, operand, line, column);
+    return parse_operator_expr(parser, EXPR_OR);
+}
+
+static ASTNode* parse_expression(Parser* parser)
+{
+    return parse_operator_expr(parser, EXPR_ADDITIVE);
 }
 
 //===================================================================
@@ -1197,7 +1509,7 @@ static ASTNode* parse_factor(Parser* parser)
 //      | 'true' 
 //      | 'false' 
 //      | IDENTIFIER 
-//      | '(' logical_expr ')'
+// ('(' logical_expr ')' é tratado em parse_operator_expr)
 //===================================================================
 static ASTNode* parse_atom(Parser* parser)
 {
@@ -1207,38 +1519,34 @@ static ASTNode* parse_atom(Parser* parser)
     {
         case TOKEN_TRUE:
             parser_advance(parser);
-            return create_bool_node(1, token.line, token.column);
+            return create_bool_node(parser->arena, 1, token.line, token.column);
 
         case TOKEN_FALSE:
             parser_advance(parser);
-            return create_bool_node(0, token.line, token.column);
+            return create_bool_node(parser->arena, 0, token.line, token.column);
 
         case TOKEN_NUMBER:
             parser_advance(parser);
-            return create_number_node(token.value.number,token.line, token.column);
+            if (token.is_integer)
+            {
+                return create_integer_node(parser->arena, token.value.integer, token.line, token.column);
+            }
+            return create_number_node(parser->arena, token.value.number,token.line, token.column);
 
         case TOKEN_STRING:
+        {
+            size_t length;
+            const char* value = lexer_token_contents(parser->lexer, token, &length);
             parser_advance(parser);
-            return create_string_node(token.value.string,token.line, token.column);
+            return create_string_node(parser->arena, value, length, token.line, token.column);
+        }
             
         case TOKEN_IDENTIFIER:
-            parser_advance(parser);
-            return create_variable_node(token.value.varname, token.line, token.column);
-            
-        case TOKEN_LPAREN:
         {
-            parser_advance(parser);  // Consume '('
-            ASTNode* node = parse_logical_expr(parser);
-            if (parser->has_error) return NULL;
-            
-            if (!parser_expect(parser, TOKEN_RPAREN))
-            {
-                free_ast(node);
-                parser_set_error(parser, "Parser error: Expected ')'");
-                return NULL;
-            }
-            parser_advance(parser);  // Consume ')'
-            return node;
+            char var_name[VARNAME_SIZE];
+            lexer_token_text(parser->lexer, token, var_name, sizeof(var_name));
+            parser_advance(parser);
+            return create_variable_node(parser->arena, var_name, token.line, token.column);
         }
             
         default:            
@@ -1253,10 +1561,10 @@ static ASTNode* parse_atom(Parser* parser)
 //================================
 // MAIN PARSING FUNCTION
 //================================
-ASTNode* parse(Lexer* lexer)
+ASTNode* parse(Lexer* lexer, ASTArena* arena)
 {
     Parser parser;
-    parser_init(&parser, lexer);
+    parser_init(&parser, lexer, arena);
     
     if (parser.current_token.type == TOKEN_EOF) {
         return NULL;
@@ -1266,10 +1574,6 @@ ASTNode* parse(Lexer* lexer)
     
     if (parser.has_error)
     {
-        if (result != NULL)
-        {
-            free_ast(result);
-        }
         printf("%s\n", parser.error_message);
         return NULL;
     }
@@ -1282,11 +1586,8 @@ ASTNode* parse(Lexer* lexer)
     
     if (parser.current_token.type != TOKEN_EOF)
     {
-        if (result != NULL)
-        {
-            free_ast(result);
-        }
-        printf("%sParser error: incomplete expression.%s\n", COLOR_ERROR, COLOR_RESET);
+        printf("%sParser error: incomplete expression.%s\n",
+               output_ansi(COLOR_ERROR), output_ansi(COLOR_RESET));
         return NULL;
     }
     
@@ -1296,10 +1597,10 @@ ASTNode* parse(Lexer* lexer)
 //===================================================================
 // FOR TESTING V0.2.0
 //===================================================================
-ASTNode* parse_single_statement(Lexer* lexer)
+ASTNode* parse_single_statement(Lexer* lexer, ASTArena* arena)
 {
     Parser parser;
-    parser_init(&parser, lexer);
+    parser_init(&parser, lexer, arena);
     
     if (parser.current_token.type == TOKEN_EOF)
     {
@@ -1311,7 +1612,6 @@ ASTNode* parse_single_statement(Lexer* lexer)
     
     if (parser.has_error)
     {
-        if (result) free_ast(result);
         printf("%s\n", parser.error_message);
         return NULL;
     }
@@ -1369,19 +1669,21 @@ int main()
         Lexer lexer;
         lexer_init(&lexer, testes[i]);
         
-        ASTNode* ast = parse(&lexer);
+        ASTArena* arena = ast_arena_create();
+        ASTNode* ast = parse(&lexer, arena);
         
         if (ast)
         {
             printf("AST gerada:\n");
             print_ast(ast, 0);
-            free_ast(ast);
             printf("%sParsing OK%s\n", COLOR_SUCCESS, COLOR_RESET);
         }
         else
         {
             printf("%sERRO no parsing%s\n", COLOR_ERROR, COLOR_RESET);
         }
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
         
         printf("\n");
 
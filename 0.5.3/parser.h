@@ -17,16 +17,17 @@
 
 typedef struct Parser{
     Lexer* lexer;
+    ASTArena* arena;     // Dona de todos os nós criados por este parser
     Token current_token;
     int has_error;
     char error_message[BUFFER_SIZE];
+    int loop_depth;      // while abertos (break/continue só dentro deles)
 } Parser;
 
-ASTNode* parse(Lexer* lexer);
-void free_ast(ASTNode* node);
+ASTNode* parse(Lexer* lexer, ASTArena* arena);
 void print_ast(ASTNode* node, int indent);
 
-ASTNode* parse_single_statement(Lexer* lexer);
+ASTNode* parse_single_statement(Lexer* lexer, ASTArena* arena);
 
 #endif // PARSER_H
 // Fim de parser.h
\ No newline at end of file
@@ -0,0 +1,153 @@
+// resolver.c
+
+#include <stdio.h>
+
+#include "resolver.h"
+#include "work_stack.h"
+
+// Resolve só o próprio nó; 0 = sem slot
+static int resolve_slot(ASTNode* node, SymbolTable* symbols)
+{
+    switch (node->type)
+    {
+        case NODE_VARIABLE:
+            node->data.variable.slot =
+                symbol_table_resolve(symbols, node->data.variable.var_name);
+            return node->data.variable.slot >= 0;
+
+        case NODE_ASSIGNMENT:
+            node->data.assignment.slot =
+                symbol_table_resolve(symbols, node->data.assignment.var_name);
+            return node->data.assignment.slot >= 0;
+
+        case NODE_INPUT:
+            node->data.inputstatement.slot =
+                symbol_table_resolve(symbols, node->data.inputstatement.var_name);
+            return node->data.inputstatement.slot >= 0;
+
+        case NODE_DIM:
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGNMENT:
+            node->data.array.slot =
+                symbol_table_resolve(symbols, node->data.array.var_name);
+            return node->data.array.slot >= 0;
+
+        default:
+            return 1;  // Literais, operadores, cores, width, alinhamento, break...
+    }
+}
+
+// Empilha os filhos do nó em ordem inversa: o primeiro sai primeiro,
+// e os slots ficam na ordem em que os nomes aparecem no fonte
+static void push_children(WorkStack* pending, ASTNode* node)
+{
+    ASTNode* children[3] = { NULL, NULL, NULL };
+
+    switch (node->type)
+    {
+        case NODE_ASSIGNMENT:
+            children[0] = node->data.assignment.value;
+            break;
+
+        case NODE_BINARY_OP:
+            children[0] = node->data.binaryop.left;
+            children[1] = node->data.binaryop.right;
+            break;
+
+        case NODE_LOGICAL_OP:
+        case NODE_COMPARISON_OP:
+            children[0] = node->data.logicalop.left;
+            children[1] = node->data.logicalop.right;
+            break;
+
+        case NODE_UNARY_OP:
+            children[0] = node->data.unaryop.operand;
+            break;
+
+        case NODE_NOT_LOGICAL_OP:
+            children[0] = node->data.notop.operand;
+            break;
+
+        case NODE_STATEMENT_LIST:
+        {
+            StatementListData* list = &node->data.statementlist;
+            for (int i = list->count - 1; i >= 0; i--)
+            {
+                *WORK_STACK_PUSH(pending, ASTNode*) = list->statements[i];
+            }
+            return;
+        }
+
+        case NODE_PRINT:
+        {
+            PrintStatementData* print = &node->data.printstatement;
+            for (int i = print->count - 1; i >= 0; i--)
+            {
+                *WORK_STACK_PUSH(pending, ASTNode*) = print->items[i];
+            }
+            return;
+        }
+
+        case NODE_IF:
+            children[0] = node->data.ifstatement.condition;
+            children[1] = node->data.ifstatement.then_body;
+            children[2] = node->data.ifstatement.else_body;
+            break;
+
+        case NODE_WHILE:
+            children[0] = node->data.whilestatement.condition;
+            children[1] = node->data.whilestatement.body;
+            break;
+
+        case NODE_CALL:
+            for (int i = 0; i < node->data.call.argc; i++)
+            {
+                children[i] = node->data.call.args[i];
+            }
+            break;
+
+        case NODE_DIM:
+        case NODE_INDEX:
+        case NODE_INDEX_ASSIGNMENT:
+            children[0] = node->data.array.index;
+            children[1] = node->data.array.value;
+            break;
+
+        default:
+            return;
+    }
+
+    for (int i = 2; i >= 0; i--)
+    {
+        if (children[i]) *WORK_STACK_PUSH(pending, ASTNode*) = children[i];
+    }
+}
+
+// Percurso em pré-ordem com pilha explícita: a profundidade das
+// expressões não consome pilha do C
+static int resolve_node(ASTNode* node, SymbolTable* symbols)
+{
+    WorkStack pending;
+    work_stack_init(&pending, sizeof(ASTNode*));
+    *WORK_STACK_PUSH(&pending, ASTNode*) = node;
+
+    int success = 1;
+    while (success && !work_stack_empty(&pending))
+    {
+        ASTNode* current = *WORK_STACK_TOP(&pending, ASTNode*);
+        work_stack_pop(&pending);
+
+        success = resolve_slot(current, symbols);
+        if (success) push_children(&pending, current);
+    }
+
+    work_stack_free(&pending);
+    return success;
+}
+
+int resolve_program(ASTNode* ast, SymbolTable* symbols)
+{
+    if (!ast || !symbols) return 0;
+    return resolve_node(ast, symbols);
+}
+// Fim de resolver.c
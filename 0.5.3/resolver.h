@@ -0,0 +1,22 @@
+// resolver.h
+
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "ast.h"
+#include "symbol_table.h"
+
+/********************************************************************
+Liga cada NODE_VARIABLE, NODE_ASSIGNMENT e NODE_INPUT a um slot da
+SymbolTable (campo 'slot' do nó). Deve rodar depois de parse() e
+antes de evaluate_program() ou compile_program().
+
+Nomes ainda não atribuídos recebem um slot SYM_UNDEFINED; o erro
+"not declared" continua sendo dado na execução, como antes.
+
+Retorno: 1 = sucesso, 0 = nome de variável inválido
+********************************************************************/
+int resolve_program(ASTNode* ast, SymbolTable* symbols);
+
+#endif // RESOLVER_H
+// Fim de resolver.h
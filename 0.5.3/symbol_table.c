@@ -3,55 +3,189 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #include "zzdefs.h"
 #include "color.h"
 #include "symbol_table.h"
+#include "zzarray.h"
 #include "a89alloc.h"
+#include "number_format.h"
+#include "output.h"
 
-typedef enum
-{
-    SYM_NUMBER,
-    SYM_STRING,
-    SYM_BOOL
-} SymbolType;
+// ============================================
+// ESTRUTURA
+//
+// Símbolos ficam em blocos que nunca mudam de lugar: o bloco k tem
+// SYMBOL_CHUNK_BASE << k entradas, então 1M nomes cabem em ~15 blocos
+// e ponteiros para valores (handles) continuam válidos para sempre.
+//
+// O índice por nome é uma tabela hash com endereçamento aberto
+// (sondagem linear). Cada entrada guarda o hash do nome, de modo que
+// a comparação de strings só acontece quando os hashes coincidem e o
+// crescimento não precisa recalcular nenhum hash.
+// ============================================
 
-typedef struct Symbol
+#define SYMBOL_CHUNK_BASE 64
+#define SYMBOL_MAX_CHUNKS 32
+#define SYMBOL_INDEX_INITIAL 64   // Potência de 2
+
+typedef struct
 {
     char name[VARNAME_SIZE];
-    SymbolType type;
-    union
-    {
-        int bool_value;
-        double num_value;
-        char str_value[STRING_SIZE];
-    } value;
-    struct Symbol* next;
+    SymbolValue value;
 } Symbol;
 
+typedef struct
+{
+    uint32_t hash;
+    int slot;          // -1 = entrada vazia
+} IndexEntry;
+
 struct SymbolTable
 {
-    Symbol* head;
-    int count;
+    Symbol* chunks[SYMBOL_MAX_CHUNKS];
+    int chunk_count;
+    Symbol** slots;       // slot -> símbolo (vetor plano, acesso O(1))
+    int slot_count;       // Slots reservados (inclui os ainda sem valor)
+    int slot_capacity;
+    IndexEntry* index;
+    size_t index_capacity;
+    int count;            // Variáveis com valor (SYM_UNDEFINED não conta)
 };
 
 // ============================================
 // PRIVATE HELPER FUNCTIONS (static)
 // ============================================
 
-static Symbol* find_symbol(SymbolTable* table, const char* name)
+// FNV-1a 32 bits
+static uint32_t hash_name(const char* name)
+{
+    uint32_t hash = 2166136261u;
+    while (*name)
+    {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static IndexEntry* find_entry(SymbolTable* table, const char* name, uint32_t hash)
+{
+    size_t mask = table->index_capacity - 1;
+    size_t i = hash & mask;
+    
+    while (table->index[i].slot >= 0)
+    {
+        if (table->index[i].hash == hash &&
+            strcmp(table->slots[table->index[i].slot]->name, name) == 0)
+        {
+            return &table->index[i];
+        }
+        i = (i + 1) & mask;
+    }
+    return &table->index[i];  // Entrada vazia onde o nome entraria
+}
+
+static int find_slot(SymbolTable* table, const char* name)
+{
+    if (!table || !name) return -1;
+    return find_entry(table, name, hash_name(name))->slot;
+}
+
+static SymbolValue* find_symbol(SymbolTable* table, const char* name)
+{
+    int slot = find_slot(table, name);
+    if (slot < 0 || value_is_undefined(table->slots[slot]->value.value)) return NULL;
+    return &table->slots[slot]->value;
+}
+
+static IndexEntry* create_index(size_t capacity)
+{
+    IndexEntry* index = A89ALLOC(capacity * sizeof(IndexEntry));
+    for (size_t i = 0; i < capacity; i++)
+    {
+        index[i].slot = -1;
+    }
+    return index;
+}
+
+// Dobra o índice quando passa de 50% de ocupação (usa os hashes guardados)
+static void grow_index(SymbolTable* table)
 {
-    if (!table || !name) return NULL;
+    size_t new_capacity = table->index_capacity * 2;
+    IndexEntry* index = create_index(new_capacity);
     
-    Symbol* current = table->head;
-    while (current)
+    for (size_t i = 0; i < table->index_capacity; i++)
     {
-        if (strcmp(current->name, name) == 0) {
-            return current;
+        IndexEntry entry = table->index[i];
+        if (entry.slot < 0) continue;
+        
+        size_t j = entry.hash & (new_capacity - 1);
+        while (index[j].slot >= 0)
+        {
+            j = (j + 1) & (new_capacity - 1);
         }
-        current = current->next;
+        index[j] = entry;
     }
-    return NULL;
+    
+    a89free(table->index);
+    table->index = index;
+    table->index_capacity = new_capacity;
+}
+
+// Reserva espaço para mais um símbolo; devolve NULL se não há memória
+static Symbol* new_symbol(SymbolTable* table)
+{
+    int slot = table->slot_count;
+    
+    // Vetor plano de slots: a89alloc não tem realloc (aloca, copia, libera)
+    if (slot == table->slot_capacity)
+    {
+        int new_capacity = table->slot_capacity ? table->slot_capacity * 2 
+                                                : SYMBOL_CHUNK_BASE;
+        Symbol** slots = A89ALLOC(new_capacity * sizeof(Symbol*));
+        if (!slots) return NULL;
+        if (table->slot_count > 0)
+        {
+            memcpy(slots, table->slots, table->slot_count * sizeof(Symbol*));
+        }
+        a89free(table->slots);
+        table->slots = slots;
+        table->slot_capacity = new_capacity;
+    }
+    
+    // Posição dentro dos blocos: blocos 0..k-1 somam BASE * (2^k - 1)
+    int chunk = 0;
+    int first = 0;
+    while (slot >= first + (SYMBOL_CHUNK_BASE << chunk))
+    {
+        first += SYMBOL_CHUNK_BASE << chunk;
+        chunk++;
+    }
+    
+    if (chunk >= SYMBOL_MAX_CHUNKS) return NULL;
+    if (chunk == table->chunk_count)
+    {
+        table->chunks[chunk] = A89ALLOC((SYMBOL_CHUNK_BASE << chunk) * sizeof(Symbol));
+        if (!table->chunks[chunk]) return NULL;
+        table->chunk_count++;
+    }
+    
+    Symbol* symbol = &table->chunks[chunk][slot - first];
+    table->slots[slot] = symbol;
+    return symbol;
+}
+
+// Solta o que o slot retém: referência da string ou da caixa, ou o array inteiro
+static void release_value(Value value)
+{
+    if (value_is_array(value))
+    {
+        array_free(value_as_array(value));
+        return;
+    }
+    value_release(value);
 }
 
 // ============================================
@@ -61,8 +195,9 @@ static Symbol* find_symbol(SymbolTable* table, const char* name)
 SymbolTable* symbol_table_create(void)
 {
     SymbolTable* table = A89ALLOC(sizeof(SymbolTable));
-    table->head = NULL;
-    table->count = 0;
+    memset(table, 0, sizeof(SymbolTable));
+    table->index_capacity = SYMBOL_INDEX_INITIAL;
+    table->index = create_index(table->index_capacity);
     return table;
 }
 
@@ -70,14 +205,16 @@ void symbol_table_destroy(SymbolTable* table)
 {
     if (!table) return;
     
-    Symbol* current = table->head;
-    while (current)
+    for (int i = 0; i < table->slot_count; i++)
     {
-        Symbol* next = current->next;
-        a89free(current);
-        current = next;
+        release_value(table->slots[i]->value.value);
     }
-    
+    for (int i = 0; i < table->chunk_count; i++)
+    {
+        a89free(table->chunks[i]);
+    }
+    a89free(table->slots);
+    a89free(table->index);
     a89free(table);
 }
 
@@ -88,135 +225,176 @@ static int is_valid_name(const char* name)
     if (name_len == 0 || name_len >= VARNAME_SIZE)
     {
         fprintf(stderr, "%sError: invalid variable name: '%.*s...'%s\n", 
-                COLOR_ERROR, VARNAME_SIZE - 4, name, COLOR_RESET);
+                output_ansi(COLOR_ERROR), VARNAME_SIZE - 4, name, output_ansi(COLOR_RESET));
         return 0;
     }
     return 1;
 }
 
-int symbol_table_set_bool(SymbolTable* table, const char* name, int value)
+// ============================================
+// SLOTS
+// ============================================
+
+// Devolve o slot do nome, reservando um novo (SYM_UNDEFINED) se preciso
+int symbol_table_resolve(SymbolTable* table, const char* name)
 {
-    if (!table || !name || !is_valid_name(name)) return 0;
+    if (!table || !name || !is_valid_name(name)) return -1;
     
-    Symbol* symbol = find_symbol(table, name);
+    uint32_t hash = hash_name(name);
+    IndexEntry* entry = find_entry(table, name, hash);
+    if (entry->slot >= 0) return entry->slot;
     
+    Symbol* symbol = new_symbol(table);
     if (!symbol)
     {
-        // Create new symbol
-        symbol = A89ALLOC(sizeof(Symbol));
-        strncpy(symbol->name, name, VARNAME_SIZE - 1);
-        symbol->name[VARNAME_SIZE - 1] = '\0';
-        symbol->type = SYM_BOOL;
-        symbol->value.bool_value = value;
-        
-        // Insert at beginning
-        symbol->next = table->head;
-        table->head = symbol;
-        table->count++;
+        fprintf(stderr, "%sError: symbol table full, cannot create '%s'%s\n",
+                output_ansi(COLOR_ERROR), name, output_ansi(COLOR_RESET));
+        return -1;
     }
-    else
+    strcpy(symbol->name, name);
+    symbol->value.value = VALUE_UNDEFINED;
+    
+    entry->hash = hash;
+    entry->slot = table->slot_count++;
+    
+    if ((size_t)table->slot_count * 2 > table->index_capacity)
     {
-        // Update existing
-        if (symbol->type != SYM_BOOL)
-        {
-            fprintf(stderr, "%sError: variable '%s' is not a boolean%s\n",
-                    COLOR_ERROR, name, COLOR_RESET);
-            return 0;
-        }
-        symbol->value.bool_value = value;
+        grow_index(table);
     }
+    return table->slot_count - 1;
+}
+
+SymbolHandle symbol_table_lookup(SymbolTable* table, const char* name)
+{
+    SymbolHandle handle = { -1, SYM_UNDEFINED, NULL };
     
-    return 1;   
+    int slot = find_slot(table, name);
+    if (slot >= 0)
+    {
+        handle.slot = slot;
+        handle.value = &table->slots[slot]->value;
+        handle.type = symbol_type_of(handle.value->value);
+    }
+    return handle;
 }
 
-int symbol_table_set_number(SymbolTable* table, const char* name, double value)
+SymbolValue* symbol_table_slot(SymbolTable* table, int slot)
 {
-    if (!table || !name || !is_valid_name(name)) return 0;
+    if (!table || slot < 0 || slot >= table->slot_count) return NULL;
+    return &table->slots[slot]->value;
+}
+
+const char* symbol_table_slot_name(SymbolTable* table, int slot)
+{
+    if (!table || slot < 0 || slot >= table->slot_count) return "";
+    return table->slots[slot]->name;
+}
+
+SymbolType symbol_type_of(Value value)
+{
+    if (value_is_number(value)) return SYM_NUMBER;
+    if (value_is_string(value)) return SYM_STRING;
+    if (value_is_bool(value))   return SYM_BOOL;
+    if (value_is_array(value))  return SYM_ARRAY;
+    return SYM_UNDEFINED;
+}
+
+// Primeiro valor define o tipo; depois o tipo não muda
+int symbol_table_slot_set(SymbolTable* table, int slot, Value value)
+{
+    SymbolValue* symbol = symbol_table_slot(table, slot);
+    if (!symbol) return 0;
     
-    Symbol* symbol = find_symbol(table, name);
+    SymbolType type = symbol_type_of(value);
+    if (type == SYM_UNDEFINED || type == SYM_ARRAY) return 0;
     
-    if (!symbol)
+    if (value_is_undefined(symbol->value))
     {
-        // Create new symbol
-        symbol = A89ALLOC(sizeof(Symbol));
-        strncpy(symbol->name, name, VARNAME_SIZE - 1);
-        symbol->name[VARNAME_SIZE - 1] = '\0';
-        symbol->type = SYM_NUMBER;
-        symbol->value.num_value = value;
-        
-        // Insert at beginning
-        symbol->next = table->head;
-        table->head = symbol;
         table->count++;
     }
-    else
+    else if (symbol_type_of(symbol->value) != type)
     {
-        // Update existing
-        if (symbol->type != SYM_NUMBER)
-        {
-            fprintf(stderr, "%sError: variable '%s' is not a number%s\n",
-                    COLOR_ERROR, name, COLOR_RESET);
-            return 0;
-        }
-        symbol->value.num_value = value;
+        fprintf(stderr, "%sError: variable '%s' is not a %s%s\n",
+                output_ansi(COLOR_ERROR), table->slots[slot]->name, value_type_name(value), output_ansi(COLOR_RESET));
+        return 0;
     }
     
+    // Strings: a tabela retém a nova antes de soltar a antiga
+    // (let s = s não pode liberar a string no meio)
+    value_retain(value);
+    value_release(symbol->value);
+    symbol->value = value;
     return 1;
 }
 
-int symbol_table_set_string(SymbolTable* table, const char* name, const char* value)
+// Redimensionar é permitido (o array antigo é liberado); um escalar
+// não vira array. NULL desfaz o dim: o slot volta a não ter valor
+int symbol_table_slot_dim(SymbolTable* table, int slot, Array* array)
 {
-    if (!table || !name || !is_valid_name(name)) return 0;
-    
-    Symbol* symbol = find_symbol(table, name);
+    SymbolValue* symbol = symbol_table_slot(table, slot);
+    if (!symbol) return 0;
     
-    if (!symbol)
+    if (value_is_undefined(symbol->value))
     {
-        // Create new symbol
-        symbol = A89ALLOC(sizeof(Symbol));
-        strncpy(symbol->name, name, VARNAME_SIZE - 1);
-        symbol->name[VARNAME_SIZE - 1] = '\0';
-        symbol->type = SYM_STRING;
-        strncpy(symbol->value.str_value, value, STRING_SIZE - 1);
-        symbol->value.str_value[STRING_SIZE - 1] = '\0';
-        
-        // Insert at beginning
-        symbol->next = table->head;
-        table->head = symbol;
+        if (!array) return 1;
         table->count++;
     }
+    else if (!value_is_array(symbol->value))
+    {
+        return 0;  // Quem chama já conferiu e dá a mensagem
+    }
     else
     {
-        // Update existing
-        if (symbol->type != SYM_STRING)
-        {
-            fprintf(stderr, "%sError: variable '%s' is not a string%s\n",
-                    COLOR_ERROR, name, COLOR_RESET);
-            return 0;
-        }
-        strncpy(symbol->value.str_value, value, STRING_SIZE - 1);
-        symbol->value.str_value[STRING_SIZE - 1] = '\0';
+        array_free(value_as_array(symbol->value));
+        if (!array) table->count--;
     }
     
+    symbol->value = array ? value_array(array) : VALUE_UNDEFINED;
     return 1;
 }
 
+// ============================================
+// ACESSO POR NOME
+// ============================================
+
+int symbol_table_set_bool(SymbolTable* table, const char* name, int value)
+{
+    return symbol_table_slot_set(table, symbol_table_resolve(table, name), 
+                                 value_bool(value));
+}
+
+int symbol_table_set_number(SymbolTable* table, const char* name, double value)
+{
+    return symbol_table_slot_set(table, symbol_table_resolve(table, name), 
+                                 value_from_double(value));
+}
+
+int symbol_table_set_string(SymbolTable* table, const char* name, const char* value)
+{
+    // A tabela fica com a única referência
+    String* string = string_from_text(value);
+    int success = symbol_table_slot_set(table, symbol_table_resolve(table, name), 
+                                        value_string(string));
+    string_release(string);
+    return success;
+}
+
 int symbol_table_get_bool(SymbolTable* table, const char* name, int* out_value)
 {
     if (!table || !name || !out_value) return 0;
     
-    Symbol* symbol = find_symbol(table, name);
+    SymbolValue* symbol = find_symbol(table, name);
     if (!symbol)
     {
         return 0;  // Variable doesn't exist
     }
     
-    if (symbol->type != SYM_BOOL)
+    if (!value_is_bool(symbol->value))
     {
         return 0;  // It's not a boolean
     }
     
-    *out_value = symbol->value.bool_value;
+    *out_value = value_as_bool(symbol->value);
     return 1;    
 }
 
@@ -225,18 +403,18 @@ int symbol_table_get_number(SymbolTable* table, const char* name, double* out_va
 {
     if (!table || !name || !out_value) return 0;
     
-    Symbol* symbol = find_symbol(table, name);
+    SymbolValue* symbol = find_symbol(table, name);
     if (!symbol)
     {
         return 0;  // Variable doesn't exist
     }
     
-    if (symbol->type != SYM_NUMBER)
+    if (!value_is_number(symbol->value))
     {
         return 0;  // It's not a number
     }
     
-    *out_value = symbol->value.num_value;
+    *out_value = value_as_number(symbol->value);
     return 1;
 }
 
@@ -244,18 +422,18 @@ int symbol_table_get_string(SymbolTable* table, const char* name, char* out_valu
 {
     if (!table || !name || !out_value || max_len == 0) return 0;
     
-    Symbol* symbol = find_symbol(table, name);
+    SymbolValue* symbol = find_symbol(table, name);
     if (!symbol)
     {
         return 0;  // Variable doesn't exist
     }
     
-    if (symbol->type != SYM_STRING)
+    if (!value_is_string(symbol->value))
     {
         return 0;  // It's not a string
     }
     
-    strncpy(out_value, symbol->value.str_value, max_len - 1);
+    strncpy(out_value, value_as_string(symbol->value), max_len - 1);
     out_value[max_len - 1] = '\0';
     return 1;
 }
@@ -271,6 +449,11 @@ int symbol_table_count(SymbolTable* table)
     return table ? table->count : 0;
 }
 
+int symbol_table_slot_count(SymbolTable* table)
+{
+    return table ? table->slot_count : 0;
+}
+
 void symbol_table_print(SymbolTable* table)
 {
     if (!table)
@@ -282,26 +465,35 @@ void symbol_table_print(SymbolTable* table)
     printf("%s=== SYMBOL TABLE (%d variables) ===%s\n", 
             COLOR_HEADER, table->count, COLOR_RESET);
     
-    Symbol* current = table->head;
-    while (current)
+    for (int i = 0; i < table->slot_count; i++)
     {
-        printf("  %s: ", current->name);
+        Value current = table->slots[i]->value.value;
+        if (value_is_undefined(current)) continue;
+        
+        printf("  %s: ", table->slots[i]->name);
         
-        switch(current->type)
+        switch(symbol_type_of(current))
         {
             case SYM_BOOL:
-                printf("[BOOL] %s", current->value.bool_value ? "true" : "false");
+                printf("[BOOL] %s", value_as_bool(current) ? "true" : "false");
                 break;
             case SYM_NUMBER:
-                printf("[NUM] %.6g", current->value.num_value);
+            {
+                char number[NUMBER_FORMAT_SIZE];
+                value_format_number(current, number);
+                printf("[NUM] %s", number);
                 break;
+            }
             case SYM_STRING:
-                printf("[STR] \"%s\"", current->value.str_value);
+                printf("[STR] \"%s\"", value_as_string(current));
+                break;
+            case SYM_ARRAY:
+                printf("[ARRAY] %zu", value_as_array(current)->length);
+                break;
+            case SYM_UNDEFINED:
                 break;
-
         }
         printf("\n");
-        current = current->next;
     }
     
     if (table->count == 0)
@@ -353,4 +545,83 @@ int main() {
     a89check_leaks();
     return 0;
 }
-#endif
\ No newline at end of file
+#endif
+// ============================================
+// BENCHMARK
+// gcc -O2 -DBENCHSYMBOLTABLE symbol_table.c zzstring.c output.c number_format.c a89alloc.c utils.c -o bench_symbols
+// ============================================
+
+#ifdef BENCHSYMBOLTABLE
+#include <time.h>
+#include "utils.h"
+
+#define BENCH_NAME_SIZE 16
+
+static double elapsed_ms(clock_t start)
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void bench_symbol_table(int n)
+{
+    char* names = A89ALLOC((size_t)n * BENCH_NAME_SIZE);
+    for (int i = 0; i < n; i++)
+    {
+        snprintf(names + (size_t)i * BENCH_NAME_SIZE, BENCH_NAME_SIZE, "var%d", i);
+    }
+    
+    SymbolTable* table = symbol_table_create();
+    
+    // Inserção
+    clock_t start = clock();
+    for (int i = 0; i < n; i++)
+    {
+        symbol_table_set_number(table, names + (size_t)i * BENCH_NAME_SIZE, i);
+    }
+    double insert_ms = elapsed_ms(start);
+    
+    // Leitura por nome (uma busca por chamada)
+    double sum = 0;
+    start = clock();
+    for (int i = 0; i < n; i++)
+    {
+        SymbolHandle handle = symbol_table_lookup(table, names + (size_t)i * BENCH_NAME_SIZE);
+        if (handle.type == SYM_NUMBER)
+        {
+            sum += value_as_number(handle.value->value);
+        }
+    }
+    double lookup_ms = elapsed_ms(start);
+    
+    // Leitura pelo slot (caminho usado pelo evaluator e pela VM)
+    double slot_sum = 0;
+    start = clock();
+    for (int i = 0; i < n; i++)
+    {
+        slot_sum += value_as_number(symbol_table_slot(table, i)->value);
+    }
+    double slot_ms = elapsed_ms(start);
+    
+    int ok = (symbol_table_count(table) == n) && (sum == slot_sum);
+    printf("%8d names | insert %9.2f ms | lookup %9.2f ms | slot %7.2f ms | %s%s%s\n",
+           n, insert_ms, lookup_ms, slot_ms,
+           ok ? COLOR_SUCCESS : COLOR_ERROR, ok ? "OK" : "ERRO", COLOR_RESET);
+    
+    symbol_table_destroy(table);
+    a89free(names);
+}
+
+int main() {
+    setup_utf8();
+    printf("%s=== Benchmark Tabela de Símbolos ===%s\n\n",
+            COLOR_HEADER, COLOR_RESET);
+    
+    bench_symbol_table(10000);
+    bench_symbol_table(100000);
+    bench_symbol_table(1000000);
+    
+    a89check_leaks();
+    return 0;
+}
+#endif
+// Fim de symbol_table.c
@@ -5,9 +5,38 @@
 
 #include <stdlib.h>  // Para size_t
 
+#include "zzdefs.h"
+#include "value.h"
+
 // Tipo opaco (encapsulamento)
 typedef struct SymbolTable SymbolTable;
 
+typedef enum
+{
+    SYM_UNDEFINED,   // Slot reservado pelo resolver, ainda sem valor
+    SYM_NUMBER,
+    SYM_STRING,
+    SYM_BOOL,
+    SYM_ARRAY        // dim a(n): o slot é dono do Array (zzarray.h)
+} SymbolType;
+
+// Valor de uma variável (acessado diretamente pelo slot).
+// 'value' é VALUE_UNDEFINED até a primeira atribuição; uma string
+// guardada aqui tem uma referência retida pela tabela (sem cópia).
+typedef struct
+{
+    Value value;
+} SymbolValue;
+
+// Resultado de symbol_table_lookup(): uma única busca devolve o tipo
+// e o endereço do valor. O endereço é estável enquanto a tabela existir.
+typedef struct
+{
+    int slot;            // -1 = nome desconhecido
+    SymbolType type;     // Tipo no momento da busca (SYM_UNDEFINED se não existe)
+    SymbolValue* value;  // NULL se o nome é desconhecido
+} SymbolHandle;
+
 // Criação/destruição
 SymbolTable* symbol_table_create(void);
 void symbol_table_destroy(SymbolTable* table);
@@ -24,9 +53,23 @@ int symbol_table_get_number(SymbolTable* table, const char* name, double* out_va
 int symbol_table_set_string(SymbolTable* table, const char* name, const char* value);
 int symbol_table_get_string(SymbolTable* table, const char* name, char* out_value, size_t max_len);
 
+// Slots: cada nome recebe um índice fixo, atribuído pelo resolver
+// antes da execução. Em tempo de execução o acesso é direto por índice.
+int symbol_table_resolve(SymbolTable* table, const char* name);  // slot ou -1
+SymbolValue* symbol_table_slot(SymbolTable* table, int slot);     // NULL se inválido
+const char* symbol_table_slot_name(SymbolTable* table, int slot);
+int symbol_table_slot_set(SymbolTable* table, int slot, Value value);  // 0 = tipo diferente
+// dim: o slot passa a ser dono de 'array' e libera o anterior; NULL
+// volta o slot a SYM_UNDEFINED (dim que falhou não deixa o tamanho
+// antigo). 0 = a variável já tem valor de outro tipo (nada muda)
+int symbol_table_slot_dim(SymbolTable* table, int slot, Array* array);
+
 // Consultas
+SymbolType symbol_type_of(Value value);
+SymbolHandle symbol_table_lookup(SymbolTable* table, const char* name);
 int symbol_table_exists(SymbolTable* table, const char* name);  // 1=existe, 0=não existe
 int symbol_table_count(SymbolTable* table);  // número de variáveis
+int symbol_table_slot_count(SymbolTable* table);  // slots reservados (inclui sem valor)
 
 // Debug
 void symbol_table_print(SymbolTable* table);
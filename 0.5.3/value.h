@@ -0,0 +1,308 @@
+// value.h
+
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "zzstring.h"
+#include "number_format.h"
+#include "a89alloc.h"
+
+/********************************************************************
+VALOR NaN-BOXED (8 bytes)
+
+Todo valor do ZzBasic cabe em um uint64_t:
+
+* number: o próprio double. Um double só coincide com os padrões
+  abaixo se for um NaN "silencioso" com bits específicos, que as
+  operações aritméticas nunca produzem.
+
+* number inteiro (int64): QNAN | VALUE_INT_TAG | inteiro de 48 bits
+  em complemento de 2 (de -2^47 a 2^47 - 1). Fora dessa faixa o
+  inteiro vai para uma caixa no heap (IntBox, contagem de
+  referências): QNAN | VALUE_INT_TAG | VALUE_INT_BOX | ponteiro.
+  Literais inteiros e contas entre inteiros ficam aqui, sem ponto
+  flutuante, em toda a faixa do int64; só um resultado que estoura
+  int64 vira double. Para a linguagem inteiro e double são o mesmo
+  tipo number: value_is_number aceita ambos e value_as_number
+  converte. As contas estão em numeric.h.
+
+* boolean / undefined / error: QNAN com uma tag nos bits baixos.
+
+* string: SIGN_BIT | QNAN | ponteiro (48 bits) para uma String
+  (zzstring.h). O valor não conta referência: quem retém é a AST ou
+  o chunk (literais), a SymbolTable (variáveis) e o contexto de
+  execução (resultados de concatenação e das funções de string até o
+  fim do statement), que vivem mais que qualquer valor em uso.
+  value_retain/value_release são para quem passa a guardar o valor.
+  Inteiros em caixa seguem as mesmas regras, com um dono a mais: o
+  array que guarda o elemento (array_store, zzarray.h).
+
+* array: SIGN_BIT | QNAN | VALUE_INT_TAG | ponteiro para um Array
+  (zzarray.h). Só existe dentro do slot da variável (dim a(n)).
+
+VALUE_ERROR é só um marcador: a mensagem fica no contexto de execução
+(ver evaluator.h), nunca dentro do valor.
+********************************************************************/
+
+typedef uint64_t Value;
+
+typedef struct Array Array;   // zzarray.h
+
+#define VALUE_SIGN_BIT  ((uint64_t)0x8000000000000000)
+#define VALUE_QNAN      ((uint64_t)0x7ffc000000000000)
+
+// Inteiro: bit 49 (strings têm ponteiros de até 48 bits, sem ele).
+// Com SIGN_BIT, o mesmo bit marca um array. Dentro dos inteiros, o
+// bit 48 separa a caixa (ponteiro) do inteiro inline
+#define VALUE_INT_TAG   ((uint64_t)0x0002000000000000)
+#define VALUE_INT_BOX   ((uint64_t)0x0001000000000000)
+#define VALUE_INT_MASK  ((uint64_t)0x0000ffffffffffff)
+#define VALUE_INT_MIN   (-((int64_t)1 << 47))   // Faixa inline
+#define VALUE_INT_MAX   (((int64_t)1 << 47) - 1)
+
+#define VALUE_TAG_UNDEFINED 1
+#define VALUE_TAG_FALSE     2
+#define VALUE_TAG_TRUE      3
+#define VALUE_TAG_ERROR     4
+
+#define VALUE_UNDEFINED ((Value)(VALUE_QNAN | VALUE_TAG_UNDEFINED))
+#define VALUE_FALSE     ((Value)(VALUE_QNAN | VALUE_TAG_FALSE))
+#define VALUE_TRUE      ((Value)(VALUE_QNAN | VALUE_TAG_TRUE))
+#define VALUE_ERROR     ((Value)(VALUE_QNAN | VALUE_TAG_ERROR))
+
+// Inteiro fora da faixa inline. Imutável; a contagem segue as mesmas
+// regras das strings (só quem guarda o valor retém)
+typedef struct
+{
+    int64_t value;
+    uint32_t refcount;
+} IntBox;
+
+// =================================================
+// Construção
+// =================================================
+static inline Value value_number(double number)
+{
+    Value value;
+    memcpy(&value, &number, sizeof(double));
+    return value;
+}
+
+// Inteiro já conferido com value_int_fits
+static inline Value value_int(int64_t integer)
+{
+    return VALUE_QNAN | VALUE_INT_TAG | ((uint64_t)integer & VALUE_INT_MASK);
+}
+
+static inline int value_int_fits(int64_t integer)
+{
+    return integer >= VALUE_INT_MIN && integer <= VALUE_INT_MAX;
+}
+
+// Caixa nova com contagem 1: quem chama é dono da referência
+// (numeric_integer a entrega ao contexto; literais, à arena da AST)
+static inline Value value_box_int(int64_t integer)
+{
+    IntBox* box = A89ALLOC(sizeof(IntBox));
+    box->value = integer;
+    box->refcount = 1;
+    return VALUE_QNAN | VALUE_INT_TAG | VALUE_INT_BOX | (uint64_t)(uintptr_t)box;
+}
+
+// Inteiro pequeno (tamanhos, posições) sem dono para uma caixa; fora
+// da faixa inline, o double mais próximo
+static inline Value value_integer(int64_t integer)
+{
+    return value_int_fits(integer) ? value_int(integer) : value_number((double)integer);
+}
+
+// Double com valor inteiro que cabe vira inteiro (literais, input)
+static inline Value value_from_double(double number)
+{
+    if (number >= (double)VALUE_INT_MIN && number <= (double)VALUE_INT_MAX)
+    {
+        int64_t integer = (int64_t)number;
+        if ((double)integer == number) return value_int(integer);
+    }
+    return value_number(number);
+}
+
+static inline Value value_bool(int boolean)
+{
+    return boolean ? VALUE_TRUE : VALUE_FALSE;
+}
+
+static inline Value value_string(String* string)
+{
+    return VALUE_SIGN_BIT | VALUE_QNAN | (uint64_t)(uintptr_t)string;
+}
+
+static inline Value value_array(Array* array)
+{
+    return VALUE_SIGN_BIT | VALUE_QNAN | VALUE_INT_TAG | (uint64_t)(uintptr_t)array;
+}
+
+// =================================================
+// Teste de tipo
+// =================================================
+// Inteiro inline ou em caixa
+static inline int value_is_int(Value value)
+{
+    return (value & (VALUE_SIGN_BIT | VALUE_QNAN | VALUE_INT_TAG)) == (VALUE_QNAN | VALUE_INT_TAG);
+}
+
+static inline int value_is_boxed_int(Value value)
+{
+    return (value & (VALUE_SIGN_BIT | VALUE_QNAN | VALUE_INT_TAG | VALUE_INT_BOX)) ==
+           (VALUE_QNAN | VALUE_INT_TAG | VALUE_INT_BOX);
+}
+
+// Os dois inteiros inline, dado que os dois são number: entre
+// numbers, só inteiros têm QNAN e VALUE_INT_TAG ao mesmo tempo
+static inline int value_both_inline_int(Value a, Value b)
+{
+    return (a & b & (VALUE_QNAN | VALUE_INT_TAG)) == (VALUE_QNAN | VALUE_INT_TAG) &&
+           ((a | b) & VALUE_INT_BOX) == 0;
+}
+
+// Inteiro ou double
+static inline int value_is_number(Value value)
+{
+    return (value & VALUE_QNAN) != VALUE_QNAN || value_is_int(value);
+}
+
+static inline int value_is_bool(Value value)
+{
+    return (value | 1) == VALUE_TRUE;
+}
+
+static inline int value_is_string(Value value)
+{
+    return (value & (VALUE_SIGN_BIT | VALUE_QNAN | VALUE_INT_TAG)) == (VALUE_SIGN_BIT | VALUE_QNAN);
+}
+
+static inline int value_is_array(Value value)
+{
+    return (value & (VALUE_SIGN_BIT | VALUE_QNAN | VALUE_INT_TAG)) ==
+           (VALUE_SIGN_BIT | VALUE_QNAN | VALUE_INT_TAG);
+}
+
+static inline int value_is_error(Value value)
+{
+    return value == VALUE_ERROR;
+}
+
+static inline int value_is_undefined(Value value)
+{
+    return value == VALUE_UNDEFINED;
+}
+
+// =================================================
+// Extração
+// =================================================
+// Só para inteiro inline
+static inline int64_t value_inline_int(Value value)
+{
+    return (int64_t)(value << 16) >> 16;  // Estende o sinal do bit 47
+}
+
+static inline IntBox* value_as_int_box(Value value)
+{
+    return (IntBox*)(uintptr_t)(value & VALUE_INT_MASK);
+}
+
+static inline int64_t value_as_int(Value value)
+{
+    if (value & VALUE_INT_BOX) return value_as_int_box(value)->value;
+    return value_inline_int(value);
+}
+
+// Qualquer number como double (inteiros até 2^53 são exatos)
+static inline double value_as_number(Value value)
+{
+    if (value_is_int(value)) return (double)value_as_int(value);
+
+    double number;
+    memcpy(&number, &value, sizeof(double));
+    return number;
+}
+
+static inline int value_as_bool(Value value)
+{
+    return value == VALUE_TRUE;
+}
+
+static inline String* value_as_string_object(Value value)
+{
+    return (String*)(uintptr_t)(value & ~(VALUE_SIGN_BIT | VALUE_QNAN));
+}
+
+static inline Array* value_as_array(Value value)
+{
+    return (Array*)(uintptr_t)(value & ~(VALUE_SIGN_BIT | VALUE_QNAN | VALUE_INT_TAG));
+}
+
+// Texto terminado em '\0' (o tamanho está em value_string_length).
+// Uma view é copiada aqui; quem sabe usar o tamanho prefere
+// value_string_chars
+static inline const char* value_as_string(Value value)
+{
+    return string_cstr(value_as_string_object(value));
+}
+
+// Bytes da string, sem garantia de '\0' no fim (views)
+static inline const char* value_string_chars(Value value)
+{
+    return value_as_string_object(value)->chars;
+}
+
+static inline size_t value_string_length(Value value)
+{
+    return value_as_string_object(value)->length;
+}
+
+// =================================================
+// Referências (só strings e inteiros em caixa contam)
+// =================================================
+static inline void value_retain(Value value)
+{
+    if (value_is_string(value)) string_retain(value_as_string_object(value));
+    else if (value_is_boxed_int(value)) value_as_int_box(value)->refcount++;
+}
+
+static inline void value_release(Value value)
+{
+    if (value_is_string(value))
+    {
+        string_release(value_as_string_object(value));
+    }
+    else if (value_is_boxed_int(value))
+    {
+        IntBox* box = value_as_int_box(value);
+        if (--box->refcount == 0) a89free(box);
+    }
+}
+
+// Texto de um number (buffer >= NUMBER_FORMAT_SIZE); devolve o tamanho
+static inline size_t value_format_number(Value value, char* buffer)
+{
+    if (value_is_int(value)) return number_format_integer(value_as_int(value), buffer);
+    return number_format(value_as_number(value), buffer);
+}
+
+// Nome do tipo para mensagens de erro
+static inline const char* value_type_name(Value value)
+{
+    if (value_is_number(value)) return "number";
+    if (value_is_string(value)) return "string";
+    if (value_is_bool(value))   return "boolean";
+    if (value_is_array(value))  return "array";
+    if (value_is_error(value))  return "error";
+    return "undefined";
+}
+
+#endif // VALUE_H
+// Fim de value.h
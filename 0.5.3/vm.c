@@ -0,0 +1,692 @@
+// vm.c
+/********************************************************************
+VM DE PILHA
+
+Executa o bytecode gerado por compiler.c. O despacho usa "computed
+goto" (extensão do GCC/Clang: uma tabela de endereços de labels, um
+salto indireto por instrução) quando disponível, e um switch comum
+nos demais compiladores. Compile com -DVM_NO_COMPUTED_GOTO para
+forçar o switch.
+
+A saída (print, echo, cores, width/alinhamento, input) passa pelas
+mesmas funções auxiliares do evaluator para que os dois caminhos
+produzam exatamente o mesmo texto. A concatenação também: as strings
+novas ficam no ExecutionContext até a instrução que consome o valor
+da expressão (BC_SET_VAR, BC_PRINT_ITEM, BC_ECHO, BC_JUMP_IF_FALSE)
+ou um erro.
+********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdarg.h>
+
+#include "color.h"
+#include "zzdefs.h"
+#include "a89alloc.h"
+#include "color_mapping.h"
+#include "evaluator.h"
+#include "builtins.h"
+#include "vm.h"
+#include "output.h"
+#include "numeric.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(VM_NO_COMPUTED_GOTO)
+#define VM_COMPUTED_GOTO
+#endif
+
+typedef struct
+{
+    Chunk* chunk;
+    SymbolTable* symbols;
+    ExecutionContext* ctx;              // Interpretador: saída, cor e formato do print
+    Value* stack;
+    int status;
+} VM;
+
+// Imprime mensagem com a posição da instrução (mesmo formato do evaluator)
+static void vm_print_message(VM* vm, const uint8_t* instruction, const char* color,
+                             const char* format, va_list args)
+{
+    char message[BUFFER_SIZE];
+    vsnprintf(message, sizeof(message), format, args);
+
+    const LineInfo* info = chunk_find_line(vm->chunk,
+                                           (uint32_t)(instruction - vm->chunk->code));
+    output_flush(&vm->ctx->output);
+    printf("%s[%d:%d] %s%s\n", output_ansi(color),
+           info ? info->line : 0, info ? info->column : 0,
+           message, output_ansi(COLOR_RESET));
+}
+
+// Reporta o erro e devolve onde a execução continua: fim do statement
+// mais interno que contém a instrução
+static const uint8_t* vm_runtime_error(VM* vm, const uint8_t* instruction,
+                                       const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vm_print_message(vm, instruction, COLOR_ERROR, format, args);
+    va_end(args);
+
+    vm->status = 0;
+
+    uint32_t pc = (uint32_t)(instruction - vm->chunk->code);
+    const RecoveryRange* range = chunk_find_range(vm->chunk, pc);
+    if (range)
+    {
+        return vm->chunk->code + range->end;
+    }
+    return vm->chunk->code + vm->chunk->count - 1;  // BC_HALT
+}
+
+static void vm_warning(VM* vm, const uint8_t* instruction, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vm_print_message(vm, instruction, COLOR_WARNING, format, args);
+    va_end(args);
+}
+
+static int vm_store(VM* vm, int slot, Value value)
+{
+    if (!symbol_table_slot_set(vm->symbols, slot, value))
+    {
+        output_flush(&vm->ctx->output);
+        printf("Evaluator error: assigning %s to '%s'\n", value_type_name(value),
+               symbol_table_slot_name(vm->symbols, slot));
+        return 0;
+    }
+    return 1;
+}
+
+//===================================================================
+// LAÇO PRINCIPAL
+//===================================================================
+static int vm_execute(VM* vm)
+{
+    const uint8_t* code = vm->chunk->code;
+    const char* strings = vm->chunk->strings;
+    String** string_constants = vm->chunk->string_constants;
+    const Value* numbers = vm->chunk->numbers;
+    WorkStack* temps = &vm->ctx->temps;     // Caixas de inteiros (numeric.h)
+    const uint8_t* ip = code;
+    Value* sp = vm->stack;
+
+#define READ_U8()      (ip += 1, ip[-1])
+#define READ_U32()     (ip += 4, bytecode_read_u32(ip - 4))
+#define PUSH(v)        (*sp++ = (v))
+#define POP()          (*--sp)
+#define PEEK(n)        (sp[-1 - (n)])
+
+// Erro: 'size' é o tamanho da instrução já consumida (opcode + operandos)
+#define RUNTIME_ERROR(size, ...)                                  \
+    {                                                             \
+        ip = vm_runtime_error(vm, ip - (size), __VA_ARGS__);      \
+        sp = vm->stack;                                           \
+        evaluator_release_temps(vm->ctx);                         \
+        goto dispatch;                                            \
+    }
+
+// Soma de BC_ADD e BC_APPEND_VAR com a, b já lidos da pilha;
+// VALUE_ERROR = tipos que não combinam (ADD_TYPE_ERROR)
+#define ADD_VALUES(a, b)                                                          \
+    (value_is_number(a) && value_is_number(b)                                     \
+        ? numeric_add(temps, a, b)                                                \
+        : value_is_string(a) && value_is_string(b)                                \
+            ? evaluator_concat(vm->ctx, (a), (b))                                 \
+            : VALUE_ERROR)
+
+#define ADD_TYPE_ERROR(size, a, b)                                                \
+    {                                                                             \
+        if (value_is_string(a) || value_is_string(b))                             \
+            RUNTIME_ERROR(size, "Evaluator error: mathematical operation with string"); \
+        RUNTIME_ERROR(size, "Evaluator error: mathematical operation with boolean");    \
+    }
+
+#ifdef VM_COMPUTED_GOTO
+#define OPCODE_LABEL(name, operand_bytes) &&L_##name,
+    static const void* dispatch_table[] = { OPCODE_LIST(OPCODE_LABEL) };
+#undef OPCODE_LABEL
+#define VM_CASE(op)    L_##op
+#define VM_NEXT()      goto *dispatch_table[*ip++]
+#else
+#define VM_CASE(op)    case op
+#define VM_NEXT()      goto dispatch
+#endif
+
+// Queda intencional de um VM_CASE para o seguinte (-Wimplicit-fallthrough).
+// Com rótulos do goto computado não há o que anotar.
+#if !defined(VM_COMPUTED_GOTO) && defined(__has_attribute)
+#if __has_attribute(fallthrough)
+#define VM_FALLTHROUGH __attribute__((fallthrough))
+#endif
+#endif
+#ifndef VM_FALLTHROUGH
+#define VM_FALLTHROUGH ((void)0)
+#endif
+
+// 'operation' é uma função de numeric.h; VALUE_ERROR = divisão por zero
+#define ARITHMETIC_OP(operation)                                                  \
+    {                                                                             \
+        Value b = PEEK(0);                                                        \
+        Value a = PEEK(1);                                                        \
+        if (!value_is_number(a) || !value_is_number(b))                           \
+        {                                                                         \
+            if (value_is_string(a) || value_is_string(b))                         \
+                RUNTIME_ERROR(1, "Evaluator error: mathematical operation with string"); \
+            RUNTIME_ERROR(1, "Evaluator error: mathematical operation with boolean");    \
+        }                                                                         \
+        Value result = operation(temps, a, b);                                    \
+        if (value_is_error(result))                                               \
+            RUNTIME_ERROR(1, "Evaluator error: division by zero");                \
+        sp--;                                                                     \
+        sp[-1] = result;                                                          \
+        VM_NEXT();                                                                \
+    }
+
+// Operandos provados número por infer_program(): sem verificação de tipo
+#define NUMBER_OP(operation)                                                      \
+    {                                                                             \
+        Value result = operation(temps, PEEK(1), PEEK(0));                        \
+        if (value_is_error(result))                                               \
+            RUNTIME_ERROR(1, "Evaluator error: division by zero");                \
+        sp--;                                                                     \
+        sp[-1] = result;                                                          \
+        VM_NEXT();                                                                \
+    }
+
+#define COMPARISON_OP(number_test, bool_test, string_test)                        \
+    {                                                                             \
+        Value b = POP();                                                          \
+        Value a = PEEK(0);                                                        \
+        int result = 0;                                                           \
+        if (symbol_type_of(a) != symbol_type_of(b))                               \
+            RUNTIME_ERROR(1, "Evaluator error: type mismatch in comparison: "     \
+                             "cannot compare %s with %s",                         \
+                          value_type_name(a), value_type_name(b));                \
+        if (value_is_string(a))                                                   \
+        {                                                                         \
+            const String* left = value_as_string_object(a);                       \
+            const String* right = value_as_string_object(b);                      \
+            result = (string_test);                                               \
+        }                                                                         \
+        else if (value_is_number(a))                                              \
+        {                                                                         \
+            Value left = a;                                                       \
+            Value right = b;                                                      \
+            result = (number_test);                                               \
+        }                                                                         \
+        else                                                                      \
+        {                                                                         \
+            Value left = a;                                                       \
+            Value right = b;                                                      \
+            (void)left; (void)right;                                              \
+            bool_test;                                                            \
+        }                                                                         \
+        sp[-1] = value_bool(result);                                              \
+        VM_NEXT();                                                                \
+    }
+
+#define NUMBER_COMPARISON_OP(test)                                                \
+    {                                                                             \
+        Value right = POP();                                                      \
+        Value left = PEEK(0);                                                     \
+        sp[-1] = value_bool(test);                                                \
+        VM_NEXT();                                                                \
+    }
+
+#define BOOL_OPERATOR_ERROR                                                       \
+    RUNTIME_ERROR(1, "Evaluator error: operator not supported for boolean values")
+
+dispatch:
+#ifdef VM_COMPUTED_GOTO
+    goto *dispatch_table[*ip++];
+#else
+    switch (*ip++)
+#endif
+    {
+        VM_CASE(BC_HALT):
+            return vm->status;
+
+        VM_CASE(BC_NUMBER):
+            PUSH(numbers[READ_U32()]);
+            VM_NEXT();
+
+        VM_CASE(BC_STRING):
+            PUSH(value_string(string_constants[READ_U32()]));
+            VM_NEXT();
+
+        VM_CASE(BC_TRUE):
+            PUSH(VALUE_TRUE);
+            VM_NEXT();
+
+        VM_CASE(BC_FALSE):
+            PUSH(VALUE_FALSE);
+            VM_NEXT();
+
+        VM_CASE(BC_POP):
+            sp--;
+            VM_NEXT();
+
+        VM_CASE(BC_GET_VAR):
+        VM_CASE(BC_GET_VAR_NUM):
+        {
+            int number_context = (ip[-1] == BC_GET_VAR_NUM);
+            int slot = (int)READ_U32();
+            SymbolValue* symbol = symbol_table_slot(vm->symbols, slot);
+
+            if (!symbol || value_is_undefined(symbol->value))
+            {
+                const char* name = symbol_table_slot_name(vm->symbols, slot);
+                RUNTIME_ERROR(5, "Evaluator error: variable '%s' not declared. "
+                                 "Use 'let %s = value'", name, name);
+            }
+
+            // Strings apontam direto para o slot: nada escreve na tabela
+            // enquanto a expressão é avaliada
+            Value v = symbol->value;
+            if (!value_is_number(v) && (number_context || value_is_array(v)))
+            {
+                if (value_is_array(v))
+                {
+                    const char* name = symbol_table_slot_name(vm->symbols, slot);
+                    RUNTIME_ERROR(5, "Evaluator error: variable '%s' is an array, "
+                                     "use %s(index)", name, name);
+                }
+                if (value_is_string(v))
+                {
+                    RUNTIME_ERROR(5, "Evaluator error: variable '%s' is a string, "
+                                     "cannot be used in mathematical operation",
+                                  symbol_table_slot_name(vm->symbols, slot));
+                }
+                RUNTIME_ERROR(5, "Evaluator error: variable '%s' is a boolean, "
+                                 "cannot be used in mathematical operation",
+                              symbol_table_slot_name(vm->symbols, slot));
+            }
+            PUSH(v);
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_SET_VAR):
+        {
+            int slot = (int)READ_U32();
+            if (!vm_store(vm, slot, POP()))
+            {
+                vm->status = 0;
+            }
+            evaluator_release_temps(vm->ctx);
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_APPEND_VAR):
+        {
+            int slot = (int)READ_U32();
+            Value b = PEEK(0);
+            Value a = PEEK(1);
+            // A variável é a única dona: x vai direto para o bloco dela
+            if (!evaluator_append_in_place(vm->ctx, slot, b))
+            {
+                Value sum = ADD_VALUES(a, b);
+                if (value_is_error(sum)) ADD_TYPE_ERROR(5, a, b)
+                if (!vm_store(vm, slot, sum))
+                {
+                    vm->status = 0;
+                }
+            }
+            sp -= 2;
+            evaluator_release_temps(vm->ctx);
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_ADD):
+        {
+            Value b = PEEK(0);
+            Value a = PEEK(1);
+            Value sum = ADD_VALUES(a, b);
+            if (value_is_error(sum)) ADD_TYPE_ERROR(1, a, b)
+            sp--;
+            sp[-1] = sum;
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_CALL):
+        {
+            BuiltinId id = (BuiltinId)READ_U8();
+            int argc = READ_U8();
+            Value result = builtin_call(vm->ctx, id, sp - argc, argc);
+            if (value_is_error(result))
+            {
+                vm->ctx->error.has_error = 0;  // Reportado aqui, com a posição
+                RUNTIME_ERROR(3, "%s", vm->ctx->error.message);
+            }
+            sp -= argc;
+            PUSH(result);
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_DIM):
+        {
+            int slot = (int)READ_U32();
+            if (!evaluator_dim(vm->ctx, slot, POP()))
+            {
+                vm->ctx->error.has_error = 0;
+                RUNTIME_ERROR(5, "%s", vm->ctx->error.message);
+            }
+            evaluator_release_temps(vm->ctx);
+            VM_NEXT();
+        }
+
+        // Índice provado entre 1 e o tamanho: load direto. Sem array no
+        // slot (ou índice double) segue o caminho verificado, que reporta
+        // o array sem dim ou o índice não inteiro / fora dos limites
+        VM_CASE(BC_GET_INDEX_FAST):
+        {
+            Value* item = evaluator_array_item(symbol_table_slot(vm->symbols,
+                                               (int)bytecode_read_u32(ip)), sp[-1]);
+            if (item)
+            {
+                ip += 4;
+                sp[-1] = *item;
+                VM_NEXT();
+            }
+            VM_FALLTHROUGH;
+        }
+        VM_CASE(BC_GET_INDEX):
+        {
+            Value element = evaluator_array_get(vm->ctx, (int)READ_U32(), sp[-1]);
+            if (value_is_error(element))
+            {
+                vm->ctx->error.has_error = 0;
+                RUNTIME_ERROR(5, "%s", vm->ctx->error.message);
+            }
+            sp[-1] = element;
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_SET_INDEX_FAST):
+        {
+            Value* item = evaluator_array_item(symbol_table_slot(vm->symbols,
+                                               (int)bytecode_read_u32(ip)), sp[-2]);
+            if (item && value_is_number(sp[-1]))
+            {
+                ip += 4;
+                array_store(item, sp[-1]);
+                sp -= 2;
+                evaluator_release_temps(vm->ctx);
+                VM_NEXT();
+            }
+            VM_FALLTHROUGH;
+        }
+        VM_CASE(BC_SET_INDEX):
+        {
+            int slot = (int)READ_U32();
+            if (!evaluator_array_set(vm->ctx, slot, sp[-2], sp[-1]))
+            {
+                vm->ctx->error.has_error = 0;
+                RUNTIME_ERROR(5, "%s", vm->ctx->error.message);
+            }
+            sp -= 2;
+            evaluator_release_temps(vm->ctx);
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_SUB):       ARITHMETIC_OP(numeric_subtract)
+        VM_CASE(BC_MUL):       ARITHMETIC_OP(numeric_multiply)
+        VM_CASE(BC_DIV):       ARITHMETIC_OP(numeric_divide)
+        VM_CASE(BC_QUOTIENT):  ARITHMETIC_OP(numeric_quotient)
+        VM_CASE(BC_REMAINDER): ARITHMETIC_OP(numeric_remainder)
+
+        VM_CASE(BC_NEGATE):
+        {
+            Value v = sp[-1];
+            if (value_is_string(v))
+                RUNTIME_ERROR(1, "Evaluator error: unary operator '-' applied to string");
+            if (value_is_bool(v))
+                RUNTIME_ERROR(1, "Evaluator error: mathematical operation with boolean");
+            sp[-1] = numeric_negate(temps, v);
+            VM_NEXT();
+        }
+
+        // Operandos provados número por infer_program(): sem verificação
+        VM_CASE(BC_ADD_NUM):
+            sp--;
+            sp[-1] = numeric_add(temps, sp[-1], sp[0]);
+            VM_NEXT();
+
+        VM_CASE(BC_SUB_NUM):
+            sp--;
+            sp[-1] = numeric_subtract(temps, sp[-1], sp[0]);
+            VM_NEXT();
+
+        VM_CASE(BC_MUL_NUM):
+            sp--;
+            sp[-1] = numeric_multiply(temps, sp[-1], sp[0]);
+            VM_NEXT();
+
+        VM_CASE(BC_DIV_NUM):       NUMBER_OP(numeric_divide)
+        VM_CASE(BC_QUOTIENT_NUM):  NUMBER_OP(numeric_quotient)
+        VM_CASE(BC_REMAINDER_NUM): NUMBER_OP(numeric_remainder)
+
+        VM_CASE(BC_NEGATE_NUM):
+            sp[-1] = numeric_negate(temps, sp[-1]);
+            VM_NEXT();
+
+        VM_CASE(BC_EQUAL):
+            COMPARISON_OP(numeric_equal(left, right),
+                          result = (left == right),
+                          string_equal(left, right))
+        VM_CASE(BC_NOT_EQUAL):
+            COMPARISON_OP(!numeric_equal(left, right),
+                          result = (left != right),
+                          !string_equal(left, right))
+        VM_CASE(BC_LESS):
+            COMPARISON_OP(numeric_less(left, right), BOOL_OPERATOR_ERROR,
+                          string_compare(left, right) < 0)
+        VM_CASE(BC_GREATER):
+            COMPARISON_OP(numeric_less(right, left), BOOL_OPERATOR_ERROR,
+                          string_compare(left, right) > 0)
+        VM_CASE(BC_LESS_EQUAL):
+            COMPARISON_OP(numeric_less_equal(left, right), BOOL_OPERATOR_ERROR,
+                          string_compare(left, right) <= 0)
+        VM_CASE(BC_GREATER_EQUAL):
+            COMPARISON_OP(numeric_less_equal(right, left), BOOL_OPERATOR_ERROR,
+                          string_compare(left, right) >= 0)
+
+        VM_CASE(BC_EQUAL_NUM):
+            NUMBER_COMPARISON_OP(numeric_equal(left, right))
+        VM_CASE(BC_NOT_EQUAL_NUM):
+            NUMBER_COMPARISON_OP(!numeric_equal(left, right))
+        VM_CASE(BC_LESS_NUM):
+            NUMBER_COMPARISON_OP(numeric_less(left, right))
+        VM_CASE(BC_GREATER_NUM):
+            NUMBER_COMPARISON_OP(numeric_less(right, left))
+        VM_CASE(BC_LESS_EQUAL_NUM):
+            NUMBER_COMPARISON_OP(numeric_less_equal(left, right))
+        VM_CASE(BC_GREATER_EQUAL_NUM):
+            NUMBER_COMPARISON_OP(numeric_less_equal(right, left))
+
+        VM_CASE(BC_NOT):
+        {
+            Value v = sp[-1];
+            if (!value_is_bool(v))
+            {
+                RUNTIME_ERROR(1, "Evaluator error: NOT operator expects boolean, got %s",
+                              value_type_name(v));
+            }
+            sp[-1] = value_bool(!value_as_bool(v));
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_AND):
+        VM_CASE(BC_OR):
+        {
+            int is_and = (ip[-1] == BC_AND);
+            uint32_t target = READ_U32();
+            Value v = PEEK(0);
+            if (!value_is_bool(v))
+            {
+                RUNTIME_ERROR(5, "Evaluator error: logical operator expects boolean, got %s",
+                              value_type_name(v));
+            }
+            // Curto-circuito: mantém o valor na pilha como resultado
+            if (is_and ? !value_as_bool(v) : value_as_bool(v))
+            {
+                ip = code + target;
+            }
+            else
+            {
+                sp--;
+            }
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_CHECK_BOOL):
+        {
+            Value v = PEEK(0);
+            if (!value_is_bool(v))
+            {
+                RUNTIME_ERROR(1, "Evaluator error: logical operator expects boolean, got %s",
+                              value_type_name(v));
+            }
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_JUMP):
+            ip = code + bytecode_read_u32(ip);
+            VM_NEXT();
+
+        VM_CASE(BC_JUMP_IF_FALSE):
+        {
+            uint32_t target = READ_U32();
+            Value v = POP();
+            evaluator_release_temps(vm->ctx);
+            if (!value_is_bool(v))
+            {
+                RUNTIME_ERROR(5, "Evaluator error: condition must be boolean, got %s",
+                              value_type_name(v));
+            }
+            if (!value_as_bool(v))
+            {
+                ip = code + target;
+            }
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_ECHO):
+        {
+            int string_literal = READ_U8();
+            evaluator_echo_value(vm->ctx, POP(), string_literal);
+            evaluator_release_temps(vm->ctx);
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_PRINT_BEGIN):
+            evaluator_print_begin(vm->ctx);
+            VM_NEXT();
+
+        VM_CASE(BC_PRINT_ITEM):
+        {
+            int space = READ_U8();
+            evaluator_print_value(vm->ctx, POP());
+            evaluator_release_temps(vm->ctx);
+            if (space)
+            {
+                output_char(&vm->ctx->output, ' ');
+            }
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_PRINT_COLOR):
+            evaluator_color_set(vm->ctx, (ColorCode)READ_U8());
+            VM_NEXT();
+
+        VM_CASE(BC_PRINT_WIDTH):
+            evaluator_set_width(vm->ctx, (int)READ_U32());
+            VM_NEXT();
+
+        VM_CASE(BC_PRINT_ALIGN):
+            evaluator_set_alignment(vm->ctx, (TokenType)READ_U8());
+            VM_NEXT();
+
+        VM_CASE(BC_PRINT_EMPTY):
+        VM_CASE(BC_NEWLINE):
+            output_newline(&vm->ctx->output);
+            VM_NEXT();
+
+        VM_CASE(BC_NOCOLOR):
+            evaluator_color_reset(vm->ctx);
+            VM_NEXT();
+
+        VM_CASE(BC_INPUT):
+        {
+            int slot = (int)READ_U32();
+            const char* prompt = strings + READ_U32();
+            if (!evaluator_assign_input(vm->ctx, slot, prompt))
+            {
+                vm->status = 0;
+            }
+            VM_NEXT();
+        }
+
+        VM_CASE(BC_ERROR):
+        {
+            const char* message = strings + READ_U32();
+            RUNTIME_ERROR(5, "%s", message);
+        }
+
+        VM_CASE(BC_WARNING):
+        {
+            const char* message = strings + READ_U32();
+            vm_warning(vm, ip - 5, "%s", message);
+            VM_NEXT();
+        }
+
+#ifndef VM_COMPUTED_GOTO
+        default:
+            output_flush(&vm->ctx->output);
+            printf("VM error: invalid opcode %d\n", ip[-1]);
+            return 0;
+#endif
+    }
+
+#ifndef VM_COMPUTED_GOTO
+    return vm->status;
+#endif
+
+#undef READ_U8
+#undef READ_U32
+#undef PUSH
+#undef POP
+#undef PEEK
+#undef RUNTIME_ERROR
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_FALLTHROUGH
+#undef ARITHMETIC_OP
+#undef ADD_VALUES
+#undef ADD_TYPE_ERROR
+#undef COMPARISON_OP
+#undef NUMBER_COMPARISON_OP
+#undef BOOL_OPERATOR_ERROR
+}
+
+int vm_run(Chunk* chunk, ExecutionContext* ctx)
+{
+    if (!chunk || !chunk->code || !ctx) return 0;
+
+    VM vm;
+    vm.chunk = chunk;
+    vm.symbols = ctx->symbols;
+    vm.ctx = ctx;
+    vm.status = 1;
+
+    size_t slots = (size_t)chunk->max_stack + 1;
+    vm.stack = A89ALLOC(slots * sizeof(Value));
+
+    int result = vm_execute(&vm);
+
+    a89free(vm.stack);
+    return result;
+}
+// Fim de vm.c
@@ -0,0 +1,21 @@
+// vm.h
+
+#ifndef VM_H
+#define VM_H
+
+#include "bytecode.h"
+#include "evaluator.h" // ExecutionContext: variáveis, saída e cor do interpretador
+#include "value.h"   // Valor na pilha da VM (NaN-boxed, 8 bytes)
+
+/********************************************************************
+Executa um chunk gerado por compile_program().
+
+As variáveis ficam nos slots da SymbolTable do contexto, de modo que
+o REPL pode compilar e executar linha a linha mantendo o estado.
+
+Retorno: 1 = todos os statements executaram sem erro, 0 = houve erro
+********************************************************************/
+int vm_run(Chunk* chunk, ExecutionContext* ctx);
+
+#endif // VM_H
+// Fim de vm.h
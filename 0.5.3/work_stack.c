@@ -0,0 +1,45 @@
+// work_stack.c
+
+#include <string.h>
+
+#include "work_stack.h"
+#include "a89alloc.h"
+
+void work_stack_init(WorkStack* stack, size_t item_size)
+{
+    stack->data = stack->inline_data;
+    stack->item_size = item_size;
+    stack->count = 0;
+    stack->capacity = WORK_STACK_INLINE_BYTES / item_size;
+}
+
+void work_stack_free(WorkStack* stack)
+{
+    if (stack->data != stack->inline_data)
+    {
+        a89free(stack->data);
+    }
+    stack->data = stack->inline_data;
+    stack->count = 0;
+    stack->capacity = WORK_STACK_INLINE_BYTES / stack->item_size;
+}
+
+void* work_stack_push(WorkStack* stack)
+{
+    if (stack->count == stack->capacity)
+    {
+        // Cheio: dobra, saindo do buffer interno na primeira vez
+        size_t capacity = stack->capacity ? stack->capacity * 2 : 16;
+        unsigned char* data = A89ALLOC(capacity * stack->item_size);
+        memcpy(data, stack->data, stack->count * stack->item_size);
+        if (stack->data != stack->inline_data)
+        {
+            a89free(stack->data);
+        }
+        stack->data = data;
+        stack->capacity = capacity;
+    }
+    return stack->data + stack->count++ * stack->item_size;
+}
+
+// Fim de work_stack.c
@@ -0,0 +1,61 @@
+// work_stack.h
+
+#ifndef WORK_STACK_H
+#define WORK_STACK_H
+
+#include <stddef.h>
+
+/********************************************************************
+PILHA DE TRABALHO
+
+Substitui a pilha do C nos percursos da AST que não podem recursar
+(expressões aninhadas milhares de níveis: parser, resolver, optimizer,
+inferência, compilador e o evaluator a partir de certa profundidade).
+
+Os itens têm tamanho fixo, escolhido em work_stack_init(). Os
+primeiros bytes ficam dentro da própria estrutura (que normalmente
+está na pilha do C); só expressões profundas chegam ao heap, que
+cresce dobrando. O limite é a memória, não a pilha do processo.
+
+Os ponteiros devolvidos por push/top valem até o próximo push.
+A estrutura não pode ser copiada depois de usada ('data' pode apontar
+para o próprio inline_data).
+********************************************************************/
+
+#define WORK_STACK_INLINE_BYTES 512
+
+typedef struct
+{
+    unsigned char* data;        // inline_data ou bloco A89ALLOC
+    size_t item_size;
+    size_t count;
+    size_t capacity;            // Em itens
+    unsigned char inline_data[WORK_STACK_INLINE_BYTES];
+} WorkStack;
+
+void work_stack_init(WorkStack* stack, size_t item_size);
+void work_stack_free(WorkStack* stack);     // Libera o bloco do heap, se houver
+
+void* work_stack_push(WorkStack* stack);    // Espaço para um item novo no topo
+
+static inline void* work_stack_top(WorkStack* stack)
+{
+    return stack->data + (stack->count - 1) * stack->item_size;
+}
+
+static inline void work_stack_pop(WorkStack* stack)
+{
+    stack->count--;
+}
+
+static inline int work_stack_empty(const WorkStack* stack)
+{
+    return stack->count == 0;
+}
+
+// Acesso tipado: WORK_STACK_TOP(&frames, EvalFrame)->state
+#define WORK_STACK_PUSH(stack, type) ((type*)work_stack_push(stack))
+#define WORK_STACK_TOP(stack, type)  ((type*)work_stack_top(stack))
+
+#endif // WORK_STACK_H
+// Fim de work_stack.h
@@ -0,0 +1,71 @@
+// zzarray.h
+
+#ifndef ZZARRAY_H
+#define ZZARRAY_H
+
+#include <stddef.h>
+
+#include "a89alloc.h"
+#include "value.h"
+
+/********************************************************************
+ARRAYS NUMÉRICOS (dim a(n))
+
+Cabeçalho e elementos num único bloco contíguo: a(i) é items[i - 1],
+um load direto, sem indireção por elemento. Cada elemento é um Value
+number (inteiro ou double, value.h) de 8 bytes, e dim zera todos com
+o inteiro 0. Um inteiro em caixa é retido pelo array enquanto estiver
+no elemento (array_store) e solto no free, que percorre os elementos
+como o dim já tinha percorrido.
+
+O array pertence à variável: a SymbolTable guarda value_array(array)
+no slot e libera o bloco quando o slot é redimensionado ou a tabela
+destruída (symbol_table_slot_dim). O Value do array nunca sai do
+slot: ler a variável 'a' sem índice é erro, então ninguém mais retém
+o ponteiro e não há contagem de referências.
+
+Índices começam em 1, como em mid, field e instr.
+********************************************************************/
+
+#define ARRAY_MAX_LENGTH 100000000   // 800 MB de elementos
+
+struct Array
+{
+    size_t length;          // Elementos válidos: a(1) .. a(length)
+    Value items[];
+};
+
+// Array com 'length' zeros (length <= ARRAY_MAX_LENGTH)
+static inline Array* array_create(size_t length)
+{
+    Array* array = A89ALLOC(sizeof(Array) + (length ? length : 1) * sizeof(Value));
+    array->length = length;
+    for (size_t i = 0; i < length; i++)
+    {
+        array->items[i] = value_int(0);
+    }
+    return array;
+}
+
+// Grava um number no elemento (retém a caixa nova, solta a antiga)
+static inline void array_store(Value* item, Value value)
+{
+    if (value_is_boxed_int(value) || value_is_boxed_int(*item))
+    {
+        value_retain(value);
+        value_release(*item);
+    }
+    *item = value;
+}
+
+static inline void array_free(Array* array)
+{
+    for (size_t i = 0; i < array->length; i++)
+    {
+        value_release(array->items[i]);
+    }
+    a89free(array);
+}
+
+#endif // ZZARRAY_H
+// Fim de zzarray.h
@@ -1,8 +1,15 @@
 // zzbasic.c
 
+#define _POSIX_C_SOURCE 200809L  // fileno, fstat e mmap também com -std=c11
+
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include <ctype.h>
 
 #include "help.h"  
@@ -13,6 +20,13 @@
 #include "ast.h"
 #include "parser.h"
 #include "evaluator.h"
+#include "optimizer.h"
+#include "resolver.h"
+#include "inference.h"
+#include "compiler.h"
+#include "vm.h"
+#include "output.h"
+#include "work_stack.h"
 
 
 // ============================================
@@ -52,17 +66,30 @@ int is_empty_line(const char *line)
 
 
 //===================================================================
-// Reads entire source file and returns as string
+// Carrega o arquivo fonte para o lexer, com uma única abertura
+//
+// Arquivos grandes são mapeados somente leitura (mmap) e entregues
+// ao lexer sem cópia; "\r\n" é tratado pelo próprio lexer. Arquivos
+// pequenos são lidos de uma vez num buffer A89ALLOC.
 //
-// CALLER IS RESPONSIBLE FOR FREEING THE ALLOCATED MEMORY
+// O lexer precisa de '\0' depois do último byte. O mmap só garante
+// isso quando o tamanho não é múltiplo da página (o resto da última
+// página vem zerado); nos outros casos também usamos leitura.
 //
+// CALLER MUST CALL source_close()
 //===================================================================
-char* read_file(const char* filename, size_t* length) {
+int source_open(SourceFile* source, const char* filename)
+{
+    source->text = NULL;
+    source->length = 0;
+    source->mapped = 0;
+
     FILE* file = fopen(filename, "rb");
-    if (!file){
-        printf("Error opening file '%s': %s\n", 
-               filename, strerror(errno));
-        exit(EXIT_FAILURE);
+    if (!file) {
+        printf("%sError: cannot open file '%s'%s\n", 
+               output_ansi(COLOR_ERROR), filename, output_ansi(COLOR_RESET));
+        printf("Check if file exists and you have read permission.\n");
+        return 0;
     } 
     
     // Get file size
@@ -71,50 +98,199 @@ char* read_file(const char* filename, size_t* length) {
         printf("Error retrieving file size for '%s': %s\n",
                filename, strerror(errno));
         fclose(file);
-        exit(EXIT_FAILURE);
+        return 0;
     }
     
-    *length = st.st_size;
-    
-    // Allocate buffer (with extra space for null terminator if needed)
-    char* buffer = A89ALLOC(*length + 1);
-    if (!buffer) {
-        printf("Error allocating memory for file '%s'\n", filename);
-        fclose(file);
-        exit(EXIT_FAILURE);
+    size_t length = st.st_size;
+
+#ifndef _WIN32
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (length >= SOURCE_MMAP_MIN && page_size > 0 && length % page_size != 0)
+    {
+        void* map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (map != MAP_FAILED)
+        {
+            fclose(file);  // O mapeamento continua válido
+            source->text = map;
+            source->length = length;
+            source->mapped = 1;
+            return 1;
+        }
+        // Falhou: segue com a leitura normal
     }
+#endif
+    
+    // Allocate buffer (with extra space for null terminator)
+    char* buffer = A89ALLOC(length + 1);
     
     // Read everything at once
-    size_t bytes_read = fread(buffer, 1, *length, file);
+    size_t bytes_read = fread(buffer, 1, length, file);
     fclose(file);
     
-    if (bytes_read != *length) {
+    if (bytes_read != length) {
         printf("Error reading file '%s' (expected %zu bytes, read %zu)\n",
-               filename, *length, bytes_read);
+               filename, length, bytes_read);
         a89free(buffer);
-        exit(EXIT_FAILURE);
+        return 0;
+    }
+    
+    buffer[length] = '\0'; // Null-terminate string
+
+    source->text = buffer;
+    source->length = length;
+    return 1;
+}
+
+void source_close(SourceFile* source)
+{
+#ifndef _WIN32
+    if (source->mapped)
+    {
+        munmap((void*)source->text, source->length);
+    }
+    else
+#endif
+    {
+        a89free((void*)source->text);
+    }
+
+    source->text = NULL;
+    source->length = 0;
+    source->mapped = 0;
+}
+
+// ============================================
+// Execution Engine
+// ============================================
+static ExecMode exec_mode = EXEC_AUTO;
+static int quick_dump = 0;
+
+void set_exec_mode(ExecMode mode)
+{
+    exec_mode = mode;
+}
+
+void set_quick_dump(int enabled)
+{
+    quick_dump = enabled;
+}
+
+// Há um while no statement (dentro de if/else também). Só listas e
+// if são abertos: expressões não contêm statements. Pilha de trabalho
+// porque os if podem estar aninhados milhares de níveis
+static int statement_has_loop(ASTNode* statement)
+{
+    // Caso comum (print, let...): nada a abrir, nem cria a pilha
+    if (statement->type == NODE_WHILE) return 1;
+    if (statement->type != NODE_IF && statement->type != NODE_STATEMENT_LIST) return 0;
+    
+    WorkStack pending;
+    work_stack_init(&pending, sizeof(ASTNode*));
+    *WORK_STACK_PUSH(&pending, ASTNode*) = statement;
+    
+    int found = 0;
+    while (!found && !work_stack_empty(&pending))
+    {
+        ASTNode* node = *WORK_STACK_TOP(&pending, ASTNode*);
+        work_stack_pop(&pending);
+        if (!node) continue;
+        
+        switch (node->type)
+        {
+            case NODE_WHILE:
+                found = 1;
+                break;
+            
+            case NODE_IF:
+                *WORK_STACK_PUSH(&pending, ASTNode*) = node->data.ifstatement.then_body;
+                *WORK_STACK_PUSH(&pending, ASTNode*) = node->data.ifstatement.else_body;
+                break;
+            
+            case NODE_STATEMENT_LIST:
+                for (int i = 0; i < node->data.statementlist.count; i++)
+                {
+                    *WORK_STACK_PUSH(&pending, ASTNode*) = node->data.statementlist.statements[i];
+                }
+                break;
+            
+            default:
+                break;
+        }
     }
     
-    buffer[*length] = '\0'; // Null-terminate string
+    work_stack_free(&pending);
+    return found;
+}
 
-    // ========== CORREÇÃO CRÍTICA PARA WINDOWS ==========
-    // Remove todos os \r (carriage return)
-    char* dst = buffer;
-    char* src = buffer;
-    size_t new_len = 0;
+// Motor padrão, statement a statement do nível de cima: o que executa
+// uma vez só (print, let, if sem laço) vai direto pelo evaluator, e
+// compilar custaria mais que executar; cada statement com while é
+// compilado num chunk próprio e roda na VM. Os dois motores dividem o
+// ExecutionContext (variáveis, cor, width), então a saída é a mesma
+static int execute_tiered(ASTNode* ast, ExecutionContext* ctx)
+{
+    ASTNode** statements = &ast;
+    int count = 1;
+    if (ast->type == NODE_STATEMENT_LIST)
+    {
+        statements = ast->data.statementlist.statements;
+        count = ast->data.statementlist.count;
+    }
     
-    while (*src) {
-        if (*src != '\r') {  // Remove \r
-            *dst++ = *src;
-            new_len++;
+    int success = 1;
+    for (int i = 0; i < count; i++)
+    {
+        if (!statement_has_loop(statements[i]))
+        {
+            // Nível de cima: break/continue não chegam aqui (parser)
+            if (execute_statement(statements[i], ctx) == STMT_ERROR) success = 0;
+            continue;
         }
-        src++;
+        
+        Chunk chunk;
+        chunk_init(&chunk);
+        if (!compile_program(statements[i], &chunk) || !vm_run(&chunk, ctx)) success = 0;
+        chunk_free(&chunk);
     }
-    *dst = '\0';
-    *length = new_len;  // Atualiza tamanho
-    // ===================================================
+    return success;
+}
 
-    return buffer;
+// Otimiza, resolve as variáveis, infere os tipos e executa a AST pelo
+// motor escolhido (ExecMode), no interpretador da sessão
+int execute_program(ASTNode* ast, ExecutionContext* ctx)
+{
+    if (!optimize_program(ast, ctx) || !resolve_program(ast, ctx->symbols) ||
+        !infer_program(ast, ctx))
+    {
+        return 0;
+    }
+
+    int success;
+    if (exec_mode == EXEC_AST)
+    {
+        success = evaluate_program(ast, ctx);
+        if (quick_dump)
+        {
+            evaluator_dump_quickening(ast, ctx);
+        }
+    }
+    else if (exec_mode == EXEC_AUTO)
+    {
+        success = execute_tiered(ast, ctx);
+    }
+    else
+    {
+        Chunk chunk;
+        chunk_init(&chunk);
+
+        success = compile_program(ast, &chunk) && vm_run(&chunk, ctx);
+
+        chunk_free(&chunk);
+    }
+
+    // O que o print deixou no buffer sai antes do próximo prompt
+    output_flush(&ctx->output);
+    return success;
 }
 
 // ============================================
@@ -123,7 +299,7 @@ char* read_file(const char* filename, size_t* length) {
 void run_repl(void)
 {
     char line[BUFFER_SIZE];
-    SymbolTable* symbols = symbol_table_create();
+    ExecutionContext* ctx = execution_context_create();
     
     while (1)
     {
@@ -154,15 +330,14 @@ void run_repl(void)
 
         if (strcmp(line, "vars") == 0)
         {
-            list_variables(symbols);
+            list_variables(ctx->symbols);
             continue;
         }
 
         if (strcmp(line, "reset") == 0)
         {
             printf("Resetting all variables...\n");
-            symbol_table_destroy(symbols);
-            symbols = symbol_table_create();  
+            execution_context_reset(ctx);
             printf("All variables cleared.\n");
             continue;
         }
@@ -205,16 +380,31 @@ void run_repl(void)
             }
             else
             {
-                show_ast(code);
+                show_ast(code, ctx);
+            }
+            continue;
+        }
+
+        if (strncmp(line, "bytecode ", 9) == 0)
+        {
+            const char* code = line + 9;  // Pula "bytecode "
+            if (code[0] == '\0')
+            {
+                printf("Usage: bytecode \"code\"\n");
+                printf("Example: bytecode \"x * 2\"\n");
+            }
+            else
+            {
+                show_bytecode(code, ctx);
             }
             continue;
         }
 
         if (strncmp(line, "symbols", 7) == 0)
         {
-            if (symbols)
+            if (ctx->symbols)
             {  
-                symbol_table_print(symbols);
+                symbol_table_print(ctx->symbols);
             }
             else
             {
@@ -229,18 +419,23 @@ void run_repl(void)
             Lexer lexer;
             lexer_init(&lexer, line);
     
-            ASTNode* ast = parse(&lexer);  // Agora parse retorna statement list
+            // Cada linha tem a sua arena: a AST inteira é liberada de uma vez
+            ASTArena* arena = ast_arena_create();
+            ASTNode* ast = parse(&lexer, arena);  // Agora parse retorna statement list
             if (ast == NULL) {
                 // Error already printed by parser
+                ast_arena_destroy(arena);
+                lexer_free(&lexer);
                 continue;
             }
             
-            int success = evaluate_program(ast, symbols);
+            int success = execute_program(ast, ctx);
             if (!success) {
-                // Error already printed by evaluate_program
+                // Error already printed by execute_program
             }
             
-            free_ast(ast);
+            ast_arena_destroy(arena);
+            lexer_free(&lexer);
         }
         else
         {
@@ -248,14 +443,17 @@ void run_repl(void)
         }
     }
     
-    symbol_table_destroy(symbols);
+    execution_context_destroy(ctx);
 }
 
 
 //=========== DEBUG ==============================
 void debug_file(const char* filename) {
-    size_t input_size;
-    char* code = read_file(filename, &input_size);
+    SourceFile source;
+    if (!source_open(&source, filename)) return;
+
+    const char* code = source.text;
+    size_t input_size = source.length;
     
     printf("=== DEBUG FILE ===\n");
     printf("Tamanho: %zu bytes\n", input_size);
@@ -271,7 +469,7 @@ void debug_file(const char* filename) {
     
     // Testa o lexer
     Lexer lexer;
-    lexer_init(&lexer, code);
+    lexer_init_buffer(&lexer, code, input_size);
     
     printf("Tokens:\n");
     int count = 0;
@@ -280,46 +478,61 @@ void debug_file(const char* filename) {
     {
         token = lexer_get_next_token(&lexer);
         printf("%3d: [%s] ", ++count, token_type_to_string(token.type));
-        if (token.type == TOKEN_NUMBER) 
+        if (token.type == TOKEN_NUMBER && token.is_integer) 
+            printf("(%lld)", (long long)token.value.integer);
+        else if (token.type == TOKEN_NUMBER) 
             printf("(%.2f)", token.value.number);
         else if (token.type == TOKEN_STRING) 
-            printf("(%s)", token.value.string);  // Para strings
-        else if (token.type == TOKEN_IDENTIFIER) 
-            printf("(%s)", token.value.varname);  // Para identificadores
-        else if (token.text[0]) 
-            printf("(%s)", token.text);
+        {
+            size_t length;
+            const char* text = lexer_token_contents(&lexer, token, &length);
+            printf("(%.*s)", (int)length, text);  // Para strings
+        }
+        else
+        {
+            char text[TOKENTEXT_SIZE];
+            lexer_token_text(&lexer, token, text, sizeof(text));
+            if (text[0]) 
+                printf("(%s)", text);
+        }
         printf("\n");
     } while (token.type != TOKEN_EOF && token.type != TOKEN_ERROR);
     
-    a89free(code);
+    lexer_free(&lexer);
+    source_close(&source);
 }
 //================================================
 
 
-void run_file(const char* filename)
+int run_file(const char* filename)
 {
     //debug_file(filename);
 
-    size_t input_size;
-    char* code = read_file(filename, &input_size);
-    SymbolTable* symbols = symbol_table_create();
+    SourceFile source;
+    if (!source_open(&source, filename)) {
+        return 0;
+    }
+    ExecutionContext* ctx = execution_context_create();
 
-    if (code[0] != '\0')
+    if (source.length > 0)
     {
         Lexer lexer;
-        lexer_init(&lexer, code);
+        lexer_init_buffer(&lexer, source.text, source.length);
 
-        ASTNode* ast = parse(&lexer);// Agora parse retorna statement list
+        ASTArena* arena = ast_arena_create();
+        ASTNode* ast = parse(&lexer, arena);// Agora parse retorna statement list
         if (ast == NULL) {
-            printf("%sParsing error%s\n", COLOR_ERROR, COLOR_RESET);
-            symbol_table_destroy(symbols);
-            a89free(code);
+            printf("%sParsing error%s\n", output_ansi(COLOR_ERROR), output_ansi(COLOR_RESET));
+            ast_arena_destroy(arena);
+            lexer_free(&lexer);
+            execution_context_destroy(ctx);
+            source_close(&source);
             exit(EXIT_FAILURE);
         }
 
-        int success = evaluate_program(ast, symbols);
+        int success = execute_program(ast, ctx);
         if (!success) {
-            // Error already printed by execute_statement
+            // Error already printed by execute_program
         }
 
         // if (!success) {
@@ -328,11 +541,13 @@ void run_file(const char* filename)
         //     printf("%sPrograma executado com sucesso!%s\n", COLOR_SUCCESS, COLOR_RESET);
         // }
         
-        free_ast(ast);
-        a89free(code);
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
     }
     
-    symbol_table_destroy(symbols);
+    source_close(&source);
+    execution_context_destroy(ctx);
+    return 1;
 }
 
 // ============================================
@@ -380,21 +595,63 @@ void show_tokens(const char* code)
     lexer_print_all_tokens(code);
 }
 
-void show_ast(const char* code)
+void show_ast(const char* code, ExecutionContext* ctx)
 {
     Lexer lexer;
     lexer_init(&lexer, code);
     
-    ASTNode* ast = parse(&lexer);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
     if (!ast) {
         printf("Error parsing code.\n");
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
         return;
     }
     
-    printf("%sAST for: \"%s\"\n%s", COLOR_HEADER, code, COLOR_RESET);
+    printf("%sAST for: \"%s\"\n%s", output_ansi(COLOR_HEADER), code, output_ansi(COLOR_RESET));
     print_ast(ast, 0);
     
-    free_ast(ast);
+    // Mesma árvore depois de optimize_program() (o que de fato executa)
+    if (optimize_program(ast, ctx))
+    {
+        printf("%sOptimized AST:\n%s", output_ansi(COLOR_HEADER), output_ansi(COLOR_RESET));
+        print_ast(ast, 0);
+    }
+    
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+}
+
+void show_bytecode(const char* code, ExecutionContext* ctx)
+{
+    SymbolTable* symbols = ctx->symbols;
+
+    Lexer lexer;
+    lexer_init(&lexer, code);
+
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    if (!ast) {
+        printf("Error parsing code.\n");
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
+        return;
+    }
+
+    Chunk chunk;
+    chunk_init(&chunk);
+
+    if (optimize_program(ast, ctx) && resolve_program(ast, symbols) &&
+        infer_program(ast, ctx) && compile_program(ast, &chunk))
+    {
+        printf("%sBytecode for: \"%s\"\n%s", output_ansi(COLOR_HEADER), code, output_ansi(COLOR_RESET));
+        chunk_disassemble(&chunk, symbols);
+    }
+
+    chunk_free(&chunk);
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
 }
 
 
@@ -407,18 +664,622 @@ void print_banner(void)
     
     // ZzBasic ASCII art (COLOR_SUCCESS - bright green)
     printf("====================================\n");
-    printf(COLOR_SUCCESS);
+    printf("%s", output_ansi(COLOR_SUCCESS));
     printf(" ______    ____            _      \n");
     printf("|___  /   |  _ \\          (_)     \n");
     printf("   / / ___| |_) | __ _ ___ _  ___ \n");
     printf("  / / |_  /  _ < / _` / __| |/ __|\n");
     printf(" / /__ / /| |_) | (_| \\__ \\ | (__ \n");
     printf("/_____/___|____/ \\__,_|___/_|\\___|\n");
-    printf(COLOR_RESET);
+    printf("%s", output_ansi(COLOR_RESET));
     printf("\nv%s on %s\n", ZZ_VERSION, get_os_name());
     printf("====================================\n");
     
     // Lines and version/OS information
     printf("\n");
 }
+
+// ============================================
+// BENCHMARK: rastreamento x release do a89alloc
+// Mesmo script nos dois modos (todos os .c menos main.c):
+// gcc -O2 -DBENCHA89ALLOC <arquivos> -lm -o bench_tracking
+// gcc -O2 -DBENCHA89ALLOC -DA89ALLOC_RELEASE <arquivos> -lm -o bench_release
+// ============================================
+
+#ifdef BENCHA89ALLOC
+#include <time.h>
+
+// Executa cada linha como o REPL: arena, parse e execução próprios
+static double bench_run_script(const char** lines, int count, int rounds,
+                               ExecMode mode)
+{
+    ExecutionContext* ctx = execution_context_create();
+    set_exec_mode(mode);
+    
+    clock_t start = clock();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            Lexer lexer;
+            lexer_init(&lexer, lines[i]);
+            
+            ASTArena* arena = ast_arena_create();
+            ASTNode* ast = parse(&lexer, arena);
+            if (ast)
+            {
+                execute_program(ast, ctx);
+            }
+            ast_arena_destroy(arena);
+            lexer_free(&lexer);
+        }
+    }
+    double ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+    
+    execution_context_destroy(ctx);
+    return ms;
+}
+
+int main()
+{
+    setup_utf8();
+    
+    // Script sem saída: só atribuições e if
+    const char* script[] =
+    {
+        "let a = 1",
+        "let b = a * 2 + 3",
+        "let s = \"texto\"",
+        "let ok = true",
+        "if (b > a) then\n let a = a + 1\nend if",
+        "let c = (a + b) * (b - a) / 2",
+    };
+    int count = sizeof(script) / sizeof(script[0]);
+    int rounds = 50000;
+    
+#ifdef A89ALLOC_RELEASE
+    const char* build = "release";
+#else
+    const char* build = "tracking";
+#endif
+    
+    printf("%s=== Benchmark a89alloc (%s) ===%s\n\n", COLOR_HEADER, build, COLOR_RESET);
+    
+    double vm_ms = bench_run_script(script, count, rounds, EXEC_VM);
+    double ast_ms = bench_run_script(script, count, rounds, EXEC_AST);
+    
+    A89Stats stats = a89stats();
+    printf("%d linhas x %d | vm %.1f ms | ast %.1f ms\n", count, rounds, vm_ms, ast_ms);
+    printf("alocacoes %zu | pico %zu bytes | ativos %zu bytes\n",
+           stats.allocation_count, stats.peak_bytes, stats.live_bytes);
+    
+    a89check_leaks();
+    return 0;
+}
+#endif
+// ============================================
+// BENCHMARK: print com saída redirecionada
+// O relatório vai para stdout; o tempo vai para stderr
+// gcc -O2 -DBENCHOUTPUT <todos os .c menos main.c> -lm -o bench_output
+// ./bench_output > relatorio.txt
+// ============================================
+
+#ifdef BENCHOUTPUT
+#include <time.h>
+
+#define BENCH_ROWS   2000
+#define BENCH_ROUNDS 250
+
+int main()
+{
+    setup_utf8();
+    
+    // Um relatório: cada linha tem cores, width e alinhamentos
+    size_t size = (size_t)BENCH_ROWS * 160;
+    char* source = A89ALLOC(size);
+    size_t used = 0;
+    for (int i = 0; i < BENCH_ROWS; i++)
+    {
+        used += snprintf(source + used, size - used,
+                         "print \"pedido\" width(8) right %d \" | \" width(12) center \"produto\" "
+                         "green %d.25 width(10) right n red \"ok\" nl\n",
+                         i, i % 100);
+    }
+    
+    ExecutionContext* ctx = execution_context_create();
+    symbol_table_set_number(ctx->symbols, "n", 42);
+    
+    Lexer lexer;
+    lexer_init(&lexer, source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    if (!ast)
+    {
+        fprintf(stderr, "Parsing error\n");
+        return 1;
+    }
+    
+    // O padrão (EXEC_AUTO) não deve perder para --ast: sem while nada compila
+    const ExecMode modes[3] = { EXEC_AUTO, EXEC_VM, EXEC_AST };
+    double ms[3];
+    for (int mode = 0; mode < 3; mode++)
+    {
+        set_exec_mode(modes[mode]);
+        
+        clock_t start = clock();
+        for (int r = 0; r < BENCH_ROUNDS; r++)
+        {
+            execute_program(ast, ctx);
+        }
+        fflush(stdout);
+        ms[mode] = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+    }
+    
+    long lines = (long)BENCH_ROWS * BENCH_ROUNDS;
+    fprintf(stderr, "%ld linhas por motor | padrão %.1f ms (%.0f ns/linha) | "
+            "vm %.1f ms (%.0f ns/linha) | ast %.1f ms (%.0f ns/linha)\n",
+            lines, ms[0], ms[0] * 1e6 / lines, ms[1], ms[1] * 1e6 / lines,
+            ms[2], ms[2] * 1e6 / lines);
+    
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(ctx);
+    a89free(source);
+    
+    a89check_leaks();
+    return 0;
+}
+#endif
+// ============================================
+// BENCHMARK: laço while (voltas por segundo)
+// gcc -O2 -DBENCHLOOP <todos os .c menos main.c> -lm -o bench_loop
+// ./bench_loop
+// ============================================
+
+#ifdef BENCHLOOP
+#include <time.h>
+
+#define BENCH_ITERATIONS 2000000
+
+static const char* bench_loop_source =
+    "let i = 0\n"
+    "let soma = 0\n"
+    "let pares = 0\n"
+    "while (i < n) do\n"
+    "    let i = i + 1\n"
+    "    if (i < 10) then\n"
+    "        continue\n"
+    "    end if\n"
+    "    let soma = soma + i * 2\n"
+    "    if (soma > 1000000000) then\n"
+    "        let soma = soma - 1000000000\n"
+    "        let pares = pares + 1\n"
+    "    end if\n"
+    "    if (i == limite) then\n"
+    "        break\n"
+    "    end if\n"
+    "end while\n";
+
+int main()
+{
+    setup_utf8();
+    
+    ExecutionContext* ctx = execution_context_create();
+    SymbolTable* symbols = ctx->symbols;
+    symbol_table_set_number(symbols, "n", BENCH_ITERATIONS);
+    symbol_table_set_number(symbols, "limite", BENCH_ITERATIONS + 1);
+    
+    Lexer lexer;
+    lexer_init(&lexer, bench_loop_source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    if (!ast)
+    {
+        fprintf(stderr, "Parsing error\n");
+        return 1;
+    }
+    
+    printf("%s=== Benchmark while: %d voltas ===%s\n\n",
+           COLOR_HEADER, BENCH_ITERATIONS, COLOR_RESET);
+    
+    for (int mode = 0; mode < 2; mode++)
+    {
+        set_exec_mode(mode == 0 ? EXEC_VM : EXEC_AST);
+        
+        size_t allocations = a89stats().allocation_count;
+        clock_t start = clock();
+        execute_program(ast, ctx);
+        double ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+        allocations = a89stats().allocation_count - allocations;
+        
+        SymbolHandle soma = symbol_table_lookup(symbols, "soma");
+        printf("%-3s | %8.1f ms | %6.2f M voltas/s | %zu alocações no programa | soma %.0f\n",
+               mode == 0 ? "vm" : "ast", ms,
+               BENCH_ITERATIONS / (ms * 1000.0), allocations,
+               value_as_number(soma.value->value));
+    }
+    
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(ctx);
+    
+    a89check_leaks();
+    return 0;
+}
+#endif
+// ============================================
+// BENCHMARK: string de 10 MB montada num laço (let s = s + bloco)
+// Com o append no próprio bloco e a capacidade dobrando, o custo é
+// linear: poucas alocações em vez de uma cópia inteira por volta.
+// gcc -O2 -DBENCHSTRING <todos os .c menos main.c> -lm -o bench_string
+// ./bench_string
+// ============================================
+
+#ifdef BENCHSTRING
+#include <time.h>
+
+#define BENCH_BLOCK_SIZE 100
+#define BENCH_BLOCKS     100000        // 100 x 100000 = 10 MB
+
+static const char* bench_string_source =
+    "let s = \"\"\n"
+    "let i = 0\n"
+    "while (i < n) do\n"
+    "    let s = s + bloco\n"
+    "    let i = i + 1\n"
+    "end while\n"
+    "let igual = (s == copia)\n";
+
+int main()
+{
+    setup_utf8();
+
+    char bloco[BENCH_BLOCK_SIZE + 1];
+    for (int i = 0; i < BENCH_BLOCK_SIZE; i++) bloco[i] = (char)('a' + i % 26);
+    bloco[BENCH_BLOCK_SIZE] = '\0';
+
+    ExecutionContext* ctx = execution_context_create();
+    SymbolTable* symbols = ctx->symbols;
+    symbol_table_set_number(symbols, "n", BENCH_BLOCKS);
+    symbol_table_set_string(symbols, "bloco", bloco);
+    symbol_table_set_string(symbols, "copia", "");
+
+    Lexer lexer;
+    lexer_init(&lexer, bench_string_source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    if (!ast)
+    {
+        fprintf(stderr, "Parsing error\n");
+        return 1;
+    }
+
+    printf("%s=== Benchmark string: %d x %d bytes ===%s\n\n",
+           COLOR_HEADER, BENCH_BLOCKS, BENCH_BLOCK_SIZE, COLOR_RESET);
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        set_exec_mode(mode == 0 ? EXEC_VM : EXEC_AST);
+
+        size_t allocations = a89stats().allocation_count;
+        clock_t start = clock();
+        execute_program(ast, ctx);
+        double ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+        allocations = a89stats().allocation_count - allocations;
+
+        // A segunda volta compara com o resultado da primeira (memcmp de 10 MB)
+        String* s = value_as_string_object(symbol_table_lookup(symbols, "s").value->value);
+        Value igual = symbol_table_lookup(symbols, "igual").value->value;
+        printf("%-3s | %8.1f ms | %7.1f MB/s | %zu alocações no programa | %zu bytes | igual %s\n",
+               mode == 0 ? "vm" : "ast", ms,
+               s->length / (ms * 1000.0), allocations, s->length,
+               value_as_bool(igual) ? "true" : "false");
+
+        symbol_table_set_string(symbols, "copia", s->chars);
+    }
+
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(ctx);
+
+    a89check_leaks();
+    return 0;
+}
+#endif
+// ============================================
+// BENCHMARK: linha de ~1 MB cortada campo a campo com instr e mid
+// mid devolve uma view da linha original: "let linha = mid(linha, p + 1)"
+// não copia o resto da linha a cada campo, e o laço fica linear.
+// gcc -O2 -DBENCHSPLIT <todos os .c menos main.c> -lm -o bench_split
+// ./bench_split
+// ============================================
+
+#ifdef BENCHSPLIT
+#include <time.h>
+
+#define BENCH_FIELD_SIZE 10
+#define BENCH_FIELDS     100000        // 100000 x (10 + ';') = 1,1 MB
+
+static const char* bench_split_source =
+    "let campos = 0\n"
+    "let total = 0\n"
+    "let p = instr(linha, \";\")\n"
+    "while (p > 0) do\n"
+    "    let total = total + len(mid(linha, 1, p - 1))\n"
+    "    let linha = mid(linha, p + 1)\n"
+    "    let campos = campos + 1\n"
+    "    let p = instr(linha, \";\")\n"
+    "end while\n";
+
+int main()
+{
+    setup_utf8();
+
+    size_t size = (size_t)BENCH_FIELDS * (BENCH_FIELD_SIZE + 1);
+    char* text = A89ALLOC(size + 1);
+    for (size_t i = 0; i < size; i++)
+    {
+        text[i] = i % (BENCH_FIELD_SIZE + 1) == BENCH_FIELD_SIZE ? ';' : (char)('a' + i % 26);
+    }
+    text[size] = '\0';
+
+    ExecutionContext* ctx = execution_context_create();
+    SymbolTable* symbols = ctx->symbols;
+
+    Lexer lexer;
+    lexer_init(&lexer, bench_split_source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+    if (!ast)
+    {
+        fprintf(stderr, "Parsing error\n");
+        return 1;
+    }
+
+    printf("%s=== Benchmark split: %d campos, %zu bytes ===%s\n\n",
+           COLOR_HEADER, BENCH_FIELDS, size, COLOR_RESET);
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        set_exec_mode(mode == 0 ? EXEC_VM : EXEC_AST);
+        symbol_table_set_string(symbols, "linha", text);
+
+        size_t allocations = a89stats().allocation_count;
+        clock_t start = clock();
+        execute_program(ast, ctx);
+        double ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+        allocations = a89stats().allocation_count - allocations;
+
+        double campos = value_as_number(symbol_table_lookup(symbols, "campos").value->value);
+        double total = value_as_number(symbol_table_lookup(symbols, "total").value->value);
+        printf("%-3s | %8.1f ms | %7.1f MB/s | %zu alocações no programa | %.0f campos, %.0f bytes\n",
+               mode == 0 ? "vm" : "ast", ms, size / (ms * 1000.0), allocations, campos, total);
+    }
+
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(ctx);
+    a89free(text);
+
+    a89check_leaks();
+    return 0;
+}
+#endif
+// ============================================
+// BENCHMARK: array de 10 milhões de números, preenchido e somado
+// "provado": while (i <= n) depois de dim a(n), o optimizer tira a
+// verificação de limites de a(i); "verificado": o laço vai até m
+// (= n, mas não o n do dim) e cada acesso confere o índice.
+// gcc -O2 -DBENCHARRAY <todos os .c menos main.c> -lm -o bench_array
+// ./bench_array
+// ============================================
+
+#ifdef BENCHARRAY
+#include <time.h>
+
+#define BENCH_ELEMENTS 10000000
+
+// %s: limite dos dois laços (n ou m)
+static const char* bench_array_source =
+    "dim a(n)\n"
+    "let i = 1\n"
+    "while (i <= %s) do\n"
+    "    let a(i) = i * 2\n"
+    "    let i = i + 1\n"
+    "end while\n"
+    "let soma = 0\n"
+    "let i = 1\n"
+    "while (i <= %s) do\n"
+    "    let soma = soma + a(i)\n"
+    "    let i = i + 1\n"
+    "end while\n";
+
+int main()
+{
+    setup_utf8();
+
+    ExecutionContext* ctx = execution_context_create();
+    SymbolTable* symbols = ctx->symbols;
+    symbol_table_set_number(symbols, "n", BENCH_ELEMENTS);
+    symbol_table_set_number(symbols, "m", BENCH_ELEMENTS);
+
+    printf("%s=== Benchmark array: %d elementos ===%s\n\n",
+           COLOR_HEADER, BENCH_ELEMENTS, COLOR_RESET);
+
+    for (int proven = 1; proven >= 0; proven--)
+    {
+        const char* bound = proven ? "n" : "m";
+        char source[512];
+        snprintf(source, sizeof(source), bench_array_source, bound, bound);
+
+        Lexer lexer;
+        lexer_init(&lexer, source);
+        ASTArena* arena = ast_arena_create();
+        ASTNode* ast = parse(&lexer, arena);
+        if (!ast)
+        {
+            fprintf(stderr, "Parsing error\n");
+            return 1;
+        }
+
+        for (int mode = 0; mode < 2; mode++)
+        {
+            set_exec_mode(mode == 0 ? EXEC_VM : EXEC_AST);
+
+            clock_t start = clock();
+            execute_program(ast, ctx);
+            double ms = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+            SymbolHandle soma = symbol_table_lookup(symbols, "soma");
+            printf("%-3s | %-10s | %8.1f ms | %6.2f M elementos/s | soma %.0f\n",
+                   mode == 0 ? "vm" : "ast", proven ? "provado" : "verificado", ms,
+                   2.0 * BENCH_ELEMENTS / (ms * 1000.0), value_as_number(soma.value->value));
+        }
+
+        ast_arena_destroy(arena);
+        lexer_free(&lexer);
+    }
+
+    execution_context_destroy(ctx);
+
+    a89check_leaks();
+    return 0;
+}
+#endif
+// ============================================
+// TESTE: expressões com 100 mil níveis de aninhamento
+// Parser, optimizer, resolver, inferência, compilador, VM e evaluator
+// rodam numa thread com pilha fixa de DEEP_STACK_SIZE: nenhuma fase
+// pode recursar por nível da expressão.
+// gcc -O2 -DTESTDEEP <todos os .c menos main.c> -lm -lpthread -o test_deep
+// ./test_deep
+// ============================================
+
+#ifdef TESTDEEP
+#include <pthread.h>
+
+#define DEEP_LEVELS     100000
+#define DEEP_STACK_SIZE (256 * 1024)
+
+typedef struct
+{
+    const char* name;
+    const char* open;       // Repetido DEEP_LEVELS vezes antes do centro
+    const char* center;
+    const char* close;      // Repetido DEEP_LEVELS vezes depois
+    int is_bool;
+    double expected;        // Valor esperado de 'r' (bool: 0/1)
+} DeepCase;
+
+static const DeepCase deep_cases[] =
+{
+    // ((v + 1) + 1)...: aninhado à esquerda
+    { "soma aninhada à esquerda", "(", "v", " + 1)", 0, 5 + DEEP_LEVELS },
+    // 1 - (1 - (...)): aninhado à direita, pilha de valores da VM funda
+    { "subtração aninhada à direita", "1 - (", "v", ")", 0, 5 },
+    // (not (not ...)): operadores unários
+    { "not aninhado", "(not ", "(v == 5)", ")", 1, 1 },
+    // (v < 6 and (v < 6 and ...)): sem curto-circuito até o fim
+    { "and aninhado", "(v < 6 and ", "v > 4", ")", 1, 1 },
+    // a(a(a(...))): índices de array (a(5) = 5)
+    { "índice aninhado", "a(", "v", ")", 0, 5 },
+};
+
+// Antes da expressão de cada caso
+#define DEEP_PREFIX "dim a(5)\nlet a(5) = 5\nlet r = "
+
+static char* deep_source(const DeepCase* test)
+{
+    size_t open_len = strlen(test->open);
+    size_t close_len = strlen(test->close);
+    size_t prefix_len = strlen(DEEP_PREFIX);
+    size_t size = prefix_len + (open_len + close_len) * DEEP_LEVELS + strlen(test->center) + 1;
+
+    char* source = A89ALLOC(size);
+    char* p = source;
+    memcpy(p, DEEP_PREFIX, prefix_len);
+    p += prefix_len;
+    for (int i = 0; i < DEEP_LEVELS; i++, p += open_len) memcpy(p, test->open, open_len);
+    strcpy(p, test->center);
+    p += strlen(test->center);
+    for (int i = 0; i < DEEP_LEVELS; i++, p += close_len) memcpy(p, test->close, close_len);
+    *p = '\0';
+    return source;
+}
+
+static int deep_run(const DeepCase* test, const char* source, ExecMode mode)
+{
+    ExecutionContext* ctx = execution_context_create();
+    symbol_table_set_number(ctx->symbols, "v", 5);
+    set_exec_mode(mode);
+
+    Lexer lexer;
+    lexer_init(&lexer, source);
+    ASTArena* arena = ast_arena_create();
+    ASTNode* ast = parse(&lexer, arena);
+
+    int ok = ast != NULL && execute_program(ast, ctx);
+    if (ok)
+    {
+        SymbolHandle r = symbol_table_lookup(ctx->symbols, "r");
+        Value value = r.value ? r.value->value : VALUE_UNDEFINED;
+        ok = test->is_bool
+           ? value_is_bool(value) && value_as_bool(value) == (int)test->expected
+           : value_is_number(value) && value_as_number(value) == test->expected;
+    }
+
+    ast_arena_destroy(arena);
+    lexer_free(&lexer);
+    execution_context_destroy(ctx);
+    return ok;
+}
+
+static void* deep_thread(void* arg)
+{
+    int* falhas = arg;
+    int num_cases = sizeof(deep_cases) / sizeof(deep_cases[0]);
+
+    for (int i = 0; i < num_cases; i++)
+    {
+        char* source = deep_source(&deep_cases[i]);
+        for (int mode = 0; mode < 2; mode++)
+        {
+            int ok = deep_run(&deep_cases[i], source, mode == 0 ? EXEC_VM : EXEC_AST);
+            printf("%s%-4s%s %-3s %s\n", ok ? COLOR_SUCCESS : COLOR_ERROR,
+                   ok ? "OK" : "ERRO", COLOR_RESET, mode == 0 ? "vm" : "ast",
+                   deep_cases[i].name);
+            if (!ok) (*falhas)++;
+        }
+        a89free(source);
+    }
+    return NULL;
+}
+
+int main()
+{
+    setup_utf8();
+
+    printf("%s=== Teste: %d níveis, pilha de %d KB ===%s\n\n",
+           COLOR_HEADER, DEEP_LEVELS, DEEP_STACK_SIZE / 1024, COLOR_RESET);
+
+    int falhas = 0;
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, DEEP_STACK_SIZE);
+    if (pthread_create(&thread, &attr, deep_thread, &falhas) != 0)
+    {
+        fprintf(stderr, "pthread_create failed\n");
+        return 1;
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    printf("\n%s%s%s\n", falhas ? COLOR_ERROR : COLOR_SUCCESS,
+           falhas ? "ERRO" : "OK", COLOR_RESET);
+
+    a89check_leaks();
+    return falhas != 0;
+}
+#endif
 // Fim de zzbasic.c
\ No newline at end of file
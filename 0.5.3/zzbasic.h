@@ -5,20 +5,49 @@
 
 #include <stdio.h>
 
+#include "ast.h"
 #include "symbol_table.h"
+#include "evaluator.h"
 
 #define ZZ_VERSION "0.5.3"
 #define ZZ_PROMPT ">> "
 
+// Arquivos a partir deste tamanho são mapeados em vez de lidos
+#define SOURCE_MMAP_MIN (64 * 1024)
+
+// Código-fonte carregado de arquivo (ver source_open)
+typedef struct
+{
+    const char* text;       // Terminado em '\0'
+    size_t length;
+    int mapped;             // 1 = mmap, 0 = buffer A89ALLOC
+} SourceFile;
+
+// Motor de execução. Padrão: statements com while vão para a VM de
+// bytecode e o resto para o evaluator da AST, que executa uma vez sem
+// pagar a compilação. --vm compila tudo, --ast não compila nada
+typedef enum
+{
+    EXEC_AUTO,
+    EXEC_VM,
+    EXEC_AST
+} ExecMode;
+
+void set_exec_mode(ExecMode mode);
+void set_quick_dump(int enabled);  // --dump-quick: nós especializados depois de cada programa (--ast)
+int execute_program(ASTNode* ast, ExecutionContext* ctx);
+
 const char* get_os_name(void);
 int is_empty_line(const char *line);
-char* read_file(const char* filename, size_t* length);
+int source_open(SourceFile* source, const char* filename);
+void source_close(SourceFile* source);
 void run_repl(void);
-void run_file(const char* filename);
+int run_file(const char* filename);
 int has_zz_extension(const char* filename);
 void list_variables(SymbolTable* symbols);
 void show_tokens(const char* code);
-void show_ast(const char* code);
+void show_ast(const char* code, ExecutionContext* ctx);
+void show_bytecode(const char* code, ExecutionContext* ctx);
 
 void print_banner(void);
 
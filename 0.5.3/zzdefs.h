@@ -8,7 +8,6 @@
 #define NUMBER_SIZE 		64
 #define VARNAME_SIZE 		64
 #define TOKENTEXT_SIZE   	128    // Para texto de token (números, operadores)
-#define STRING_SIZE 		256
 
 #endif
 // Fim de zzdefs.h
\ No newline at end of file
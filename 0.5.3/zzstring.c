@@ -0,0 +1,162 @@
+// zzstring.c
+
+#include <string.h>
+
+#include "zzstring.h"
+#include "a89alloc.h"
+
+// Constante estática (texto vazio)
+static String empty_string = { 0, 1, STRING_IMMORTAL, 0, (char*)"", NULL };
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME        16777619u
+
+// Bloco com cabeçalho e espaço para 'capacity' bytes logo depois;
+// length, hash e o texto ficam para o chamador
+static String* string_alloc(size_t capacity)
+{
+    String* string = A89ALLOC(sizeof(String) + capacity);
+    string->capacity = capacity;
+    string->refcount = 1;
+    string->chars = (char*)(string + 1);
+    string->parent = NULL;
+    return string;
+}
+
+String* string_new(const char* chars, size_t length)
+{
+    if (length == 0) return string_empty();
+
+    String* string = string_alloc(length + 1);
+    string->length = length;
+    string->hash = 0;
+    memcpy(string->chars, chars, length);
+    string->chars[length] = '\0';
+    return string;
+}
+
+String* string_from_text(const char* text)
+{
+    return string_new(text, strlen(text));
+}
+
+String* string_empty(void)
+{
+    return &empty_string;
+}
+
+String* string_view(String* string, size_t offset, size_t length)
+{
+    if (length == 0) return string_empty();
+    if (length == string->length) return string_retain(string);
+    if (length < STRING_VIEW_MIN) return string_new(string->chars + offset, length);
+
+    // Sempre a raiz: uma view de view não prende a view intermediária
+    String* owner = string->parent ? string->parent : string;
+
+    String* view = A89ALLOC(sizeof(String));
+    view->length = length;
+    view->capacity = 0;
+    view->refcount = 1;
+    view->hash = 0;
+    view->chars = string->chars + offset;
+    view->parent = string_retain(owner);
+    return view;
+}
+
+void string_materialize(String* string)
+{
+    if (string->capacity != 0) return;
+
+    // Texto num bloco separado do cabeçalho: o endereço da String não
+    // muda, porque outros valores podem estar apontando para ela
+    char* chars = A89ALLOC(string->length + 1);
+    memcpy(chars, string->chars, string->length);
+    chars[string->length] = '\0';
+
+    string_release(string->parent);
+    string->parent = NULL;
+    string->chars = chars;
+    string->capacity = string->length + 1;
+}
+
+void string_free(String* string)
+{
+    if (string->parent)
+    {
+        string_release(string->parent);
+    }
+    else if (string->chars != (char*)(string + 1))
+    {
+        a89free(string->chars);  // View materializada
+    }
+    a89free(string);
+}
+
+String* string_concat(String* a, String* b)
+{
+    if (a->length == 0) return string_retain(b);
+    if (b->length == 0) return string_retain(a);
+
+    size_t length = a->length + b->length;
+    String* string = string_alloc(length + 1);
+    string->length = length;
+    string->hash = 0;
+    memcpy(string->chars, a->chars, a->length);
+    memcpy(string->chars + a->length, b->chars, b->length);
+    string->chars[length] = '\0';
+    return string;
+}
+
+String* string_append(String* string, const char* chars, size_t length)
+{
+    size_t old_length = string->length;
+    size_t needed = old_length + length + 1;
+
+    if (needed > string->capacity)
+    {
+        // Dobra: n acréscimos custam O(n) cópias no total. Uma view
+        // (capacidade 0) cai sempre aqui e ganha bloco próprio
+        size_t capacity = string->capacity * 2;
+        if (capacity < needed) capacity = needed;
+
+        String* grown = string_alloc(capacity);
+        grown->length = old_length;
+        memcpy(grown->chars, string->chars, old_length);
+        memcpy(grown->chars + old_length, chars, length);  // Antes de soltar o antigo
+        string_free(string);
+        string = grown;
+    }
+    else
+    {
+        memmove(string->chars + old_length, chars, length);
+    }
+
+    string->length = old_length + length;
+    string->chars[string->length] = '\0';
+    string->hash = 0;
+    return string;
+}
+
+int string_compare(const String* a, const String* b)
+{
+    if (a == b) return 0;
+
+    size_t common = a->length < b->length ? a->length : b->length;
+    int order = memcmp(a->chars, b->chars, common);
+    if (order != 0) return order;
+    return (a->length > b->length) - (a->length < b->length);
+}
+
+uint32_t string_hash_bytes(const char* chars, size_t length)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)chars[i];
+        hash *= FNV_PRIME;
+    }
+    return hash ? hash : 1;
+}
+
+// Fim de zzstring.c
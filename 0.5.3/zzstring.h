@@ -0,0 +1,134 @@
+// zzstring.h
+
+#ifndef ZZSTRING_H
+#define ZZSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/********************************************************************
+STRINGS IMUTÁVEIS COM CONTAGEM DE REFERÊNCIAS
+
+Cabeçalho (tamanho e contagem) e caracteres num único bloco: o texto
+fica logo depois do cabeçalho, terminado em '\0' para as APIs de C.
+Não há limite de tamanho, e passar uma string adiante (Value,
+variável, literal) custa O(1) qualquer que seja o tamanho.
+
+Views: string_view() devolve um trecho de outra string sem copiar o
+texto. A view retém a dona dos bytes (a raiz, nunca outra view) e
+aponta para dentro dela; o trecho não tem '\0'. Quem precisa do
+terminador chama string_cstr(), que copia o trecho para um bloco
+próprio uma única vez. string_append também copia antes de alterar.
+Trechos curtos (menos de STRING_VIEW_MIN bytes) são sempre copiados:
+custam o mesmo que o cabeçalho da view e não prendem a dona.
+
+Quem guarda uma string retém uma referência:
+
+* literais: a arena da AST (ast_arena_string) e o chunk da VM
+* variáveis: a SymbolTable (symbol_table_slot_set)
+
+Valores em trânsito (evaluator, pilha da VM) são emprestados. Nenhuma
+expressão altera variáveis, então o dono sempre vive mais que eles.
+As strings criadas durante uma expressão (concatenação) são retidas
+pelo ExecutionContext até o fim do statement (evaluator_concat).
+
+Imutável para quem enxerga: só string_append altera o bloco, e só
+quando o chamador é o único dono (contagem 1). A capacidade cresce
+dobrando, então "let s = s + x" num laço custa O(1) amortizado.
+********************************************************************/
+
+#define STRING_IMMORTAL UINT32_MAX   // Contagem de constantes estáticas
+#define STRING_VIEW_MIN 32           // Trechos menores são copiados
+
+typedef struct String String;
+
+struct String
+{
+    size_t length;          // Em bytes, sem o '\0'
+    size_t capacity;        // Bytes reservados em chars (>= length + 1); 0 = view
+    uint32_t refcount;      // STRING_IMMORTAL: nunca liberada
+    uint32_t hash;          // FNV-1a calculado sob demanda (0 = ainda não)
+    char* chars;            // Logo depois do cabeçalho, ou dentro de 'parent'
+    String* parent;         // View: dona dos bytes (retida); NULL nas demais
+};
+
+// Cópia de 'length' bytes (não precisam ter '\0'); contagem 1
+String* string_new(const char* chars, size_t length);
+String* string_from_text(const char* text);
+
+// String vazia compartilhada (não aloca)
+String* string_empty(void);
+
+// Trecho [offset, offset + length) de 'string', que precisa caber
+// nela. A string inteira devolve ela mesma; trecho vazio, a vazia
+String* string_view(String* string, size_t offset, size_t length);
+
+static inline int string_is_view(const String* string)
+{
+    return string->parent != NULL;
+}
+
+// Texto terminado em '\0'. Uma view vira string própria aqui (cópia
+// do trecho, solta a dona); quem já a enxergava não percebe diferença
+void string_materialize(String* string);
+
+static inline const char* string_cstr(String* string)
+{
+    if (string->capacity == 0) string_materialize(string);
+    return string->chars;
+}
+
+// Nova string a + b (contagem 1). Se um lado é vazio, devolve o
+// outro com uma referência a mais, sem copiar
+String* string_concat(String* a, String* b);
+
+// Acrescenta 'length' bytes ao fim de 'string', que precisa ter
+// contagem 1. Devolve o bloco (pode ter mudado de endereço; o antigo
+// já foi liberado). 'chars' pode apontar para a própria string.
+// Uma view é copiada para um bloco novo antes de crescer
+String* string_append(String* string, const char* chars, size_t length);
+
+void string_free(String* string);  // Use string_release()
+
+// FNV-1a dos bytes; nunca devolve 0 (reservado para "não calculado")
+uint32_t string_hash_bytes(const char* chars, size_t length);
+
+static inline uint32_t string_hash(String* string)
+{
+    if (string->hash == 0)
+    {
+        string->hash = string_hash_bytes(string->chars, string->length);
+    }
+    return string->hash;
+}
+
+static inline String* string_retain(String* string)
+{
+    if (string->refcount != STRING_IMMORTAL) string->refcount++;
+    return string;
+}
+
+static inline void string_release(String* string)
+{
+    if (string->refcount != STRING_IMMORTAL && --string->refcount == 0)
+    {
+        string_free(string);
+    }
+}
+
+// Igualdade: mesmo ponteiro (literais internados), tamanho e hash já
+// calculados decidem antes de comparar os bytes
+static inline int string_equal(const String* a, const String* b)
+{
+    if (a == b) return 1;
+    if (a->length != b->length) return 0;
+    if (a->hash && b->hash && a->hash != b->hash) return 0;
+    return memcmp(a->chars, b->chars, a->length) == 0;
+}
+
+// Ordem dos bytes (<0, 0, >0); um prefixo vem antes
+int string_compare(const String* a, const String* b);
+
+#endif // ZZSTRING_H
+// Fim de zzstring.h